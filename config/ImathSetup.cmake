@@ -113,6 +113,11 @@ if(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)
     "Debug" "Release" "MinSizeRel" "RelWithDebInfo")
 endif()
 
+# Timings that compare the batched functions with their
+# one-at-a-time counterparts, printed by ImathTest. They are not part
+# of the test suite, so they are only compiled on request.
+option(IMATH_TEST_BENCHMARKS "Compile the timings of the batched functions into ImathTest" OFF)
+
 # Code check related features
 option(IMATH_USE_CLANG_TIDY "Check if clang-tidy is available, and enable that" OFF)
 if(IMATH_USE_CLANG_TIDY)
@@ -0,0 +1,47 @@
+#include <Imath/ImathBVH.h>
+#include <Imath/ImathSphere.h>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+void
+bvh_example()
+{
+    std::vector<Imath::Sphere3f> spheres;
+    std::vector<Imath::Box3f> bounds;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        Imath::V3f center (float (i) * 3.0f, 0.0f, 0.0f);
+        spheres.push_back (Imath::Sphere3f (center, 1.0f));
+        bounds.push_back (Imath::Box3f (center - Imath::V3f (1.0f), center + Imath::V3f (1.0f)));
+    }
+
+    Imath::BVHf bvh (bounds.data(), bounds.size());
+
+    // Cast a ray along the x axis from x = -10
+
+    Imath::Line3f ray (Imath::V3f (-10.0f, 0.0f, 0.0f), Imath::V3f (0.0f, 0.0f, 0.0f));
+
+    float t = std::numeric_limits<float>::max();
+    size_t hit;
+
+    bvh.closestHit (ray, t, hit, [&] (size_t i, const Imath::Line3f& r, float& t) {
+        float ti;
+        if (spheres[i].intersectT (r, ti) && ti < t)
+        {
+            t = ti;
+            return true;
+        }
+        return false;
+    });
+
+    assert (hit == 0 && t == 9.0f);
+
+    // Find the spheres whose bounds overlap a box
+
+    size_t count = 0;
+    Imath::Box3f box (Imath::V3f (4.0f, -1.0f, -1.0f), Imath::V3f (8.0f, 1.0f, 1.0f));
+    bvh.findOverlapping (box, [&] (size_t) { ++count; });
+    assert (count == 3);
+}
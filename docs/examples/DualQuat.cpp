@@ -0,0 +1,21 @@
+#include <Imath/ImathMatrixAlgo.h>
+#include <Imath/ImathQuat.h>
+
+void
+dualquat_example()
+{
+    Imath::Quatf q;
+    q.setAxisAngle (Imath::V3f (0.0f, 0.0f, 1.0f), float (M_PI_2));
+
+    Imath::DualQuatf a (q, Imath::V3f (1.0f, 2.0f, 3.0f));
+    Imath::DualQuatf b = Imath::extractDualQuat (a.toMatrix44());
+
+    Imath::V3f p = Imath::V3f (1.0f, 0.0f, 0.0f) * a;
+    assert (p.equalWithAbsError (Imath::V3f (1.0f, 3.0f, 3.0f), 1e-6f));
+
+    // Halfway along the screw: a 45 degree rotation about the screw
+    // axis through (-0.5, 1.5, z), and half the translation along it.
+
+    Imath::DualQuatf c = Imath::sclerp (Imath::DualQuatf(), b, 0.5f);
+    assert (c.translation().equalWithAbsError (Imath::V3f (0.914214f, 0.792893f, 1.5f), 1e-5f));
+}
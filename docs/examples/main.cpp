@@ -3,8 +3,10 @@
 
 #include <iostream>
 
+void bvh_example();
 void color3_example();
 void color4_example();
+void dualquat_example();
 void euler_example();
 void frustum_example();
 void interval_example();
@@ -26,8 +28,10 @@ main (int argc, char* argv[])
 {
     std::cout << "imath examples..." << std::endl;
 
+    bvh_example();
     color3_example();
     color4_example();
+    dualquat_example();
     euler_example();
     frustum_example();
     interval_example();
@@ -0,0 +1,1259 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHBVH_H
+#define INCLUDED_IMATHBVH_H
+
+//-------------------------------------------------------------------------
+//
+//  A bounding volume hierarchy over the bounding boxes of primitives,
+//  for ray casting, frustum culling, box overlap and closest-point
+//  queries.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathBox.h"
+#include "ImathFrustumTest.h"
+#include "ImathLine.h"
+#include "ImathNamespace.h"
+#include "ImathPreparedRay.h"
+#include "ImathSpaceFillingCurve.h"
+#include "ImathVec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/////////////////////////////////////////////////////////////////
+// BVH
+//
+//	template class BVH<T>
+//
+// A BVH is built from an array of primitive bounding boxes. It does
+// not know what the primitives are; the queries report primitives by
+// their index in the array, and ray and distance queries call back
+// to intersect the primitives or to measure the distance to them.
+//
+
+//////////////////////////////////////////////////////////////////
+// How to use this
+//
+// Build the hierarchy from the bounds of the primitives:
+//    Imath::BVH<float> bvh (myBounds, numPrimitives);
+//
+// Cast rays. The intersector tests one primitive against the ray,
+// and if the primitive is hit at a distance in [0, t), it sets t to
+// the distance and returns true:
+//    float t = std::numeric_limits<float>::max();
+//    size_t hitPrimitive;
+//    bvh.closestHit (myRay, t, hitPrimitive,
+//                    [&] (size_t i, const Line3f& ray, float& t) { ... });
+//    bvh.anyHit (myRay, tMax, myIntersector)
+//
+// Find the primitives whose bounds are visible, or overlap a box:
+//    bvh.findVisible (myFrustumTest, [&] (size_t i) { ... });
+//    bvh.findOverlapping (myBox, [&] (size_t i) { ... });
+//
+// Find the closest primitives to a point. The distance function
+// measures the squared distance from the point to one primitive,
+// and if it is less than d2, sets d2 to it and returns true. For
+// points, the primitive bounds are the points themselves, and for
+// triangles, closestPointOnTriangle() in ImathVecAlgo.h gives the
+// distance:
+//    float d2 = std::numeric_limits<float>::max();
+//    size_t closest;
+//    bvh.findClosest (myPoint, d2, closest,
+//                     [&] (size_t i, const V3f& p, float& d2) { ... });
+//    bvh.findKClosest (myPoint, k, maxD2, primitives, d2s, myDistance);
+//    bvh.findWithinDistance (myPoint, maxD2, myDistance,
+//                            [&] (size_t i, float d2) { ... });
+//    bvh.findClosest (myPoints, n, primitives, d2s, myDistance);
+//
+
+//////////////////////////////////////////////////////////////////
+// Explanation of how it works
+//
+// Construction: a binary tree is built top-down. Each node is split
+// where the binned surface area heuristic (SAH), evaluated at 16
+// bins along each axis, estimates the lowest cost of tracing rays,
+// or made a leaf when splitting does not pay. Below depth 32, nodes
+// are split at the median instead, which bounds the depth of the
+// tree and the size of the traversal stacks. Construction runs in
+// the calling thread; Imath has no threading dependency, so callers
+// that need faster builds can build separate hierarchies over
+// disjoint sets of primitives in their own threads.
+//
+// Layout: the binary tree is collapsed into a tree with four
+// children per node, stored in a single array. Each node holds the
+// bounds of its children in structure-of-arrays layout, so that a
+// ray or query box is tested against all four children with plain
+// loops that the compiler can vectorize. Four lanes match the SSE
+// and NEON register width; there is no eight-wide layout, which
+// would only pay off with AVX code paths that Imath does not have.
+//
+// Traversal: rays use the slab test of PreparedRay, with the
+// reciprocal of the direction computed once per ray. Closest-hit
+// queries visit the children in front-to-back order and skip
+// children beyond the closest hit found so far. Frustum queries use
+// FrustumTest::classify(): subtrees that are entirely inside the
+// frustum are reported without further tests, and the children of a
+// node are only tested against the planes that the node straddles.
+// Distance queries measure the squared distance from the point to
+// the bounds of the four children at once, visit the children near
+// to far, and skip children and primitives whose bounds are farther
+// than the closest primitives found so far.
+//
+// Primitives with empty bounds can never be hit or be visible; they
+// are left out of the hierarchy.
+//
+
+template <class T> class BVH
+{
+  public:
+    //
+    // A node of the hierarchy. Child i is
+    //
+    //	    a leaf with primitives indices()[child[i]] to
+    //	    indices()[child[i] + count[i] - 1], if count[i] > 0,
+    //
+    //	    the node nodes()[child[i]] if count[i] == 0 and
+    //	    child[i] != UNUSED,
+    //
+    //	    unused, with empty bounds, if child[i] == UNUSED.
+    //
+
+    enum : uint32_t
+    {
+        UNUSED = ~uint32_t (0)
+    };
+
+    struct Node
+    {
+        T minX[4];
+        T minY[4];
+        T minZ[4];
+        T maxX[4];
+        T maxY[4];
+        T maxZ[4];
+
+        uint32_t child[4];
+        uint32_t count[4];
+
+        Box<Vec3<T>> bounds (int i) const noexcept
+        {
+            return Box<Vec3<T>> (Vec3<T> (minX[i], minY[i], minZ[i]),
+                                 Vec3<T> (maxX[i], maxY[i], maxZ[i]));
+        }
+    };
+
+    //
+    // Construction. The primitive bounds are copied; at most
+    // 2^32 - 1 primitives are supported.
+    //
+
+    BVH() noexcept {}
+    BVH (const Box<Vec3<T>>* bounds, size_t n, int maxLeafSize = 4);
+
+    void build (const Box<Vec3<T>>* bounds, size_t n, int maxLeafSize = 4);
+
+    //
+    // Queries
+    //
+
+    // The bounds of all primitives
+    Box<Vec3<T>> bounds() const noexcept { return _bounds; }
+
+    // The number of primitives passed to build()
+    size_t size() const noexcept { return _size; }
+
+    // The nodes; nodes()[0] is the root, if there are any nodes
+    const std::vector<Node>& nodes() const noexcept { return _nodes; }
+
+    // The indices of the primitives in the hierarchy, in leaf order
+    const std::vector<uint32_t>& indices() const noexcept { return _indices; }
+
+    //
+    // Ray queries. The ray is ray.pos + t * ray.dir for t >= 0; the
+    // direction need not be normalized. The intersector is called
+    // as intersect (size_t primitive, const Line3<T>& ray, T& t) for
+    // primitives whose bounds the ray hits before t. If it hits the
+    // primitive at a distance in [0, t), it sets t to the distance
+    // and returns true.
+    //
+    // closestHit() returns true if any primitive is hit before the
+    // initial value of t, and sets t and primitive to the closest hit.
+    //
+    // anyHit() returns true as soon as a primitive is hit before tMax.
+    //
+
+    template <class Intersector>
+    bool closestHit (const Line3<T>& ray, T& t, size_t& primitive, Intersector&& intersect) const;
+
+    template <class Intersector>
+    bool anyHit (const Line3<T>& ray, T tMax, Intersector&& intersect) const;
+
+    //
+    // Call visit (size_t primitive) for each primitive whose bounds
+    // are visible in a frustum, as by FrustumTest::isVisible(), or
+    // overlap a box, as by Box::intersects().
+    //
+
+    template <class Visitor> void findVisible (const FrustumTest<T>& frustumTest, Visitor&& visit) const;
+
+    template <class Visitor> void findOverlapping (const Box<Vec3<T>>& box, Visitor&& visit) const;
+
+    //
+    // Distance queries. The distance function is called as
+    // distance (size_t primitive, const Vec3<T>& p, T& d2) for
+    // primitives whose bounds are closer to p than d2 (squared).
+    // If the squared distance from p to the primitive is less than
+    // d2, it sets d2 to the squared distance and returns true.
+    //
+    // findClosest() returns true if any primitive is closer than the
+    // initial value of d2, and sets d2 and primitive to the closest.
+    //
+    // findKClosest() finds the k closest primitives that are closer
+    // than maxD2, and stores them and their squared distances in
+    // primitives[] and d2[], from closest to farthest. It returns
+    // how many it found, at most k.
+    //
+    // findWithinDistance() calls visit (size_t primitive, T d2) for
+    // each primitive that is closer than maxD2, in no particular
+    // order.
+    //
+    // The batch version of findClosest() finds the closest primitive
+    // to each of n points, and sets primitives[i] to size() and
+    // d2[i] to the largest T if there are no primitives. The queries
+    // are made in Morton order, so that consecutive queries visit
+    // the same nodes. All queries are const; a large batch can be
+    // split among several threads.
+    //
+
+    template <class Distance>
+    bool findClosest (const Vec3<T>& p, T& d2, size_t& primitive, Distance&& distance) const;
+
+    template <class Distance>
+    size_t findKClosest (const Vec3<T>& p,
+                         size_t k,
+                         T maxD2,
+                         size_t primitives[],
+                         T d2[],
+                         Distance&& distance) const;
+
+    template <class Distance, class Visitor>
+    void findWithinDistance (const Vec3<T>& p, T maxD2, Distance&& distance, Visitor&& visit) const;
+
+    template <class Distance>
+    void findClosest (const Vec3<T>* points,
+                      size_t n,
+                      size_t primitives[],
+                      T d2[],
+                      Distance&& distance) const;
+
+  private:
+    // Depth below which nodes are split at the median, and the
+    // traversal stack size that results
+    static constexpr int maxSahDepth = 32;
+    static constexpr int stackSize   = 256;
+
+    struct BuildNode
+    {
+        Box<Vec3<T>> bounds;
+        size_t begin;
+        size_t end;
+        size_t left; // 0 for leaves; the root is never a child
+        size_t right;
+    };
+
+    struct Primitive
+    {
+        Box<Vec3<T>> bounds;
+        Vec3<T> centroid;
+        uint32_t index;
+    };
+
+    void
+    buildBinary (std::vector<Primitive>& primitives, std::vector<BuildNode>& tree, int maxLeafSize);
+
+    void collapse (const std::vector<BuildNode>& tree);
+
+    static T halfArea (const Box<Vec3<T>>& b) noexcept;
+    static void extend (Box<Vec3<T>>& box, const Box<Vec3<T>>& b) noexcept;
+    static void extend (Box<Vec3<T>>& box, const Vec3<T>& p) noexcept;
+    static int binIndex (T x, T lo, T scale, int numBins) noexcept;
+
+    template <bool Parallel>
+    int intersectChildren (const Node& node,
+                           const PreparedRay<T>& ray,
+                           T tMax,
+                           T tNear[4]) const noexcept;
+
+    static void distanceToChildren (const Node& node, const Vec3<T>& p, T d2[4]) noexcept;
+    static T distanceToBox (const Box<Vec3<T>>& box, const Vec3<T>& p) noexcept;
+
+    template <class Visitor> void visitNear (const Vec3<T>& p, T& maxD2, Visitor& visit) const;
+
+    template <class Visitor> void visitSubtree (uint32_t node, Visitor& visit) const;
+
+    template <class Visitor> void visitLeaf (const Node& node, int i, Visitor& visit) const;
+
+    Box<Vec3<T>> _bounds;
+    size_t _size = 0;
+    std::vector<Node> _nodes;
+    std::vector<uint32_t> _indices;
+    std::vector<Box<Vec3<T>>> _primitiveBounds; // in leaf order
+};
+
+//--------------------
+// Convenient typedefs
+//--------------------
+
+typedef BVH<float> BVHf;
+typedef BVH<double> BVHd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T> BVH<T>::BVH (const Box<Vec3<T>>* bounds, size_t n, int maxLeafSize)
+{
+    build (bounds, n, maxLeafSize);
+}
+
+template <class T>
+void
+BVH<T>::build (const Box<Vec3<T>>* bounds, size_t n, int maxLeafSize)
+{
+    _bounds.makeEmpty();
+    _size = n;
+    _nodes.clear();
+    _indices.clear();
+    _primitiveBounds.clear();
+
+    std::vector<Primitive> primitives;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!bounds[i].isEmpty())
+        {
+            primitives.push_back (Primitive { bounds[i], bounds[i].center(), uint32_t (i) });
+            _bounds.extendBy (bounds[i]);
+        }
+    }
+
+    if (primitives.empty())
+        return;
+
+    std::vector<BuildNode> tree;
+    buildBinary (primitives, tree, std::max (maxLeafSize, 1));
+    collapse (tree);
+
+    _indices.resize (primitives.size());
+    _primitiveBounds.resize (primitives.size());
+
+    for (size_t i = 0; i < primitives.size(); ++i)
+    {
+        _indices[i]         = primitives[i].index;
+        _primitiveBounds[i] = primitives[i].bounds;
+    }
+}
+
+template <class T>
+inline T
+BVH<T>::halfArea (const Box<Vec3<T>>& b) noexcept
+{
+    Vec3<T> d = b.size();
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+//
+// Box::extendBy() without branches, which mispredict often when
+// binning primitives
+//
+
+template <class T>
+inline void
+BVH<T>::extend (Box<Vec3<T>>& box, const Box<Vec3<T>>& b) noexcept
+{
+    box.min.x = std::min (box.min.x, b.min.x);
+    box.min.y = std::min (box.min.y, b.min.y);
+    box.min.z = std::min (box.min.z, b.min.z);
+    box.max.x = std::max (box.max.x, b.max.x);
+    box.max.y = std::max (box.max.y, b.max.y);
+    box.max.z = std::max (box.max.z, b.max.z);
+}
+
+template <class T>
+inline void
+BVH<T>::extend (Box<Vec3<T>>& box, const Vec3<T>& p) noexcept
+{
+    extend (box, Box<Vec3<T>> (p, p));
+}
+
+template <class T>
+inline int
+BVH<T>::binIndex (T x, T lo, T scale, int numBins) noexcept
+{
+    return std::min (int ((x - lo) * scale), numBins - 1);
+}
+
+template <class T>
+void
+BVH<T>::buildBinary (std::vector<Primitive>& primitives,
+                     std::vector<BuildNode>& tree,
+                     int maxLeafSize)
+{
+    //
+    // The primitives are partitioned in place, so that the primitives
+    // of each node are contiguous in memory.
+    //
+
+    const int numBins = 16;
+    Primitive* prims  = primitives.data();
+
+    tree.push_back ({ _bounds, 0, primitives.size(), 0, 0 });
+
+    struct Job
+    {
+        size_t node;
+        int depth;
+    };
+
+    std::vector<Job> jobs (1, Job { 0, 0 });
+
+    while (!jobs.empty())
+    {
+        Job job = jobs.back();
+        jobs.pop_back();
+
+        const size_t begin = tree[job.node].begin;
+        const size_t end   = tree[job.node].end;
+        const size_t count = end - begin;
+
+        if (count <= 1)
+            continue;
+
+        Box<Vec3<T>> centroidBounds;
+        for (size_t i = begin; i < end; ++i)
+            extend (centroidBounds, prims[i].centroid);
+
+        int bestAxis  = -1;
+        int bestSplit = 0;
+        T bestCost    = std::numeric_limits<T>::max();
+
+        if (job.depth < maxSahDepth)
+        {
+            // Bin the primitives along all three axes in one pass
+
+            Vec3<T> lo = centroidBounds.min;
+            Vec3<T> scale;
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                T extent    = centroidBounds.max[axis] - lo[axis];
+                scale[axis] = extent > 0 ? T (numBins) / extent : T (0);
+            }
+
+            size_t binCount[3][numBins] = {};
+            Box<Vec3<T>> binBounds[3][numBins];
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    int b = binIndex (prims[i].centroid[axis], lo[axis], scale[axis], numBins);
+                    ++binCount[axis][b];
+                    extend (binBounds[axis][b], prims[i].bounds);
+                }
+            }
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (scale[axis] == 0)
+                    continue;
+
+                // Sweep over the bins that are used from the right,
+                // then from the left. The split after used[k] puts
+                // the primitives in used[0] to used[k] on the left.
+
+                int used[numBins];
+                int numUsed = 0;
+
+                for (int b = 0; b < numBins; ++b)
+                    if (binCount[axis][b])
+                        used[numUsed++] = b;
+
+                T rightArea[numBins];
+                size_t rightCount[numBins];
+                Box<Vec3<T>> acc;
+                size_t n = 0;
+
+                for (int k = numUsed - 1; k > 0; --k)
+                {
+                    extend (acc, binBounds[axis][used[k]]);
+                    n += binCount[axis][used[k]];
+                    rightArea[k]  = halfArea (acc);
+                    rightCount[k] = n;
+                }
+
+                acc.makeEmpty();
+                n = 0;
+
+                for (int k = 0; k < numUsed - 1; ++k)
+                {
+                    extend (acc, binBounds[axis][used[k]]);
+                    n += binCount[axis][used[k]];
+
+                    T cost = T (n) * halfArea (acc) + T (rightCount[k + 1]) * rightArea[k + 1];
+
+                    if (cost < bestCost)
+                    {
+                        bestCost  = cost;
+                        bestAxis  = axis;
+                        bestSplit = used[k + 1];
+                    }
+                }
+            }
+
+            // Cost relative to a leaf, with the cost of traversing a
+            // node equal to that of intersecting a primitive
+
+            T area = halfArea (tree[job.node].bounds);
+
+            if (count <= size_t (maxLeafSize) &&
+                (bestAxis < 0 || (area > 0 && 1 + bestCost / area >= T (count))))
+                continue;
+        }
+        else if (count <= size_t (maxLeafSize))
+        {
+            continue;
+        }
+
+        size_t mid;
+
+        if (bestAxis >= 0)
+        {
+            T lo    = centroidBounds.min[bestAxis];
+            T scale = T (numBins) / (centroidBounds.max[bestAxis] - lo);
+
+            mid = std::partition (prims + begin,
+                                  prims + end,
+                                  [&] (const Primitive& p) {
+                                      return binIndex (p.centroid[bestAxis], lo, scale, numBins) <
+                                             bestSplit;
+                                  }) -
+                  prims;
+        }
+        else
+        {
+            // Split at the median along the largest axis of the
+            // centroids; if the centroids coincide, any split will do
+
+            mid      = begin + count / 2;
+            int axis = centroidBounds.majorAxis();
+
+            std::nth_element (prims + begin,
+                              prims + mid,
+                              prims + end,
+                              [&] (const Primitive& a, const Primitive& b) {
+                                  return a.centroid[axis] < b.centroid[axis];
+                              });
+        }
+
+        BuildNode left  = { Box<Vec3<T>>(), begin, mid, 0, 0 };
+        BuildNode right = { Box<Vec3<T>>(), mid, end, 0, 0 };
+
+        for (size_t i = begin; i < mid; ++i)
+            extend (left.bounds, prims[i].bounds);
+
+        for (size_t i = mid; i < end; ++i)
+            extend (right.bounds, prims[i].bounds);
+
+        tree[job.node].left  = tree.size();
+        tree[job.node].right = tree.size() + 1;
+        tree.push_back (left);
+        tree.push_back (right);
+
+        jobs.push_back (Job { tree[job.node].left, job.depth + 1 });
+        jobs.push_back (Job { tree[job.node].right, job.depth + 1 });
+    }
+}
+
+template <class T>
+void
+BVH<T>::collapse (const std::vector<BuildNode>& tree)
+{
+    //
+    // Each four-wide node takes the children of a binary node and
+    // repeatedly replaces the inner child with the largest surface
+    // area by its two children, until it has four children.
+    //
+
+    struct Job
+    {
+        size_t binary;
+        size_t parent;
+        int slot;
+    };
+
+    std::vector<Job> jobs (1, Job { 0, 0, -1 });
+
+    while (!jobs.empty())
+    {
+        Job job = jobs.back();
+        jobs.pop_back();
+
+        size_t children[4];
+        int numChildren = 0;
+
+        if (tree[job.binary].left)
+        {
+            children[numChildren++] = tree[job.binary].left;
+            children[numChildren++] = tree[job.binary].right;
+        }
+        else
+        {
+            children[numChildren++] = job.binary; // a single leaf
+        }
+
+        while (numChildren < 4)
+        {
+            int best   = -1;
+            T bestArea = T (-1);
+
+            for (int i = 0; i < numChildren; ++i)
+            {
+                const BuildNode& c = tree[children[i]];
+
+                if (c.left && halfArea (c.bounds) > bestArea)
+                {
+                    best     = i;
+                    bestArea = halfArea (c.bounds);
+                }
+            }
+
+            if (best < 0)
+                break;
+
+            size_t c                = children[best];
+            children[best]          = tree[c].left;
+            children[numChildren++] = tree[c].right;
+        }
+
+        uint32_t index = uint32_t (_nodes.size());
+        _nodes.push_back (Node());
+
+        if (job.slot >= 0)
+            _nodes[job.parent].child[job.slot] = index;
+
+        Node& node = _nodes[index];
+
+        for (int i = 0; i < 4; ++i)
+        {
+            Box<Vec3<T>> b;
+            node.child[i] = UNUSED;
+            node.count[i] = 0;
+
+            if (i < numChildren)
+            {
+                const BuildNode& c = tree[children[i]];
+                b                  = c.bounds;
+
+                if (c.left)
+                {
+                    jobs.push_back (Job { children[i], index, i });
+                }
+                else
+                {
+                    node.child[i] = uint32_t (c.begin);
+                    node.count[i] = uint32_t (c.end - c.begin);
+                }
+            }
+
+            node.minX[i] = b.min.x;
+            node.minY[i] = b.min.y;
+            node.minZ[i] = b.min.z;
+            node.maxX[i] = b.max.x;
+            node.maxY[i] = b.max.y;
+            node.maxZ[i] = b.max.z;
+        }
+    }
+}
+
+//
+// Slab test of a ray against the four children of a node, as in
+// PreparedRay::intersects(); Parallel is ray.parallel. The near and far sides of each slab are
+// selected by the signs of the direction, so that empty boxes are
+// never hit. Where a zero direction component meets a slab boundary,
+// 0 * inf yields NaN, which the comparisons ignore: the ray counts as
+// inside the slab.
+//
+// Returns a bit mask of the children that are hit in [0, tMax], and
+// the distances at which the ray enters them.
+//
+
+template <class T>
+template <bool Parallel>
+inline int
+BVH<T>::intersectChildren (const Node& node,
+                           const PreparedRay<T>& ray,
+                           T tMax,
+                           T tNear[4]) const noexcept
+{
+    const T* nearX = ray.sign[0] ? node.maxX : node.minX;
+    const T* nearY = ray.sign[1] ? node.maxY : node.minY;
+    const T* nearZ = ray.sign[2] ? node.maxZ : node.minZ;
+    const T* farX  = ray.sign[0] ? node.minX : node.maxX;
+    const T* farY  = ray.sign[1] ? node.minY : node.maxY;
+    const T* farZ  = ray.sign[2] ? node.minZ : node.maxZ;
+
+    int hits = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        T tx0, ty0, tz0, tx1, ty1, tz1;
+
+        if (!Parallel)
+        {
+            tx0 = nearX[i] * ray.invDir.x - ray.posInvDir.x;
+            ty0 = nearY[i] * ray.invDir.y - ray.posInvDir.y;
+            tz0 = nearZ[i] * ray.invDir.z - ray.posInvDir.z;
+            tx1 = farX[i] * ray.invDir.x - ray.posInvDir.x;
+            ty1 = farY[i] * ray.invDir.y - ray.posInvDir.y;
+            tz1 = farZ[i] * ray.invDir.z - ray.posInvDir.z;
+        }
+        else
+        {
+            tx0 = (nearX[i] - ray.pos.x) * ray.invDir.x;
+            ty0 = (nearY[i] - ray.pos.y) * ray.invDir.y;
+            tz0 = (nearZ[i] - ray.pos.z) * ray.invDir.z;
+            tx1 = (farX[i] - ray.pos.x) * ray.invDir.x;
+            ty1 = (farY[i] - ray.pos.y) * ray.invDir.y;
+            tz1 = (farZ[i] - ray.pos.z) * ray.invDir.z;
+        }
+
+        T t0 = T (0);
+        t0   = tx0 > t0 ? tx0 : t0;
+        t0   = ty0 > t0 ? ty0 : t0;
+        t0   = tz0 > t0 ? tz0 : t0;
+
+        T t1 = tMax;
+        t1   = tx1 < t1 ? tx1 : t1;
+        t1   = ty1 < t1 ? ty1 : t1;
+        t1   = tz1 < t1 ? tz1 : t1;
+
+        tNear[i] = t0;
+        hits |= int (t0 <= t1) << i;
+    }
+
+    return hits;
+}
+
+template <class T>
+template <class Intersector>
+bool
+BVH<T>::closestHit (const Line3<T>& ray, T& t, size_t& primitive, Intersector&& intersect) const
+{
+    if (_nodes.empty())
+        return false;
+
+    PreparedRay<T> r (ray);
+    bool hit = false;
+
+    struct Entry
+    {
+        uint32_t node;
+        T tNear;
+    };
+
+    Entry stack[stackSize];
+    int top      = 0;
+    stack[top++] = Entry { 0, T (0) };
+
+    while (top > 0)
+    {
+        Entry e = stack[--top];
+
+        if (e.tNear > t)
+            continue;
+
+        const Node& node = _nodes[e.node];
+
+        T tNear[4];
+        int hits = r.parallel ? intersectChildren<true> (node, r, t, tNear)
+                              : intersectChildren<false> (node, r, t, tNear);
+
+        // Leaves are intersected right away; inner nodes are pushed
+        // far to near, so that the nearest is visited first
+
+        Entry inner[4];
+        int numInner = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!(hits & (1 << i)))
+                continue;
+
+            if (node.count[i])
+            {
+                for (uint32_t j = node.child[i]; j < node.child[i] + node.count[i]; ++j)
+                {
+                    if (intersect (size_t (_indices[j]), ray, t))
+                    {
+                        hit       = true;
+                        primitive = _indices[j];
+                    }
+                }
+            }
+            else if (node.child[i] != UNUSED)
+            {
+                int k = numInner++;
+
+                for (; k > 0 && inner[k - 1].tNear < tNear[i]; --k)
+                    inner[k] = inner[k - 1];
+
+                inner[k] = Entry { node.child[i], tNear[i] };
+            }
+        }
+
+        for (int i = 0; i < numInner; ++i)
+            stack[top++] = inner[i];
+    }
+
+    return hit;
+}
+
+template <class T>
+template <class Intersector>
+bool
+BVH<T>::anyHit (const Line3<T>& ray, T tMax, Intersector&& intersect) const
+{
+    if (_nodes.empty())
+        return false;
+
+    PreparedRay<T> r (ray);
+
+    uint32_t stack[stackSize];
+    int top      = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+
+        T tNear[4];
+        int hits = r.parallel ? intersectChildren<true> (node, r, tMax, tNear)
+                              : intersectChildren<false> (node, r, tMax, tNear);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!(hits & (1 << i)))
+                continue;
+
+            if (node.count[i])
+            {
+                for (uint32_t j = node.child[i]; j < node.child[i] + node.count[i]; ++j)
+                {
+                    T t = tMax;
+
+                    if (intersect (size_t (_indices[j]), ray, t))
+                        return true;
+                }
+            }
+            else if (node.child[i] != UNUSED)
+            {
+                stack[top++] = node.child[i];
+            }
+        }
+    }
+
+    return false;
+}
+
+//
+// The squared distances from a point to the bounds of the four
+// children of a node, as (closestPointInBox (p, box) - p).length2().
+// Unused children have empty bounds, with min > max; the distance
+// to them is larger than any other, or infinite.
+//
+
+template <class T>
+inline void
+BVH<T>::distanceToChildren (const Node& node, const Vec3<T>& p, T d2[4]) noexcept
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        T dx0 = node.minX[i] - p.x;
+        T dy0 = node.minY[i] - p.y;
+        T dz0 = node.minZ[i] - p.z;
+        T dx1 = p.x - node.maxX[i];
+        T dy1 = p.y - node.maxY[i];
+        T dz1 = p.z - node.maxZ[i];
+
+        T dx = dx0 > dx1 ? dx0 : dx1;
+        T dy = dy0 > dy1 ? dy0 : dy1;
+        T dz = dz0 > dz1 ? dz0 : dz1;
+
+        dx = dx > T (0) ? dx : T (0);
+        dy = dy > T (0) ? dy : T (0);
+        dz = dz > T (0) ? dz : T (0);
+
+        d2[i] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+template <class T>
+inline T
+BVH<T>::distanceToBox (const Box<Vec3<T>>& box, const Vec3<T>& p) noexcept
+{
+    T dx = std::max (std::max (box.min.x - p.x, p.x - box.max.x), T (0));
+    T dy = std::max (std::max (box.min.y - p.y, p.y - box.max.y), T (0));
+    T dz = std::max (std::max (box.min.z - p.z, p.z - box.max.z), T (0));
+
+    return dx * dx + dy * dy + dz * dz;
+}
+
+//
+// Call visit (uint32_t j) for the primitives in leaf order whose
+// bounds are closer to p than maxD2, visiting the children of each
+// node near to far. The visitor may reduce maxD2 as it finds
+// primitives, which prunes the rest of the traversal.
+//
+
+template <class T>
+template <class Visitor>
+void
+BVH<T>::visitNear (const Vec3<T>& p, T& maxD2, Visitor& visit) const
+{
+    if (_nodes.empty())
+        return;
+
+    struct Entry
+    {
+        uint32_t node;
+        T d2;
+    };
+
+    Entry stack[stackSize];
+    int top      = 0;
+    stack[top++] = Entry { 0, T (0) };
+
+    while (top > 0)
+    {
+        Entry e = stack[--top];
+
+        if (!(e.d2 < maxD2))
+            continue;
+
+        const Node& node = _nodes[e.node];
+
+        T d2[4];
+        distanceToChildren (node, p, d2);
+
+        // Sort the children that are close enough near to far
+
+        int order[4];
+        int numChildren = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!(d2[i] < maxD2) || (node.count[i] == 0 && node.child[i] == UNUSED))
+                continue;
+
+            int k = numChildren++;
+
+            for (; k > 0 && d2[order[k - 1]] > d2[i]; --k)
+                order[k] = order[k - 1];
+
+            order[k] = i;
+        }
+
+        // Leaves are visited right away; inner nodes are pushed far
+        // to near, so that the nearest is visited first
+
+        for (int k = 0; k < numChildren; ++k)
+        {
+            int i = order[k];
+
+            if (node.count[i] == 0 || !(d2[i] < maxD2))
+                continue;
+
+            for (uint32_t j = node.child[i]; j < node.child[i] + node.count[i]; ++j)
+            {
+                if (distanceToBox (_primitiveBounds[j], p) < maxD2)
+                    visit (j);
+            }
+        }
+
+        for (int k = numChildren - 1; k >= 0; --k)
+        {
+            int i = order[k];
+
+            if (node.count[i] == 0)
+                stack[top++] = Entry { node.child[i], d2[i] };
+        }
+    }
+}
+
+template <class T>
+template <class Distance>
+bool
+BVH<T>::findClosest (const Vec3<T>& p, T& d2, size_t& primitive, Distance&& distance) const
+{
+    bool found = false;
+
+    auto visit = [&] (uint32_t j) {
+        if (distance (size_t (_indices[j]), p, d2))
+        {
+            found     = true;
+            primitive = _indices[j];
+        }
+    };
+
+    visitNear (p, d2, visit);
+    return found;
+}
+
+template <class T>
+template <class Distance>
+size_t
+BVH<T>::findKClosest (const Vec3<T>& p,
+                      size_t k,
+                      T maxD2,
+                      size_t primitives[],
+                      T d2[],
+                      Distance&& distance) const
+{
+    //
+    // primitives[] and d2[] hold the closest primitives found so
+    // far, sorted by distance; once there are k of them, the search
+    // is limited to primitives closer than the kth.
+    //
+
+    size_t count = 0;
+    T limit      = maxD2;
+
+    if (k == 0)
+        return 0;
+
+    auto visit = [&] (uint32_t j) {
+        T dj = limit;
+
+        if (!distance (size_t (_indices[j]), p, dj))
+            return;
+
+        size_t i = count < k ? count++ : k - 1;
+
+        for (; i > 0 && d2[i - 1] > dj; --i)
+        {
+            primitives[i] = primitives[i - 1];
+            d2[i]         = d2[i - 1];
+        }
+
+        primitives[i] = _indices[j];
+        d2[i]         = dj;
+
+        if (count == k)
+            limit = d2[k - 1];
+    };
+
+    visitNear (p, limit, visit);
+    return count;
+}
+
+template <class T>
+template <class Distance, class Visitor>
+void
+BVH<T>::findWithinDistance (const Vec3<T>& p, T maxD2, Distance&& distance, Visitor&& visit) const
+{
+    auto visitPrimitive = [&] (uint32_t j) {
+        T dj = maxD2;
+
+        if (distance (size_t (_indices[j]), p, dj))
+            visit (size_t (_indices[j]), dj);
+    };
+
+    visitNear (p, maxD2, visitPrimitive);
+}
+
+template <class T>
+template <class Distance>
+void
+BVH<T>::findClosest (const Vec3<T>* points,
+                     size_t n,
+                     size_t primitives[],
+                     T d2[],
+                     Distance&& distance) const
+{
+    if (n == 0)
+        return;
+
+    std::vector<uint64_t> codes (n);
+    std::vector<uint32_t> order (n);
+
+    mortonCodes (points, _bounds, codes.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+        order[i] = uint32_t (i);
+
+    radixSort (codes.data(), order.data(), n);
+
+    for (size_t k = 0; k < n; ++k)
+    {
+        size_t i      = order[k];
+        d2[i]         = std::numeric_limits<T>::max();
+        primitives[i] = _size;
+
+        findClosest (points[i], d2[i], primitives[i], distance);
+    }
+}
+
+template <class T>
+template <class Visitor>
+inline void
+BVH<T>::visitLeaf (const Node& node, int i, Visitor& visit) const
+{
+    for (uint32_t j = node.child[i]; j < node.child[i] + node.count[i]; ++j)
+        visit (size_t (_indices[j]));
+}
+
+template <class T>
+template <class Visitor>
+void
+BVH<T>::visitSubtree (uint32_t root, Visitor& visit) const
+{
+    uint32_t stack[stackSize];
+    int top      = 0;
+    stack[top++] = root;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (node.count[i])
+                visitLeaf (node, i, visit);
+            else if (node.child[i] != UNUSED)
+                stack[top++] = node.child[i];
+        }
+    }
+}
+
+template <class T>
+template <class Visitor>
+void
+BVH<T>::findVisible (const FrustumTest<T>& frustumTest, Visitor&& visit) const
+{
+    if (_nodes.empty())
+        return;
+
+    typedef FrustumTest<T> FT;
+
+    struct Entry
+    {
+        uint32_t node;
+        unsigned int planeMask;
+    };
+
+    Entry stack[stackSize];
+    int top      = 0;
+    stack[top++] = Entry { 0, FT::ALL_PLANES };
+
+    while (top > 0)
+    {
+        Entry e          = stack[--top];
+        const Node& node = _nodes[e.node];
+
+        for (int i = 0; i < 4; ++i)
+        {
+            unsigned int planeMask       = e.planeMask;
+            typename FT::Classification c = frustumTest.classify (node.bounds (i), planeMask);
+
+            if (c == FT::OUTSIDE || (node.count[i] == 0 && node.child[i] == UNUSED))
+                continue;
+
+            if (c == FT::INSIDE)
+            {
+                if (node.count[i])
+                    visitLeaf (node, i, visit);
+                else
+                    visitSubtree (node.child[i], visit);
+            }
+            else if (node.count[i])
+            {
+                for (uint32_t j = node.child[i]; j < node.child[i] + node.count[i]; ++j)
+                {
+                    unsigned int primitiveMask = planeMask;
+
+                    if (frustumTest.classify (_primitiveBounds[j], primitiveMask) != FT::OUTSIDE)
+                        visit (size_t (_indices[j]));
+                }
+            }
+            else
+            {
+                stack[top++] = Entry { node.child[i], planeMask };
+            }
+        }
+    }
+}
+
+template <class T>
+template <class Visitor>
+void
+BVH<T>::findOverlapping (const Box<Vec3<T>>& box, Visitor&& visit) const
+{
+    if (_nodes.empty() || box.isEmpty())
+        return;
+
+    uint32_t stack[stackSize];
+    int top      = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+
+        // The test of Box::intersects(Box), for four boxes at a time
+
+        int overlaps = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            int disjoint = (node.maxX[i] < box.min.x) | (node.minX[i] > box.max.x) |
+                           (node.maxY[i] < box.min.y) | (node.minY[i] > box.max.y) |
+                           (node.maxZ[i] < box.min.z) | (node.minZ[i] > box.max.z);
+
+            overlaps |= (disjoint ^ 1) << i;
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!(overlaps & (1 << i)))
+                continue;
+
+            if (node.count[i])
+            {
+                for (uint32_t j = node.child[i]; j < node.child[i] + node.count[i]; ++j)
+                {
+                    if (_primitiveBounds[j].intersects (box))
+                        visit (size_t (_indices[j]));
+                }
+            }
+            else if (node.child[i] != UNUSED)
+            {
+                stack[top++] = node.child[i];
+            }
+        }
+    }
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHBVH_H
@@ -8,6 +8,8 @@
 
 #include "ImathNamespace.h"
 #include "ImathVec.h"
+#include <cstddef>
+#include <type_traits>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -805,6 +807,67 @@ Box<Vec3<T>>::majorAxis() const noexcept
     return major;
 }
 
+//-------------------------------------------------------------------
+//
+//  Arrays of 3D boxes
+//
+//-------------------------------------------------------------------
+
+///
+/// An array of 3D boxes in structure-of-arrays layout: the i-th box
+/// has minimum (minX[i], minY[i], minZ[i]) and maximum (maxX[i],
+/// maxY[i], maxZ[i]). Functions that read arrays of boxes take
+/// `Box3SoA<const T>`, which a `Box3SoA<T>` converts to.
+///
+
+template <class T> class Box3SoA
+{
+  public:
+    typedef typename std::remove_const<T>::type BaseType;
+
+    T* minX;
+    T* minY;
+    T* minZ;
+    T* maxX;
+    T* maxY;
+    T* maxZ;
+
+    /// Construct from the six component arrays.
+    IMATH_HOSTDEVICE constexpr Box3SoA (T* minX,
+                                        T* minY,
+                                        T* minZ,
+                                        T* maxX,
+                                        T* maxY,
+                                        T* maxZ) noexcept
+        : minX (minX), minY (minY), minZ (minZ), maxX (maxX), maxY (maxY), maxZ (maxZ)
+    {}
+
+    /// Convert, typically from `Box3SoA<T>` to `Box3SoA<const T>`.
+    template <class S>
+    IMATH_HOSTDEVICE constexpr Box3SoA (const Box3SoA<S>& b) noexcept
+        : minX (b.minX), minY (b.minY), minZ (b.minZ), maxX (b.maxX), maxY (b.maxY), maxZ (b.maxZ)
+    {}
+
+    /// Return the i-th box.
+    IMATH_HOSTDEVICE constexpr Box<Vec3<BaseType>> operator[] (size_t i) const noexcept
+    {
+        return Box<Vec3<BaseType>> (Vec3<BaseType> (minX[i], minY[i], minZ[i]),
+                                    Vec3<BaseType> (maxX[i], maxY[i], maxZ[i]));
+    }
+
+    /// Set the i-th box.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 void
+    set (size_t i, const Box<Vec3<BaseType>>& b) const noexcept
+    {
+        minX[i] = b.min.x;
+        minY[i] = b.min.y;
+        minZ[i] = b.min.z;
+        maxX[i] = b.max.x;
+        maxY[i] = b.max.y;
+        maxZ[i] = b.max.z;
+    }
+};
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHBOX_H
@@ -30,6 +30,22 @@
 //                           const Matrix44<T>&,
 //                           Box<V3ec3<S>>&)
 //
+//	void transform(const Box<Vec3<S>>* boxes,
+//		       const Matrix44<T>&,
+//		       Box<Vec3<S>>* result,
+//		       size_t n)
+//	void affineTransform(const Box<Vec3<S>>* boxes,
+//			     const Matrix44<T>&,
+//			     Box<Vec3<S>>* result,
+//			     size_t n)
+//	    (and overloads for Box3SoA)
+//
+//	Box<Vec3<T>> computeBounds(const Vec3<T>* points, size_t n)
+//	Box<Vec2<T>> computeBounds(const Vec2<T>* points, size_t n)
+//	Interval<T> computeBounds(const T* values, size_t n)
+//	Box<Vec3<T>> computeBounds(const T* xyz, size_t n, size_t stride)
+//	Box<Vec3<T>> computeBounds(const T* x, const T* y, const T* z, size_t n)
+//
 //	bool findEntryAndExitPoints(const Line<T> &line,
 //				    const Box< Vec3<T> > &box,
 //				    Vec3<T> &enterPoint,
@@ -44,10 +60,13 @@
 //---------------------------------------------------------------------------
 
 #include "ImathBox.h"
+#include "ImathInterval.h"
 #include "ImathLineAlgo.h"
 #include "ImathMatrix.h"
 #include "ImathNamespace.h"
 #include "ImathPlane.h"
+#include <algorithm>
+#include <cstddef>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -391,6 +410,392 @@ affineTransform (const Box<Vec3<S>>& box, const Matrix44<T>& m, Box<Vec3<S>>& re
     }
 }
 
+//
+// BoxBlock holds a block of 3D boxes in local arrays. The batched
+// transform functions below copy their inputs into blocks, transform
+// within the blocks, and copy the results out. The arithmetic loops
+// then access only local arrays, which the compiler knows do not
+// alias the caller's arrays, so they vectorize without run-time
+// overlap checks, and the result may be the input array. BoxBlock
+// is not part of the public interface.
+//
+
+template <class T> struct BoxBlock
+{
+    static constexpr size_t size = 64;
+
+    T minX[size];
+    T minY[size];
+    T minZ[size];
+    T maxX[size];
+    T maxY[size];
+    T maxZ[size];
+
+    // Copy n boxes, starting at index i, in or out
+
+    IMATH_HOSTDEVICE void load (const Box3SoA<const T>& b, size_t i, size_t n) noexcept
+    {
+        for (size_t j = 0; j < n; ++j)
+            minX[j] = b.minX[i + j];
+        for (size_t j = 0; j < n; ++j)
+            minY[j] = b.minY[i + j];
+        for (size_t j = 0; j < n; ++j)
+            minZ[j] = b.minZ[i + j];
+        for (size_t j = 0; j < n; ++j)
+            maxX[j] = b.maxX[i + j];
+        for (size_t j = 0; j < n; ++j)
+            maxY[j] = b.maxY[i + j];
+        for (size_t j = 0; j < n; ++j)
+            maxZ[j] = b.maxZ[i + j];
+    }
+
+    IMATH_HOSTDEVICE void load (const Box<Vec3<T>>* b, size_t i, size_t n) noexcept
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            minX[j] = b[i + j].min.x;
+            minY[j] = b[i + j].min.y;
+            minZ[j] = b[i + j].min.z;
+            maxX[j] = b[i + j].max.x;
+            maxY[j] = b[i + j].max.y;
+            maxZ[j] = b[i + j].max.z;
+        }
+    }
+
+    IMATH_HOSTDEVICE void store (const Box3SoA<T>& b, size_t i, size_t n) const noexcept
+    {
+        for (size_t j = 0; j < n; ++j)
+            b.minX[i + j] = minX[j];
+        for (size_t j = 0; j < n; ++j)
+            b.minY[i + j] = minY[j];
+        for (size_t j = 0; j < n; ++j)
+            b.minZ[i + j] = minZ[j];
+        for (size_t j = 0; j < n; ++j)
+            b.maxX[i + j] = maxX[j];
+        for (size_t j = 0; j < n; ++j)
+            b.maxY[i + j] = maxY[j];
+        for (size_t j = 0; j < n; ++j)
+            b.maxZ[i + j] = maxZ[j];
+    }
+
+    IMATH_HOSTDEVICE void store (Box<Vec3<T>>* b, size_t i, size_t n) const noexcept
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            b[i + j].min = Vec3<T> (minX[j], minY[j], minZ[j]);
+            b[i + j].max = Vec3<T> (maxX[j], maxY[j], maxZ[j]);
+        }
+    }
+
+    // Add the smaller and the larger of c * lo and c * hi to newLo
+    // and newHi, written as the min and max patterns the compiler
+    // recognizes
+
+    IMATH_HOSTDEVICE static void
+    extendByProducts (T c, T lo, T hi, T& newLo, T& newHi) noexcept
+    {
+        T a = c * lo;
+        T b = c * hi;
+
+        newLo += a < b ? a : b;
+        newHi += b < a ? a : b;
+    }
+
+    //
+    // Set the first n boxes to those of block b, transformed by a
+    // matrix whose rightmost column is (0 0 0 1), with the same
+    // arithmetic as affineTransform(box, m); the results are
+    // identical unless the boxes or the matrix contain NaNs. The
+    // first loop has no branches, for the compiler to vectorize it;
+    // the second copies empty and infinite boxes unchanged.
+    //
+
+    template <class S>
+    IMATH_HOSTDEVICE void
+    affineTransform (const BoxBlock& b, const Matrix44<S>& m, size_t n) noexcept
+    {
+        T c[4][3];
+
+        for (int k = 0; k < 4; ++k)
+            for (int i = 0; i < 3; ++i)
+                c[k][i] = (T) m[k][i];
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            T newLo[3] = { c[3][0], c[3][1], c[3][2] };
+            T newHi[3] = { c[3][0], c[3][1], c[3][2] };
+
+            for (int i = 0; i < 3; ++i)
+            {
+                extendByProducts (c[0][i], b.minX[j], b.maxX[j], newLo[i], newHi[i]);
+                extendByProducts (c[1][i], b.minY[j], b.maxY[j], newLo[i], newHi[i]);
+                extendByProducts (c[2][i], b.minZ[j], b.maxZ[j], newLo[i], newHi[i]);
+            }
+
+            minX[j] = newLo[0];
+            minY[j] = newLo[1];
+            minZ[j] = newLo[2];
+            maxX[j] = newHi[0];
+            maxY[j] = newHi[1];
+            maxZ[j] = newHi[2];
+        }
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            bool empty = b.maxX[j] < b.minX[j] || b.maxY[j] < b.minY[j] || b.maxZ[j] < b.minZ[j];
+
+            bool infinite = b.minX[j] == limits<T>::min() && b.minY[j] == limits<T>::min() &&
+                            b.minZ[j] == limits<T>::min() && b.maxX[j] == limits<T>::max() &&
+                            b.maxY[j] == limits<T>::max() && b.maxZ[j] == limits<T>::max();
+
+            if (empty || infinite)
+            {
+                minX[j] = b.minX[j];
+                minY[j] = b.minY[j];
+                minZ[j] = b.minZ[j];
+                maxX[j] = b.maxX[j];
+                maxY[j] = b.maxY[j];
+                maxZ[j] = b.maxZ[j];
+            }
+        }
+    }
+};
+
+//
+// Transform n boxes: result[i] = transform (boxes[i], m) for i in
+// [0, n), and likewise for affineTransform(). The result may be the
+// input array. transform() checks once whether m is affine, rather
+// than once per box; if it is, it uses affineTransform().
+//
+// The boxes may be arrays of Box or in structure-of-arrays layout;
+// for the latter, specify the box type, as in
+// transform<float> (boxes, m, result, n).
+//
+// Arrays of Box are copied through BoxBlock as well. The copies cost
+// less than they save: transforming the boxes in place in the array
+// does not vectorize, and is barely faster than one box at a time.
+// For arrays that fit in the cache, the blocked transform is about
+// twice as fast as one box at a time; for larger arrays, memory
+// bandwidth limits the gain, and structure-of-arrays input gains more.
+//
+
+template <class S, class T>
+void
+affineTransform (const Box3SoA<const S>& boxes,
+                 const Matrix44<T>& m,
+                 const Box3SoA<S>& result,
+                 size_t n) noexcept
+{
+    BoxBlock<S> b, r;
+
+    for (size_t i = 0; i < n; i += BoxBlock<S>::size)
+    {
+        size_t k = std::min (n - i, size_t (BoxBlock<S>::size));
+
+        b.load (boxes, i, k);
+        r.affineTransform (b, m, k);
+        r.store (result, i, k);
+    }
+}
+
+template <class S, class T>
+void
+affineTransform (const Box<Vec3<S>>* boxes,
+                 const Matrix44<T>& m,
+                 Box<Vec3<S>>* result,
+                 size_t n) noexcept
+{
+    BoxBlock<S> b, r;
+
+    for (size_t i = 0; i < n; i += BoxBlock<S>::size)
+    {
+        size_t k = std::min (n - i, size_t (BoxBlock<S>::size));
+
+        b.load (boxes, i, k);
+        r.affineTransform (b, m, k);
+        r.store (result, i, k);
+    }
+}
+
+template <class S, class T>
+void
+transform (const Box3SoA<const S>& boxes,
+           const Matrix44<T>& m,
+           const Box3SoA<S>& result,
+           size_t n) noexcept
+{
+    if (m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1)
+    {
+        affineTransform (boxes, m, result, n);
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        result.set (i, transform (boxes[i], m));
+}
+
+template <class S, class T>
+void
+transform (const Box<Vec3<S>>* boxes,
+           const Matrix44<T>& m,
+           Box<Vec3<S>>* result,
+           size_t n) noexcept
+{
+    if (m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1)
+    {
+        affineTransform (boxes, m, result, n);
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        result[i] = transform (boxes[i], m);
+}
+
+//
+// Compute the bounds of n points of D components each, stored
+// consecutively in p, into lo[D] and hi[D]. The values are split
+// among independent lanes, each lane holding one component, so that
+// the loop has no dependencies between iterations and no branches,
+// for the compiler to vectorize it; the lanes are combined at the
+// end. Like Box::extendBy(), the comparisons ignore NaNs. With no
+// points, or NaNs only, lo is the largest and hi the smallest value
+// of T, which is an empty box. boundsOfComponents() is not part of
+// the public interface.
+//
+
+template <class T, int D>
+IMATH_HOSTDEVICE void
+boundsOfComponents (const T* p, size_t n, T lo[D], T hi[D]) noexcept
+{
+    const size_t numLanes = 16 * D;
+
+    T laneLo[numLanes];
+    T laneHi[numLanes];
+
+    for (size_t j = 0; j < numLanes; ++j)
+    {
+        laneLo[j] = limits<T>::max();
+        laneHi[j] = limits<T>::min();
+    }
+
+    size_t numValues = n * D;
+    size_t i         = 0;
+
+    for (; i + numLanes <= numValues; i += numLanes)
+    {
+        for (size_t j = 0; j < numLanes; ++j)
+        {
+            T v       = p[i + j];
+            laneLo[j] = v < laneLo[j] ? v : laneLo[j];
+            laneHi[j] = laneHi[j] < v ? v : laneHi[j];
+        }
+    }
+
+    // The remaining values are whole points, so lane j still holds
+    // component j % D
+
+    for (size_t j = 0; i + j < numValues; ++j)
+    {
+        T v       = p[i + j];
+        laneLo[j] = v < laneLo[j] ? v : laneLo[j];
+        laneHi[j] = laneHi[j] < v ? v : laneHi[j];
+    }
+
+    for (int d = 0; d < D; ++d)
+    {
+        lo[d] = laneLo[d];
+        hi[d] = laneHi[d];
+
+        for (size_t j = d + D; j < numLanes; j += D)
+        {
+            lo[d] = laneLo[j] < lo[d] ? laneLo[j] : lo[d];
+            hi[d] = hi[d] < laneHi[j] ? laneHi[j] : hi[d];
+        }
+    }
+}
+
+//
+// Compute the bounding box of n points: the same box as extending an
+// empty box by each point in turn, but about 1.5 times as fast for
+// large arrays. The result is an empty box if n is 0 or all values
+// are NaN; like Box::extendBy(), the functions ignore NaNs. Because
+// the points are visited in a different order, a bound of zero may
+// have the sign of a different zero among the points.
+//
+// The points may be arrays of Vec3, Vec2, or scalars for an
+// Interval; interleaved with other data, every stride-th element of
+// an array of T, starting with the x, y, z components of the first
+// point; or in structure-of-arrays layout, with the coordinates in
+// separate arrays.
+//
+// The functions run in the calling thread; Imath has no threading
+// dependency. To compute the bounds of an array in parallel, compute
+// the bounds of separate chunks of the array in the caller's
+// threads, and combine them with Box::extendBy (const Box&).
+//
+
+template <class T>
+Box<Vec3<T>>
+computeBounds (const Vec3<T>* points, size_t n) noexcept
+{
+    T lo[3], hi[3];
+    boundsOfComponents<T, 3> (reinterpret_cast<const T*> (points), n, lo, hi);
+    return Box<Vec3<T>> (Vec3<T> (lo[0], lo[1], lo[2]), Vec3<T> (hi[0], hi[1], hi[2]));
+}
+
+template <class T>
+Box<Vec2<T>>
+computeBounds (const Vec2<T>* points, size_t n) noexcept
+{
+    T lo[2], hi[2];
+    boundsOfComponents<T, 2> (reinterpret_cast<const T*> (points), n, lo, hi);
+    return Box<Vec2<T>> (Vec2<T> (lo[0], lo[1]), Vec2<T> (hi[0], hi[1]));
+}
+
+template <class T>
+Interval<T>
+computeBounds (const T* values, size_t n) noexcept
+{
+    T lo, hi;
+    boundsOfComponents<T, 1> (values, n, &lo, &hi);
+    return Interval<T> (lo, hi);
+}
+
+template <class T>
+Box<Vec3<T>>
+computeBounds (const T* xyz, size_t n, size_t stride) noexcept
+{
+    if (stride == 3)
+        return computeBounds (reinterpret_cast<const Vec3<T>*> (xyz), n);
+
+    Vec3<T> lo (limits<T>::max());
+    Vec3<T> hi (limits<T>::min());
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T* p = xyz + i * stride;
+
+        for (int d = 0; d < 3; ++d)
+        {
+            lo[d] = p[d] < lo[d] ? p[d] : lo[d];
+            hi[d] = hi[d] < p[d] ? p[d] : hi[d];
+        }
+    }
+
+    return Box<Vec3<T>> (lo, hi);
+}
+
+template <class T>
+Box<Vec3<T>>
+computeBounds (const T* x, const T* y, const T* z, size_t n) noexcept
+{
+    Interval<T> bx = computeBounds (x, n);
+    Interval<T> by = computeBounds (y, n);
+    Interval<T> bz = computeBounds (z, n);
+
+    return Box<Vec3<T>> (Vec3<T> (bx.min, by.min, bz.min), Vec3<T> (bx.max, by.max, bz.max));
+}
+
 template <class T>
 IMATH_HOSTDEVICE IMATH_CONSTEXPR14 bool
 findEntryAndExitPoints (const Line3<T>& r, const Box<Vec3<T>>& b, Vec3<T>& entry, Vec3<T>& exit) noexcept
@@ -10,9 +10,423 @@
 //----------------------------------------------------------------------------
 
 #include "ImathColorAlgo.h"
+#include "ImathSrgb.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 
 IMATH_INTERNAL_NAMESPACE_SOURCE_ENTER
 
+namespace
+{
+
+//
+// The array conversions work on blocks of pixels, copied to separate
+// arrays of float components and converted in place, so that the
+// loops of rgb2hsvBlock() and hsv2rgbBlock() vectorize regardless of
+// the layout and type of the pixels, and so that the input and output
+// may be the same array.
+//
+// The loops have no branches: all arithmetic is done unconditionally,
+// and only its operands and results are selected with conditional
+// expressions, which the compiler turns into blends. Divisions whose
+// results the double-precision code would not use divide by infinity
+// instead, yielding 0, so that their results need no selection.
+//
+
+const size_t blockSize = 256;
+
+void
+rgb2hsvBlock (float* c0, float* c1, float* c2, size_t n)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        float x = c0[i];
+        float y = c1[i];
+        float z = c2[i];
+
+        float max   = (x > y) ? ((x > z) ? x : z) : ((y > z) ? y : z);
+        float min   = (x < y) ? ((x < z) ? x : z) : ((y < z) ? y : z);
+        float range = max - min;
+        float sat   = range / ((max != 0) ? max : inf);
+
+        // h = offset + (minuend - subtrahend) / range
+
+        float offset     = (x == max) ? 0.0f : ((y == max) ? 2.0f : 4.0f);
+        float minuend    = (x == max) ? y : ((y == max) ? z : x);
+        float subtrahend = (x == max) ? z : ((y == max) ? x : y);
+        float numerator  = offset * range + (minuend - subtrahend);
+        float hue        = numerator / ((sat != 0) ? range : inf) / 6;
+
+        c0[i] = hue + ((hue < 0) ? 1.0f : 0.0f);
+        c1[i] = sat;
+        c2[i] = max;
+    }
+}
+
+//
+// x clamped to [0,1], with arithmetic instead of comparisons.
+//
+
+inline float
+clamp01 (float x)
+{
+    return (std::fabs (x) - std::fabs (x - 1) + 1) * 0.5f;
+}
+
+//
+// With h the hue scaled to [0,6], a channel of the color is
+// val * (1 - sat * w), where the weight w of the red channel is
+// clamp01 (2 - |h - 3|), of green clamp01 (|h - 2| - 1) and of blue
+// clamp01 (|h - 4| - 1). For each sector of the hue, these are the
+// values of hsv2rgb_d(): val, p, q or t.
+//
+
+void
+hsv2rgbBlock (float* c0, float* c1, float* c2, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        float hue = c0[i] * 6;
+        float sat = c1[i];
+        float val = c2[i];
+
+        //
+        // Hues outside [0,1] are black, as in hsv2rgb_d(). A hue of 1,
+        // the only one that scales to 6, has the same weights as 0.
+        //
+
+        val = (std::fabs (hue - 3) <= 3) ? val : 0.0f;
+
+        c0[i] = val * (1 - sat * clamp01 (2 - std::fabs (hue - 3)));
+        c1[i] = val * (1 - sat * clamp01 (std::fabs (hue - 2) - 1));
+        c2[i] = val * (1 - sat * clamp01 (std::fabs (hue - 4) - 1));
+    }
+}
+
+//
+// Convert n <= blockSize pixels of type Color3<T> or Color4<T> with
+// the function convert, through arrays of float; alpha is copied.
+//
+
+template <class T>
+inline void
+setAlpha (const Color3<T>&, Color3<T>&) noexcept
+{}
+
+template <class T>
+inline void
+setAlpha (const Color4<T>& in, Color4<T>& out) noexcept
+{
+    out.a = in.a;
+}
+
+template <class C, class F>
+void
+convertBlock (const C* in, C* out, size_t n, F convert) noexcept
+{
+    typedef typename C::BaseType T;
+
+    float x[blockSize], y[blockSize], z[blockSize];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = float (in[i][0]);
+        y[i] = float (in[i][1]);
+        z[i] = float (in[i][2]);
+    }
+
+    convert (x, y, z, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        setAlpha (in[i], out[i]);
+        out[i][0] = T (x[i]);
+        out[i][1] = T (y[i]);
+        out[i][2] = T (z[i]);
+    }
+}
+
+template <class C, class F>
+void
+convertArray (const C* in, C* out, size_t n, F convert) noexcept
+{
+    for (size_t i = 0; i < n; i += blockSize)
+        convertBlock (in + i, out + i, std::min (n - i, blockSize), convert);
+}
+
+//
+// Tables for converting between 8-bit sRGB and linear float values,
+// with the transfer function of ImathSrgb.h. A linear value x
+// encodes to the byte k for which threshold[k] <= x < threshold[k+1];
+// the thresholds are the smallest floats whose encoding, scaled to
+// [0,255], reaches k when truncating, or k - 1/2 when rounding. Since
+// consecutive thresholds are more than 1/srgbBins apart, the byte for
+// the start of x's bin is k or k - 1, and one comparison decides
+// between them.
+//
+
+const int srgbBins = 4096;
+
+struct SrgbTables
+{
+    SrgbTables();
+
+    float decode[256];
+    float threshold[2][257];    // [PackedColorRounding][k]
+    uint8_t bin[2][srgbBins + 1];
+};
+
+SrgbTables::SrgbTables()
+{
+    const float inf = std::numeric_limits<float>::infinity();
+
+    for (int k = 0; k < 256; ++k)
+        decode[k] = float (srgbDecode<double> (k / 255.0));
+
+    for (int r = 0; r < 2; ++r)
+    {
+        float* t = threshold[r];
+
+        t[0]   = -inf;
+        t[256] = inf;
+
+        for (int k = 1; k < 256; ++k)
+        {
+            double target = (r == PACKED_COLOR_ROUND) ? k - 0.5 : k;
+
+            t[k] = float (srgbDecode<double> (target / 255));
+
+            while (srgbEncode<double> (t[k]) * 255 < target)
+                t[k] = std::nextafter (t[k], inf);
+
+            while (srgbEncode<double> (std::nextafter (t[k], -inf)) * 255 >= target)
+                t[k] = std::nextafter (t[k], -inf);
+
+            // srgbEncode (1.0) rounds to just below 1, which would put
+            // the truncating threshold of 255 above 1, out of reach of
+            // the clamped values; 1 must encode to 255
+
+            t[k] = std::min (t[k], 1.0f);
+        }
+
+        for (int b = 0, k = 0; b <= srgbBins; ++b)
+        {
+            while (t[k + 1] <= float (b) / srgbBins)
+                ++k;
+
+            bin[r][b] = uint8_t (k);
+        }
+    }
+}
+
+const SrgbTables&
+srgbTables()
+{
+    static const SrgbTables tables;
+    return tables;
+}
+
+inline PackedColor
+srgbByte (float x, const float* threshold, const uint8_t* bin) noexcept
+{
+    x = (x >= 0) ? ((x <= 1) ? x : 1.0f) : 0.0f;
+
+    PackedColor k = bin[int (x * srgbBins)];
+    return k + (x >= threshold[k + 1]);
+}
+
+//
+// A linear value, scaled and biased, clamped to [0,255] and truncated.
+// NaNs fail the first comparison and become 0. Clamping to 0 first
+// makes that a choice between v and zero, which vectorizes to a mask
+// rather than a blend.
+//
+
+inline PackedColor
+linearByte (float x, float scale, float bias) noexcept
+{
+    float v = x * scale + bias;
+    v       = (v > 0) ? v : 0.0f;
+    v       = (v < 255) ? v : 255.0f;
+    return PackedColor (int (v));
+}
+
+//
+// The factor from color components to bytes: the components of float
+// and half colors range from 0 to 1, and those of unsigned char
+// colors from 0 to 255.
+//
+
+template <class T>
+constexpr float
+byteScale() noexcept
+{
+    return std::is_integral<T>::value ? 1.0f : 255.0f;
+}
+
+template <class T>
+inline float
+alpha (const Color3<T>&) noexcept
+{
+    return byteScale<T>() == 1 ? 255.0f : 1.0f;
+}
+
+template <class T>
+inline float
+alpha (const Color4<T>& c) noexcept
+{
+    return float (c.a);
+}
+
+template <class T>
+inline void
+storeAlpha (Color3<T>&, float) noexcept
+{}
+
+template <class T>
+inline void
+storeAlpha (Color4<T>& c, float a) noexcept
+{
+    c.a = T (a);
+}
+
+template <class C>
+void
+packBlock (const C* in,
+           PackedColor* packed,
+           size_t n,
+           PackedColorRounding rounding,
+           PackedColorEncoding encoding) noexcept
+{
+    typedef typename C::BaseType T;
+
+    const float scale = byteScale<T>();
+    const float bias  = (rounding == PACKED_COLOR_ROUND && byteScale<T>() != 1) ? 0.5f : 0.0f;
+
+    if (encoding == PACKED_COLOR_SRGB)
+    {
+        const SrgbTables& tables = srgbTables();
+        const float* threshold   = tables.threshold[rounding];
+        const uint8_t* bin       = tables.bin[rounding];
+        const float normalize    = byteScale<T>() / 255;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            packed[i] = srgbByte (float (in[i][0]) * normalize, threshold, bin) |
+                        (srgbByte (float (in[i][1]) * normalize, threshold, bin) << 8) |
+                        (srgbByte (float (in[i][2]) * normalize, threshold, bin) << 16) |
+                        (linearByte (alpha (in[i]), scale, bias) << 24);
+        }
+    }
+    else
+    {
+        //
+        // The components of the pixels are contiguous, and are
+        // converted in one loop over all of them, which vectorizes
+        // without shuffles; the bytes are then combined. The alpha of
+        // Color3 is the same for all pixels.
+        //
+
+        const size_t dim = C::dimensions();
+        const T* c       = &in[0][0];
+
+        PackedColor b[4 * blockSize];
+
+        for (size_t j = 0; j < n * dim; ++j)
+            b[j] = linearByte (float (c[j]), scale, bias);
+
+        if (dim == 4)
+        {
+            for (size_t i = 0; i < n; ++i)
+                packed[i] = b[4 * i] | (b[4 * i + 1] << 8) | (b[4 * i + 2] << 16) |
+                            (b[4 * i + 3] << 24);
+        }
+        else
+        {
+            const PackedColor a = linearByte (alpha (in[0]), scale, bias) << 24;
+
+            for (size_t i = 0; i < n; ++i)
+                packed[i] = b[3 * i] | (b[3 * i + 1] << 8) | (b[3 * i + 2] << 16) | a;
+        }
+    }
+}
+
+template <class C>
+void
+unpackBlock (const PackedColor* packed, C* out, size_t n, PackedColorEncoding encoding) noexcept
+{
+    typedef typename C::BaseType T;
+
+    //
+    // Values in [0,1] are stored as is in float and half colors, and
+    // rounded to bytes in unsigned char colors.
+    //
+
+    const float scale = 255 / byteScale<T>();
+    const float bias  = (byteScale<T>() == 1) ? 0.5f : 0.0f;
+
+    float x[blockSize], y[blockSize], z[blockSize], a[blockSize];
+
+    if (encoding == PACKED_COLOR_SRGB)
+    {
+        const float* decode = srgbTables().decode;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i] = decode[packed[i] & 0xFF];
+            y[i] = decode[(packed[i] >> 8) & 0xFF];
+            z[i] = decode[(packed[i] >> 16) & 0xFF];
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i] = float (packed[i] & 0xFF) * (1.0f / 255);
+            y[i] = float ((packed[i] >> 8) & 0xFF) * (1.0f / 255);
+            z[i] = float ((packed[i] >> 16) & 0xFF) * (1.0f / 255);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        a[i] = float (packed[i] >> 24) * (1.0f / 255);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i][0] = T (x[i] * scale + bias);
+        out[i][1] = T (y[i] * scale + bias);
+        out[i][2] = T (z[i] * scale + bias);
+        storeAlpha (out[i], a[i] * scale + bias);
+    }
+}
+
+template <class C>
+void
+packArray (const C* in,
+           PackedColor* packed,
+           size_t n,
+           PackedColorRounding rounding,
+           PackedColorEncoding encoding) noexcept
+{
+    for (size_t i = 0; i < n; i += blockSize)
+        packBlock (in + i, packed + i, std::min (n - i, blockSize), rounding, encoding);
+}
+
+template <class C>
+void
+unpackArray (const PackedColor* packed, C* out, size_t n, PackedColorEncoding encoding) noexcept
+{
+    for (size_t i = 0; i < n; i += blockSize)
+        unpackBlock (packed + i, out + i, std::min (n - i, blockSize), encoding);
+}
+
+} // namespace
+
 Vec3<double>
 hsv2rgb_d (const Vec3<double>& hsv) noexcept
 {
@@ -199,4 +613,119 @@ rgb2hsv_d (const Color4<double>& c) noexcept
     return Color4<double> (hue, sat, val, c.a);
 }
 
+void
+rgb2hsv (const Color3<float>* rgb, Color3<float>* hsv, size_t n) noexcept
+{
+    convertArray (rgb, hsv, n, rgb2hsvBlock);
+}
+
+void
+rgb2hsv (const Color4<float>* rgb, Color4<float>* hsv, size_t n) noexcept
+{
+    convertArray (rgb, hsv, n, rgb2hsvBlock);
+}
+
+void
+rgb2hsv (const Color3<half>* rgb, Color3<half>* hsv, size_t n) noexcept
+{
+    convertArray (rgb, hsv, n, rgb2hsvBlock);
+}
+
+void
+rgb2hsv (const Color4<half>* rgb, Color4<half>* hsv, size_t n) noexcept
+{
+    convertArray (rgb, hsv, n, rgb2hsvBlock);
+}
+
+void
+hsv2rgb (const Color3<float>* hsv, Color3<float>* rgb, size_t n) noexcept
+{
+    convertArray (hsv, rgb, n, hsv2rgbBlock);
+}
+
+void
+hsv2rgb (const Color4<float>* hsv, Color4<float>* rgb, size_t n) noexcept
+{
+    convertArray (hsv, rgb, n, hsv2rgbBlock);
+}
+
+void
+hsv2rgb (const Color3<half>* hsv, Color3<half>* rgb, size_t n) noexcept
+{
+    convertArray (hsv, rgb, n, hsv2rgbBlock);
+}
+
+void
+hsv2rgb (const Color4<half>* hsv, Color4<half>* rgb, size_t n) noexcept
+{
+    convertArray (hsv, rgb, n, hsv2rgbBlock);
+}
+
+void
+rgb2packed (const Color3<float>* c,
+            PackedColor* packed,
+            size_t n,
+            PackedColorRounding rounding,
+            PackedColorEncoding encoding) noexcept
+{
+    packArray (c, packed, n, rounding, encoding);
+}
+
+void
+rgb2packed (const Color4<float>* c,
+            PackedColor* packed,
+            size_t n,
+            PackedColorRounding rounding,
+            PackedColorEncoding encoding) noexcept
+{
+    packArray (c, packed, n, rounding, encoding);
+}
+
+void
+rgb2packed (const Color4<half>* c,
+            PackedColor* packed,
+            size_t n,
+            PackedColorRounding rounding,
+            PackedColorEncoding encoding) noexcept
+{
+    packArray (c, packed, n, rounding, encoding);
+}
+
+void
+rgb2packed (const Color4<unsigned char>* c,
+            PackedColor* packed,
+            size_t n,
+            PackedColorRounding rounding,
+            PackedColorEncoding encoding) noexcept
+{
+    packArray (c, packed, n, rounding, encoding);
+}
+
+void
+packed2rgb (const PackedColor* packed, Color3<float>* c, size_t n, PackedColorEncoding encoding) noexcept
+{
+    unpackArray (packed, c, n, encoding);
+}
+
+void
+packed2rgb (const PackedColor* packed, Color4<float>* c, size_t n, PackedColorEncoding encoding) noexcept
+{
+    unpackArray (packed, c, n, encoding);
+}
+
+void
+packed2rgb (const PackedColor* packed, Color4<half>* c, size_t n, PackedColorEncoding encoding) noexcept
+{
+    unpackArray (packed, c, n, encoding);
+}
+
+void
+packed2rgb (const PackedColor* packed,
+            Color4<unsigned char>* c,
+            size_t n,
+            PackedColorEncoding encoding) noexcept
+{
+    unpackArray (packed, c, n, encoding);
+}
+
 IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -11,6 +11,7 @@
 #include "ImathLimits.h"
 #include "ImathMath.h"
 #include "ImathNamespace.h"
+#include <cstddef>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -27,6 +28,93 @@ IMATH_EXPORT Vec3<double> rgb2hsv_d (const Vec3<double>& rgb) noexcept;
 
 IMATH_EXPORT Color4<double> rgb2hsv_d (const Color4<double>& rgb) noexcept;
 
+//
+//	Conversion of arrays of n colors between RGB and HSV, for
+//	processing whole images. The conversions compute in float, in
+//	loops without branches that the compiler vectorizes. For float
+//	colors, hue and saturation agree with rgb2hsv_d() and hsv2rgb_d()
+//	to within 1e-6, and the other components to within 1e-6 times
+//	the largest component; half colors are additionally rounded to
+//	half. Alpha is copied, and the input and output arrays may be the
+//	same. Callers that convert large images may divide them into
+//	scanlines and convert those in parallel.
+//
+
+IMATH_EXPORT void rgb2hsv (const Color3<float>* rgb, Color3<float>* hsv, size_t n) noexcept;
+IMATH_EXPORT void rgb2hsv (const Color4<float>* rgb, Color4<float>* hsv, size_t n) noexcept;
+IMATH_EXPORT void rgb2hsv (const Color3<half>* rgb, Color3<half>* hsv, size_t n) noexcept;
+IMATH_EXPORT void rgb2hsv (const Color4<half>* rgb, Color4<half>* hsv, size_t n) noexcept;
+
+IMATH_EXPORT void hsv2rgb (const Color3<float>* hsv, Color3<float>* rgb, size_t n) noexcept;
+IMATH_EXPORT void hsv2rgb (const Color4<float>* hsv, Color4<float>* rgb, size_t n) noexcept;
+IMATH_EXPORT void hsv2rgb (const Color3<half>* hsv, Color3<half>* rgb, size_t n) noexcept;
+IMATH_EXPORT void hsv2rgb (const Color4<half>* hsv, Color4<half>* rgb, size_t n) noexcept;
+
+//
+//	Conversion of arrays of n colors to and from PackedColor, for
+//	uploading whole framebuffers. Unlike the single-color
+//	rgb2packed(), components outside [0,1] are clamped, NaNs become
+//	0, and the rounding may be to the nearest 8-bit value; with
+//	PACKED_COLOR_TRUNCATE, the results for components in [0,1] are
+//	those of rgb2packed(). With PACKED_COLOR_SRGB, the red, green and
+//	blue components are encoded with the sRGB transfer function when
+//	packing, and decoded when unpacking; alpha is always linear.
+//	Colors without alpha pack with an alpha of 0xFF, as in
+//	rgb2packed(). The components of Color4<unsigned char> range from
+//	0 to 255, as the bytes of PackedColor, and are copied unless they
+//	are sRGB-encoded or decoded.
+//
+
+enum PackedColorRounding
+{
+    PACKED_COLOR_TRUNCATE,
+    PACKED_COLOR_ROUND
+};
+
+enum PackedColorEncoding
+{
+    PACKED_COLOR_LINEAR,
+    PACKED_COLOR_SRGB
+};
+
+IMATH_EXPORT void rgb2packed (const Color3<float>* c,
+                              PackedColor* packed,
+                              size_t n,
+                              PackedColorRounding rounding = PACKED_COLOR_ROUND,
+                              PackedColorEncoding encoding = PACKED_COLOR_LINEAR) noexcept;
+IMATH_EXPORT void rgb2packed (const Color4<float>* c,
+                              PackedColor* packed,
+                              size_t n,
+                              PackedColorRounding rounding = PACKED_COLOR_ROUND,
+                              PackedColorEncoding encoding = PACKED_COLOR_LINEAR) noexcept;
+IMATH_EXPORT void rgb2packed (const Color4<half>* c,
+                              PackedColor* packed,
+                              size_t n,
+                              PackedColorRounding rounding = PACKED_COLOR_ROUND,
+                              PackedColorEncoding encoding = PACKED_COLOR_LINEAR) noexcept;
+IMATH_EXPORT void rgb2packed (const Color4<unsigned char>* c,
+                              PackedColor* packed,
+                              size_t n,
+                              PackedColorRounding rounding = PACKED_COLOR_ROUND,
+                              PackedColorEncoding encoding = PACKED_COLOR_LINEAR) noexcept;
+
+IMATH_EXPORT void packed2rgb (const PackedColor* packed,
+                              Color3<float>* c,
+                              size_t n,
+                              PackedColorEncoding encoding = PACKED_COLOR_LINEAR) noexcept;
+IMATH_EXPORT void packed2rgb (const PackedColor* packed,
+                              Color4<float>* c,
+                              size_t n,
+                              PackedColorEncoding encoding = PACKED_COLOR_LINEAR) noexcept;
+IMATH_EXPORT void packed2rgb (const PackedColor* packed,
+                              Color4<half>* c,
+                              size_t n,
+                              PackedColorEncoding encoding = PACKED_COLOR_LINEAR) noexcept;
+IMATH_EXPORT void packed2rgb (const PackedColor* packed,
+                              Color4<unsigned char>* c,
+                              size_t n,
+                              PackedColorEncoding encoding = PACKED_COLOR_LINEAR) noexcept;
+
 //
 //	Color conversion functions and general color algorithms
 //
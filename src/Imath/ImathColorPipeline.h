@@ -0,0 +1,374 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHCOLORPIPELINE_H
+#define INCLUDED_IMATHCOLORPIPELINE_H
+
+//-------------------------------------------------------------------------
+//
+//  A sequence of color matrices and transfer curves, applied to whole
+//  arrays of colors in one pass.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathColor.h"
+#include "ImathMatrix.h"
+#include "ImathNamespace.h"
+#include "ImathSrgb.h"
+#include "half.h"
+#include "halfFunction.h"
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/////////////////////////////////////////////////////////////////
+// ColorPipeline
+//
+//	template class ColorPipeline<T>
+//
+// A color transform built from a sequence of stages: 3x3 matrices,
+// such as conversions between RGB primaries, and transfer curves
+// applied to each of the red, green and blue components, such as the
+// sRGB encoding. For instance, converting linear ACEScg to sRGB is
+//
+//	ColorPipelinef acescgToSrgb;
+//	acescgToSrgb.appendMatrix (ap1ToRec709);
+//	acescgToSrgb.appendCurve (ColorPipelinef::CURVE_SRGB_ENCODE);
+//
+// Colors are row vectors, multiplied by the matrices on the right, as
+// with Vec3 * Matrix33, so that a matrix m maps c to c * m. Adjacent
+// matrices are multiplied together when they are appended, so that
+// each pixel costs at most one matrix per curve, plus one.
+//
+// The curves are
+//
+//	CURVE_SRGB_ENCODE	linear to sRGB-encoded values
+//	CURVE_SRGB_DECODE	sRGB-encoded values to linear
+//	appendPower (e)		x to x^e
+//
+// extended to negative values by symmetry, f(-x) = -f(x), and
+// lookup tables, halfFunction objects evaluated for the components
+// rounded to half. The lookup tables are much faster than std::pow(),
+// at the cost of the rounding.
+//
+// apply() converts arrays of Color3 or Color4 of float, double or
+// half, computing in T, a block of pixels at a time, with the block
+// in structure-of-arrays layout so that the compiler vectorizes the
+// matrices. Alpha is copied, and the input and output arrays may be
+// the same. A ColorPipeline does not change while it is applied, so
+// that threads may convert parts of an image with the same one.
+//
+
+template <class T> class ColorPipeline
+{
+  public:
+    enum Curve
+    {
+        CURVE_SRGB_ENCODE,
+        CURVE_SRGB_DECODE
+    };
+
+    // The identity transform, without stages.
+    ColorPipeline() {}
+
+    ////////////////////////////////////////////////////////////////////
+    // appendMatrix()
+    // Append a matrix, multiplying it with the last stage if that is a
+    // matrix.
+    ColorPipeline& appendMatrix (const Matrix33<T>& m);
+
+    ////////////////////////////////////////////////////////////////////
+    // appendCurve()
+    // Append an sRGB transfer curve.
+    ColorPipeline& appendCurve (Curve curve);
+
+    ////////////////////////////////////////////////////////////////////
+    // appendCurve()
+    // Append a lookup table; the halfFunction is copied.
+    template <class U> ColorPipeline& appendCurve (const halfFunction<U>& f);
+
+    ////////////////////////////////////////////////////////////////////
+    // appendPower()
+    // Append the curve x^exponent.
+    ColorPipeline& appendPower (T exponent);
+
+    ////////////////////////////////////////////////////////////////////
+    // append()
+    // Append the stages of another pipeline.
+    ColorPipeline& append (const ColorPipeline& pipeline);
+
+    // The number of stages, after adjacent matrices are multiplied.
+    size_t numStages() const noexcept { return _stages.size(); }
+
+    ////////////////////////////////////////////////////////////////////
+    // apply()
+    // Transform a single color.
+    template <class S> Color3<S> apply (const Color3<S>& c) const noexcept;
+    template <class S> Color4<S> apply (const Color4<S>& c) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // apply()
+    // Transform the n colors in[i] into out[i].
+    template <class S> void apply (const Color3<S>* in, Color3<S>* out, size_t n) const noexcept;
+    template <class S> void apply (const Color4<S>* in, Color4<S>* out, size_t n) const noexcept;
+
+  private:
+    enum StageType
+    {
+        STAGE_MATRIX,
+        STAGE_SRGB_ENCODE,
+        STAGE_SRGB_DECODE,
+        STAGE_POWER,
+        STAGE_LUT
+    };
+
+    struct Stage
+    {
+        StageType type = STAGE_MATRIX;
+        Matrix33<T> matrix;
+        T exponent = T (1);
+        std::shared_ptr<const std::vector<T>> lut; // indexed by half::bits()
+    };
+
+    static const size_t blockSize = 256;
+
+    template <class C> void applyBlocks (const C* in, C* out, size_t n) const noexcept;
+    void applyStages (T* r, T* g, T* b, size_t n) const noexcept;
+
+    template <class S> static void copyAlpha (const Color3<S>&, Color3<S>&) noexcept {}
+    template <class S> static void copyAlpha (const Color4<S>& in, Color4<S>& out) noexcept
+    {
+        out.a = in.a;
+    }
+
+    static void applyMatrix (const Matrix33<T>& m, T* r, T* g, T* b, size_t n) noexcept;
+
+    std::vector<Stage> _stages;
+};
+
+template <class T>
+ColorPipeline<T>&
+ColorPipeline<T>::appendMatrix (const Matrix33<T>& m)
+{
+    if (!_stages.empty() && _stages.back().type == STAGE_MATRIX)
+    {
+        _stages.back().matrix *= m;
+    }
+    else
+    {
+        Stage stage;
+        stage.type   = STAGE_MATRIX;
+        stage.matrix = m;
+        _stages.push_back (stage);
+    }
+
+    return *this;
+}
+
+template <class T>
+ColorPipeline<T>&
+ColorPipeline<T>::appendCurve (Curve curve)
+{
+    Stage stage;
+    stage.type = curve == CURVE_SRGB_ENCODE ? STAGE_SRGB_ENCODE : STAGE_SRGB_DECODE;
+    _stages.push_back (stage);
+    return *this;
+}
+
+template <class T>
+template <class U>
+ColorPipeline<T>&
+ColorPipeline<T>::appendCurve (const halfFunction<U>& f)
+{
+    std::shared_ptr<std::vector<T>> lut (new std::vector<T> (1 << 16));
+
+    for (int i = 0; i < (1 << 16); ++i)
+    {
+        half x;
+        x.setBits (i);
+        (*lut)[i] = T (f (x));
+    }
+
+    Stage stage;
+    stage.type = STAGE_LUT;
+    stage.lut  = lut;
+    _stages.push_back (stage);
+    return *this;
+}
+
+template <class T>
+ColorPipeline<T>&
+ColorPipeline<T>::appendPower (T exponent)
+{
+    Stage stage;
+    stage.type     = STAGE_POWER;
+    stage.exponent = exponent;
+    _stages.push_back (stage);
+    return *this;
+}
+
+template <class T>
+ColorPipeline<T>&
+ColorPipeline<T>::append (const ColorPipeline& pipeline)
+{
+    // Copy the stages first, in case the pipeline is *this
+
+    std::vector<Stage> stages = pipeline._stages;
+
+    for (const Stage& stage : stages)
+    {
+        if (stage.type == STAGE_MATRIX)
+            appendMatrix (stage.matrix);
+        else
+            _stages.push_back (stage);
+    }
+
+    return *this;
+}
+
+template <class T>
+template <class S>
+Color3<S>
+ColorPipeline<T>::apply (const Color3<S>& c) const noexcept
+{
+    Color3<S> result;
+    applyBlocks (&c, &result, 1);
+    return result;
+}
+
+template <class T>
+template <class S>
+Color4<S>
+ColorPipeline<T>::apply (const Color4<S>& c) const noexcept
+{
+    Color4<S> result;
+    apply (&c, &result, 1);
+    return result;
+}
+
+template <class T>
+template <class S>
+void
+ColorPipeline<T>::apply (const Color3<S>* in, Color3<S>* out, size_t n) const noexcept
+{
+    applyBlocks (in, out, n);
+}
+
+template <class T>
+template <class S>
+void
+ColorPipeline<T>::apply (const Color4<S>* in, Color4<S>* out, size_t n) const noexcept
+{
+    applyBlocks (in, out, n);
+}
+
+//
+// The components of a block of colors are copied into three arrays,
+// transformed by each stage in turn, and copied back, so that each
+// color is read and written once however many stages there are.
+//
+
+template <class T>
+template <class C>
+void
+ColorPipeline<T>::applyBlocks (const C* in, C* out, size_t n) const noexcept
+{
+    typedef typename C::BaseType S;
+
+    T r[blockSize], g[blockSize], b[blockSize];
+
+    for (size_t start = 0; start < n; start += blockSize)
+    {
+        size_t m = n - start < blockSize ? n - start : blockSize;
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            r[i] = T (in[start + i][0]);
+            g[i] = T (in[start + i][1]);
+            b[i] = T (in[start + i][2]);
+        }
+
+        applyStages (r, g, b, m);
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            out[start + i][0] = S (r[i]);
+            out[start + i][1] = S (g[i]);
+            out[start + i][2] = S (b[i]);
+            copyAlpha (in[start + i], out[start + i]);
+        }
+    }
+}
+
+template <class T>
+void
+ColorPipeline<T>::applyStages (T* r, T* g, T* b, size_t n) const noexcept
+{
+    T* components[] = {r, g, b};
+
+    for (const Stage& stage : _stages)
+    {
+        if (stage.type == STAGE_MATRIX)
+        {
+            applyMatrix (stage.matrix, r, g, b, n);
+            continue;
+        }
+
+        for (T* c : components)
+        {
+            if (stage.type == STAGE_SRGB_ENCODE)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    c[i] = srgbEncode (c[i]);
+            }
+            else if (stage.type == STAGE_SRGB_DECODE)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    c[i] = srgbDecode (c[i]);
+            }
+            else if (stage.type == STAGE_POWER)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    c[i] = std::copysign (std::pow (std::abs (c[i]), stage.exponent), c[i]);
+            }
+            else
+            {
+                const T* lut = stage.lut->data();
+
+                for (size_t i = 0; i < n; ++i)
+                    c[i] = lut[half (float (c[i])).bits()];
+            }
+        }
+    }
+}
+
+template <class T>
+void
+ColorPipeline<T>::applyMatrix (const Matrix33<T>& m, T* r, T* g, T* b, size_t n) noexcept
+{
+    const T m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+    const T m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+    const T m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T x  = r[i];
+        T y  = g[i];
+        T z  = b[i];
+        r[i] = x * m00 + y * m10 + z * m20;
+        g[i] = x * m01 + y * m11 + z * m21;
+        b[i] = x * m02 + y * m12 + z * m22;
+    }
+}
+
+typedef ColorPipeline<float> ColorPipelinef;
+typedef ColorPipeline<double> ColorPipelined;
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHCOLORPIPELINE_H
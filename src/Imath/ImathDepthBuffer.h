@@ -0,0 +1,240 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHDEPTHBUFFER_H
+#define INCLUDED_IMATHDEPTHBUFFER_H
+
+//-------------------------------------------------------------------------
+//
+//  Conversion of whole depth buffers between Z-buffer values and
+//  camera-space depth.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathFrustum.h"
+#include "ImathNamespace.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/////////////////////////////////////////////////////////////////
+// DepthLinearizer
+//
+//	template class DepthLinearizer<T>
+//
+// Precomputes the conversion of a frustum's Z-buffer values to depth,
+// as Frustum::ZToDepth() and normalizedZToDepth() compute it, and
+// back, as Frustum::DepthToZ() does. Z-buffer values range from zmin
+// to zmax: 0 to 1 for floating-point buffers, the defaults, and for
+// instance 0 to 0xffffff or 0xffffffff for 24- or 32-bit integer
+// buffers; zmin and zmax are long long, unlike the long arguments of
+// Frustum::ZToDepth(), so that 32-bit ranges fit on all platforms.
+// The depth is the camera-space z coordinate of the point, which is
+// negative in front of the camera, and the frustum's depth range, and
+// infinite far plane if any, are taken into account.
+//
+// Both directions are a ratio of linear functions, (A * z + B) /
+// (C * z + D), with A = 0 for perspective frustums and C = 0 for
+// orthographic ones, so that each sample costs two multiply-adds and
+// a division, in loops without branches that the compiler vectorizes.
+// The conversions of buffers are templates on the type of the
+// Z-buffer samples, which may be float, double, half or an unsigned
+// integer type. Integer samples are truncated like DepthToZ()'s
+// results and clamped to [zmin, zmax].
+//
+// A DepthLinearizer does not change after its construction, so that
+// threads may convert parts of a buffer with the same one.
+//
+
+template <class T> class DepthLinearizer
+{
+  public:
+    // Throws std::domain_error if zmin == zmax, like
+    // Frustum::ZToDepthExc().
+    DepthLinearizer (const Frustum<T>& frustum, long long zmin = 0, long long zmax = 1);
+
+    ////////////////////////////////////////////////////////////////////
+    // toLinear()
+    // Return the depth of a Z-buffer value.
+    constexpr T toLinear (T z) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // fromLinear()
+    // Return the Z-buffer value of a depth, unclamped and unrounded.
+    constexpr T fromLinear (T depth) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // depthBufferToLinear()
+    // Convert the n Z-buffer values z[i] to depths.
+    template <class S>
+    void depthBufferToLinear (const S* z, size_t n, T* depth) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // linearToDepthBuffer()
+    // Convert n depths to Z-buffer values of type S.
+    template <class S>
+    void linearToDepthBuffer (const T* depth, size_t n, S* z) const noexcept;
+
+  private:
+    template <class S> S toSample (T z, std::true_type) const noexcept;
+    template <class S> S toSample (T z, std::false_type) const noexcept;
+
+    T _toA, _toB, _toC, _toD;         // z to depth
+    T _fromA, _fromB, _fromC, _fromD; // depth to z
+    T _zmin, _zmax;
+    long long _zmaxInt;
+};
+
+//
+// With Zp the normalized device coordinate of z, alpha * z + beta,
+// and dn and df those of the near and far planes, Frustum's
+// normalizedZToDepth() computes
+//
+//	orthographic:	(Zp * (f - n) + df * n - dn * f) / (dn - df)
+//	perspective:	(df - dn) * f * n / (Zp * (f - n) - df * f + dn * n)
+//	infinite far:	(df - dn) * n / (Zp - df)
+//
+// The coefficients are computed in double precision, and the
+// perspective ones are divided by f - n to keep them in range.
+//
+
+template <class T>
+DepthLinearizer<T>::DepthLinearizer (const Frustum<T>& frustum,
+                                     long long zmin,
+                                     long long zmax)
+{
+    if (zmax == zmin)
+        throw std::domain_error ("Bad call to DepthLinearizer: zmax == zmin");
+
+    double n     = frustum.nearPlane();
+    double f     = frustum.farPlane();
+    double zdiff = double (zmax) - double (zmin);
+
+    T dnT = 0, dfT = 0;
+    frustum.depthBounds (dnT, dfT);
+    double dn = dnT;
+    double df = dfT;
+
+    // normalizedZToNdc() is linear, and exact at 0 and 1
+
+    double ndc0  = frustum.normalizedZToNdc (T (0));
+    double ndc1  = frustum.normalizedZToNdc (T (1));
+    double alpha = (ndc1 - ndc0) / zdiff;
+    double beta  = -alpha * double (zmin) + ndc0;
+
+    double a, b, c, d;
+
+    if (frustum.orthographic())
+    {
+        a = alpha * (f - n) / (dn - df);
+        b = (beta * (f - n) + df * n - dn * f) / (dn - df);
+        c = 0;
+        d = 1;
+    }
+    else if (f > limits<double>::max())
+    {
+        a = 0;
+        b = (df - dn) * n;
+        c = alpha;
+        d = beta - df;
+    }
+    else
+    {
+        a = 0;
+        b = (df - dn) * f * n / (f - n);
+        c = alpha;
+        d = beta - (df * f - dn * n) / (f - n);
+    }
+
+    // The inverse of depth = (a * z + b) / (c * z + d)
+
+    _toA   = T (a);
+    _toB   = T (b);
+    _toC   = T (c);
+    _toD   = T (d);
+    _fromA = T (d);
+    _fromB = T (-b);
+    _fromC = T (-c);
+    _fromD = T (a);
+
+    _zmin    = T (zmin);
+    _zmax    = T (zmax);
+    _zmaxInt = zmax;
+}
+
+template <class T>
+constexpr inline T
+DepthLinearizer<T>::toLinear (T z) const noexcept
+{
+    return (_toA * z + _toB) / (_toC * z + _toD);
+}
+
+template <class T>
+constexpr inline T
+DepthLinearizer<T>::fromLinear (T depth) const noexcept
+{
+    return (_fromA * depth + _fromB) / (_fromC * depth + _fromD);
+}
+
+template <class T>
+template <class S>
+inline S
+DepthLinearizer<T>::toSample (T z, std::true_type) const noexcept
+{
+    // Clamp before converting, so that the conversion is defined;
+    // a NaN becomes zmin. T (zmax) may round up, hence the clamp of
+    // the integer.
+
+    z      = z >= _zmin ? z : _zmin;
+    z      = z <= _zmax ? z : _zmax;
+    long long i = (long long) (z);
+    return S (i <= _zmaxInt ? i : _zmaxInt);
+}
+
+template <class T>
+template <class S>
+inline S
+DepthLinearizer<T>::toSample (T z, std::false_type) const noexcept
+{
+    return S (z);
+}
+
+template <class T>
+template <class S>
+void
+DepthLinearizer<T>::depthBufferToLinear (const S* z, size_t n, T* depth) const noexcept
+{
+    const T a = _toA, b = _toB, c = _toC, d = _toD;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T zi     = T (z[i]);
+        depth[i] = (a * zi + b) / (c * zi + d);
+    }
+}
+
+template <class T>
+template <class S>
+void
+DepthLinearizer<T>::linearToDepthBuffer (const T* depth, size_t n, S* z) const noexcept
+{
+    const T a = _fromA, b = _fromB, c = _fromC, d = _fromD;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T zi = (a * depth[i] + b) / (c * depth[i] + d);
+        z[i] = toSample<S> (zi, std::is_integral<S>());
+    }
+}
+
+typedef DepthLinearizer<float> DepthLinearizerf;
+typedef DepthLinearizer<double> DepthLinearizerd;
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHDEPTHBUFFER_H
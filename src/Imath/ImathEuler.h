@@ -265,6 +265,46 @@ template <class T> class Euler : public Vec3<T>
 
     IMATH_HOSTDEVICE void angleMapping (int& i, int& j, int& k) const noexcept;
 
+    //------------------------------------------------------------
+    //	Conversions for an order that is known at compile time.
+    //  The angles are in ijk form, as stored in an Euler of order
+    //  O.  These produce the same results as the member functions,
+    //  but the order-dependent branches and axis indices are
+    //  resolved at compile time:
+    //
+    //	    Matrix33f M = Eulerf::toMatrix33<Eulerf::XYZ> (ijk);
+    //	    V3f ijk     = Eulerf::extractAngles<Eulerf::XYZ> (M);
+    //------------------------------------------------------------
+
+    template <Order O> IMATH_HOSTDEVICE static Matrix33<T> toMatrix33 (const Vec3<T>& ijk) noexcept;
+    template <Order O> IMATH_HOSTDEVICE static Matrix44<T> toMatrix44 (const Vec3<T>& ijk) noexcept;
+    template <Order O> IMATH_HOSTDEVICE static Quat<T> toQuat (const Vec3<T>& ijk) noexcept;
+
+    template <Order O> IMATH_HOSTDEVICE static Vec3<T> extractAngles (const Matrix33<T>& M) noexcept;
+    template <Order O> IMATH_HOSTDEVICE static Vec3<T> extractAngles (const Matrix44<T>& M) noexcept;
+    template <Order O> IMATH_HOSTDEVICE static Vec3<T> extractAngles (const Quat<T>& q) noexcept;
+
+    //------------------------------------------------------------
+    //	Batched conversions of n angle triples, in ijk form for
+    //  the given order, to and from rotations.  The order is
+    //  dispatched once per call, to a loop that is specialized
+    //  for the order at compile time.  The loops call the same
+    //  sin(), cos() and atan2() as the member functions, which
+    //  dominate the cost, so they are not faster than converting
+    //  Euler objects one at a time; they save the per-object
+    //  order handling and give bit-identical results.
+    //------------------------------------------------------------
+
+    static void toMatrix33 (const Vec3<T>* ijk, Matrix33<T>* result, size_t n, Order order) noexcept;
+    static void toMatrix44 (const Vec3<T>* ijk, Matrix44<T>* result, size_t n, Order order) noexcept;
+    static void toQuat (const Vec3<T>* ijk, Quat<T>* result, size_t n, Order order) noexcept;
+
+    static void
+    extractAngles (const Matrix33<T>* M, Vec3<T>* ijk, size_t n, Order order) noexcept;
+    static void
+    extractAngles (const Matrix44<T>* M, Vec3<T>* ijk, size_t n, Order order) noexcept;
+    static void extractAngles (const Quat<T>* q, Vec3<T>* ijk, size_t n, Order order) noexcept;
+
     //----------------------------------------------------------------------
     //
     //  Utility methods for getting continuous rotations. None of these
@@ -302,6 +342,89 @@ template <class T> class Euler : public Vec3<T>
     IMATH_HOSTDEVICE constexpr bool parityEven() const { return _parityEven; }
     IMATH_HOSTDEVICE constexpr Axis initialAxis() const { return _initialAxis; }
 
+  private:
+    //
+    // The conversions, with the properties of the order as
+    // arguments.  The member functions pass the stored properties;
+    // the compile-time conversions pass constants, which the
+    // compiler propagates into the inlined code.
+    //
+
+    IMATH_HOSTDEVICE static constexpr int initialAxisOf (Order o) noexcept
+    {
+        return o & 0x2000 ? Z : (o & 0x1000 ? Y : X);
+    }
+
+    IMATH_HOSTDEVICE static constexpr bool frameStaticOf (Order o) noexcept
+    {
+        return (o & 0x1) != 0;
+    }
+
+    IMATH_HOSTDEVICE static constexpr bool parityEvenOf (Order o) noexcept
+    {
+        return (o & 0x100) != 0;
+    }
+
+    IMATH_HOSTDEVICE static constexpr bool initialRepeatedOf (Order o) noexcept
+    {
+        return (o & 0x10) != 0;
+    }
+
+    IMATH_HOSTDEVICE static constexpr int secondAxisOf (int i, bool parityEven) noexcept
+    {
+        return parityEven ? (i + 1) % 3 : (i > 0 ? i - 1 : 2);
+    }
+
+    IMATH_HOSTDEVICE static constexpr int thirdAxisOf (int i, bool parityEven) noexcept
+    {
+        return parityEven ? (i > 0 ? i - 1 : 2) : (i + 1) % 3;
+    }
+
+    template <class M>
+    IMATH_HOSTDEVICE static void rotationMatrix (M& mat,
+                                                 const Vec3<T>& ijk,
+                                                 int i,
+                                                 bool frameStatic,
+                                                 bool parityEven,
+                                                 bool initialRepeated) noexcept;
+
+    IMATH_HOSTDEVICE static Quat<T> rotationQuat (const Vec3<T>& ijk,
+                                                  int i,
+                                                  bool frameStatic,
+                                                  bool parityEven,
+                                                  bool initialRepeated) noexcept;
+
+    IMATH_HOSTDEVICE static Vec3<T> anglesFromMatrix (const Matrix44<T>& M,
+                                                      int i,
+                                                      bool frameStatic,
+                                                      bool parityEven,
+                                                      bool initialRepeated) noexcept;
+
+    IMATH_HOSTDEVICE static Matrix44<T> asMatrix44 (const Matrix33<T>& M) noexcept;
+
+    //
+    // One conversion of each kind, for the batched conversions
+    //
+
+    IMATH_HOSTDEVICE static void
+    convert (const Vec3<T>& ijk, Matrix33<T>& M, int i, bool fs, bool pe, bool ir) noexcept;
+    IMATH_HOSTDEVICE static void
+    convert (const Vec3<T>& ijk, Matrix44<T>& M, int i, bool fs, bool pe, bool ir) noexcept;
+    IMATH_HOSTDEVICE static void
+    convert (const Vec3<T>& ijk, Quat<T>& q, int i, bool fs, bool pe, bool ir) noexcept;
+    IMATH_HOSTDEVICE static void
+    convert (const Matrix33<T>& M, Vec3<T>& ijk, int i, bool fs, bool pe, bool ir) noexcept;
+    IMATH_HOSTDEVICE static void
+    convert (const Matrix44<T>& M, Vec3<T>& ijk, int i, bool fs, bool pe, bool ir) noexcept;
+    IMATH_HOSTDEVICE static void
+    convert (const Quat<T>& q, Vec3<T>& ijk, int i, bool fs, bool pe, bool ir) noexcept;
+
+    template <Order O, class Src, class Dst>
+    IMATH_HOSTDEVICE static void convert (const Src* src, Dst* dst, size_t n) noexcept;
+
+    template <class Src, class Dst>
+    IMATH_HOSTDEVICE static void convert (const Src* src, Dst* dst, size_t n, Order order) noexcept;
+
   protected:
     bool _frameStatic : 1;     // relative or static rotations
     bool _initialRepeated : 1; // init axis repeated as last
@@ -329,8 +452,8 @@ inline void
 Euler<T>::angleOrder (int& i, int& j, int& k) const noexcept
 {
     i = _initialAxis;
-    j = _parityEven ? (i + 1) % 3 : (i > 0 ? i - 1 : 2);
-    k = _parityEven ? (i > 0 ? i - 1 : 2) : (i + 1) % 3;
+    j = secondAxisOf (i, _parityEven);
+    k = thirdAxisOf (i, _parityEven);
 }
 
 template <class T>
@@ -455,120 +578,40 @@ Euler<T>::extract (const Quat<T>& q) noexcept
 }
 
 template <class T>
-void
-Euler<T>::extract (const Matrix33<T>& M) noexcept
+inline Matrix44<T>
+Euler<T>::asMatrix44 (const Matrix33<T>& M) noexcept
 {
-    int i, j, k;
-    angleOrder (i, j, k);
-
-    if (_initialRepeated)
-    {
-        //
-        // Extract the first angle, x.
-        //
-
-        x = std::atan2 (M[j][i], M[k][i]);
-
-        //
-        // Remove the x rotation from M, so that the remaining
-        // rotation, N, is only around two axes, and gimbal lock
-        // cannot occur.
-        //
-
-        Vec3<T> r (0, 0, 0);
-        r[i] = (_parityEven ? -x : x);
-
-        Matrix44<T> N;
-        N.rotate (r);
-
-        N = N * Matrix44<T> (M[0][0],
-                             M[0][1],
-                             M[0][2],
-                             0,
-                             M[1][0],
-                             M[1][1],
-                             M[1][2],
-                             0,
-                             M[2][0],
-                             M[2][1],
-                             M[2][2],
-                             0,
-                             0,
-                             0,
-                             0,
-                             1);
-        //
-        // Extract the other two angles, y and z, from N.
-        //
-
-        T sy = std::sqrt (N[j][i] * N[j][i] + N[k][i] * N[k][i]);
-        y    = std::atan2 (sy, N[i][i]);
-        z    = std::atan2 (N[j][k], N[j][j]);
-    }
-    else
-    {
-        //
-        // Extract the first angle, x.
-        //
-
-        x = std::atan2 (M[j][k], M[k][k]);
-
-        //
-        // Remove the x rotation from M, so that the remaining
-        // rotation, N, is only around two axes, and gimbal lock
-        // cannot occur.
-        //
-
-        Vec3<T> r (0, 0, 0);
-        r[i] = (_parityEven ? -x : x);
-
-        Matrix44<T> N;
-        N.rotate (r);
-
-        N = N * Matrix44<T> (M[0][0],
-                             M[0][1],
-                             M[0][2],
-                             0,
-                             M[1][0],
-                             M[1][1],
-                             M[1][2],
-                             0,
-                             M[2][0],
-                             M[2][1],
-                             M[2][2],
-                             0,
-                             0,
-                             0,
-                             0,
-                             1);
-        //
-        // Extract the other two angles, y and z, from N.
-        //
-
-        T cy = std::sqrt (N[i][i] * N[i][i] + N[i][j] * N[i][j]);
-        y    = std::atan2 (-N[i][k], cy);
-        z    = std::atan2 (-N[j][i], N[j][j]);
-    }
-
-    if (!_parityEven)
-        *this *= -1;
-
-    if (!_frameStatic)
-    {
-        T t = x;
-        x   = z;
-        z   = t;
-    }
+    return Matrix44<T> (M[0][0],
+                        M[0][1],
+                        M[0][2],
+                        0,
+                        M[1][0],
+                        M[1][1],
+                        M[1][2],
+                        0,
+                        M[2][0],
+                        M[2][1],
+                        M[2][2],
+                        0,
+                        0,
+                        0,
+                        0,
+                        1);
 }
 
 template <class T>
-void
-Euler<T>::extract (const Matrix44<T>& M) noexcept
+inline Vec3<T>
+Euler<T>::anglesFromMatrix (const Matrix44<T>& M,
+                            int i,
+                            bool frameStatic,
+                            bool parityEven,
+                            bool initialRepeated) noexcept
 {
-    int i, j, k;
-    angleOrder (i, j, k);
+    int j = secondAxisOf (i, parityEven);
+    int k = thirdAxisOf (i, parityEven);
+    T x, y, z;
 
-    if (_initialRepeated)
+    if (initialRepeated)
     {
         //
         // Extract the first angle, x.
@@ -583,7 +626,7 @@ Euler<T>::extract (const Matrix44<T>& M) noexcept
         //
 
         Vec3<T> r (0, 0, 0);
-        r[i] = (_parityEven ? -x : x);
+        r[i] = (parityEven ? -x : x);
 
         Matrix44<T> N;
         N.rotate (r);
@@ -612,7 +655,7 @@ Euler<T>::extract (const Matrix44<T>& M) noexcept
         //
 
         Vec3<T> r (0, 0, 0);
-        r[i] = (_parityEven ? -x : x);
+        r[i] = (parityEven ? -x : x);
 
         Matrix44<T> N;
         N.rotate (r);
@@ -627,32 +670,55 @@ Euler<T>::extract (const Matrix44<T>& M) noexcept
         z    = std::atan2 (-N[j][i], N[j][j]);
     }
 
-    if (!_parityEven)
-        *this *= -1;
-
-    if (!_frameStatic)
+    if (!parityEven)
     {
-        T t = x;
-        x   = z;
-        z   = t;
+        x = -x;
+        y = -y;
+        z = -z;
     }
+
+    if (frameStatic)
+        return Vec3<T> (x, y, z);
+    else
+        return Vec3<T> (z, y, x);
 }
 
 template <class T>
-Matrix33<T>
-Euler<T>::toMatrix33() const noexcept
+void
+Euler<T>::extract (const Matrix33<T>& M) noexcept
 {
-    int i, j, k;
-    angleOrder (i, j, k);
+    *this = anglesFromMatrix (
+        asMatrix44 (M), _initialAxis, _frameStatic, _parityEven, _initialRepeated);
+}
+
+template <class T>
+void
+Euler<T>::extract (const Matrix44<T>& M) noexcept
+{
+    *this = anglesFromMatrix (M, _initialAxis, _frameStatic, _parityEven, _initialRepeated);
+}
+
+template <class T>
+template <class M>
+inline void
+Euler<T>::rotationMatrix (M& mat,
+                          const Vec3<T>& ijk,
+                          int i,
+                          bool frameStatic,
+                          bool parityEven,
+                          bool initialRepeated) noexcept
+{
+    int j = secondAxisOf (i, parityEven);
+    int k = thirdAxisOf (i, parityEven);
 
     Vec3<T> angles;
 
-    if (_frameStatic)
-        angles = (*this);
+    if (frameStatic)
+        angles = ijk;
     else
-        angles = Vec3<T> (z, y, x);
+        angles = Vec3<T> (ijk.z, ijk.y, ijk.x);
 
-    if (!_parityEven)
+    if (!parityEven)
         angles *= -1.0;
 
     T ci = std::cos (angles.x);
@@ -667,33 +733,38 @@ Euler<T>::toMatrix33() const noexcept
     T sc = si * ch;
     T ss = si * sh;
 
-    Matrix33<T> M;
-
-    if (_initialRepeated)
+    if (initialRepeated)
     {
-        M[i][i] = cj;
-        M[j][i] = sj * si;
-        M[k][i] = sj * ci;
-        M[i][j] = sj * sh;
-        M[j][j] = -cj * ss + cc;
-        M[k][j] = -cj * cs - sc;
-        M[i][k] = -sj * ch;
-        M[j][k] = cj * sc + cs;
-        M[k][k] = cj * cc - ss;
+        mat[i][i] = cj;
+        mat[j][i] = sj * si;
+        mat[k][i] = sj * ci;
+        mat[i][j] = sj * sh;
+        mat[j][j] = -cj * ss + cc;
+        mat[k][j] = -cj * cs - sc;
+        mat[i][k] = -sj * ch;
+        mat[j][k] = cj * sc + cs;
+        mat[k][k] = cj * cc - ss;
     }
     else
     {
-        M[i][i] = cj * ch;
-        M[j][i] = sj * sc - cs;
-        M[k][i] = sj * cc + ss;
-        M[i][j] = cj * sh;
-        M[j][j] = sj * ss + cc;
-        M[k][j] = sj * cs - sc;
-        M[i][k] = -sj;
-        M[j][k] = cj * si;
-        M[k][k] = cj * ci;
+        mat[i][i] = cj * ch;
+        mat[j][i] = sj * sc - cs;
+        mat[k][i] = sj * cc + ss;
+        mat[i][j] = cj * sh;
+        mat[j][j] = sj * ss + cc;
+        mat[k][j] = sj * cs - sc;
+        mat[i][k] = -sj;
+        mat[j][k] = cj * si;
+        mat[k][k] = cj * ci;
     }
+}
 
+template <class T>
+Matrix33<T>
+Euler<T>::toMatrix33() const noexcept
+{
+    Matrix33<T> M;
+    rotationMatrix (M, *this, _initialAxis, _frameStatic, _parityEven, _initialRepeated);
     return M;
 }
 
@@ -701,75 +772,30 @@ template <class T>
 Matrix44<T>
 Euler<T>::toMatrix44() const noexcept
 {
-    int i, j, k;
-    angleOrder (i, j, k);
-
-    Vec3<T> angles;
-
-    if (_frameStatic)
-        angles = (*this);
-    else
-        angles = Vec3<T> (z, y, x);
-
-    if (!_parityEven)
-        angles *= -1.0;
-
-    T ci = std::cos (angles.x);
-    T cj = std::cos (angles.y);
-    T ch = std::cos (angles.z);
-    T si = std::sin (angles.x);
-    T sj = std::sin (angles.y);
-    T sh = std::sin (angles.z);
-
-    T cc = ci * ch;
-    T cs = ci * sh;
-    T sc = si * ch;
-    T ss = si * sh;
-
     Matrix44<T> M;
-
-    if (_initialRepeated)
-    {
-        M[i][i] = cj;
-        M[j][i] = sj * si;
-        M[k][i] = sj * ci;
-        M[i][j] = sj * sh;
-        M[j][j] = -cj * ss + cc;
-        M[k][j] = -cj * cs - sc;
-        M[i][k] = -sj * ch;
-        M[j][k] = cj * sc + cs;
-        M[k][k] = cj * cc - ss;
-    }
-    else
-    {
-        M[i][i] = cj * ch;
-        M[j][i] = sj * sc - cs;
-        M[k][i] = sj * cc + ss;
-        M[i][j] = cj * sh;
-        M[j][j] = sj * ss + cc;
-        M[k][j] = sj * cs - sc;
-        M[i][k] = -sj;
-        M[j][k] = cj * si;
-        M[k][k] = cj * ci;
-    }
-
+    rotationMatrix (M, *this, _initialAxis, _frameStatic, _parityEven, _initialRepeated);
     return M;
 }
 
 template <class T>
-Quat<T>
-Euler<T>::toQuat() const noexcept
+inline Quat<T>
+Euler<T>::rotationQuat (const Vec3<T>& ijk,
+                        int i,
+                        bool frameStatic,
+                        bool parityEven,
+                        bool initialRepeated) noexcept
 {
+    int j = secondAxisOf (i, parityEven);
+    int k = thirdAxisOf (i, parityEven);
+
     Vec3<T> angles;
-    int i, j, k;
-    angleOrder (i, j, k);
 
-    if (_frameStatic)
-        angles = (*this);
+    if (frameStatic)
+        angles = ijk;
     else
-        angles = Vec3<T> (z, y, x);
+        angles = Vec3<T> (ijk.z, ijk.y, ijk.x);
 
-    if (!_parityEven)
+    if (!parityEven)
         angles.y = -angles.y;
 
     T ti = angles.x * 0.5;
@@ -786,12 +812,12 @@ Euler<T>::toQuat() const noexcept
     T sc = si * ch;
     T ss = si * sh;
 
-    T parity = _parityEven ? 1.0 : -1.0;
+    T parity = parityEven ? 1.0 : -1.0;
 
     Quat<T> q;
     Vec3<T> a;
 
-    if (_initialRepeated)
+    if (initialRepeated)
     {
         a[i]     = cj * (cs + sc);
         a[j]     = sj * (cc + ss) * parity, // NOSONAR - suppress SonarCloud bug report.
@@ -811,6 +837,272 @@ Euler<T>::toQuat() const noexcept
     return q;
 }
 
+template <class T>
+Quat<T>
+Euler<T>::toQuat() const noexcept
+{
+    return rotationQuat (*this, _initialAxis, _frameStatic, _parityEven, _initialRepeated);
+}
+
+template <class T>
+inline void
+Euler<T>::convert (const Vec3<T>& ijk, Matrix33<T>& M, int i, bool fs, bool pe, bool ir) noexcept
+{
+    rotationMatrix (M, ijk, i, fs, pe, ir);
+}
+
+template <class T>
+inline void
+Euler<T>::convert (const Vec3<T>& ijk, Matrix44<T>& M, int i, bool fs, bool pe, bool ir) noexcept
+{
+    M.makeIdentity();
+    rotationMatrix (M, ijk, i, fs, pe, ir);
+}
+
+template <class T>
+inline void
+Euler<T>::convert (const Vec3<T>& ijk, Quat<T>& q, int i, bool fs, bool pe, bool ir) noexcept
+{
+    q = rotationQuat (ijk, i, fs, pe, ir);
+}
+
+template <class T>
+inline void
+Euler<T>::convert (const Matrix33<T>& M, Vec3<T>& ijk, int i, bool fs, bool pe, bool ir) noexcept
+{
+    ijk = anglesFromMatrix (asMatrix44 (M), i, fs, pe, ir);
+}
+
+template <class T>
+inline void
+Euler<T>::convert (const Matrix44<T>& M, Vec3<T>& ijk, int i, bool fs, bool pe, bool ir) noexcept
+{
+    ijk = anglesFromMatrix (M, i, fs, pe, ir);
+}
+
+template <class T>
+inline void
+Euler<T>::convert (const Quat<T>& q, Vec3<T>& ijk, int i, bool fs, bool pe, bool ir) noexcept
+{
+    ijk = anglesFromMatrix (asMatrix44 (q.toMatrix33()), i, fs, pe, ir);
+}
+
+template <class T>
+template <typename Euler<T>::Order O, class Src, class Dst>
+inline void
+Euler<T>::convert (const Src* src, Dst* dst, size_t n) noexcept
+{
+    for (size_t m = 0; m < n; ++m)
+    {
+        convert (src[m],
+                 dst[m],
+                 initialAxisOf (O),
+                 frameStaticOf (O),
+                 parityEvenOf (O),
+                 initialRepeatedOf (O));
+    }
+}
+
+template <class T>
+template <class Src, class Dst>
+void
+Euler<T>::convert (const Src* src, Dst* dst, size_t n, Order order) noexcept
+{
+    switch (order)
+    {
+        case XYZ:
+            convert<XYZ> (src, dst, n);
+            break;
+        case XZY:
+            convert<XZY> (src, dst, n);
+            break;
+        case YZX:
+            convert<YZX> (src, dst, n);
+            break;
+        case YXZ:
+            convert<YXZ> (src, dst, n);
+            break;
+        case ZXY:
+            convert<ZXY> (src, dst, n);
+            break;
+        case ZYX:
+            convert<ZYX> (src, dst, n);
+            break;
+        case XZX:
+            convert<XZX> (src, dst, n);
+            break;
+        case XYX:
+            convert<XYX> (src, dst, n);
+            break;
+        case YXY:
+            convert<YXY> (src, dst, n);
+            break;
+        case YZY:
+            convert<YZY> (src, dst, n);
+            break;
+        case ZYZ:
+            convert<ZYZ> (src, dst, n);
+            break;
+        case ZXZ:
+            convert<ZXZ> (src, dst, n);
+            break;
+        case XYZr:
+            convert<XYZr> (src, dst, n);
+            break;
+        case XZYr:
+            convert<XZYr> (src, dst, n);
+            break;
+        case YZXr:
+            convert<YZXr> (src, dst, n);
+            break;
+        case YXZr:
+            convert<YXZr> (src, dst, n);
+            break;
+        case ZXYr:
+            convert<ZXYr> (src, dst, n);
+            break;
+        case ZYXr:
+            convert<ZYXr> (src, dst, n);
+            break;
+        case XZXr:
+            convert<XZXr> (src, dst, n);
+            break;
+        case XYXr:
+            convert<XYXr> (src, dst, n);
+            break;
+        case YXYr:
+            convert<YXYr> (src, dst, n);
+            break;
+        case YZYr:
+            convert<YZYr> (src, dst, n);
+            break;
+        case ZYZr:
+            convert<ZYZr> (src, dst, n);
+            break;
+        case ZXZr:
+            convert<ZXZr> (src, dst, n);
+            break;
+        default:
+
+            //
+            // Not one of the named orders; decode the order like
+            // setOrder() does.
+            //
+
+            for (size_t m = 0; m < n; ++m)
+            {
+                convert (src[m],
+                         dst[m],
+                         initialAxisOf (order),
+                         frameStaticOf (order),
+                         parityEvenOf (order),
+                         initialRepeatedOf (order));
+            }
+    }
+}
+
+template <class T>
+template <typename Euler<T>::Order O>
+inline Matrix33<T>
+Euler<T>::toMatrix33 (const Vec3<T>& ijk) noexcept
+{
+    Matrix33<T> M;
+    convert<O> (&ijk, &M, 1);
+    return M;
+}
+
+template <class T>
+template <typename Euler<T>::Order O>
+inline Matrix44<T>
+Euler<T>::toMatrix44 (const Vec3<T>& ijk) noexcept
+{
+    Matrix44<T> M;
+    convert<O> (&ijk, &M, 1);
+    return M;
+}
+
+template <class T>
+template <typename Euler<T>::Order O>
+inline Quat<T>
+Euler<T>::toQuat (const Vec3<T>& ijk) noexcept
+{
+    Quat<T> q;
+    convert<O> (&ijk, &q, 1);
+    return q;
+}
+
+template <class T>
+template <typename Euler<T>::Order O>
+inline Vec3<T>
+Euler<T>::extractAngles (const Matrix33<T>& M) noexcept
+{
+    Vec3<T> ijk;
+    convert<O> (&M, &ijk, 1);
+    return ijk;
+}
+
+template <class T>
+template <typename Euler<T>::Order O>
+inline Vec3<T>
+Euler<T>::extractAngles (const Matrix44<T>& M) noexcept
+{
+    Vec3<T> ijk;
+    convert<O> (&M, &ijk, 1);
+    return ijk;
+}
+
+template <class T>
+template <typename Euler<T>::Order O>
+inline Vec3<T>
+Euler<T>::extractAngles (const Quat<T>& q) noexcept
+{
+    Vec3<T> ijk;
+    convert<O> (&q, &ijk, 1);
+    return ijk;
+}
+
+template <class T>
+void
+Euler<T>::toMatrix33 (const Vec3<T>* ijk, Matrix33<T>* result, size_t n, Order order) noexcept
+{
+    convert (ijk, result, n, order);
+}
+
+template <class T>
+void
+Euler<T>::toMatrix44 (const Vec3<T>* ijk, Matrix44<T>* result, size_t n, Order order) noexcept
+{
+    convert (ijk, result, n, order);
+}
+
+template <class T>
+void
+Euler<T>::toQuat (const Vec3<T>* ijk, Quat<T>* result, size_t n, Order order) noexcept
+{
+    convert (ijk, result, n, order);
+}
+
+template <class T>
+void
+Euler<T>::extractAngles (const Matrix33<T>* M, Vec3<T>* ijk, size_t n, Order order) noexcept
+{
+    convert (M, ijk, n, order);
+}
+
+template <class T>
+void
+Euler<T>::extractAngles (const Matrix44<T>* M, Vec3<T>* ijk, size_t n, Order order) noexcept
+{
+    convert (M, ijk, n, order);
+}
+
+template <class T>
+void
+Euler<T>::extractAngles (const Quat<T>* q, Vec3<T>* ijk, size_t n, Order order) noexcept
+{
+    convert (q, ijk, n, order);
+}
+
 template <class T>
 constexpr inline bool
 Euler<T>::legal (typename Euler<T>::Order order) noexcept
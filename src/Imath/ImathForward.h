@@ -15,22 +15,36 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 //
 
 template <class T> class Box;
+template <class T> class Box3SoA;
 template <class T> class Color3;
 template <class T> class Color4;
+template <class T> class ColorPipeline;
+template <class T> class DepthLinearizer;
+template <class T> class DualQuat;
 template <class T> class Euler;
 template <class T> class Frustum;
 template <class T> class FrustumTest;
 template <class T> class Interval;
 template <class T> class Line3;
+template <class T> class Line3SoA;
+template <class C> class Lut3D;
 template <class T> class Matrix33;
 template <class T> class Matrix44;
+template <class T, int N> class MultiFrustumTest;
 template <class T> class Plane3;
+template <class T> class PreparedRay;
+template <class Q> class QuantizedBox;
 template <class T> class Quat;
+template <class T> class QuatSoA;
+template <class T, int N> class RayPacket;
 template <class T> class Shear6;
+template <class T> class SlerpKey;
 template <class T> class Sphere3;
+template <class T> class Sphere3SoA;
 template <class T> class TMatrix;
 template <class T> class TMatrixBase;
 template <class T> class TMatrixData;
+template <class T, int N> class TrianglePacket;
 template <class T> class Vec2;
 template <class T> class Vec3;
 template <class T> class Vec4;
@@ -7,6 +7,10 @@
 #define INCLUDED_IMATHFRAME_H
 
 #include "ImathNamespace.h"
+#include "ImathQuat.h"
+#include <cmath>
+#include <cstddef>
+#include <limits>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -178,6 +182,227 @@ Matrix44<T> constexpr lastFrame (const Matrix44<T>& Mi, // Previous matrix
     return Mi * Tr;
 }
 
+//
+//  computeFrames - Compute the reference frames at all points of a curve.
+//
+//  These functions compute rotation-minimizing frames along a curve of
+//  n points with the double reflection method (Wang, Juttler, Zheng and
+//  Liu, "Computation of Rotation Minimizing Frames", ACM Transactions on
+//  Graphics, 2008), which costs a few dot products per point instead of
+//  a rotation matrix.
+//
+//  The frame at point i has the tangent t, the normal n and the binormal
+//  b = t % n as its axes. The tangent is the direction from the previous
+//  point to the next one, or along the first or last segment at the ends
+//  of the curve. The first normal is chosen as by firstFrame().
+//
+//  The frames are returned either as tangents and normals, as matrices
+//  with rows t, n, b and the point, like those of firstFrame(), or as
+//  quaternions q such that q.toMatrix33() has rows t, n and b.
+//
+//  The curves of a set are independent, so that a large set of curves can
+//  be divided among several threads.
+//
+
+template <class T>
+void computeFrames (const Vec3<T>* points, size_t n, Vec3<T>* tangents, Vec3<T>* normals) noexcept;
+
+template <class T>
+void computeFrames (const Vec3<T>* points, size_t n, Matrix44<T>* frames) noexcept;
+
+template <class T>
+void computeFrames (const Vec3<T>* points, size_t n, Quat<T>* rotations) noexcept;
+
+//
+// curveTangent(), frameRotation() and rotationMinimizingFrames() are not
+// part of the public interface.
+//
+
+template <class T>
+inline Vec3<T>
+curveTangent (const Vec3<T>* points, size_t n, size_t i, const Vec3<T>& previous) noexcept
+{
+    Vec3<T> d = points[i + 1 < n ? i + 1 : i] - points[i > 0 ? i - 1 : i];
+    T l2      = d.length2();
+
+    return l2 > T (0) ? d / std::sqrt (l2) : previous;
+}
+
+template <class T>
+inline Quat<T>
+frameRotation (const Vec3<T>& t, const Vec3<T>& n, const Vec3<T>& b) noexcept
+{
+    //
+    //  The quaternion of the rotation matrix with rows t, n and b, as in
+    //  extractQuat().
+    //
+
+    T trace = t.x + n.y + b.z;
+    Quat<T> q;
+
+    if (trace > T (0))
+    {
+        T s = std::sqrt (trace + T (1));
+        T f = T (0.5) / s;
+        q   = Quat<T> (s * T (0.5), (n.z - b.y) * f, (b.x - t.z) * f, (t.y - n.x) * f);
+    }
+    else if (t.x >= n.y && t.x >= b.z)
+    {
+        T s = std::sqrt (t.x - n.y - b.z + T (1));
+        T f = T (0.5) / s;
+        q   = Quat<T> ((n.z - b.y) * f, s * T (0.5), (t.y + n.x) * f, (t.z + b.x) * f);
+    }
+    else if (n.y >= b.z)
+    {
+        T s = std::sqrt (n.y - b.z - t.x + T (1));
+        T f = T (0.5) / s;
+        q   = Quat<T> ((b.x - t.z) * f, (t.y + n.x) * f, s * T (0.5), (n.z + b.y) * f);
+    }
+    else
+    {
+        T s = std::sqrt (b.z - t.x - n.y + T (1));
+        T f = T (0.5) / s;
+        q   = Quat<T> ((t.y - n.x) * f, (t.z + b.x) * f, (n.z + b.y) * f, s * T (0.5));
+    }
+
+    return q;
+}
+
+//
+//  Call frame (i, t, r) with the tangent t and the normal r at each point
+//  i of the curve, in order.
+//
+
+template <class T, class Frame>
+void
+rotationMinimizingFrames (const Vec3<T>* points, size_t n, Frame& frame) noexcept
+{
+    if (n == 0)
+        return;
+
+    //
+    //  The first tangent is along the first segment of nonzero length,
+    //  or the x axis if all points coincide.
+    //
+
+    Vec3<T> t (1, 0, 0);
+
+    for (size_t j = 1; j < n; ++j)
+    {
+        if (points[j] != points[0])
+        {
+            t = (points[j] - points[0]).normalized();
+            break;
+        }
+    }
+
+    //
+    //  The first normal is that of the plane of the first three points;
+    //  if they are nearly collinear, rounding errors leave it far from
+    //  orthogonal to the tangent, and an axis is used instead.
+    //
+
+    Vec3<T> d = n > 2 ? points[2] - points[0] : Vec3<T> (0);
+    Vec3<T> r = t.cross (d);
+
+    if (r.length2() > T (64) * std::numeric_limits<T>::epsilon() * d.length2())
+    {
+        r -= t * t.dot (r);
+        r.normalize();
+    }
+    else
+    {
+        int i = std::abs (t[0]) < std::abs (t[1]) ? 0 : 1;
+        if (std::abs (t[2]) < std::abs (t[i]))
+            i = 2;
+
+        Vec3<T> v (0);
+        v[i] = 1;
+        r    = t.cross (v).normalized();
+    }
+
+    frame (size_t (0), t, r);
+
+    for (size_t i = 0; i + 1 < n; ++i)
+    {
+        //
+        //  Reflect the frame in the plane that bisects the segment from
+        //  point i to point i+1, then in the plane that maps the
+        //  reflected tangent onto the next tangent.
+        //
+
+        Vec3<T> tNext = curveTangent (points, n, i + 1, t);
+
+        Vec3<T> v1 = points[i + 1] - points[i];
+        T c1       = v1.dot (v1);
+
+        Vec3<T> rL = r;
+        Vec3<T> tL = t;
+
+        if (c1 > T (0))
+        {
+            T f = T (2) / c1;
+            rL -= v1 * (f * v1.dot (r));
+            tL -= v1 * (f * v1.dot (t));
+        }
+
+        Vec3<T> v2 = tNext - tL;
+        T c2       = v2.dot (v2);
+
+        if (c2 > T (0))
+            rL -= v2 * ((T (2) / c2) * v2.dot (rL));
+
+        //
+        //  Remove the rounding errors that accumulate along long
+        //  curves, keeping the normal orthogonal to the tangent.
+        //
+
+        rL -= tNext * tNext.dot (rL);
+        rL.normalize();
+
+        t = tNext;
+        r = rL;
+
+        frame (i + 1, t, r);
+    }
+}
+
+template <class T>
+void
+computeFrames (const Vec3<T>* points, size_t n, Vec3<T>* tangents, Vec3<T>* normals) noexcept
+{
+    auto frame = [=] (size_t i, const Vec3<T>& t, const Vec3<T>& r) {
+        tangents[i] = t;
+        normals[i]  = r;
+    };
+
+    rotationMinimizingFrames (points, n, frame);
+}
+
+template <class T>
+void
+computeFrames (const Vec3<T>* points, size_t n, Matrix44<T>* frames) noexcept
+{
+    auto frame = [=] (size_t i, const Vec3<T>& t, const Vec3<T>& r) {
+        Vec3<T> b = t.cross (r);
+        Matrix33<T> m (t.x, t.y, t.z, r.x, r.y, r.z, b.x, b.y, b.z);
+        frames[i] = Matrix44<T> (m, points[i]);
+    };
+
+    rotationMinimizingFrames (points, n, frame);
+}
+
+template <class T>
+void
+computeFrames (const Vec3<T>* points, size_t n, Quat<T>* rotations) noexcept
+{
+    auto frame = [=] (size_t i, const Vec3<T>& t, const Vec3<T>& r) {
+        rotations[i] = frameRotation (t, r, t.cross (r));
+    };
+
+    rotationMinimizingFrames (points, n, frame);
+}
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHFRAME_H
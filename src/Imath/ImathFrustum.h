@@ -13,6 +13,8 @@
 #include "ImathNamespace.h"
 #include "ImathPlane.h"
 #include "ImathVec.h"
+#include <cmath>
+#include <cstddef>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -30,10 +32,41 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 //  nearPlane/farPlane: near/far are keywords used by Microsoft's
 //  compiler, so we use nearPlane/farPlane instead to avoid
 //  issues.
+//
+//  The far plane of a perspective frustum may be at infinity,
+//  std::numeric_limits<T>::infinity(). The projection matrix then
+//  maps the far plane to the limit of its depth range, planes()
+//  returns a far plane that contains all points, and the depth
+//  conversions remain valid.
+//
+//  The depth range selects how projectionMatrix() maps depth to
+//  normalized device coordinates, and thus how the Z-buffer values
+//  of ZToDepth(), normalizedZToDepth() and DepthToZ() are read:
+//
+//  DEPTH_NEGATIVE_ONE_TO_ONE	the near plane maps to -1 and the far
+//				plane to 1, as in OpenGL; normalized
+//				Z values in [0,1] map to [-1,1]. This
+//				is the default.
+//
+//  DEPTH_ZERO_TO_ONE		the near plane maps to 0 and the far
+//				plane to 1, as in Direct3D, Metal and
+//				Vulkan.
+//
+//  DEPTH_ONE_TO_ZERO		the near plane maps to 1 and the far
+//				plane to 0 ("reverse-Z"), which, with a
+//				floating-point depth buffer, spreads the
+//				precision evenly over distance.
 
 template <class T> class Frustum
 {
   public:
+    enum DepthRange
+    {
+        DEPTH_NEGATIVE_ONE_TO_ONE,
+        DEPTH_ZERO_TO_ONE,
+        DEPTH_ONE_TO_ZERO
+    };
+
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Frustum() noexcept;
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Frustum (const Frustum&) noexcept;
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14
@@ -71,6 +104,9 @@ template <class T> class Frustum
     IMATH_HOSTDEVICE void modifyNearAndFar (T nearPlane, T farPlane) noexcept;
     IMATH_HOSTDEVICE void setOrthographic (bool) noexcept;
 
+    // The depth range is not changed by set()
+    IMATH_HOSTDEVICE void setDepthRange (DepthRange) noexcept;
+
     //--------------
     //  Access
     //--------------
@@ -84,6 +120,13 @@ template <class T> class Frustum
     IMATH_HOSTDEVICE constexpr T right() const noexcept { return _right; }
     IMATH_HOSTDEVICE constexpr T bottom() const noexcept { return _bottom; }
     IMATH_HOSTDEVICE constexpr T top() const noexcept { return _top; }
+    IMATH_HOSTDEVICE constexpr DepthRange depthRange() const noexcept { return _depthRange; }
+
+    // The normalized device coordinates of the near and far planes,
+    // and those of a Z-buffer value normalized to [0,1], in the
+    // frustum's depth range
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 void depthBounds (T& dn, T& df) const noexcept;
+    IMATH_HOSTDEVICE constexpr T normalizedZToNdc (T zval) const noexcept;
 
     //-----------------------------------------------------------------------
     //  Sets the planes in p to be the six bounding planes of the frustum, in
@@ -141,12 +184,35 @@ template <class T> class Frustum
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 T screenRadius (const Vec3<T>& p, T radius) const noexcept;
     IMATH_CONSTEXPR14 T screenRadiusExc (const Vec3<T>& p, T radius) const;
 
+    //-----------------------------------------------------------------------
+    //  Batched projection: the N versions apply the functions above to n
+    //  points or radii, with the scale factors of the window and the
+    //  orthographic/perspective choice computed once per call, in loops
+    //  that the compiler can vectorize. The results match those of the
+    //  single versions to within rounding. The rays may be stored as an
+    //  array of Line3 or in structure-of-arrays layout; as with
+    //  projectScreenToRay(), their directions are normalized.
+    //-----------------------------------------------------------------------
+
+    void projectPointToScreenN (const Vec3<T>* points, size_t n, Vec2<T>* result) const noexcept;
+    void projectScreenToRayN (const Vec2<T>* points, size_t n, Line3<T>* rays) const noexcept;
+    void
+    projectScreenToRayN (const Vec2<T>* points, size_t n, const Line3SoA<T>& rays) const noexcept;
+
+    void
+    worldRadiusN (const Vec3<T>* points, const T* radii, size_t n, T* result) const noexcept;
+    void
+    screenRadiusN (const Vec3<T>* points, const T* radii, size_t n, T* result) const noexcept;
+
   protected:
     IMATH_HOSTDEVICE constexpr Vec2<T> screenToLocal (const Vec2<T>&) const noexcept;
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec2<T>
     localToScreen (const Vec2<T>&) const noexcept;
     IMATH_CONSTEXPR14 Vec2<T> localToScreenExc (const Vec2<T>&) const;
 
+    IMATH_HOSTDEVICE constexpr bool infiniteFarPlane() const noexcept;
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 void depthCoefficients (T& C, T& D) const noexcept;
+
   protected:
     T _nearPlane;
     T _farPlane;
@@ -155,6 +221,7 @@ template <class T> class Frustum
     T _top;
     T _bottom;
     bool _orthographic;
+    DepthRange _depthRange = DEPTH_NEGATIVE_ONE_TO_ONE;
 };
 
 template <class T> IMATH_CONSTEXPR14 inline Frustum<T>::Frustum() noexcept
@@ -193,6 +260,7 @@ Frustum<T>::operator= (const Frustum& f) noexcept
     _top          = f._top;
     _bottom       = f._bottom;
     _orthographic = f._orthographic;
+    _depthRange   = f._depthRange;
 
     return *this;
 }
@@ -203,7 +271,7 @@ Frustum<T>::operator== (const Frustum<T>& src) const noexcept
 {
     return _nearPlane == src._nearPlane && _farPlane == src._farPlane && _left == src._left &&
            _right == src._right && _top == src._top && _bottom == src._bottom &&
-           _orthographic == src._orthographic;
+           _orthographic == src._orthographic && _depthRange == src._depthRange;
 }
 
 template <class T>
@@ -263,6 +331,80 @@ Frustum<T>::setOrthographic (bool ortho) noexcept
     _orthographic = ortho;
 }
 
+template <class T>
+inline void
+Frustum<T>::setDepthRange (DepthRange depthRange) noexcept
+{
+    _depthRange = depthRange;
+}
+
+template <class T>
+constexpr inline bool
+Frustum<T>::infiniteFarPlane() const noexcept
+{
+    return _farPlane > limits<T>::max();
+}
+
+//
+//  The normalized device coordinates of the near and far planes.
+//
+
+template <class T>
+IMATH_CONSTEXPR14 inline void
+Frustum<T>::depthBounds (T& dn, T& df) const noexcept
+{
+    dn = _depthRange == DEPTH_NEGATIVE_ONE_TO_ONE ? T (-1)
+         : _depthRange == DEPTH_ZERO_TO_ONE       ? T (0)
+                                                  : T (1);
+    df = _depthRange == DEPTH_ONE_TO_ZERO ? T (0) : T (1);
+}
+
+//
+//  The depth row of the projection matrix: a point at z maps to depth
+//  (C * z + D) / -z for a perspective projection, or C * z + D for an
+//  orthographic one. With dn and df the depths of the near and far
+//  planes, the coefficients for OpenGL are the familiar ones, and for
+//  an infinite far plane they are their limits.
+//
+
+template <class T>
+IMATH_CONSTEXPR14 inline void
+Frustum<T>::depthCoefficients (T& C, T& D) const noexcept
+{
+    T dn = 0, df = 0;
+    depthBounds (dn, df);
+
+    T farMinusNear = _farPlane - _nearPlane;
+
+    if (_orthographic)
+    {
+        C = (dn - df) / farMinusNear;
+        D = (dn * _farPlane - df * _nearPlane) / farMinusNear;
+    }
+    else if (infiniteFarPlane())
+    {
+        C = -df;
+        D = (dn - df) * _nearPlane;
+    }
+    else
+    {
+        C = (dn * _nearPlane - df * _farPlane) / farMinusNear;
+        D = (dn - df) * _nearPlane * _farPlane / farMinusNear;
+    }
+}
+
+//
+//  Z-buffer values are normalized to [0,1]; for OpenGL, [0,1] maps to
+//  [-1,1] in normalized device coordinates.
+//
+
+template <class T>
+constexpr inline T
+Frustum<T>::normalizedZToNdc (T zval) const noexcept
+{
+    return _depthRange == DEPTH_NEGATIVE_ONE_TO_ONE ? zval * T (2) - T (1) : zval;
+}
+
 template <class T>
 inline void
 Frustum<T>::setExc (T nearPlane, T farPlane, T fovx, T fovy, T aspect)
@@ -382,11 +524,11 @@ Frustum<T>::projectionMatrixExc() const
     {
         T tx = -rightPlusLeft / rightMinusLeft;
         T ty = -topPlusBottom / topMinusBottom;
-        T tz = -farPlusNear / farMinusNear;
 
         if ((abs (rightMinusLeft) < T (1) && T (2) > limits<T>::max() * abs (rightMinusLeft)) ||
             (abs (topMinusBottom) < T (1) && T (2) > limits<T>::max() * abs (topMinusBottom)) ||
-            (abs (farMinusNear) < T (1) && T (2) > limits<T>::max() * abs (farMinusNear)))
+            (abs (farMinusNear) < T (1) && T (2) > limits<T>::max() * abs (farMinusNear)) ||
+            infiniteFarPlane())
         {
             throw std::domain_error ("Bad viewing frustum: "
                                      "projection matrix cannot be computed.");
@@ -394,15 +536,16 @@ Frustum<T>::projectionMatrixExc() const
 
         T A = T (2) / rightMinusLeft;
         T B = T (2) / topMinusBottom;
-        T C = T (-2) / farMinusNear;
 
-        return Matrix44<T> (A, 0, 0, 0, 0, B, 0, 0, 0, 0, C, 0, tx, ty, tz, 1.f);
+        T C, D;
+        depthCoefficients (C, D);
+
+        return Matrix44<T> (A, 0, 0, 0, 0, B, 0, 0, 0, 0, C, 0, tx, ty, D, 1.f);
     }
     else
     {
         T A = rightPlusLeft / rightMinusLeft;
         T B = topPlusBottom / topMinusBottom;
-        T C = -farPlusNear / farMinusNear;
 
         T farTimesNear = T (-2) * _farPlane * _nearPlane;
         if (abs (farMinusNear) < T (1) && abs (farTimesNear) > limits<T>::max() * abs (farMinusNear))
@@ -411,7 +554,8 @@ Frustum<T>::projectionMatrixExc() const
                                      "projection matrix cannot be computed.");
         }
 
-        T D = farTimesNear / farMinusNear;
+        T C, D;
+        depthCoefficients (C, D);
 
         T twoTimesNear = T (2) * _nearPlane;
 
@@ -441,30 +585,23 @@ Frustum<T>::projectionMatrix() const noexcept
     T topPlusBottom  = _top + _bottom;
     T topMinusBottom = _top - _bottom;
 
-    T farPlusNear  = _farPlane + _nearPlane;
-    T farMinusNear = _farPlane - _nearPlane;
+    T C, D;
+    depthCoefficients (C, D);
 
     if (_orthographic)
     {
         T tx = -rightPlusLeft / rightMinusLeft;
         T ty = -topPlusBottom / topMinusBottom;
-        T tz = -farPlusNear / farMinusNear;
 
         T A = T (2) / rightMinusLeft;
         T B = T (2) / topMinusBottom;
-        T C = T (-2) / farMinusNear;
 
-        return Matrix44<T> (A, 0, 0, 0, 0, B, 0, 0, 0, 0, C, 0, tx, ty, tz, 1.f);
+        return Matrix44<T> (A, 0, 0, 0, 0, B, 0, 0, 0, 0, C, 0, tx, ty, D, 1.f);
     }
     else
     {
         T A = rightPlusLeft / rightMinusLeft;
         T B = topPlusBottom / topMinusBottom;
-        T C = -farPlusNear / farMinusNear;
-
-        T farTimesNear = T (-2) * _farPlane * _nearPlane;
-
-        T D = farTimesNear / farMinusNear;
 
         T twoTimesNear = T (2) * _nearPlane;
 
@@ -491,7 +628,9 @@ Frustum<T>::window (T l, T r, T t, T b) const noexcept
     Vec2<T> bl = screenToLocal (Vec2<T> (l, b));
     Vec2<T> tr = screenToLocal (Vec2<T> (r, t));
 
-    return Frustum<T> (_nearPlane, _farPlane, bl.x, tr.x, tr.y, bl.y, _orthographic);
+    Frustum<T> f (_nearPlane, _farPlane, bl.x, tr.x, tr.y, bl.y, _orthographic);
+    f.setDepthRange (_depthRange);
+    return f;
 }
 
 template <class T>
@@ -599,20 +738,41 @@ Frustum<T>::ZToDepth (long zval, long zmin, long zmax) const noexcept
     return normalizedZToDepth (fzval);
 }
 
+//
+//  The depth conversions invert the depth row of the projection
+//  matrix. They are written so that for the default depth range they
+//  round exactly like the OpenGL formulas they generalize.
+//
+
 template <class T>
 IMATH_CONSTEXPR14 T
 Frustum<T>::normalizedZToDepthExc (T zval) const
 {
-    T Zp = zval * T (2) - T (1);
+    T Zp = normalizedZToNdc (zval);
+    T dn = 0, df = 0;
+    depthBounds (dn, df);
 
     if (_orthographic)
     {
-        return -(Zp * (_farPlane - _nearPlane) + (_farPlane + _nearPlane)) / T (2);
+        return (Zp * (_farPlane - _nearPlane) + (df * _nearPlane - dn * _farPlane)) / (dn - df);
+    }
+    else if (infiniteFarPlane())
+    {
+        T farTimesNear = (df - dn) * _nearPlane;
+        T farMinusNear = Zp - df;
+
+        if (abs (farMinusNear) < 1 && abs (farTimesNear) > limits<T>::max() * abs (farMinusNear))
+        {
+            throw std::domain_error ("Frustum::normalizedZToDepth cannot be computed: "
+                                     "the depth is at the infinite far plane");
+        }
+
+        return farTimesNear / farMinusNear;
     }
     else
     {
-        T farTimesNear = 2 * _farPlane * _nearPlane;
-        T farMinusNear = Zp * (_farPlane - _nearPlane) - _farPlane - _nearPlane;
+        T farTimesNear = (df - dn) * _farPlane * _nearPlane;
+        T farMinusNear = Zp * (_farPlane - _nearPlane) - df * _farPlane + dn * _nearPlane;
 
         if (abs (farMinusNear) < 1 && abs (farTimesNear) > limits<T>::max() * abs (farMinusNear))
         {
@@ -629,31 +789,59 @@ template <class T>
 IMATH_CONSTEXPR14 T
 Frustum<T>::normalizedZToDepth (T zval) const noexcept
 {
-    T Zp = zval * T (2) - T (1);
+    T Zp = normalizedZToNdc (zval);
+    T dn = 0, df = 0;
+    depthBounds (dn, df);
 
     if (_orthographic)
     {
-        return -(Zp * (_farPlane - _nearPlane) + (_farPlane + _nearPlane)) / T (2);
+        return (Zp * (_farPlane - _nearPlane) + (df * _nearPlane - dn * _farPlane)) / (dn - df);
+    }
+    else if (infiniteFarPlane())
+    {
+        return (df - dn) * _nearPlane / (Zp - df);
     }
     else
     {
-        T farTimesNear = 2 * _farPlane * _nearPlane;
-        T farMinusNear = Zp * (_farPlane - _nearPlane) - _farPlane - _nearPlane;
+        T farTimesNear = (df - dn) * _farPlane * _nearPlane;
+        T farMinusNear = Zp * (_farPlane - _nearPlane) - df * _farPlane + dn * _nearPlane;
 
         return farTimesNear / farMinusNear;
     }
 }
 
+//
+//  Map a depth in normalized device coordinates to [zmin,zmax]. The
+//  product is computed in double, so that a float depth keeps the
+//  precision of a large range of z values. Not part of the public
+//  interface.
+//
+
+template <class T>
+IMATH_CONSTEXPR14 inline long
+ndcToZ (T Zp, bool negativeOneToOne, long zmin, long zmax) noexcept
+{
+    long zdiff = zmax - zmin;
+
+    if (negativeOneToOne)
+        return long (0.5 * (double (Zp) + 1) * zdiff) + zmin;
+    else
+        return long (double (Zp) * zdiff) + zmin;
+}
+
 template <class T>
 IMATH_CONSTEXPR14 long
 Frustum<T>::DepthToZExc (T depth, long zmin, long zmax) const
 {
-    long zdiff     = zmax - zmin;
     T farMinusNear = _farPlane - _nearPlane;
+    T dn = 0, df = 0;
+    depthBounds (dn, df);
+
+    bool negativeOneToOne = _depthRange == DEPTH_NEGATIVE_ONE_TO_ONE;
 
     if (_orthographic)
     {
-        T farPlusNear = T (2) * depth + _farPlane + _nearPlane;
+        T farPlusNear = (df - dn) * depth - dn * _farPlane + df * _nearPlane;
 
         if (abs (farMinusNear) < T (1) && abs (farPlusNear) > limits<T>::max() * abs (farMinusNear))
         {
@@ -663,20 +851,24 @@ Frustum<T>::DepthToZExc (T depth, long zmin, long zmax) const
         }
 
         T Zp = -farPlusNear / farMinusNear;
-        return long (0.5 * (Zp + 1) * zdiff) + zmin;
+        return ndcToZ (Zp, negativeOneToOne, zmin, zmax);
     }
     else
     {
         // Perspective
 
-        T farTimesNear = T (2) * _farPlane * _nearPlane;
+        T farTimesNear = infiniteFarPlane() ? (df - dn) * _nearPlane
+                                            : (df - dn) * _farPlane * _nearPlane;
         if (abs (depth) < T (1) && abs (farTimesNear) > limits<T>::max() * abs (depth))
         {
             throw std::domain_error ("Bad call to DepthToZ function: "
                                      "value of `depth' is too small");
         }
 
-        T farPlusNear = farTimesNear / depth + _farPlane + _nearPlane;
+        if (infiniteFarPlane())
+            return ndcToZ (farTimesNear / depth + df, negativeOneToOne, zmin, zmax);
+
+        T farPlusNear = farTimesNear / depth + df * _farPlane - dn * _nearPlane;
         if (abs (farMinusNear) < T (1) && abs (farPlusNear) > limits<T>::max() * abs (farMinusNear))
         {
             throw std::domain_error ("Bad viewing frustum: "
@@ -685,7 +877,7 @@ Frustum<T>::DepthToZExc (T depth, long zmin, long zmax) const
         }
 
         T Zp = farPlusNear / farMinusNear;
-        return long (0.5 * (Zp + 1) * zdiff) + zmin;
+        return ndcToZ (Zp, negativeOneToOne, zmin, zmax);
     }
 }
 
@@ -693,26 +885,34 @@ template <class T>
 IMATH_CONSTEXPR14 long
 Frustum<T>::DepthToZ (T depth, long zmin, long zmax) const noexcept
 {
-    long zdiff     = zmax - zmin;
     T farMinusNear = _farPlane - _nearPlane;
+    T dn = 0, df = 0;
+    depthBounds (dn, df);
+
+    bool negativeOneToOne = _depthRange == DEPTH_NEGATIVE_ONE_TO_ONE;
 
     if (_orthographic)
     {
-        T farPlusNear = T (2) * depth + _farPlane + _nearPlane;
+        T farPlusNear = (df - dn) * depth - dn * _farPlane + df * _nearPlane;
 
         T Zp = -farPlusNear / farMinusNear;
-        return long (0.5 * (Zp + 1) * zdiff) + zmin;
+        return ndcToZ (Zp, negativeOneToOne, zmin, zmax);
+    }
+    else if (infiniteFarPlane())
+    {
+        T Zp = (df - dn) * _nearPlane / depth + df;
+        return ndcToZ (Zp, negativeOneToOne, zmin, zmax);
     }
     else
     {
         // Perspective
 
-        T farTimesNear = T (2) * _farPlane * _nearPlane;
+        T farTimesNear = (df - dn) * _farPlane * _nearPlane;
 
-        T farPlusNear = farTimesNear / depth + _farPlane + _nearPlane;
+        T farPlusNear = farTimesNear / depth + df * _farPlane - dn * _nearPlane;
 
         T Zp = farPlusNear / farMinusNear;
-        return long (0.5 * (Zp + 1) * zdiff) + zmin;
+        return ndcToZ (Zp, negativeOneToOne, zmin, zmax);
     }
 }
 
@@ -782,6 +982,140 @@ Frustum<T>::worldRadius (const Vec3<T>& p, T radius) const noexcept
     return radius * (p.z / -_nearPlane);
 }
 
+template <class T>
+void
+Frustum<T>::projectPointToScreenN (const Vec3<T>* points, size_t n, Vec2<T>* result) const noexcept
+{
+    //
+    // localToScreen() is a scale and an offset. For perspective
+    // projections, the scale includes _nearPlane, and each point is
+    // multiplied by -1/z, or by 1/_nearPlane where z is 0, so that the
+    // point is used as it is, as in projectPointToScreen().
+    //
+
+    const T sx = T (2) / (_right - _left);
+    const T sy = T (2) / (_top - _bottom);
+    const T ox = -(_right + _left) / (_right - _left);
+    const T oy = -(_top + _bottom) / (_top - _bottom);
+
+    if (_orthographic)
+    {
+        for (size_t i = 0; i < n; ++i)
+            result[i] = Vec2<T> (points[i].x * sx + ox, points[i].y * sy + oy);
+    }
+    else
+    {
+        const T psx       = sx * _nearPlane;
+        const T psy       = sy * _nearPlane;
+        const T nearPlane = _nearPlane;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T z       = points[i].z != T (0) ? points[i].z : -nearPlane;
+            T w       = T (-1) / z;
+            result[i] = Vec2<T> (points[i].x * w * psx + ox, points[i].y * w * psy + oy);
+        }
+    }
+}
+
+//
+// The rays of projectScreenToRayN() are computed by rayFromScreen(),
+// which is not part of the public interface, and stored by the
+// caller's Store function. (With gcc, vectorizing the perspective
+// loop, which normalizes the directions with std::sqrt(), requires
+// -fno-math-errno.)
+//
+
+template <class T, class Store>
+inline void
+rayFromScreen (const Frustum<T>& f, const Vec2<T>* points, size_t n, Store store) noexcept
+{
+    // screenToLocal() as a scale and an offset
+
+    const T sx = (f.right() - f.left()) * T (0.5);
+    const T sy = (f.top() - f.bottom()) * T (0.5);
+    const T ox = f.left() + sx;
+    const T oy = f.bottom() + sy;
+
+    if (f.orthographic())
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            T x = points[i].x * sx + ox;
+            T y = points[i].y * sy + oy;
+            store (i, x, y, T (0), T (0), T (0), T (-1));
+        }
+    }
+    else
+    {
+        const T z  = -f.nearPlane();
+        const T z2 = z * z;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T x = points[i].x * sx + ox;
+            T y = points[i].y * sy + oy;
+            T s = T (1) / std::sqrt (x * x + y * y + z2);
+            store (i, T (0), T (0), T (0), x * s, y * s, z * s);
+        }
+    }
+}
+
+template <class T>
+void
+Frustum<T>::projectScreenToRayN (const Vec2<T>* points, size_t n, Line3<T>* rays) const noexcept
+{
+    rayFromScreen (*this, points, n, [rays] (size_t i, T px, T py, T pz, T dx, T dy, T dz) {
+        rays[i].pos = Vec3<T> (px, py, pz);
+        rays[i].dir = Vec3<T> (dx, dy, dz);
+    });
+}
+
+template <class T>
+void
+Frustum<T>::projectScreenToRayN (const Vec2<T>* points,
+                                 size_t n,
+                                 const Line3SoA<T>& rays) const noexcept
+{
+    T* posX = rays.posX;
+    T* posY = rays.posY;
+    T* posZ = rays.posZ;
+    T* dirX = rays.dirX;
+    T* dirY = rays.dirY;
+    T* dirZ = rays.dirZ;
+
+    rayFromScreen (*this, points, n, [=] (size_t i, T px, T py, T pz, T dx, T dy, T dz) {
+        posX[i] = px;
+        posY[i] = py;
+        posZ[i] = pz;
+        dirX[i] = dx;
+        dirY[i] = dy;
+        dirZ[i] = dz;
+    });
+}
+
+template <class T>
+void
+Frustum<T>::worldRadiusN (const Vec3<T>* points, const T* radii, size_t n, T* result) const
+    noexcept
+{
+    const T s = T (-1) / _nearPlane;
+
+    for (size_t i = 0; i < n; ++i)
+        result[i] = radii[i] * (points[i].z * s);
+}
+
+template <class T>
+void
+Frustum<T>::screenRadiusN (const Vec3<T>* points, const T* radii, size_t n, T* result) const
+    noexcept
+{
+    const T nearPlane = _nearPlane;
+
+    for (size_t i = 0; i < n; ++i)
+        result[i] = radii[i] * (-nearPlane / points[i].z);
+}
+
 template <class T>
 void
 Frustum<T>::planes (Plane3<T> p[6]) const noexcept
@@ -845,6 +1179,15 @@ Frustum<T>::planes (Plane3<T> p[6], const Matrix44<T>& M) const noexcept
         p[3].set (o, b, a);
         p[4].set (a, d, c);
         p[5].set (e, f, g);
+
+        if (infiniteFarPlane())
+        {
+            // The far corners are at infinity; the far plane, parallel
+            // to the near plane, contains every point.
+
+            p[5].normal   = -p[4].normal;
+            p[5].distance = _farPlane;
+        }
     }
     else
     {
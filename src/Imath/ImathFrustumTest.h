@@ -21,6 +21,10 @@
 #include "ImathNamespace.h"
 #include "ImathSphere.h"
 #include "ImathVec.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -57,6 +61,15 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 //    myFrustumTest.completelyContains(myBox)
 //    myFrustumTest.completelyContains(mySphere)
 //
+// To test a hierarchy of bounds, classify each node, and pass the
+// planes that the node straddles on to its children:
+//    unsigned int planeMask = FrustumTest<T>::ALL_PLANES;
+//    myFrustumTest.classify(myBox, planeMask, myBoxLastPlane)
+//
+// To test many objects at once, store their bounds in arrays and call:
+//    myFrustumTest.isVisibleN(myBoxes, n, myVisibleMask)
+//    myFrustumTest.classifyN(myBoxes, n, myVisibleMask, myContainedMask)
+//
 
 //////////////////////////////////////////////////////////////////
 // Explanation of how it works
@@ -78,6 +91,11 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 //         false-negatives.)
 //
 //
+// Arrays: The *N() functions test blocks of 64 shapes, with the same
+//         arithmetic as the single-shape tests, so the results match
+//         bit for bit. The loops over a block have no branches and
+//         are written for the compiler to vectorize.
+//
 // SPECIAL NOTE: "Where are the dot products?"
 //     Actual dot products are currently slow for most SIMD architectures.
 //     In order to keep this code optimization-ready, the dot products
@@ -90,6 +108,27 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 template <class T> class FrustumTest
 {
   public:
+    //
+    // Results of classify()
+    //
+
+    enum Classification
+    {
+        OUTSIDE,    // entirely outside the frustum
+        INTERSECTS, // straddles one or more planes
+        INSIDE      // entirely inside the frustum
+    };
+
+    //
+    // Plane masks: bit i stands for plane i, in the order of
+    // Frustum::planes() (top, right, bottom, left, near, far).
+    //
+
+    enum
+    {
+        ALL_PLANES = 0x3f
+    };
+
     FrustumTest() noexcept
     {
         Frustum<T> frust;
@@ -121,6 +160,77 @@ template <class T> class FrustumTest
     bool completelyContains (const Sphere3<T>& sphere) const noexcept;
     bool completelyContains (const Box<Vec3<T>>& box) const noexcept;
 
+    ////////////////////////////////////////////////////////////////////
+    // classify()
+    // Classify shapes as OUTSIDE, INTERSECTS or INSIDE in one test.
+    // OUTSIDE matches !isVisible() and INSIDE matches
+    // completelyContains().
+    //
+    // Only the planes in planeMask are tested; the shape is assumed
+    // to be inside the others. Unless the result is OUTSIDE, planeMask
+    // is set to the planes that the shape straddles, which is zero for
+    // INSIDE. The children of a node in a bounding volume hierarchy
+    // lie inside their parent, so they need only be tested against
+    // the planes the parent straddles.
+    //
+    // lastPlane, from 0 to 5, is tested first; when a plane rejects
+    // the shape, lastPlane is set to it. Storing lastPlane with each
+    // node makes rejections of slowly moving objects cost a single
+    // plane test in most frames. Values outside 0 to 5, for instance
+    // from uninitialized storage, are taken as 0.
+    Classification classify (const Box<Vec3<T>>& box) const noexcept;
+    Classification classify (const Sphere3<T>& sphere) const noexcept;
+
+    Classification classify (const Box<Vec3<T>>& box, unsigned int& planeMask) const noexcept;
+    Classification classify (const Sphere3<T>& sphere, unsigned int& planeMask) const noexcept;
+
+    Classification
+    classify (const Box<Vec3<T>>& box, unsigned int& planeMask, int& lastPlane) const noexcept;
+    Classification
+    classify (const Sphere3<T>& sphere, unsigned int& planeMask, int& lastPlane) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // isVisibleN(), completelyContainsN(), classifyN()
+    // Test n shapes, given in structure-of-arrays layout or as arrays
+    // of Box or Sphere3. The result of isVisible() or
+    // completelyContains() for the i-th shape is stored in bit
+    // (i % 64) of mask[i / 64]. Each mask must hold (n + 63) / 64
+    // words; the unused bits of the last word are cleared.
+    // classifyN() computes both results in one pass.
+    //
+    // Calls on ranges that start at multiples of 64 write separate
+    // words of the masks, so a large array can be split between
+    // threads.
+    void isVisibleN (const Box3SoA<const T>& boxes, size_t n, uint64_t* mask) const noexcept;
+    void isVisibleN (const Box<Vec3<T>>* boxes, size_t n, uint64_t* mask) const noexcept;
+    void isVisibleN (const Sphere3SoA<const T>& spheres, size_t n, uint64_t* mask) const noexcept;
+    void isVisibleN (const Sphere3<T>* spheres, size_t n, uint64_t* mask) const noexcept;
+
+    void
+    completelyContainsN (const Box3SoA<const T>& boxes, size_t n, uint64_t* mask) const noexcept;
+    void completelyContainsN (const Box<Vec3<T>>* boxes, size_t n, uint64_t* mask) const noexcept;
+    void completelyContainsN (const Sphere3SoA<const T>& spheres,
+                              size_t n,
+                              uint64_t* mask) const noexcept;
+    void completelyContainsN (const Sphere3<T>* spheres, size_t n, uint64_t* mask) const noexcept;
+
+    void classifyN (const Box3SoA<const T>& boxes,
+                    size_t n,
+                    uint64_t* visible,
+                    uint64_t* contained) const noexcept;
+    void classifyN (const Box<Vec3<T>>* boxes,
+                    size_t n,
+                    uint64_t* visible,
+                    uint64_t* contained) const noexcept;
+    void classifyN (const Sphere3SoA<const T>& spheres,
+                    size_t n,
+                    uint64_t* visible,
+                    uint64_t* contained) const noexcept;
+    void classifyN (const Sphere3<T>* spheres,
+                    size_t n,
+                    uint64_t* visible,
+                    uint64_t* contained) const noexcept;
+
     // These next items are kept primarily for debugging tools.
     // It's useful for drawing the culling environment, and also
     // for getting an "outside view" of the culling frustum.
@@ -144,6 +254,68 @@ template <class T> class FrustumTest
     // These are kept primarily for debugging tools.
     Frustum<T> currFrustum;
     Matrix44<T> cameraMatrix;
+
+  private:
+    // The array tests work on blocks of this many shapes, one mask
+    // word per block.
+    static constexpr size_t blockSize = 64;
+
+    // Test one plane: 0 if the shape is inside, 1 if it straddles
+    // the plane, and 2 if it is outside.
+    int testPlane (int i, const Vec3<T>& center, const Vec3<T>& extent) const noexcept;
+    int testPlane (int i, const Vec3<T>& center, T radius) const noexcept;
+
+    template <class Extent>
+    Classification classifyCenter (const Vec3<T>& center,
+                                   const Extent& extent,
+                                   unsigned int& planeMask,
+                                   int& lastPlane) const noexcept;
+
+    void planeArrays (T nx[6], T ny[6], T nz[6], T ax[6], T ay[6], T az[6], T offset[6])
+        const noexcept;
+
+    template <bool Visible, bool Contained, class Boxes>
+    void testBoxesN (const Boxes& boxes, size_t n, uint64_t* visible, uint64_t* contained)
+        const noexcept;
+
+    template <bool Visible, bool Contained, class Spheres>
+    void testSpheresN (const Spheres& spheres, size_t n, uint64_t* visible, uint64_t* contained)
+        const noexcept;
+
+    static void loadBlock (const Box3SoA<const T>& boxes,
+                           size_t i,
+                           size_t m,
+                           T minX[],
+                           T minY[],
+                           T minZ[],
+                           T maxX[],
+                           T maxY[],
+                           T maxZ[]) noexcept;
+    static void loadBlock (const Box<Vec3<T>>* boxes,
+                           size_t i,
+                           size_t m,
+                           T minX[],
+                           T minY[],
+                           T minZ[],
+                           T maxX[],
+                           T maxY[],
+                           T maxZ[]) noexcept;
+    static void loadBlock (const Sphere3SoA<const T>& spheres,
+                           size_t i,
+                           size_t m,
+                           T x[],
+                           T y[],
+                           T z[],
+                           T radius[]) noexcept;
+    static void loadBlock (const Sphere3<T>* spheres,
+                           size_t i,
+                           size_t m,
+                           T x[],
+                           T y[],
+                           T z[],
+                           T radius[]) noexcept;
+
+    static uint64_t packMask (const int rejected[], size_t m) noexcept;
 };
 
 ////////////////////////////////////////////////////////////////////
@@ -341,9 +513,745 @@ FrustumTest<T>::isVisible (const Vec3<T>& vec) const noexcept
     return true;
 }
 
+////////////////////////////////////////////////////////////////////
+// classify()
+//
+
+template <typename T>
+inline int
+FrustumTest<T>::testPlane (int i, const Vec3<T>& center, const Vec3<T>& extent) const noexcept
+{
+    // The same expressions as isVisible(Box) and completelyContains(Box)
+
+    const int k = i / 3;
+    const int c = i % 3;
+
+    T d = planeNormX[k][c] * center.x + planeNormY[k][c] * center.y + planeNormZ[k][c] * center.z;
+
+    if (d - planeNormAbsX[k][c] * extent.x - planeNormAbsY[k][c] * extent.y -
+            planeNormAbsZ[k][c] * extent.z - planeOffsetVec[k][c] >=
+        0)
+        return 2;
+
+    if (d + planeNormAbsX[k][c] * extent.x + planeNormAbsY[k][c] * extent.y +
+            planeNormAbsZ[k][c] * extent.z - planeOffsetVec[k][c] >=
+        0)
+        return 1;
+
+    return 0;
+}
+
+template <typename T>
+inline int
+FrustumTest<T>::testPlane (int i, const Vec3<T>& center, T radius) const noexcept
+{
+    // The same expressions as isVisible(Sphere) and
+    // completelyContains(Sphere)
+
+    const int k = i / 3;
+    const int c = i % 3;
+
+    T d = planeNormX[k][c] * center.x + planeNormY[k][c] * center.y + planeNormZ[k][c] * center.z;
+
+    if (d - radius - planeOffsetVec[k][c] >= 0)
+        return 2;
+
+    if (d + radius - planeOffsetVec[k][c] >= 0)
+        return 1;
+
+    return 0;
+}
+
+template <typename T>
+template <class Extent>
+typename FrustumTest<T>::Classification
+FrustumTest<T>::classifyCenter (const Vec3<T>& center,
+                                const Extent& extent,
+                                unsigned int& planeMask,
+                                int& lastPlane) const noexcept
+{
+    unsigned int straddled = 0;
+
+    // The plane that rejected the shape last time is most likely to
+    // reject it again. Shifting by a plane outside 0 to 5 would be
+    // undefined.
+
+    if (lastPlane < 0 || lastPlane > 5)
+        lastPlane = 0;
+
+    if (planeMask & (1u << lastPlane))
+    {
+        int r = testPlane (lastPlane, center, extent);
+
+        if (r == 2)
+            return OUTSIDE;
+
+        straddled |= unsigned (r) << lastPlane;
+    }
+
+    for (int i = 0; i < 6; ++i)
+    {
+        if (i == lastPlane || !(planeMask & (1u << i)))
+            continue;
+
+        int r = testPlane (i, center, extent);
+
+        if (r == 2)
+        {
+            lastPlane = i;
+            return OUTSIDE;
+        }
+
+        straddled |= unsigned (r) << i;
+    }
+
+    planeMask = straddled;
+    return straddled ? INTERSECTS : INSIDE;
+}
+
+template <typename T>
+typename FrustumTest<T>::Classification
+FrustumTest<T>::classify (const Box<Vec3<T>>& box,
+                          unsigned int& planeMask,
+                          int& lastPlane) const noexcept
+{
+    if (box.isEmpty())
+        return OUTSIDE;
+
+    Vec3<T> center = (box.min + box.max) / 2;
+    Vec3<T> extent = (box.max - center);
+
+    return classifyCenter (center, extent, planeMask, lastPlane);
+}
+
+template <typename T>
+typename FrustumTest<T>::Classification
+FrustumTest<T>::classify (const Sphere3<T>& sphere,
+                          unsigned int& planeMask,
+                          int& lastPlane) const noexcept
+{
+    return classifyCenter (sphere.center, sphere.radius, planeMask, lastPlane);
+}
+
+template <typename T>
+typename FrustumTest<T>::Classification
+FrustumTest<T>::classify (const Box<Vec3<T>>& box, unsigned int& planeMask) const noexcept
+{
+    int lastPlane = 0;
+    return classify (box, planeMask, lastPlane);
+}
+
+template <typename T>
+typename FrustumTest<T>::Classification
+FrustumTest<T>::classify (const Sphere3<T>& sphere, unsigned int& planeMask) const noexcept
+{
+    int lastPlane = 0;
+    return classify (sphere, planeMask, lastPlane);
+}
+
+template <typename T>
+typename FrustumTest<T>::Classification
+FrustumTest<T>::classify (const Box<Vec3<T>>& box) const noexcept
+{
+    unsigned int planeMask = ALL_PLANES;
+    return classify (box, planeMask);
+}
+
+template <typename T>
+typename FrustumTest<T>::Classification
+FrustumTest<T>::classify (const Sphere3<T>& sphere) const noexcept
+{
+    unsigned int planeMask = ALL_PLANES;
+    return classify (sphere, planeMask);
+}
+
+////////////////////////////////////////////////////////////////////
+// The array tests
+//
+
+template <typename T>
+void
+FrustumTest<T>::planeArrays (T nx[6], T ny[6], T nz[6], T ax[6], T ay[6], T az[6], T offset[6])
+    const noexcept
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            nx[i * 3 + j]     = planeNormX[i][j];
+            ny[i * 3 + j]     = planeNormY[i][j];
+            nz[i * 3 + j]     = planeNormZ[i][j];
+            ax[i * 3 + j]     = planeNormAbsX[i][j];
+            ay[i * 3 + j]     = planeNormAbsY[i][j];
+            az[i * 3 + j]     = planeNormAbsZ[i][j];
+            offset[i * 3 + j] = planeOffsetVec[i][j];
+        }
+    }
+}
+
+template <typename T>
+inline void
+FrustumTest<T>::loadBlock (const Box3SoA<const T>& boxes,
+                           size_t i,
+                           size_t m,
+                           T minX[],
+                           T minY[],
+                           T minZ[],
+                           T maxX[],
+                           T maxY[],
+                           T maxZ[]) noexcept
+{
+    std::copy (boxes.minX + i, boxes.minX + i + m, minX);
+    std::copy (boxes.minY + i, boxes.minY + i + m, minY);
+    std::copy (boxes.minZ + i, boxes.minZ + i + m, minZ);
+    std::copy (boxes.maxX + i, boxes.maxX + i + m, maxX);
+    std::copy (boxes.maxY + i, boxes.maxY + i + m, maxY);
+    std::copy (boxes.maxZ + i, boxes.maxZ + i + m, maxZ);
+}
+
+template <typename T>
+inline void
+FrustumTest<T>::loadBlock (const Box<Vec3<T>>* boxes,
+                           size_t i,
+                           size_t m,
+                           T minX[],
+                           T minY[],
+                           T minZ[],
+                           T maxX[],
+                           T maxY[],
+                           T maxZ[]) noexcept
+{
+    for (size_t j = 0; j < m; ++j)
+    {
+        const Box<Vec3<T>>& box = boxes[i + j];
+        minX[j]                 = box.min.x;
+        minY[j]                 = box.min.y;
+        minZ[j]                 = box.min.z;
+        maxX[j]                 = box.max.x;
+        maxY[j]                 = box.max.y;
+        maxZ[j]                 = box.max.z;
+    }
+}
+
+template <typename T>
+inline void
+FrustumTest<T>::loadBlock (const Sphere3SoA<const T>& spheres,
+                           size_t i,
+                           size_t m,
+                           T x[],
+                           T y[],
+                           T z[],
+                           T radius[]) noexcept
+{
+    std::copy (spheres.x + i, spheres.x + i + m, x);
+    std::copy (spheres.y + i, spheres.y + i + m, y);
+    std::copy (spheres.z + i, spheres.z + i + m, z);
+    std::copy (spheres.radius + i, spheres.radius + i + m, radius);
+}
+
+template <typename T>
+inline void
+FrustumTest<T>::loadBlock (const Sphere3<T>* spheres,
+                           size_t i,
+                           size_t m,
+                           T x[],
+                           T y[],
+                           T z[],
+                           T radius[]) noexcept
+{
+    for (size_t j = 0; j < m; ++j)
+    {
+        const Sphere3<T>& sphere = spheres[i + j];
+        x[j]                     = sphere.center.x;
+        y[j]                     = sphere.center.y;
+        z[j]                     = sphere.center.z;
+        radius[j]                = sphere.radius;
+    }
+}
+
+template <typename T>
+inline uint64_t
+FrustumTest<T>::packMask (const int rejected[], size_t m) noexcept
+{
+    uint64_t mask = 0;
+
+    for (size_t j = 0; j < m; ++j)
+        mask |= uint64_t (rejected[j] == 0) << j;
+
+    return mask;
+}
+
+//
+// The box tests compute, for each plane, the same expressions as
+// isVisible(Box) and completelyContains(Box). A box is rejected
+// if it is empty or if the expression is >= 0 for any plane.
+//
+
+template <typename T>
+template <bool Visible, bool Contained, class Boxes>
+void
+FrustumTest<T>::testBoxesN (const Boxes& boxes, size_t n, uint64_t* visible, uint64_t* contained)
+    const noexcept
+{
+    T nx[6], ny[6], nz[6], ax[6], ay[6], az[6], offset[6];
+    planeArrays (nx, ny, nz, ax, ay, az, offset);
+
+    for (size_t i = 0; i < n; i += blockSize)
+    {
+        const size_t m = std::min (n - i, size_t (blockSize));
+
+        T minX[blockSize], minY[blockSize], minZ[blockSize];
+        T maxX[blockSize], maxY[blockSize], maxZ[blockSize];
+        loadBlock (boxes, i, m, minX, minY, minZ, maxX, maxY, maxZ);
+
+        int outside[blockSize], notInside[blockSize];
+
+        for (size_t j = 0; j < m; ++j)
+        {
+            T cx = (minX[j] + maxX[j]) / T (2);
+            T cy = (minY[j] + maxY[j]) / T (2);
+            T cz = (minZ[j] + maxZ[j]) / T (2);
+            T ex = maxX[j] - cx;
+            T ey = maxY[j] - cy;
+            T ez = maxZ[j] - cz;
+
+            int empty = (maxX[j] < minX[j]) | (maxY[j] < minY[j]) | (maxZ[j] < minZ[j]);
+            int out   = empty;
+            int notIn = empty;
+
+            for (int p = 0; p < 6; ++p)
+            {
+                T d = nx[p] * cx + ny[p] * cy + nz[p] * cz;
+
+                if (Visible)
+                    out |= d - ax[p] * ex - ay[p] * ey - az[p] * ez - offset[p] >= 0;
+
+                if (Contained)
+                    notIn |= d + ax[p] * ex + ay[p] * ey + az[p] * ez - offset[p] >= 0;
+            }
+
+            outside[j]   = out;
+            notInside[j] = notIn;
+        }
+
+        if (Visible)
+            visible[i / blockSize] = packMask (outside, m);
+
+        if (Contained)
+            contained[i / blockSize] = packMask (notInside, m);
+    }
+}
+
+template <typename T>
+template <bool Visible, bool Contained, class Spheres>
+void
+FrustumTest<T>::testSpheresN (const Spheres& spheres,
+                              size_t n,
+                              uint64_t* visible,
+                              uint64_t* contained) const noexcept
+{
+    T nx[6], ny[6], nz[6], ax[6], ay[6], az[6], offset[6];
+    planeArrays (nx, ny, nz, ax, ay, az, offset);
+
+    for (size_t i = 0; i < n; i += blockSize)
+    {
+        const size_t m = std::min (n - i, size_t (blockSize));
+
+        T x[blockSize], y[blockSize], z[blockSize], radius[blockSize];
+        loadBlock (spheres, i, m, x, y, z, radius);
+
+        int outside[blockSize], notInside[blockSize];
+
+        for (size_t j = 0; j < m; ++j)
+        {
+            int out   = 0;
+            int notIn = 0;
+
+            for (int p = 0; p < 6; ++p)
+            {
+                T d = nx[p] * x[j] + ny[p] * y[j] + nz[p] * z[j];
+
+                if (Visible)
+                    out |= d - radius[j] - offset[p] >= 0;
+
+                if (Contained)
+                    notIn |= d + radius[j] - offset[p] >= 0;
+            }
+
+            outside[j]   = out;
+            notInside[j] = notIn;
+        }
+
+        if (Visible)
+            visible[i / blockSize] = packMask (outside, m);
+
+        if (Contained)
+            contained[i / blockSize] = packMask (notInside, m);
+    }
+}
+
+template <typename T>
+void
+FrustumTest<T>::isVisibleN (const Box3SoA<const T>& boxes, size_t n, uint64_t* mask) const noexcept
+{
+    testBoxesN<true, false> (boxes, n, mask, nullptr);
+}
+
+template <typename T>
+void
+FrustumTest<T>::isVisibleN (const Box<Vec3<T>>* boxes, size_t n, uint64_t* mask) const noexcept
+{
+    testBoxesN<true, false> (boxes, n, mask, nullptr);
+}
+
+template <typename T>
+void
+FrustumTest<T>::isVisibleN (const Sphere3SoA<const T>& spheres, size_t n, uint64_t* mask)
+    const noexcept
+{
+    testSpheresN<true, false> (spheres, n, mask, nullptr);
+}
+
+template <typename T>
+void
+FrustumTest<T>::isVisibleN (const Sphere3<T>* spheres, size_t n, uint64_t* mask) const noexcept
+{
+    testSpheresN<true, false> (spheres, n, mask, nullptr);
+}
+
+template <typename T>
+void
+FrustumTest<T>::completelyContainsN (const Box3SoA<const T>& boxes, size_t n, uint64_t* mask)
+    const noexcept
+{
+    testBoxesN<false, true> (boxes, n, nullptr, mask);
+}
+
+template <typename T>
+void
+FrustumTest<T>::completelyContainsN (const Box<Vec3<T>>* boxes, size_t n, uint64_t* mask)
+    const noexcept
+{
+    testBoxesN<false, true> (boxes, n, nullptr, mask);
+}
+
+template <typename T>
+void
+FrustumTest<T>::completelyContainsN (const Sphere3SoA<const T>& spheres,
+                                     size_t n,
+                                     uint64_t* mask) const noexcept
+{
+    testSpheresN<false, true> (spheres, n, nullptr, mask);
+}
+
+template <typename T>
+void
+FrustumTest<T>::completelyContainsN (const Sphere3<T>* spheres, size_t n, uint64_t* mask)
+    const noexcept
+{
+    testSpheresN<false, true> (spheres, n, nullptr, mask);
+}
+
+template <typename T>
+void
+FrustumTest<T>::classifyN (const Box3SoA<const T>& boxes,
+                           size_t n,
+                           uint64_t* visible,
+                           uint64_t* contained) const noexcept
+{
+    testBoxesN<true, true> (boxes, n, visible, contained);
+}
+
+template <typename T>
+void
+FrustumTest<T>::classifyN (const Box<Vec3<T>>* boxes,
+                           size_t n,
+                           uint64_t* visible,
+                           uint64_t* contained) const noexcept
+{
+    testBoxesN<true, true> (boxes, n, visible, contained);
+}
+
+template <typename T>
+void
+FrustumTest<T>::classifyN (const Sphere3SoA<const T>& spheres,
+                           size_t n,
+                           uint64_t* visible,
+                           uint64_t* contained) const noexcept
+{
+    testSpheresN<true, true> (spheres, n, visible, contained);
+}
+
+template <typename T>
+void
+FrustumTest<T>::classifyN (const Sphere3<T>* spheres,
+                           size_t n,
+                           uint64_t* visible,
+                           uint64_t* contained) const noexcept
+{
+    testSpheresN<true, true> (spheres, n, visible, contained);
+}
+
 typedef FrustumTest<float> FrustumTestf;
 typedef FrustumTest<double> FrustumTestd;
 
+/////////////////////////////////////////////////////////////////
+// MultiFrustumTest
+//
+//	template class MultiFrustumTest<T, N>
+//
+// Tests shapes against N frustums at once, for example the views of
+// cascaded shadow maps, stereo eyes or cube map faces. The result
+// is a mask with bit v set if the shape is visible in view v. N may
+// be from 1 to 64; the mask is the smallest unsigned type that holds
+// N bits.
+//
+// The planes are stored plane by plane, with the N views next to
+// each other, so that each shape is loaded once and tested against
+// all views with vector operations across the views. For each view
+// the arithmetic is that of FrustumTest, so bit v of the mask matches
+// FrustumTest::isVisible() for view v exactly.
+//
+
+template <class T, int N> class MultiFrustumTest
+{
+    static_assert (N >= 1 && N <= 64, "MultiFrustumTest holds from 1 to 64 views");
+
+  public:
+    typedef typename std::conditional<
+        N <= 8,
+        uint8_t,
+        typename std::conditional<
+            N <= 16,
+            uint16_t,
+            typename std::conditional<N <= 32, uint32_t, uint64_t>::type>::type>::type ViewMask;
+
+    static constexpr int numViews = N;
+
+    // Construct with the default Frustum and an identity camera
+    // matrix for all views.
+    MultiFrustumTest() noexcept;
+
+    MultiFrustumTest (const Frustum<T> frustums[N], const Matrix44<T> cameraMats[N]) noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // setFrustum()
+    // Update view v, from 0 to N-1.
+    void setFrustum (int v, const Frustum<T>& frustum, const Matrix44<T>& cameraMat) noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // isVisible()
+    // Return the mask of the views in which a shape is visible.
+    ViewMask isVisible (const Sphere3<T>& sphere) const noexcept;
+    ViewMask isVisible (const Box<Vec3<T>>& box) const noexcept;
+    ViewMask isVisible (const Vec3<T>& vec) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // isVisibleN()
+    // Store the view masks of n shapes in masks[0] to masks[n-1].
+    void isVisibleN (const Box3SoA<const T>& boxes, size_t n, ViewMask* masks) const noexcept;
+    void isVisibleN (const Box<Vec3<T>>* boxes, size_t n, ViewMask* masks) const noexcept;
+    void isVisibleN (const Sphere3SoA<const T>& spheres, size_t n, ViewMask* masks) const noexcept;
+    void isVisibleN (const Sphere3<T>* spheres, size_t n, ViewMask* masks) const noexcept;
+
+    // The frustum and camera matrix of view v, for debugging tools.
+    Matrix44<T> cameraMat (int v) const noexcept { return cameraMatrix[v]; }
+    Frustum<T> currentFrustum (int v) const noexcept { return currFrustum[v]; }
+
+  protected:
+    // planeNormX[p][v] is the X component of the normal of plane p of
+    // view v, and so on.
+    T planeNormX[6][N];
+    T planeNormY[6][N];
+    T planeNormZ[6][N];
+    T planeNormAbsX[6][N];
+    T planeNormAbsY[6][N];
+    T planeNormAbsZ[6][N];
+    T planeOffset[6][N];
+
+    Frustum<T> currFrustum[N];
+    Matrix44<T> cameraMatrix[N];
+
+  private:
+    ViewMask
+    boxMask (T minX, T minY, T minZ, T maxX, T maxY, T maxZ) const noexcept;
+    ViewMask sphereMask (T x, T y, T z, T radius) const noexcept;
+};
+
+template <class T, int N> MultiFrustumTest<T, N>::MultiFrustumTest() noexcept
+{
+    Frustum<T> frust;
+    Matrix44<T> cameraMat;
+
+    for (int v = 0; v < N; ++v)
+        setFrustum (v, frust, cameraMat);
+}
+
+template <class T, int N>
+MultiFrustumTest<T, N>::MultiFrustumTest (const Frustum<T> frustums[N],
+                                          const Matrix44<T> cameraMats[N]) noexcept
+{
+    for (int v = 0; v < N; ++v)
+        setFrustum (v, frustums[v], cameraMats[v]);
+}
+
+template <class T, int N>
+void
+MultiFrustumTest<T, N>::setFrustum (int v,
+                                    const Frustum<T>& frustum,
+                                    const Matrix44<T>& cameraMat) noexcept
+{
+    Plane3<T> frustumPlanes[6];
+    frustum.planes (frustumPlanes, cameraMat);
+
+    for (int p = 0; p < 6; ++p)
+    {
+        planeNormX[p][v]    = frustumPlanes[p].normal.x;
+        planeNormY[p][v]    = frustumPlanes[p].normal.y;
+        planeNormZ[p][v]    = frustumPlanes[p].normal.z;
+        planeNormAbsX[p][v] = std::abs (frustumPlanes[p].normal.x);
+        planeNormAbsY[p][v] = std::abs (frustumPlanes[p].normal.y);
+        planeNormAbsZ[p][v] = std::abs (frustumPlanes[p].normal.z);
+        planeOffset[p][v]   = frustumPlanes[p].distance;
+    }
+
+    currFrustum[v]  = frustum;
+    cameraMatrix[v] = cameraMat;
+}
+
+//
+// The loops over the views have no branches, for the compiler to
+// vectorize them.
+//
+
+template <class T, int N>
+inline typename MultiFrustumTest<T, N>::ViewMask
+MultiFrustumTest<T, N>::boxMask (T minX, T minY, T minZ, T maxX, T maxY, T maxZ) const noexcept
+{
+    if (maxX < minX || maxY < minY || maxZ < minZ)
+        return 0;
+
+    // The same expressions as FrustumTest::isVisible(Box)
+
+    T cx = (minX + maxX) / T (2);
+    T cy = (minY + maxY) / T (2);
+    T cz = (minZ + maxZ) / T (2);
+    T ex = maxX - cx;
+    T ey = maxY - cy;
+    T ez = maxZ - cz;
+
+    int outside[N] = {};
+
+    for (int p = 0; p < 6; ++p)
+    {
+        for (int v = 0; v < N; ++v)
+        {
+            T d = planeNormX[p][v] * cx + planeNormY[p][v] * cy + planeNormZ[p][v] * cz -
+                  planeNormAbsX[p][v] * ex - planeNormAbsY[p][v] * ey -
+                  planeNormAbsZ[p][v] * ez - planeOffset[p][v];
+
+            outside[v] |= d >= 0;
+        }
+    }
+
+    ViewMask mask = 0;
+
+    for (int v = 0; v < N; ++v)
+        mask |= ViewMask (outside[v] == 0) << v;
+
+    return mask;
+}
+
+template <class T, int N>
+inline typename MultiFrustumTest<T, N>::ViewMask
+MultiFrustumTest<T, N>::sphereMask (T x, T y, T z, T radius) const noexcept
+{
+    // The same expressions as FrustumTest::isVisible(Sphere)
+
+    int outside[N] = {};
+
+    for (int p = 0; p < 6; ++p)
+    {
+        for (int v = 0; v < N; ++v)
+        {
+            T d = planeNormX[p][v] * x + planeNormY[p][v] * y + planeNormZ[p][v] * z - radius -
+                  planeOffset[p][v];
+
+            outside[v] |= d >= 0;
+        }
+    }
+
+    ViewMask mask = 0;
+
+    for (int v = 0; v < N; ++v)
+        mask |= ViewMask (outside[v] == 0) << v;
+
+    return mask;
+}
+
+template <class T, int N>
+typename MultiFrustumTest<T, N>::ViewMask
+MultiFrustumTest<T, N>::isVisible (const Sphere3<T>& sphere) const noexcept
+{
+    return sphereMask (sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius);
+}
+
+template <class T, int N>
+typename MultiFrustumTest<T, N>::ViewMask
+MultiFrustumTest<T, N>::isVisible (const Box<Vec3<T>>& box) const noexcept
+{
+    return boxMask (box.min.x, box.min.y, box.min.z, box.max.x, box.max.y, box.max.z);
+}
+
+template <class T, int N>
+typename MultiFrustumTest<T, N>::ViewMask
+MultiFrustumTest<T, N>::isVisible (const Vec3<T>& vec) const noexcept
+{
+    return sphereMask (vec.x, vec.y, vec.z, T (0));
+}
+
+template <class T, int N>
+void
+MultiFrustumTest<T, N>::isVisibleN (const Box3SoA<const T>& boxes, size_t n, ViewMask* masks)
+    const noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        masks[i] = boxMask (boxes.minX[i],
+                            boxes.minY[i],
+                            boxes.minZ[i],
+                            boxes.maxX[i],
+                            boxes.maxY[i],
+                            boxes.maxZ[i]);
+}
+
+template <class T, int N>
+void
+MultiFrustumTest<T, N>::isVisibleN (const Box<Vec3<T>>* boxes, size_t n, ViewMask* masks)
+    const noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        masks[i] = isVisible (boxes[i]);
+}
+
+template <class T, int N>
+void
+MultiFrustumTest<T, N>::isVisibleN (const Sphere3SoA<const T>& spheres,
+                                    size_t n,
+                                    ViewMask* masks) const noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        masks[i] = sphereMask (spheres.x[i], spheres.y[i], spheres.z[i], spheres.radius[i]);
+}
+
+template <class T, int N>
+void
+MultiFrustumTest<T, N>::isVisibleN (const Sphere3<T>* spheres, size_t n, ViewMask* masks)
+    const noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        masks[i] = isVisible (spheres[i]);
+}
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHFRUSTUMTEST_H
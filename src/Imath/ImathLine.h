@@ -16,6 +16,8 @@
 #include "ImathMatrix.h"
 #include "ImathNamespace.h"
 #include "ImathVec.h"
+#include <cstddef>
+#include <type_traits>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -149,6 +151,61 @@ operator* (const Line3<S>& line, const Matrix44<T>& M) noexcept
     return Line3<S> (line.pos * M, (line.pos + line.dir) * M);
 }
 
+//-------------------------------------------------------------------
+//	An array of lines in structure-of-arrays layout: the i-th line
+//	has position (posX[i], posY[i], posZ[i]) and direction (dirX[i],
+//	dirY[i], dirZ[i]). Functions that read arrays of lines take
+//	Line3SoA<const T>, which a Line3SoA<T> converts to.
+//-------------------------------------------------------------------
+
+template <class T> class Line3SoA
+{
+  public:
+    typedef typename std::remove_const<T>::type BaseType;
+
+    T* posX;
+    T* posY;
+    T* posZ;
+    T* dirX;
+    T* dirY;
+    T* dirZ;
+
+    IMATH_HOSTDEVICE constexpr Line3SoA (T* posX,
+                                         T* posY,
+                                         T* posZ,
+                                         T* dirX,
+                                         T* dirY,
+                                         T* dirZ) noexcept
+        : posX (posX), posY (posY), posZ (posZ), dirX (dirX), dirY (dirY), dirZ (dirZ)
+    {}
+
+    template <class S>
+    IMATH_HOSTDEVICE constexpr Line3SoA (const Line3SoA<S>& l) noexcept
+        : posX (l.posX), posY (l.posY), posZ (l.posZ), dirX (l.dirX), dirY (l.dirY), dirZ (l.dirZ)
+    {}
+
+    // Load and store the i-th line. The direction is stored as it
+    // is, without normalizing it.
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Line3<BaseType> operator[] (size_t i) const noexcept
+    {
+        Line3<BaseType> l;
+        l.pos = Vec3<BaseType> (posX[i], posY[i], posZ[i]);
+        l.dir = Vec3<BaseType> (dirX[i], dirY[i], dirZ[i]);
+        return l;
+    }
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 void set (size_t i, const Line3<BaseType>& l) const noexcept
+    {
+        posX[i] = l.pos.x;
+        posY[i] = l.pos.y;
+        posZ[i] = l.pos.z;
+        dirX[i] = l.dir.x;
+        dirY[i] = l.dir.y;
+        dirZ[i] = l.dir.z;
+    }
+};
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHLINE_H
@@ -0,0 +1,390 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHLUT3D_H
+#define INCLUDED_IMATHLUT3D_H
+
+//-------------------------------------------------------------------------
+//
+//  A 3D lookup table of colors, for transforms that mix the color
+//  components.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathColor.h"
+#include "ImathMatrix.h"
+#include "ImathNamespace.h"
+#include "ImathVec.h"
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/////////////////////////////////////////////////////////////////
+// Lut3D
+//
+//	template class Lut3D<C>
+//
+// A lattice of size x size x size colors of type C, Color3<T> or
+// Vec3<T> with T float or double, over the box [domainMin, domainMax]
+// of input colors: entry (r, g, b) is the output for the input
+// latticePoint (r, g, b), and inputs between lattice points are
+// interpolated from the 8 corners of their cell, trilinearly, or from
+// the 4 corners of the tetrahedron of the cell that contains them,
+// which is cheaper and keeps the gray axis of the cell exact. Inputs
+// outside the domain are clamped to it, and NaN components become the
+// domain's minimum.
+//
+// The entries are stored in tiles of 4 x 4 x 4, so that the corners
+// of most cells lie within a few cache lines; the storage is padded to
+// a multiple of 4 entries along each axis. The offset of an entry is
+// the sum of per-axis offsets, which are precomputed.
+//
+// apply() converts arrays of Color3 or Color4 of float or half,
+// computing in T. Alpha is copied, and the input and output arrays
+// may be the same. A Lut3D does not change while it is applied, so
+// that threads may convert parts of an image with the same one.
+//
+
+template <class C> class Lut3D
+{
+  public:
+    typedef typename C::BaseType T;
+
+    enum Interpolation
+    {
+        INTERPOLATE_TRILINEAR,
+        INTERPOLATE_TETRAHEDRAL
+    };
+
+    static constexpr int tileSize = 4;
+
+    ////////////////////////////////////////////////////////////////////
+    // Constructor
+    // The identity transform. Throws std::domain_error if size is less
+    // than 2 or the domain is empty.
+    explicit Lut3D (int size,
+                    const Vec3<T>& domainMin = Vec3<T> (0),
+                    const Vec3<T>& domainMax = Vec3<T> (1));
+
+    int size() const noexcept { return _size; }
+    const Vec3<T>& domainMin() const noexcept { return _domainMin; }
+    const Vec3<T>& domainMax() const noexcept { return _domainMax; }
+
+    // The input color of entry (r, g, b).
+    Vec3<T> latticePoint (int r, int g, int b) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // operator()
+    // Entry (r, g, b), with each index from 0 to size - 1.
+    C& operator() (int r, int g, int b) noexcept;
+    const C& operator() (int r, int g, int b) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // lookup()
+    // Interpolate the output for a color.
+    C lookup (const Vec3<T>& c, Interpolation interpolation = INTERPOLATE_TETRAHEDRAL) const
+        noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // apply()
+    // Look up the n colors in[i] into out[i].
+    template <class S>
+    void apply (const Color3<S>* in,
+                Color3<S>* out,
+                size_t n,
+                Interpolation interpolation = INTERPOLATE_TETRAHEDRAL) const noexcept;
+    template <class S>
+    void apply (const Color4<S>* in,
+                Color4<S>* out,
+                size_t n,
+                Interpolation interpolation = INTERPOLATE_TETRAHEDRAL) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // appendMatrix()
+    // Transform the output by a matrix, as c * m; this is exact.
+    void appendMatrix (const Matrix33<T>& m) noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // prependMatrix()
+    // Transform the input by a matrix, as c * m, before the lookup, by
+    // resampling the table at the transformed lattice points; lattice
+    // points that are transformed out of the domain are clamped to it.
+    void prependMatrix (const Matrix33<T>& m,
+                        Interpolation interpolation = INTERPOLATE_TETRAHEDRAL);
+
+  private:
+    template <class D>
+    void applyArray (const D* in, D* out, size_t n, Interpolation interpolation) const noexcept;
+
+    template <class S> static void copyAlpha (const Color3<S>&, Color3<S>&) noexcept {}
+    template <class S> static void copyAlpha (const Color4<S>& in, Color4<S>& out) noexcept
+    {
+        out.a = in.a;
+    }
+
+    void cell (T x, int axis, int& offset, int& step, T& fraction) const noexcept;
+    C trilinear (T r, T g, T b) const noexcept;
+    C tetrahedral (T r, T g, T b) const noexcept;
+
+    int _size;
+    Vec3<T> _domainMin;
+    Vec3<T> _domainMax;
+    Vec3<T> _scale; // (size - 1) / (domainMax - domainMin)
+    std::vector<int> _offsets[3];
+    std::vector<C> _entries;
+};
+
+template <class C>
+Lut3D<C>::Lut3D (int size, const Vec3<T>& domainMin, const Vec3<T>& domainMax)
+    : _size (size), _domainMin (domainMin), _domainMax (domainMax)
+{
+    if (size < 2)
+        throw std::domain_error ("Bad 3D lookup table: size is less than 2");
+
+    if (!(domainMin.x < domainMax.x && domainMin.y < domainMax.y && domainMin.z < domainMax.z))
+        throw std::domain_error ("Bad 3D lookup table: empty domain");
+
+    for (int i = 0; i < 3; ++i)
+        _scale[i] = T (size - 1) / (domainMax[i] - domainMin[i]);
+
+    // Tiles along red, then green, then blue, with the entries of each
+    // tile in the same order
+
+    const int tiles      = (size + tileSize - 1) / tileSize;
+    const int tileVolume = tileSize * tileSize * tileSize;
+
+    for (int axis = 0, stride = 1, tileStride = tileVolume; axis < 3; ++axis)
+    {
+        _offsets[axis].resize (size);
+
+        for (int i = 0; i < size; ++i)
+            _offsets[axis][i] = (i / tileSize) * tileStride + (i % tileSize) * stride;
+
+        stride *= tileSize;
+        tileStride *= tiles;
+    }
+
+    _entries.resize (size_t (tiles) * tiles * tiles * tileVolume);
+
+    for (int b = 0; b < size; ++b)
+        for (int g = 0; g < size; ++g)
+            for (int r = 0; r < size; ++r)
+                (*this) (r, g, b) = C (latticePoint (r, g, b));
+}
+
+template <class C>
+inline Vec3<typename C::BaseType>
+Lut3D<C>::latticePoint (int r, int g, int b) const noexcept
+{
+    return Vec3<T> (_domainMin.x + T (r) / _scale.x,
+                    _domainMin.y + T (g) / _scale.y,
+                    _domainMin.z + T (b) / _scale.z);
+}
+
+template <class C>
+inline C&
+Lut3D<C>::operator() (int r, int g, int b) noexcept
+{
+    return _entries[_offsets[0][r] + _offsets[1][g] + _offsets[2][b]];
+}
+
+template <class C>
+inline const C&
+Lut3D<C>::operator() (int r, int g, int b) const noexcept
+{
+    return _entries[_offsets[0][r] + _offsets[1][g] + _offsets[2][b]];
+}
+
+//
+// The cell that contains x along an axis: the offset of its lower
+// corner, the step to its upper corner, and the position of x between
+// them. Clamping with comparisons that are false for NaN maps NaN to
+// the lower end of the domain.
+//
+
+template <class C>
+inline void
+Lut3D<C>::cell (T x, int axis, int& offset, int& step, T& fraction) const noexcept
+{
+    const T last = T (_size - 1);
+
+    x = (x - _domainMin[axis]) * _scale[axis];
+    x = x >= 0 ? x : T (0);
+    x = x <= last ? x : last;
+
+    int i    = int (x);
+    i        = i < _size - 2 ? i : _size - 2;
+    fraction = x - T (i);
+
+    const int* offsets = _offsets[axis].data();
+    offset             = offsets[i];
+    step               = offsets[i + 1] - offsets[i];
+}
+
+template <class C>
+inline C
+Lut3D<C>::trilinear (T r, T g, T b) const noexcept
+{
+    int o0, o1, o2, s0, s1, s2;
+    T f0, f1, f2;
+
+    cell (r, 0, o0, s0, f0);
+    cell (g, 1, o1, s1, f1);
+    cell (b, 2, o2, s2, f2);
+
+    const C* e = _entries.data() + o0 + o1 + o2;
+
+    C c00 = e[0] * (1 - f0) + e[s0] * f0;
+    C c10 = e[s1] * (1 - f0) + e[s1 + s0] * f0;
+    C c01 = e[s2] * (1 - f0) + e[s2 + s0] * f0;
+    C c11 = e[s2 + s1] * (1 - f0) + e[s2 + s1 + s0] * f0;
+
+    C c0 = c00 * (1 - f1) + c10 * f1;
+    C c1 = c01 * (1 - f1) + c11 * f1;
+
+    return c0 * (1 - f2) + c1 * f2;
+}
+
+//
+// The tetrahedron that contains a point of a cell has the corners
+// from the lower corner of the cell to the upper one, stepping along
+// the axes in the order of decreasing fractions. The corners and
+// weights are selected without branches.
+//
+
+template <class C>
+inline C
+Lut3D<C>::tetrahedral (T r, T g, T b) const noexcept
+{
+    int o0, o1, o2, s0, s1, s2;
+    T f0, f1, f2;
+
+    cell (r, 0, o0, s0, f0);
+    cell (g, 1, o1, s1, f1);
+    cell (b, 2, o2, s2, f2);
+
+    const bool ge01 = f0 >= f1;
+    const bool ge12 = f1 >= f2;
+    const bool ge02 = f0 >= f2;
+
+    // The steps along the axes with the largest and smallest fractions
+
+    int first = ge01 && ge02 ? s0 : !ge01 && ge12 ? s1 : s2;
+    int last  = ge02 && ge12 ? s2 : !ge01 && !ge02 ? s0 : s1;
+
+    T hi  = f0 > f1 ? f0 : f1;
+    hi    = hi > f2 ? hi : f2;
+    T lo  = f0 < f1 ? f0 : f1;
+    lo    = lo < f2 ? lo : f2;
+    T mid = f0 + f1 + f2 - hi - lo;
+
+    const C* e = _entries.data() + o0 + o1 + o2;
+    int upper  = s0 + s1 + s2;
+
+    return e[0] * (1 - hi) + e[first] * (hi - mid) + e[upper - last] * (mid - lo) +
+           e[upper] * lo;
+}
+
+template <class C>
+inline C
+Lut3D<C>::lookup (const Vec3<T>& c, Interpolation interpolation) const noexcept
+{
+    return interpolation == INTERPOLATE_TRILINEAR ? trilinear (c.x, c.y, c.z)
+                                                  : tetrahedral (c.x, c.y, c.z);
+}
+
+template <class C>
+template <class S>
+void
+Lut3D<C>::apply (const Color3<S>* in,
+                 Color3<S>* out,
+                 size_t n,
+                 Interpolation interpolation) const noexcept
+{
+    applyArray (in, out, n, interpolation);
+}
+
+template <class C>
+template <class S>
+void
+Lut3D<C>::apply (const Color4<S>* in,
+                 Color4<S>* out,
+                 size_t n,
+                 Interpolation interpolation) const noexcept
+{
+    applyArray (in, out, n, interpolation);
+}
+
+template <class C>
+template <class D>
+void
+Lut3D<C>::applyArray (const D* in, D* out, size_t n, Interpolation interpolation) const noexcept
+{
+    typedef typename D::BaseType S;
+
+    // One loop per interpolation, for the compiler to inline it
+
+    if (interpolation == INTERPOLATE_TRILINEAR)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            C c       = trilinear (T (in[i][0]), T (in[i][1]), T (in[i][2]));
+            out[i][0] = S (c[0]);
+            out[i][1] = S (c[1]);
+            out[i][2] = S (c[2]);
+            copyAlpha (in[i], out[i]);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            C c       = tetrahedral (T (in[i][0]), T (in[i][1]), T (in[i][2]));
+            out[i][0] = S (c[0]);
+            out[i][1] = S (c[1]);
+            out[i][2] = S (c[2]);
+            copyAlpha (in[i], out[i]);
+        }
+    }
+}
+
+template <class C>
+void
+Lut3D<C>::appendMatrix (const Matrix33<T>& m) noexcept
+{
+    for (int b = 0; b < _size; ++b)
+        for (int g = 0; g < _size; ++g)
+            for (int r = 0; r < _size; ++r)
+            {
+                C& c = (*this) (r, g, b);
+                c    = C (c * m);
+            }
+}
+
+template <class C>
+void
+Lut3D<C>::prependMatrix (const Matrix33<T>& m, Interpolation interpolation)
+{
+    std::vector<C> entries (_entries.size());
+
+    for (int b = 0; b < _size; ++b)
+        for (int g = 0; g < _size; ++g)
+            for (int r = 0; r < _size; ++r)
+            {
+                int i      = _offsets[0][r] + _offsets[1][g] + _offsets[2][b];
+                entries[i] = lookup (latticePoint (r, g, b) * m, interpolation);
+            }
+
+    _entries.swap (entries);
+}
+
+typedef Lut3D<Color3<float>> Lut3Df;
+typedef Lut3D<Color3<double>> Lut3Dd;
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHLUT3D_H
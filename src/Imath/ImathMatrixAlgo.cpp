@@ -12,6 +12,7 @@
 #include "ImathMatrixAlgo.h"
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 #if defined(IMATH_DLL)
 #    define EXPORT_CONST __declspec(dllexport)
@@ -1227,4 +1228,592 @@ template IMATH_EXPORT void minEigenVector (Matrix44<float>& A, Vec4<float>& S);
 template IMATH_EXPORT void minEigenVector (Matrix33<double>& A, Vec3<double>& S);
 template IMATH_EXPORT void minEigenVector (Matrix44<double>& A, Vec4<double>& S);
 
+namespace
+{
+
+//
+// Helpers for the polar decomposition and the matrix functions below.
+// They are written in terms of TM::dimensions() so that the same code
+// serves both Matrix33 and Matrix44.
+//
+
+template <typename TM>
+typename TM::BaseType
+norm1 (const TM& A)
+{
+    typedef typename TM::BaseType T;
+    T result (0);
+    for (unsigned int j = 0; j < TM::dimensions(); ++j)
+    {
+        T sum (0);
+        for (unsigned int i = 0; i < TM::dimensions(); ++i)
+            sum += std::abs (A[i][j]);
+        result = std::max (result, sum);
+    }
+    return result;
+}
+
+template <typename TM>
+typename TM::BaseType
+normInf (const TM& A)
+{
+    typedef typename TM::BaseType T;
+    T result (0);
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+    {
+        T sum (0);
+        for (unsigned int j = 0; j < TM::dimensions(); ++j)
+            sum += std::abs (A[i][j]);
+        result = std::max (result, sum);
+    }
+    return result;
+}
+
+template <typename TM>
+typename TM::BaseType
+normFrobenius2 (const TM& A)
+{
+    typedef typename TM::BaseType T;
+    T result (0);
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+        for (unsigned int j = 0; j < TM::dimensions(); ++j)
+            result += A[i][j] * A[i][j];
+    return result;
+}
+
+template <typename TM>
+bool
+isSymmetric (const TM& A)
+{
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+        for (unsigned int j = i + 1; j < TM::dimensions(); ++j)
+            if (A[i][j] != A[j][i])
+                return false;
+    return true;
+}
+
+template <typename TM>
+bool
+isSingular (const TM& A, const typename TM::BaseType n1)
+{
+    typedef typename TM::BaseType T;
+
+    //
+    // Compare the determinant against the scale of the matrix
+    // (n1^dimensions), so that the test does not depend on
+    // the overall magnitude of the entries.
+    //
+
+    T scale (1);
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+        scale *= n1;
+
+    return !(std::abs (A.determinant()) > scale * limits<T>::epsilon());
+}
+
+template <typename TM>
+void
+symmetrize (TM& A)
+{
+    typedef typename TM::BaseType T;
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+        for (unsigned int j = i + 1; j < TM::dimensions(); ++j)
+            A[i][j] = A[j][i] = T (0.5) * (A[i][j] + A[j][i]);
+}
+
+//
+// Apply a scalar function to a symmetric matrix via its
+// eigendecomposition A = V * diag(S) * V^T.
+//
+
+template <typename TM, typename TV, typename F>
+TM
+symmetricFunction (const TM& A, F f)
+{
+    TM M (A);
+    TM V;
+    TV S;
+    jacobiEigenSolver (M, S, V);
+
+    for (unsigned int k = 0; k < TM::dimensions(); ++k)
+        S[k] = f (S[k]);
+
+    TM result;
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+    {
+        for (unsigned int j = 0; j < TM::dimensions(); ++j)
+        {
+            typename TM::BaseType sum (0);
+            for (unsigned int k = 0; k < TM::dimensions(); ++k)
+                sum += V[i][k] * S[k] * V[j][k];
+            result[i][j] = sum;
+        }
+    }
+    return result;
+}
+
+template <typename TM, typename TV>
+void
+polarDecomposeImp (const TM& A, TM& Q, TM& S, const typename TM::BaseType tol)
+{
+    typedef typename TM::BaseType T;
+
+    //
+    // Higham's Newton iteration for the orthonormal polar factor,
+    //     X' = (g * X + 1/g * X^-T) / 2,
+    // with the Frobenius-norm scaling factor g, which is switched off
+    // once the iteration is close to convergence.  All norms below are
+    // squared Frobenius norms, which are cheaper than the 1- and
+    // infinity-norms and work as well for matrices this small.
+    //
+
+    const int maxIter = 20; // Convergence is quadratic; this only guards
+                            // against pathological input.
+    const T tol2       = tol * tol;
+    bool lastIteration = false;
+    bool scale         = true;
+
+    TM X (A);
+    T n2 = normFrobenius2 (X);
+
+    if (n2 == 0 || isSingular (X, std::sqrt (n2)))
+    {
+        //
+        // X^-1 does not exist; use the SVD A = U * diag(s) * V^T,
+        // from which Q = U * V^T and S = U * diag(s) * U^T.
+        //
+
+        TM U, V;
+        TV s;
+        jacobiSVD (A, U, s, V, tol);
+
+        for (unsigned int i = 0; i < TM::dimensions(); ++i)
+        {
+            for (unsigned int j = 0; j < TM::dimensions(); ++j)
+            {
+                T q (0), p (0);
+                for (unsigned int k = 0; k < TM::dimensions(); ++k)
+                {
+                    q += U[i][k] * V[j][k];
+                    p += U[i][k] * s[k] * U[j][k];
+                }
+                Q[i][j] = q;
+                S[i][j] = p;
+            }
+        }
+        return;
+    }
+
+    for (int iter = 0; iter < maxIter; ++iter)
+    {
+        const TM Xi = X.inverse();
+        T g (1);
+
+        if (scale)
+            g = std::sqrt (std::sqrt (normFrobenius2 (Xi) / n2));
+
+        const TM Xn    = X * (T (0.5) * g) + Xi.transposed() * (T (0.5) / g);
+        const T change = normFrobenius2 (Xn - X);
+        n2             = normFrobenius2 (Xn);
+        X              = Xn;
+
+        if (lastIteration || change <= tol2 * n2)
+            break;
+
+        // With quadratic convergence, one more step reaches tol.
+        if (change <= tol * n2)
+            lastIteration = true;
+
+        if (change <= T (1e-4) * n2)
+            scale = false;
+    }
+
+    Q = X;
+    S = A * Q.transposed();
+    symmetrize (S);
+}
+
+template <typename TM>
+TM
+expmImp (const TM& A)
+{
+    typedef typename TM::BaseType T;
+
+    //
+    // Scale A by 2^-s so that its norm is at most 1/2, evaluate the
+    // [6/6] Pade approximant r(X) = D(X)^-1 * N(X), and square the
+    // result s times.  The scale is only defined for finite entries
+    // (normInf() would also skip a row with a NaN).
+    //
+
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+        for (unsigned int j = 0; j < TM::dimensions(); ++j)
+            if (!std::isfinite (A[i][j]))
+                throw std::domain_error ("Cannot compute exponential of matrix "
+                                         "with infinite or NaN entries.");
+
+    const T nrm = normInf (A);
+    int s       = 0;
+
+    if (nrm > T (0.5))
+        s = std::max (0, int (std::ceil (std::log2 (nrm / T (0.5)))));
+
+    const TM X = A * T (std::ldexp (1.0, -s));
+
+    // c[k] = c[k-1] * (q - k + 1) / (k * (2q - k + 1)), q = 6
+    static const T c[] = { T (1.0),
+                           T (1.0 / 2.0),
+                           T (5.0 / 44.0),
+                           T (1.0 / 66.0),
+                           T (1.0 / 792.0),
+                           T (1.0 / 15840.0),
+                           T (1.0 / 665280.0) };
+
+    TM P;
+    TM N;
+    TM D;
+    N *= c[0];
+    D *= c[0];
+
+    for (int k = 1; k <= 6; ++k)
+    {
+        P = P * X;
+        const TM term = P * c[k];
+        N += term;
+        if (k & 1)
+            D -= term;
+        else
+            D += term;
+    }
+
+    TM E = D.inverse() * N;
+
+    for (int k = 0; k < s; ++k)
+        E = E * E;
+
+    return E;
+}
+
+template <typename TM>
+TM
+sqrtmDenmanBeavers (const TM& A)
+{
+    typedef typename TM::BaseType T;
+
+    //
+    // Determinant-scaled Denman-Beavers iteration:
+    //     Y' = (g * Y + 1/g * Z^-1) / 2
+    //     Z' = (g * Z + 1/g * Y^-1) / 2
+    // converges to Y = sqrt(A), Z = sqrt(A)^-1.
+    //
+
+    const int maxIter  = 50;
+    const T tol        = limits<T>::epsilon() * TM::dimensions();
+    const T convTol    = std::sqrt (tol);
+    const T invDim     = T (-0.5) / TM::dimensions();
+    bool lastIteration = false;
+    bool scale         = true;
+
+    TM Y (A);
+    TM Z;
+
+    for (int iter = 0; iter < maxIter; ++iter)
+    {
+        const T n1 = norm1 (Y);
+
+        if (n1 == 0 || isSingular (Y, n1))
+            throw std::domain_error ("Cannot compute square root of singular matrix.");
+
+        const TM Yi = Y.inverse();
+        const TM Zi = Z.inverse();
+        T g (1);
+
+        if (scale)
+            g = std::pow (std::abs (Y.determinant() * Z.determinant()), invDim);
+
+        const TM Yn    = Y * (T (0.5) * g) + Zi * (T (0.5) / g);
+        Z              = Z * (T (0.5) * g) + Yi * (T (0.5) / g);
+        const T nn1    = norm1 (Yn);
+        const T change = norm1 (Yn - Y);
+        Y              = Yn;
+
+        if (lastIteration || change <= tol * nn1)
+            return Y;
+
+        if (change <= convTol * nn1)
+            lastIteration = true;
+
+        if (change <= T (0.01) * nn1)
+            scale = false;
+    }
+
+    //
+    // The iteration only fails to converge if A has
+    // eigenvalues on or very near the negative real axis.
+    //
+
+    throw std::domain_error ("Cannot compute square root of matrix "
+                             "with negative real eigenvalues.");
+}
+
+template <typename TM, typename TV>
+TM
+sqrtmImp (const TM& A)
+{
+    typedef typename TM::BaseType T;
+
+    if (isSymmetric (A))
+    {
+        const T tol = limits<T>::epsilon() * TM::dimensions() * norm1 (A);
+
+        return symmetricFunction<TM, TV> (A, [tol] (T x) {
+            if (x < -tol)
+                throw std::domain_error ("Cannot compute square root of matrix "
+                                         "with negative real eigenvalues.");
+            return x > 0 ? std::sqrt (x) : T (0);
+        });
+    }
+
+    return sqrtmDenmanBeavers (A);
+}
+
+template <typename TM, typename TV>
+TM
+logmImp (const TM& A)
+{
+    typedef typename TM::BaseType T;
+
+    if (isSymmetric (A))
+    {
+        return symmetricFunction<TM, TV> (A, [] (T x) {
+            if (!(x > 0))
+                throw std::domain_error ("Cannot compute logarithm of matrix "
+                                         "with non-positive real eigenvalues.");
+            return std::log (x);
+        });
+    }
+
+    //
+    // Inverse scaling and squaring: take square roots until X is
+    // close to the identity, then sum the Gregory series
+    //     log(X) = 2 * sum Z^(2j+1) / (2j+1),  Z = (X - I) (X + I)^-1
+    // and scale the result back up by 2^k.
+    //
+
+    const TM I;
+    const int maxRoots = 64;
+    TM X (A);
+    int k = 0;
+
+    while (norm1 (X - I) > T (0.25))
+    {
+        if (++k > maxRoots)
+            throw std::domain_error ("Cannot compute logarithm of matrix "
+                                     "with negative real eigenvalues.");
+
+        X = sqrtmDenmanBeavers (X);
+    }
+
+    const TM Z  = (X - I) * (X + I).inverse();
+    const TM Z2 = Z * Z;
+    TM P (Z);
+    TM sum (Z);
+
+    for (int j = 1; j < 30; ++j)
+    {
+        P              = P * Z2;
+        const TM term  = P * (T (1) / T (2 * j + 1));
+        sum           += term;
+
+        if (norm1 (term) <= limits<T>::epsilon() * norm1 (sum))
+            break;
+    }
+
+    return sum * T (std::ldexp (2.0, k));
+}
+
+} // namespace
+
+template <typename T>
+void
+polarDecompose (const Matrix33<T>& A, Matrix33<T>& Q, Matrix33<T>& S, const T tol)
+{
+    polarDecomposeImp<Matrix33<T>, Vec3<T>> (A, Q, S, tol);
+}
+
+template <typename T>
+void
+polarDecompose (const Matrix44<T>& A, Matrix44<T>& Q, Matrix44<T>& S, const T tol)
+{
+    polarDecomposeImp<Matrix44<T>, Vec4<T>> (A, Q, S, tol);
+}
+
+template <typename T>
+void
+polarDecompose (const Matrix33<T>* A, Matrix33<T>* Q, Matrix33<T>* S, size_t n, const T tol)
+{
+    Matrix33<T> s;
+    for (size_t i = 0; i < n; ++i)
+        polarDecomposeImp<Matrix33<T>, Vec3<T>> (A[i], Q[i], S ? S[i] : s, tol);
+}
+
+template <typename T>
+void
+polarDecompose (const Matrix44<T>* A, Matrix44<T>* Q, Matrix44<T>* S, size_t n, const T tol)
+{
+    Matrix44<T> s;
+    for (size_t i = 0; i < n; ++i)
+        polarDecomposeImp<Matrix44<T>, Vec4<T>> (A[i], Q[i], S ? S[i] : s, tol);
+}
+
+template <typename T>
+Matrix33<T>
+expm (const Matrix33<T>& A)
+{
+    return expmImp (A);
+}
+
+template <typename T>
+Matrix44<T>
+expm (const Matrix44<T>& A)
+{
+    return expmImp (A);
+}
+
+template <typename T>
+Matrix33<T>
+logm (const Matrix33<T>& A)
+{
+    return logmImp<Matrix33<T>, Vec3<T>> (A);
+}
+
+template <typename T>
+Matrix44<T>
+logm (const Matrix44<T>& A)
+{
+    return logmImp<Matrix44<T>, Vec4<T>> (A);
+}
+
+template <typename T>
+Matrix33<T>
+sqrtm (const Matrix33<T>& A)
+{
+    return sqrtmImp<Matrix33<T>, Vec3<T>> (A);
+}
+
+template <typename T>
+Matrix44<T>
+sqrtm (const Matrix44<T>& A)
+{
+    return sqrtmImp<Matrix44<T>, Vec4<T>> (A);
+}
+
+template <typename T>
+void
+expm (const Matrix33<T>* A, Matrix33<T>* result, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = expmImp (A[i]);
+}
+
+template <typename T>
+void
+expm (const Matrix44<T>* A, Matrix44<T>* result, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = expmImp (A[i]);
+}
+
+template <typename T>
+void
+logm (const Matrix33<T>* A, Matrix33<T>* result, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = logmImp<Matrix33<T>, Vec3<T>> (A[i]);
+}
+
+template <typename T>
+void
+logm (const Matrix44<T>* A, Matrix44<T>* result, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = logmImp<Matrix44<T>, Vec4<T>> (A[i]);
+}
+
+template <typename T>
+void
+sqrtm (const Matrix33<T>* A, Matrix33<T>* result, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = sqrtmImp<Matrix33<T>, Vec3<T>> (A[i]);
+}
+
+template <typename T>
+void
+sqrtm (const Matrix44<T>* A, Matrix44<T>* result, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = sqrtmImp<Matrix44<T>, Vec4<T>> (A[i]);
+}
+
+template IMATH_EXPORT void
+polarDecompose (const Matrix33<float>& A, Matrix33<float>& Q, Matrix33<float>& S, const float tol);
+template IMATH_EXPORT void
+polarDecompose (const Matrix33<double>& A, Matrix33<double>& Q, Matrix33<double>& S, const double tol);
+template IMATH_EXPORT void
+polarDecompose (const Matrix44<float>& A, Matrix44<float>& Q, Matrix44<float>& S, const float tol);
+template IMATH_EXPORT void
+polarDecompose (const Matrix44<double>& A, Matrix44<double>& Q, Matrix44<double>& S, const double tol);
+
+template IMATH_EXPORT void polarDecompose (const Matrix33<float>* A,
+                                           Matrix33<float>* Q,
+                                           Matrix33<float>* S,
+                                           size_t n,
+                                           const float tol);
+template IMATH_EXPORT void polarDecompose (const Matrix33<double>* A,
+                                           Matrix33<double>* Q,
+                                           Matrix33<double>* S,
+                                           size_t n,
+                                           const double tol);
+template IMATH_EXPORT void polarDecompose (const Matrix44<float>* A,
+                                           Matrix44<float>* Q,
+                                           Matrix44<float>* S,
+                                           size_t n,
+                                           const float tol);
+template IMATH_EXPORT void polarDecompose (const Matrix44<double>* A,
+                                           Matrix44<double>* Q,
+                                           Matrix44<double>* S,
+                                           size_t n,
+                                           const double tol);
+
+template IMATH_EXPORT Matrix33<float> expm (const Matrix33<float>& A);
+template IMATH_EXPORT Matrix33<double> expm (const Matrix33<double>& A);
+template IMATH_EXPORT Matrix44<float> expm (const Matrix44<float>& A);
+template IMATH_EXPORT Matrix44<double> expm (const Matrix44<double>& A);
+
+template IMATH_EXPORT Matrix33<float> logm (const Matrix33<float>& A);
+template IMATH_EXPORT Matrix33<double> logm (const Matrix33<double>& A);
+template IMATH_EXPORT Matrix44<float> logm (const Matrix44<float>& A);
+template IMATH_EXPORT Matrix44<double> logm (const Matrix44<double>& A);
+
+template IMATH_EXPORT Matrix33<float> sqrtm (const Matrix33<float>& A);
+template IMATH_EXPORT Matrix33<double> sqrtm (const Matrix33<double>& A);
+template IMATH_EXPORT Matrix44<float> sqrtm (const Matrix44<float>& A);
+template IMATH_EXPORT Matrix44<double> sqrtm (const Matrix44<double>& A);
+
+template IMATH_EXPORT void expm (const Matrix33<float>* A, Matrix33<float>* result, size_t n);
+template IMATH_EXPORT void expm (const Matrix33<double>* A, Matrix33<double>* result, size_t n);
+template IMATH_EXPORT void expm (const Matrix44<float>* A, Matrix44<float>* result, size_t n);
+template IMATH_EXPORT void expm (const Matrix44<double>* A, Matrix44<double>* result, size_t n);
+
+template IMATH_EXPORT void logm (const Matrix33<float>* A, Matrix33<float>* result, size_t n);
+template IMATH_EXPORT void logm (const Matrix33<double>* A, Matrix33<double>* result, size_t n);
+template IMATH_EXPORT void logm (const Matrix44<float>* A, Matrix44<float>* result, size_t n);
+template IMATH_EXPORT void logm (const Matrix44<double>* A, Matrix44<double>* result, size_t n);
+
+template IMATH_EXPORT void sqrtm (const Matrix33<float>* A, Matrix33<float>* result, size_t n);
+template IMATH_EXPORT void sqrtm (const Matrix33<double>* A, Matrix33<double>* result, size_t n);
+template IMATH_EXPORT void sqrtm (const Matrix44<float>* A, Matrix44<float>* result, size_t n);
+template IMATH_EXPORT void sqrtm (const Matrix44<double>* A, Matrix44<double>* result, size_t n);
+
 IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
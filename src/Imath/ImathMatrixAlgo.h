@@ -113,6 +113,8 @@ template <class T> void extractEulerZYX (const Matrix44<T>& mat, Vec3<T>& rot);
 
 template <class T> Quat<T> extractQuat (const Matrix44<T>& mat);
 
+template <class T> DualQuat<T> extractDualQuat (const Matrix44<T>& mat);
+
 template <class T>
 bool extractSHRT (const Matrix44<T>& mat,
                   Vec3<T>& s,
@@ -613,6 +615,13 @@ extractQuat (const Matrix44<T>& mat)
     return quat;
 }
 
+template <class T>
+DualQuat<T>
+extractDualQuat (const Matrix44<T>& mat)
+{
+    return DualQuat<T> (extractQuat (mat), Vec3<T> (mat[3][0], mat[3][1], mat[3][2]));
+}
+
 template <class T>
 bool
 extractSHRT (const Matrix44<T>& mat,
@@ -1288,6 +1297,90 @@ jacobiEigenSolver (Matrix44<T>& A, Vec4<T>& S, Matrix44<T>& V)
 template <typename TM, typename TV> void maxEigenVector (TM& A, TV& S);
 template <typename TM, typename TV> void minEigenVector (TM& A, TV& S);
 
+// Compute the polar decomposition of a 3x3/4x4 matrix A:
+//     A = S * Q
+// where Q is orthonormal and S is symmetric positive semi-definite.
+// Following Imath's row-vector convention, S is the stretch applied
+// before the rotation Q.  Q is a reflection (determinant -1) exactly
+// when A has a negative determinant.
+//
+// The decomposition is computed with Higham's scaled Newton
+// iteration, which typically converges in 6-8 matrix inversions;
+// singular matrices fall back to jacobiSVD.  Unlike extractSHRT(),
+// the result is continuous in A, which makes Q and S suitable for
+// interpolating transforms that contain shear.
+//
+// The matrix is decomposed as a whole; to blend affine transforms,
+// decompose the upper-left 3x3 and interpolate the translation
+// separately.
+//
+// The array version decomposes n matrices; S may be null if only
+// the orthonormal factors are needed.
+//
+// Currently only available for single- and double-precision matrices.
+template <typename T>
+void polarDecompose (const Matrix33<T>& A,
+                     Matrix33<T>& Q,
+                     Matrix33<T>& S,
+                     const T tol = limits<T>::epsilon());
+
+template <typename T>
+void polarDecompose (const Matrix44<T>& A,
+                     Matrix44<T>& Q,
+                     Matrix44<T>& S,
+                     const T tol = limits<T>::epsilon());
+
+template <typename T>
+void polarDecompose (const Matrix33<T>* A,
+                     Matrix33<T>* Q,
+                     Matrix33<T>* S,
+                     size_t n,
+                     const T tol = limits<T>::epsilon());
+
+template <typename T>
+void polarDecompose (const Matrix44<T>* A,
+                     Matrix44<T>* Q,
+                     Matrix44<T>* S,
+                     size_t n,
+                     const T tol = limits<T>::epsilon());
+
+// Matrix exponential, logarithm and principal square root of a 3x3/4x4
+// matrix.  (The functions are named after their MATLAB counterparts so
+// that they do not hide the scalar exp(), log() and sqrt() inside the
+// Imath namespace.)
+//
+// expm() uses scaling and squaring with a [6/6] Pade approximant.
+// sqrtm() uses the determinant-scaled Denman-Beavers iteration, and
+// logm() uses inverse scaling and squaring on top of sqrtm().
+// Symmetric matrices, such as the S factor of polarDecompose(),
+// take a faster and more accurate path through jacobiEigenSolver.
+//
+// logm() and sqrtm() require that A have no eigenvalues on the closed
+// negative real axis; sqrtm() additionally accepts symmetric positive
+// semi-definite matrices.  If A does not satisfy these conditions,
+// the functions throw std::domain_error.  expm() throws
+// std::domain_error if A has infinite or NaN entries.
+//
+// Together these allow transforms to be blended as, for instance,
+//     expm ((1 - t) * logm (A) + t * logm (B))
+//
+// The array versions apply the function to n matrices.
+//
+// Currently only available for single- and double-precision matrices.
+template <typename T> Matrix33<T> expm (const Matrix33<T>& A);
+template <typename T> Matrix44<T> expm (const Matrix44<T>& A);
+template <typename T> Matrix33<T> logm (const Matrix33<T>& A);
+template <typename T> Matrix44<T> logm (const Matrix44<T>& A);
+template <typename T> Matrix33<T> sqrtm (const Matrix33<T>& A);
+template <typename T> Matrix44<T> sqrtm (const Matrix44<T>& A);
+
+template <typename T> void expm (const Matrix33<T>* A, Matrix33<T>* result, size_t n);
+template <typename T> void expm (const Matrix44<T>* A, Matrix44<T>* result, size_t n);
+template <typename T> void logm (const Matrix33<T>* A, Matrix33<T>* result, size_t n);
+template <typename T> void logm (const Matrix44<T>* A, Matrix44<T>* result, size_t n);
+template <typename T> void sqrtm (const Matrix33<T>* A, Matrix33<T>* result, size_t n);
+template <typename T> void sqrtm (const Matrix44<T>* A, Matrix44<T>* result, size_t n);
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHMATRIXALGO_H
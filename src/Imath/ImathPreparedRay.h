@@ -0,0 +1,279 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHPREPAREDRAY_H
+#define INCLUDED_IMATHPREPAREDRAY_H
+
+//-------------------------------------------------------------------------
+//
+//  A ray with precomputed quantities, for intersecting one ray with
+//  many boxes, spheres or planes.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathBox.h"
+#include "ImathLimits.h"
+#include "ImathLine.h"
+#include "ImathNamespace.h"
+#include "ImathPlane.h"
+#include "ImathSphere.h"
+#include "ImathVec.h"
+#include <cmath>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/////////////////////////////////////////////////////////////////
+// PreparedRay
+//
+//	template class PreparedRay<T>
+//
+// Caches the direction dependent quantities of the slab test: the
+// reciprocal of the direction, its signs, and the origin times the
+// reciprocal. Testing the prepared ray against a box then takes six
+// multiply-adds and no divisions, where intersects(Box, Line3) in
+// ImathBoxAlgo.h divides up to six times for every box.
+//
+// The box tests agree with the scalar functions in ImathBoxAlgo.h:
+//
+//	findEntryAndExitT() with findEntryAndExitPoints(), for the
+//	line through the ray, extending in both directions,
+//
+//	intersectT() and intersects() with intersects(Box, Line3),
+//	for the ray starting at its origin,
+//
+// including zero and NaN direction components, origins on the sides
+// of the box, and empty boxes. Rays that just graze an edge or a face
+// of the box may differ, because of the different rounding.
+//
+// The sphere and plane tests forward to Sphere3::intersectT() and
+// Plane3::intersectT(); nothing is cached for them. They let code
+// that traverses a hierarchy with a prepared ray intersect the leaves
+// with it as well.
+//
+
+template <class T> class PreparedRay
+{
+  public:
+    Vec3<T> pos;
+    Vec3<T> dir;
+    Vec3<T> invDir;    // 1 / dir, infinite for zero components
+    Vec3<T> posInvDir; // pos * invDir
+    int sign[3];       // 1 if invDir is negative, 0 otherwise
+
+    // True if a component of pos * invDir is infinite or NaN, for
+    // instance because a component of the direction is zero. The
+    // slab test then computes (side - pos) * invDir instead.
+    bool parallel;
+
+    // Uninitialized by default, like Line3.
+    PreparedRay() noexcept {}
+
+    explicit PreparedRay (const Line3<T>& ray) noexcept;
+
+    void set (const Line3<T>& ray) noexcept;
+
+    Line3<T> ray() const noexcept;
+
+    // The point at parameter t along the ray.
+    Vec3<T> operator() (T t) const noexcept { return pos + dir * t; }
+
+    ////////////////////////////////////////////////////////////////////
+    // findEntryAndExitT()
+    // Intersect the line through the ray, extending in both
+    // directions, with a box. If they intersect, set tEntry and tExit
+    // to the parameters of the entry and exit points, which may be on
+    // either side of the origin, and return true.
+    bool findEntryAndExitT (const Box<Vec3<T>>& box, T& tEntry, T& tExit) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // intersectT()
+    // Intersect the ray, starting at its origin, with a box. If they
+    // intersect, tEntry is 0 if the origin is inside the box and the
+    // parameter of the entry point otherwise, and tExit is the
+    // parameter of the exit point.
+    bool intersectT (const Box<Vec3<T>>& box, T& tEntry, T& tExit) const noexcept;
+
+    // Like Sphere3::intersectT(): the smallest t >= 0 at which the
+    // ray hits the sphere. The direction must be normalized.
+    bool intersectT (const Sphere3<T>& sphere, T& t) const noexcept;
+
+    // Like Plane3::intersectT(): the t at which the line through the
+    // ray hits the plane.
+    bool intersectT (const Plane3<T>& plane, T& t) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // intersects()
+    // Return true if the ray hits a box, or hits it at a parameter no
+    // greater than tMax, for instance the closest hit found so far.
+    bool intersects (const Box<Vec3<T>>& box) const noexcept;
+    bool intersects (const Box<Vec3<T>>& box, T tMax) const noexcept;
+
+  private:
+    bool slabs (const Box<Vec3<T>>& box, T tMin, T tMax, T& tEntry, T& tExit) const noexcept;
+};
+
+//--------------------
+// Convenient typedefs
+//--------------------
+
+typedef PreparedRay<float> PreparedRayf;
+typedef PreparedRay<double> PreparedRayd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T> inline PreparedRay<T>::PreparedRay (const Line3<T>& ray) noexcept
+{
+    set (ray);
+}
+
+template <class T>
+inline void
+PreparedRay<T>::set (const Line3<T>& ray) noexcept
+{
+    pos      = ray.pos;
+    dir      = ray.dir;
+    parallel = false;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        //
+        // 1/0 is infinite, with the sign of the zero. A NaN direction
+        // component is treated as zero, so that the ray is parallel
+        // to that pair of sides, as in the scalar code.
+        //
+
+        T d = dir[i] == dir[i] ? dir[i] : T (0);
+
+        invDir[i]    = T (1) / d;
+        posInvDir[i] = pos[i] * invDir[i];
+        sign[i]      = invDir[i] < 0 ? 1 : 0;
+
+        if (!(std::abs (posInvDir[i]) <= limits<T>::max()))
+            parallel = true;
+    }
+}
+
+template <class T>
+inline Line3<T>
+PreparedRay<T>::ray() const noexcept
+{
+    Line3<T> r;
+    r.pos = pos;
+    r.dir = dir;
+    return r;
+}
+
+//
+// The slab test. The near and far sides of each slab are selected by
+// the signs of the direction, so that the near distance is never
+// greater than the far one for a non-empty box.
+//
+// For a zero direction component the distances are infinite, which
+// excludes the ray if its origin is outside the slab and leaves the
+// slab unconstrained if it is inside. On a side, 0 * inf yields NaN,
+// which the comparisons ignore, so that the origin counts as inside,
+// like in the scalar code.
+//
+
+template <class T>
+inline bool
+PreparedRay<T>::slabs (const Box<Vec3<T>>& box, T tMin, T tMax, T& tEntry, T& tExit)
+    const noexcept
+{
+    if (box.isEmpty())
+        return false;
+
+    const Vec3<T>& nearX = sign[0] ? box.max : box.min;
+    const Vec3<T>& nearY = sign[1] ? box.max : box.min;
+    const Vec3<T>& nearZ = sign[2] ? box.max : box.min;
+    const Vec3<T>& farX  = sign[0] ? box.min : box.max;
+    const Vec3<T>& farY  = sign[1] ? box.min : box.max;
+    const Vec3<T>& farZ  = sign[2] ? box.min : box.max;
+
+    T tx0, ty0, tz0, tx1, ty1, tz1;
+
+    if (!parallel)
+    {
+        tx0 = nearX.x * invDir.x - posInvDir.x;
+        ty0 = nearY.y * invDir.y - posInvDir.y;
+        tz0 = nearZ.z * invDir.z - posInvDir.z;
+        tx1 = farX.x * invDir.x - posInvDir.x;
+        ty1 = farY.y * invDir.y - posInvDir.y;
+        tz1 = farZ.z * invDir.z - posInvDir.z;
+    }
+    else
+    {
+        tx0 = (nearX.x - pos.x) * invDir.x;
+        ty0 = (nearY.y - pos.y) * invDir.y;
+        tz0 = (nearZ.z - pos.z) * invDir.z;
+        tx1 = (farX.x - pos.x) * invDir.x;
+        ty1 = (farY.y - pos.y) * invDir.y;
+        tz1 = (farZ.z - pos.z) * invDir.z;
+    }
+
+    T t0 = tMin;
+    t0   = tx0 > t0 ? tx0 : t0;
+    t0   = ty0 > t0 ? ty0 : t0;
+    t0   = tz0 > t0 ? tz0 : t0;
+
+    T t1 = tMax;
+    t1   = tx1 < t1 ? tx1 : t1;
+    t1   = ty1 < t1 ? ty1 : t1;
+    t1   = tz1 < t1 ? tz1 : t1;
+
+    tEntry = t0;
+    tExit  = t1;
+    return t0 <= t1;
+}
+
+template <class T>
+inline bool
+PreparedRay<T>::findEntryAndExitT (const Box<Vec3<T>>& box, T& tEntry, T& tExit) const noexcept
+{
+    return slabs (box, -limits<T>::max(), limits<T>::max(), tEntry, tExit);
+}
+
+template <class T>
+inline bool
+PreparedRay<T>::intersectT (const Box<Vec3<T>>& box, T& tEntry, T& tExit) const noexcept
+{
+    return slabs (box, T (0), limits<T>::max(), tEntry, tExit);
+}
+
+template <class T>
+inline bool
+PreparedRay<T>::intersects (const Box<Vec3<T>>& box) const noexcept
+{
+    T tEntry, tExit;
+    return slabs (box, T (0), limits<T>::max(), tEntry, tExit);
+}
+
+template <class T>
+inline bool
+PreparedRay<T>::intersects (const Box<Vec3<T>>& box, T tMax) const noexcept
+{
+    T tEntry, tExit;
+    return slabs (box, T (0), tMax, tEntry, tExit);
+}
+
+template <class T>
+inline bool
+PreparedRay<T>::intersectT (const Sphere3<T>& sphere, T& t) const noexcept
+{
+    return sphere.intersectT (ray(), t);
+}
+
+template <class T>
+inline bool
+PreparedRay<T>::intersectT (const Plane3<T>& plane, T& t) const noexcept
+{
+    return plane.intersectT (ray(), t);
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHPREPAREDRAY_H
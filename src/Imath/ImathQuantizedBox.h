@@ -0,0 +1,330 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHQUANTIZEDBOX_H
+#define INCLUDED_IMATHQUANTIZEDBOX_H
+
+//-------------------------------------------------------------------------
+//
+//  3D boxes stored as 8- or 16-bit offsets within a parent box, for
+//  compact nodes of spatial indexes.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathBox.h"
+#include "ImathNamespace.h"
+#include "ImathVec.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/////////////////////////////////////////////////////////////////
+// QuantizedBox
+//
+//	template class QuantizedBox<Q>
+//
+// A 3D box whose sides lie on a grid of maxValue() + 1 planes per
+// axis that span a parent box, stored as unsigned integers of type Q,
+// uint8_t or uint16_t: 6 or 12 bytes instead of the 24 of a Box3f.
+// The minimum of an axis is stored as the number of grid steps above
+// the parent's minimum, and the maximum as maxValue() minus the
+// number of steps below the parent's maximum, so that 0 and maxValue()
+// decode exactly to the sides of the parent.
+//
+// The rounding is conservative: the decoded box always contains the
+// part of the original box that lies within the parent, so culling
+// and intersection tests with the decoded box never reject what the
+// original box would have accepted. Quantizing a box that extends
+// beyond the parent clips it to the parent; boxes that do not overlap
+// the parent, and empty boxes, become empty.
+//
+// The parent box must be finite and have a floating-point base type,
+// and must be the same for encoding and decoding. Nodes of a
+// hierarchy typically store their children quantized relative to
+// their own box, and decode them during traversal, with decode()
+// for arrays of boxes when all children are tested at once.
+//
+
+template <class Q> class QuantizedBox
+{
+  public:
+    Q min[3];
+    Q max[3];
+
+    // Uninitialized by default, like Box's components.
+    QuantizedBox() noexcept {}
+
+    template <class T>
+    QuantizedBox (const Box<Vec3<T>>& box, const Box<Vec3<T>>& parent) noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // set()
+    // Quantize a box relative to a parent box.
+    template <class T> void set (const Box<Vec3<T>>& box, const Box<Vec3<T>>& parent) noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // decode()
+    // Return the box relative to the same parent it was quantized
+    // with. An empty quantized box decodes to an empty Box.
+    template <class T> Box<Vec3<T>> decode (const Box<Vec3<T>>& parent) const noexcept;
+
+    void makeEmpty() noexcept;
+    bool isEmpty() const noexcept;
+
+    bool operator== (const QuantizedBox& b) const noexcept;
+    bool operator!= (const QuantizedBox& b) const noexcept;
+
+    // The largest stored value, 255 or 65535.
+    static constexpr unsigned maxValue() noexcept { return Q (~Q (0)); }
+
+    // The distance between the grid planes within a parent box.
+    template <class T> static Vec3<T> step (const Box<Vec3<T>>& parent) noexcept;
+};
+
+//--------------------
+// Convenient typedefs
+//--------------------
+
+typedef QuantizedBox<uint8_t> QuantizedBox8;
+typedef QuantizedBox<uint16_t> QuantizedBox16;
+
+//---------------
+// Implementation
+//---------------
+
+template <class Q>
+template <class T>
+inline QuantizedBox<Q>::QuantizedBox (const Box<Vec3<T>>& box, const Box<Vec3<T>>& parent) noexcept
+{
+    set (box, parent);
+}
+
+template <class Q>
+template <class T>
+inline Vec3<T>
+QuantizedBox<Q>::step (const Box<Vec3<T>>& parent) noexcept
+{
+    return (parent.max - parent.min) * (T (1) / T (maxValue()));
+}
+
+template <class Q>
+template <class T>
+void
+QuantizedBox<Q>::set (const Box<Vec3<T>>& box, const Box<Vec3<T>>& parent) noexcept
+{
+    const unsigned top = maxValue();
+    Vec3<T> s          = step (parent);
+
+    unsigned lo[3], hi[3];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        T boxMin = box.min[i] > parent.min[i] ? box.min[i] : parent.min[i];
+        T boxMax = box.max[i] < parent.max[i] ? box.max[i] : parent.max[i];
+
+        if (!(boxMin <= boxMax))
+        {
+            makeEmpty();
+            return;
+        }
+
+        if (!(s[i] > 0))
+        {
+            // A flat parent: the whole axis decodes to the parent
+            lo[i] = 0;
+            hi[i] = top;
+            continue;
+        }
+
+        //
+        // Estimate the grid planes with a division, then step until
+        // decoding, with the same arithmetic as decode(), yields the
+        // innermost planes on or outside the box.
+        //
+
+        T below = std::floor ((parent.max[i] - boxMax) / s[i]);
+        hi[i]   = top - (below < T (top) ? unsigned (below) : top);
+
+        while (hi[i] < top && parent.max[i] - T (top - hi[i]) * s[i] < boxMax)
+            ++hi[i];
+
+        while (hi[i] > 0 && parent.max[i] - T (top - hi[i] + 1) * s[i] >= boxMax)
+            --hi[i];
+
+        T above = std::floor ((boxMin - parent.min[i]) / s[i]);
+        lo[i]   = above < T (hi[i]) ? unsigned (above) : hi[i];
+
+        while (lo[i] > 0 && parent.min[i] + T (lo[i]) * s[i] > boxMin)
+            --lo[i];
+
+        while (lo[i] < hi[i] && parent.min[i] + T (lo[i] + 1) * s[i] <= boxMin)
+            ++lo[i];
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        min[i] = Q (lo[i]);
+        max[i] = Q (hi[i]);
+    }
+}
+
+template <class Q>
+template <class T>
+inline Box<Vec3<T>>
+QuantizedBox<Q>::decode (const Box<Vec3<T>>& parent) const noexcept
+{
+    if (isEmpty())
+        return Box<Vec3<T>>();
+
+    const unsigned top = maxValue();
+    Vec3<T> s          = step (parent);
+
+    return Box<Vec3<T>> (Vec3<T> (parent.min.x + T (min[0]) * s.x,
+                                  parent.min.y + T (min[1]) * s.y,
+                                  parent.min.z + T (min[2]) * s.z),
+                         Vec3<T> (parent.max.x - T (top - max[0]) * s.x,
+                                  parent.max.y - T (top - max[1]) * s.y,
+                                  parent.max.z - T (top - max[2]) * s.z));
+}
+
+template <class Q>
+inline void
+QuantizedBox<Q>::makeEmpty() noexcept
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        min[i] = Q (maxValue());
+        max[i] = 0;
+    }
+}
+
+template <class Q>
+inline bool
+QuantizedBox<Q>::isEmpty() const noexcept
+{
+    return max[0] < min[0] || max[1] < min[1] || max[2] < min[2];
+}
+
+template <class Q>
+inline bool
+QuantizedBox<Q>::operator== (const QuantizedBox& b) const noexcept
+{
+    return min[0] == b.min[0] && min[1] == b.min[1] && min[2] == b.min[2] &&
+           max[0] == b.max[0] && max[1] == b.max[1] && max[2] == b.max[2];
+}
+
+template <class Q>
+inline bool
+QuantizedBox<Q>::operator!= (const QuantizedBox& b) const noexcept
+{
+    return !(*this == b);
+}
+
+//
+// Decode n boxes quantized relative to the same parent:
+// result[i] = boxes[i].decode (parent) for i in [0, n), with the same
+// arithmetic, so that the results are identical. The result may be an
+// array of Box or in structure-of-arrays layout, for instance to test
+// all children of a node against a frustum or a ray.
+//
+// The decoding loops have no branches, for the compiler to vectorize
+// them; a second loop then makes the empty boxes empty. For arrays
+// of Box, the six components of consecutive boxes are decoded as one
+// flat array, with the coefficients of each component repeated
+// across a block of several boxes, since the components are stored
+// in the same order in QuantizedBox and in Box.
+//
+
+template <class Q, class T>
+void
+decode (const QuantizedBox<Q>* boxes,
+        const Box<Vec3<T>>& parent,
+        const Box3SoA<T>& result,
+        size_t n) noexcept
+{
+    const T top      = T (QuantizedBox<Q>::maxValue());
+    const Vec3<T> s  = QuantizedBox<Q>::step (parent);
+    const Vec3<T> lo = parent.min;
+    const Vec3<T> hi = parent.max;
+
+    for (size_t i = 0; i < n; ++i)
+        result.minX[i] = lo.x + T (boxes[i].min[0]) * s.x;
+    for (size_t i = 0; i < n; ++i)
+        result.minY[i] = lo.y + T (boxes[i].min[1]) * s.y;
+    for (size_t i = 0; i < n; ++i)
+        result.minZ[i] = lo.z + T (boxes[i].min[2]) * s.z;
+    for (size_t i = 0; i < n; ++i)
+        result.maxX[i] = hi.x - (top - T (boxes[i].max[0])) * s.x;
+    for (size_t i = 0; i < n; ++i)
+        result.maxY[i] = hi.y - (top - T (boxes[i].max[1])) * s.y;
+    for (size_t i = 0; i < n; ++i)
+        result.maxZ[i] = hi.z - (top - T (boxes[i].max[2])) * s.z;
+
+    for (size_t i = 0; i < n; ++i)
+        if (boxes[i].isEmpty())
+            result.set (i, Box<Vec3<T>>());
+}
+
+template <class Q, class T>
+void
+decode (const QuantizedBox<Q>* boxes,
+        const Box<Vec3<T>>& parent,
+        Box<Vec3<T>>* result,
+        size_t n) noexcept
+{
+    //
+    // Component k of a box decodes to base[k] + (add[k] + mul[k] * q) * scale[k]:
+    // parent.min + q * step for the minimum, and
+    // parent.max + (maxValue() - q) * -step for the maximum.
+    //
+
+    const size_t blockSize = 6 * 8;
+    const size_t numValues = 6 * n;
+    const T top            = T (QuantizedBox<Q>::maxValue());
+    const Vec3<T> s        = QuantizedBox<Q>::step (parent);
+
+    T base[blockSize], add[blockSize], mul[blockSize], scale[blockSize];
+
+    for (size_t j = 0; j < blockSize && j < numValues; ++j)
+    {
+        int k = int (j % 6);
+
+        if (k < 3)
+        {
+            base[j]  = parent.min[k];
+            add[j]   = T (0);
+            mul[j]   = T (1);
+            scale[j] = s[k];
+        }
+        else
+        {
+            base[j]  = parent.max[k - 3];
+            add[j]   = top;
+            mul[j]   = T (-1);
+            scale[j] = -s[k - 3];
+        }
+    }
+
+    const Q* q = reinterpret_cast<const Q*> (boxes);
+    T* r       = reinterpret_cast<T*> (result);
+    size_t i   = 0;
+
+    for (; i + blockSize <= numValues; i += blockSize)
+        for (size_t j = 0; j < blockSize; ++j)
+            r[i + j] = base[j] + (add[j] + mul[j] * T (q[i + j])) * scale[j];
+
+    for (size_t j = 0; i + j < numValues; ++j)
+        r[i + j] = base[j] + (add[j] + mul[j] * T (q[i + j])) * scale[j];
+
+    for (i = 0; i < n; ++i)
+        if (boxes[i].isEmpty())
+            result[i].makeEmpty();
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHQUANTIZEDBOX_H
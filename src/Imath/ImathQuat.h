@@ -27,7 +27,10 @@
 #include "ImathMatrix.h"
 #include "ImathNamespace.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <type_traits>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -101,6 +104,20 @@ template <class T> class Quat
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T> inverse() const noexcept;
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T>& normalize() noexcept; // returns this
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T> normalized() const noexcept;
+
+    //
+    // renormalize() restores the unit length of a quaternion that
+    // is already close to it, for example after a chain of
+    // multiplications, with one Newton iteration for 1/length()
+    // that starts at 1: it needs no square root and no division.
+    // If |(q ^ q) - 1| <= e <= 1/2, the length of the result differs
+    // from 1 by less than e*e/2.  Use normalize() for quaternions
+    // of arbitrary length.
+    //
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T>& renormalize() noexcept; // returns this
+    IMATH_HOSTDEVICE constexpr Quat<T> renormalized() const noexcept;
+
     IMATH_HOSTDEVICE constexpr T length() const noexcept; // in R4
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T> rotateVector (const Vec3<T>& original) const noexcept;
     IMATH_HOSTDEVICE constexpr T euclideanInnerProduct (const Quat<T>& q) const noexcept;
@@ -349,6 +366,23 @@ Quat<T>::normalized() const noexcept
     return Quat();
 }
 
+template <class T>
+IMATH_CONSTEXPR14 inline Quat<T>&
+Quat<T>::renormalize() noexcept
+{
+    T s = (3 - (*this ^ *this)) / 2;
+    r *= s;
+    v *= s;
+    return *this;
+}
+
+template <class T>
+constexpr inline Quat<T>
+Quat<T>::renormalized() const noexcept
+{
+    return *this * ((3 - (*this ^ *this)) / 2);
+}
+
 template <class T>
 IMATH_CONSTEXPR14 inline Quat<T>
 Quat<T>::inverse() const noexcept
@@ -849,6 +883,1485 @@ operator* (const Vec3<T>& v, const Quat<T>& q) noexcept
     return v + T (2) * (q.r * a + b);
 }
 
+//----------------------------------------------------------------------
+//
+//	Batched interpolation
+//
+//	The array versions of slerp(), slerpShortestArc(), squad() and
+//	intermediate() below evaluate n interpolations per call.  The
+//	quaternions are read and written either as arrays of Quat, or
+//	in structure-of-arrays layout (QuatSoA), which keeps the four
+//	components in separate arrays so that the loops vectorize.
+//
+//	SlerpAccuracy selects how the angle between the quaternions,
+//	and the sines of the partial angles, are computed:
+//
+//	SLERP_EXACT	with the standard math library, exactly like
+//			the scalar slerp()
+//
+//	SLERP_ACCURATE	with polynomial approximations of acos() and
+//			sin(x)/x.  Each component of the result
+//			differs from the exact slerp() by less than
+//			2e-9, which is below float rounding.
+//
+//	SLERP_FAST	with lower order polynomials.  Each component
+//			of the result differs from the exact slerp()
+//			by less than 5e-5.
+//
+//	The error bounds assume unit quaternions, 0 <= t <= 1, and,
+//	for slerp(), that the angle between the quaternions in 4D is
+//	at most pi/2 (that is, q1^q2 >= 0), which slerpShortestArc()
+//	guarantees.  squad() chains three slerps, and the last one
+//	may span nearly pi, where slerp is ill-conditioned, so its
+//	errors can be up to fifty times larger.  Like the scalar
+//	slerp(), all results are normalized.
+//
+//----------------------------------------------------------------------
+
+enum SlerpAccuracy
+{
+    SLERP_FAST,
+    SLERP_ACCURATE,
+    SLERP_EXACT
+};
+
+//
+// A stream of quaternions in structure-of-arrays layout: the i-th
+// quaternion is (r[i], x[i], y[i], z[i]).  Use QuatSoA<const T>
+// for input streams; QuatSoA<T> converts to QuatSoA<const T>.
+// Because of that conversion, the overloads of slerp(),
+// slerpShortestArc(), squad() and intermediate() for QuatSoA cannot
+// deduce T; specify it, as in slerp<float> (q1, q2, t, result, n).
+//
+
+template <class T> class QuatSoA
+{
+  public:
+    typedef typename std::remove_const<T>::type BaseType;
+
+    T* r; // real parts
+    T* x; // imaginary parts
+    T* y;
+    T* z;
+
+    IMATH_HOSTDEVICE constexpr QuatSoA (T* r, T* x, T* y, T* z) noexcept;
+
+    template <class S> IMATH_HOSTDEVICE constexpr QuatSoA (const QuatSoA<S>& q) noexcept;
+
+    // Load and store the i-th quaternion
+
+    IMATH_HOSTDEVICE constexpr Quat<BaseType> operator[] (size_t i) const noexcept;
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 void set (size_t i, const Quat<BaseType>& q) const noexcept;
+};
+
+//
+// A slerp() segment with precomputed angle: for animation curves
+// whose keys are evaluated many times, SlerpKey caches the angle
+// between q1 and q2, and angle / sin(angle), so that evaluating
+// the segment takes only the two sines of the partial angles.
+//
+// If shortestArc is true, q2 is negated when q1^q2 < 0, so that
+// the segment interpolates like slerpShortestArc().
+//
+
+template <class T> class SlerpKey
+{
+  public:
+    Quat<T> q1;
+    Quat<T> q2;
+    T angle; // angle4D (q1, q2)
+    T scale; // angle / sin(angle), or 1 / sinx_over_x (angle)
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 SlerpKey() noexcept; // identity to identity
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14
+    SlerpKey (const Quat<T>& q1, const Quat<T>& q2, bool shortestArc = false) noexcept;
+
+    // Equivalent to slerp (q1, q2, t)
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Quat<T>
+    operator() (T t, SlerpAccuracy accuracy = SLERP_ACCURATE) const noexcept;
+};
+
+//
+// slerp (q1[i], q2[i], t[i]) for i in [0, n), and likewise for
+// slerpShortestArc(), squad() and SlerpKey.  The result may be one
+// of the input arrays.
+//
+
+template <class T>
+void slerp (const QuatSoA<const T>& q1,
+            const QuatSoA<const T>& q2,
+            const T* t,
+            const QuatSoA<T>& result,
+            size_t n,
+            SlerpAccuracy accuracy = SLERP_ACCURATE) noexcept;
+
+template <class T>
+void slerp (const Quat<T>* q1,
+            const Quat<T>* q2,
+            const T* t,
+            Quat<T>* result,
+            size_t n,
+            SlerpAccuracy accuracy = SLERP_ACCURATE) noexcept;
+
+template <class T>
+void slerpShortestArc (const QuatSoA<const T>& q1,
+                       const QuatSoA<const T>& q2,
+                       const T* t,
+                       const QuatSoA<T>& result,
+                       size_t n,
+                       SlerpAccuracy accuracy = SLERP_ACCURATE) noexcept;
+
+template <class T>
+void slerpShortestArc (const Quat<T>* q1,
+                       const Quat<T>* q2,
+                       const T* t,
+                       Quat<T>* result,
+                       size_t n,
+                       SlerpAccuracy accuracy = SLERP_ACCURATE) noexcept;
+
+template <class T>
+void squad (const QuatSoA<const T>& q1,
+            const QuatSoA<const T>& qa,
+            const QuatSoA<const T>& qb,
+            const QuatSoA<const T>& q2,
+            const T* t,
+            const QuatSoA<T>& result,
+            size_t n,
+            SlerpAccuracy accuracy = SLERP_ACCURATE) noexcept;
+
+template <class T>
+void squad (const Quat<T>* q1,
+            const Quat<T>* qa,
+            const Quat<T>* qb,
+            const Quat<T>* q2,
+            const T* t,
+            Quat<T>* result,
+            size_t n,
+            SlerpAccuracy accuracy = SLERP_ACCURATE) noexcept;
+
+template <class T>
+void slerp (const SlerpKey<T>* keys,
+            const T* t,
+            const QuatSoA<T>& result,
+            size_t n,
+            SlerpAccuracy accuracy = SLERP_ACCURATE) noexcept;
+
+template <class T>
+void slerp (const SlerpKey<T>* keys,
+            const T* t,
+            Quat<T>* result,
+            size_t n,
+            SlerpAccuracy accuracy = SLERP_ACCURATE) noexcept;
+
+//
+// intermediate (q0[i], q1[i], q2[i]) for i in [0, n).  This is
+// per-key rather than per-sample work, so it always uses the
+// standard math library.
+//
+
+template <class T>
+void intermediate (const QuatSoA<const T>& q0,
+                   const QuatSoA<const T>& q1,
+                   const QuatSoA<const T>& q2,
+                   const QuatSoA<T>& result,
+                   size_t n) noexcept;
+
+template <class T>
+void intermediate (const Quat<T>* q0,
+                   const Quat<T>* q1,
+                   const Quat<T>* q2,
+                   Quat<T>* result,
+                   size_t n) noexcept;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T>
+constexpr inline QuatSoA<T>::QuatSoA (T* r, T* x, T* y, T* z) noexcept : r (r), x (x), y (y), z (z)
+{
+    // empty
+}
+
+template <class T>
+template <class S>
+constexpr inline QuatSoA<T>::QuatSoA (const QuatSoA<S>& q) noexcept
+    : r (q.r), x (q.x), y (q.y), z (q.z)
+{
+    // empty
+}
+
+template <class T>
+constexpr inline Quat<typename QuatSoA<T>::BaseType>
+QuatSoA<T>::operator[] (size_t i) const noexcept
+{
+    return Quat<BaseType> (r[i], x[i], y[i], z[i]);
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline void
+QuatSoA<T>::set (size_t i, const Quat<BaseType>& q) const noexcept
+{
+    r[i] = q.r;
+    x[i] = q.v.x;
+    y[i] = q.v.y;
+    z[i] = q.v.z;
+}
+
+//
+// QuatBlock holds a block of quaternions in local arrays.  The
+// batched functions copy their inputs into blocks, interpolate
+// within the blocks, and copy the results out.  The interpolation
+// loops then access only local arrays, which the compiler knows
+// do not alias the caller's arrays, so they vectorize without
+// run-time overlap checks, and the result may be one of the
+// inputs.  QuatBlock is not part of the public interface.
+//
+
+template <class T> struct QuatBlock
+{
+    static constexpr size_t size = 64;
+
+    T r[size];
+    T x[size];
+    T y[size];
+    T z[size];
+
+    IMATH_HOSTDEVICE Quat<T> operator[] (size_t j) const noexcept
+    {
+        return Quat<T> (r[j], x[j], y[j], z[j]);
+    }
+
+    IMATH_HOSTDEVICE void set (size_t j, const Quat<T>& q) noexcept
+    {
+        r[j] = q.r;
+        x[j] = q.v.x;
+        y[j] = q.v.y;
+        z[j] = q.v.z;
+    }
+
+    // Copy n quaternions, starting at index i, in or out
+
+    IMATH_HOSTDEVICE void load (const QuatSoA<const T>& q, size_t i, size_t n) noexcept
+    {
+        for (size_t j = 0; j < n; ++j)
+            r[j] = q.r[i + j];
+        for (size_t j = 0; j < n; ++j)
+            x[j] = q.x[i + j];
+        for (size_t j = 0; j < n; ++j)
+            y[j] = q.y[i + j];
+        for (size_t j = 0; j < n; ++j)
+            z[j] = q.z[i + j];
+    }
+
+    IMATH_HOSTDEVICE void load (const Quat<T>* q, size_t i, size_t n) noexcept
+    {
+        for (size_t j = 0; j < n; ++j)
+            set (j, q[i + j]);
+    }
+
+    IMATH_HOSTDEVICE void store (const QuatSoA<T>& q, size_t i, size_t n) const noexcept
+    {
+        for (size_t j = 0; j < n; ++j)
+            q.r[i + j] = r[j];
+        for (size_t j = 0; j < n; ++j)
+            q.x[i + j] = x[j];
+        for (size_t j = 0; j < n; ++j)
+            q.y[i + j] = y[j];
+        for (size_t j = 0; j < n; ++j)
+            q.z[i + j] = z[j];
+    }
+
+    IMATH_HOSTDEVICE void store (Quat<T>* q, size_t i, size_t n) const noexcept
+    {
+        for (size_t j = 0; j < n; ++j)
+            q[i + j] = (*this)[j];
+    }
+};
+
+//
+// SlerpKernel implements the interpolation at the given accuracy,
+// for one quaternion, and for arrays, block by block.  It is not
+// part of the public interface.
+//
+// The polynomials are minimax fits: acos(x) = sqrt(1-x) * P(x) on
+// [0, 1], and sin(x)/x = (pi*pi - x*x) * Q(x*x) on [0, pi].  The
+// factor (pi*pi - x*x) keeps the relative error of sin(x)/x
+// bounded as x approaches pi, where the weights of slerp() divide
+// by it.  The branches on Accuracy are resolved at compile time,
+// and the interpolation has no other branches, so that the loops
+// vectorize.  (With gcc, vectorizing std::sqrt() requires
+// -fno-math-errno, which -ffast-math implies.)
+//
+
+template <class T, int Accuracy> struct SlerpKernel
+{
+    IMATH_HOSTDEVICE static IMATH_CONSTEXPR14 T acos (T x) noexcept
+    {
+        T a = std::abs (x);
+        T p;
+
+        if (Accuracy == SLERP_FAST)
+        {
+            p = T (1.5707580797720502) +
+                a * (T (-0.21287226807479825) +
+                     a * (T (0.07689003531935056) + a * T (-0.020887015640381316)));
+        }
+        else
+        {
+            p = T (1.570796314254386) +
+                a * (T (-0.21459988920606596) +
+                     a * (T (0.08899922233817541) +
+                          a * (T (-0.050312549405132995) +
+                               a * (T (0.03133482231886215) +
+                                    a * (T (-0.017808045953770578) +
+                                         a * (T (0.007244765984562259) +
+                                              a * T (-0.0014412836952366528)))))));
+        }
+
+        //
+        // acos(x) = pi - acos(-x) for negative x.  Apply the sign
+        // with copysign() rather than a conditional, so that the
+        // loops that call this have no branches.
+        //
+
+        p *= std::sqrt (std::max (1 - a, T (0)));
+        return T (M_PI_2) - std::copysign (T (M_PI_2), x) + std::copysign (p, x);
+    }
+
+    IMATH_HOSTDEVICE static IMATH_CONSTEXPR14 T sinxOverX (T x) noexcept
+    {
+        if (Accuracy == SLERP_EXACT)
+            return sinx_over_x (x);
+
+        T x2 = x * x;
+        T p;
+
+        if (Accuracy == SLERP_FAST)
+        {
+            p = T (0.10131910436403334) +
+                x2 * (T (-0.006614988666288049) +
+                      x2 * (T (0.00017071853418611368) + x2 * T (-2.0821620020462367e-06)));
+        }
+        else
+        {
+            p = T (0.10132118365566097) +
+                x2 * (T (-0.0066208817499045745) +
+                      x2 * (T (0.00017350767591641463) +
+                            x2 * (T (-2.5234198382206326e-06) +
+                                  x2 * (T (2.353752625279656e-08) +
+                                        x2 * (T (-1.5266541298101756e-10) +
+                                              x2 * T (6.66109958903316e-13))))));
+        }
+
+        return (T (M_PI * M_PI) - x2) * p;
+    }
+
+    //
+    // Weighted sum of q1 and q2 for slerp, given the angle
+    // between them and scale = 1 / sinxOverX (angle)
+    //
+
+    IMATH_HOSTDEVICE static IMATH_CONSTEXPR14 Quat<T>
+    blend (const Quat<T>& q1, const Quat<T>& q2, T angle, T scale, T t) noexcept
+    {
+        T s  = 1 - t;
+        T w1 = sinxOverX (s * angle) * scale * s;
+        T w2 = sinxOverX (t * angle) * scale * t;
+
+        Quat<T> q (w1 * q1.r + w2 * q2.r,
+                   w1 * q1.v.x + w2 * q2.v.x,
+                   w1 * q1.v.y + w2 * q2.v.y,
+                   w1 * q1.v.z + w2 * q2.v.z);
+
+        if (Accuracy == SLERP_EXACT)
+            return q.normalized();
+
+        T l = 1 / std::sqrt (q ^ q);
+        return q * l;
+    }
+
+    IMATH_HOSTDEVICE static IMATH_CONSTEXPR14 Quat<T>
+    slerp (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept
+    {
+        if (Accuracy == SLERP_EXACT)
+            return IMATH_INTERNAL_NAMESPACE::slerp (q1, q2, t);
+
+        T a = acos (q1 ^ q2);
+        return blend (q1, q2, a, 1 / sinxOverX (a), t);
+    }
+
+    IMATH_HOSTDEVICE static IMATH_CONSTEXPR14 Quat<T>
+    slerpShortestArc (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept
+    {
+        return slerp (q1, q2 * std::copysign (T (1), q1 ^ q2), t);
+    }
+
+    IMATH_HOSTDEVICE static IMATH_CONSTEXPR14 Quat<T> squad (const Quat<T>& q1,
+                                                               const Quat<T>& qa,
+                                                               const Quat<T>& qb,
+                                                               const Quat<T>& q2,
+                                                               T t) noexcept
+    {
+        Quat<T> r1 = slerp (q1, q2, t);
+        Quat<T> r2 = slerp (qa, qb, t);
+        return slerp (r1, r2, 2 * t * (1 - t));
+    }
+
+    template <class In, class Out>
+    IMATH_HOSTDEVICE static void slerpBatch (const In& q1,
+                                             const In& q2,
+                                             const T* t,
+                                             const Out& result,
+                                             size_t n,
+                                             bool shortestArc) noexcept
+    {
+        QuatBlock<T> b1, b2;
+
+        for (size_t i = 0; i < n; i += QuatBlock<T>::size)
+        {
+            size_t m    = std::min (n - i, size_t (QuatBlock<T>::size));
+            const T* ti = t + i;
+
+            b1.load (q1, i, m);
+            b2.load (q2, i, m);
+
+            if (shortestArc)
+            {
+                for (size_t j = 0; j < m; ++j)
+                    b1.set (j, slerpShortestArc (b1[j], b2[j], ti[j]));
+            }
+            else
+            {
+                for (size_t j = 0; j < m; ++j)
+                    b1.set (j, slerp (b1[j], b2[j], ti[j]));
+            }
+
+            b1.store (result, i, m);
+        }
+    }
+
+    template <class In, class Out>
+    IMATH_HOSTDEVICE static void squadBatch (const In& q1,
+                                             const In& qa,
+                                             const In& qb,
+                                             const In& q2,
+                                             const T* t,
+                                             const Out& result,
+                                             size_t n) noexcept
+    {
+        QuatBlock<T> b1, ba, bb, b2;
+
+        for (size_t i = 0; i < n; i += QuatBlock<T>::size)
+        {
+            size_t m    = std::min (n - i, size_t (QuatBlock<T>::size));
+            const T* ti = t + i;
+
+            b1.load (q1, i, m);
+            ba.load (qa, i, m);
+            bb.load (qb, i, m);
+            b2.load (q2, i, m);
+
+            for (size_t j = 0; j < m; ++j)
+                b1.set (j, squad (b1[j], ba[j], bb[j], b2[j], ti[j]));
+
+            b1.store (result, i, m);
+        }
+    }
+
+    template <class Out>
+    IMATH_HOSTDEVICE static void
+    keyBatch (const SlerpKey<T>* keys, const T* t, const Out& result, size_t n) noexcept
+    {
+        QuatBlock<T> b;
+
+        for (size_t i = 0; i < n; i += QuatBlock<T>::size)
+        {
+            size_t m              = std::min (n - i, size_t (QuatBlock<T>::size));
+            const T* ti           = t + i;
+            const SlerpKey<T>* ki = keys + i;
+
+            for (size_t j = 0; j < m; ++j)
+                b.set (j, blend (ki[j].q1, ki[j].q2, ki[j].angle, ki[j].scale, ti[j]));
+
+            b.store (result, i, m);
+        }
+    }
+};
+
+template <class T>
+IMATH_CONSTEXPR14 inline SlerpKey<T>::SlerpKey() noexcept : q1(), q2(), angle (0), scale (1)
+{
+    // empty
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline SlerpKey<T>::SlerpKey (const Quat<T>& q1,
+                                                const Quat<T>& q2,
+                                                bool shortestArc) noexcept
+    : q1 (q1), q2 (shortestArc && (q1 ^ q2) < 0 ? -q2 : q2)
+{
+    angle = angle4D (this->q1, this->q2);
+    scale = 1 / sinx_over_x (angle);
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Quat<T>
+SlerpKey<T>::operator() (T t, SlerpAccuracy accuracy) const noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST: return SlerpKernel<T, SLERP_FAST>::blend (q1, q2, angle, scale, t);
+        case SLERP_ACCURATE: return SlerpKernel<T, SLERP_ACCURATE>::blend (q1, q2, angle, scale, t);
+        default: return SlerpKernel<T, SLERP_EXACT>::blend (q1, q2, angle, scale, t);
+    }
+}
+
+//
+// The batched functions dispatch on the accuracy once, outside
+// the loops.
+//
+
+template <class T>
+inline void
+slerp (const QuatSoA<const T>& q1,
+       const QuatSoA<const T>& q2,
+       const T* t,
+       const QuatSoA<T>& result,
+       size_t n,
+       SlerpAccuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST:
+            SlerpKernel<T, SLERP_FAST>::slerpBatch (q1, q2, t, result, n, false);
+            break;
+        case SLERP_ACCURATE:
+            SlerpKernel<T, SLERP_ACCURATE>::slerpBatch (q1, q2, t, result, n, false);
+            break;
+        default:
+            SlerpKernel<T, SLERP_EXACT>::slerpBatch (q1, q2, t, result, n, false);
+    }
+}
+
+template <class T>
+inline void
+slerp (const Quat<T>* q1,
+       const Quat<T>* q2,
+       const T* t,
+       Quat<T>* result,
+       size_t n,
+       SlerpAccuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST:
+            SlerpKernel<T, SLERP_FAST>::slerpBatch (q1, q2, t, result, n, false);
+            break;
+        case SLERP_ACCURATE:
+            SlerpKernel<T, SLERP_ACCURATE>::slerpBatch (q1, q2, t, result, n, false);
+            break;
+        default:
+            SlerpKernel<T, SLERP_EXACT>::slerpBatch (q1, q2, t, result, n, false);
+    }
+}
+
+template <class T>
+inline void
+slerpShortestArc (const QuatSoA<const T>& q1,
+                  const QuatSoA<const T>& q2,
+                  const T* t,
+                  const QuatSoA<T>& result,
+                  size_t n,
+                  SlerpAccuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST:
+            SlerpKernel<T, SLERP_FAST>::slerpBatch (q1, q2, t, result, n, true);
+            break;
+        case SLERP_ACCURATE:
+            SlerpKernel<T, SLERP_ACCURATE>::slerpBatch (q1, q2, t, result, n, true);
+            break;
+        default:
+            SlerpKernel<T, SLERP_EXACT>::slerpBatch (q1, q2, t, result, n, true);
+    }
+}
+
+template <class T>
+inline void
+slerpShortestArc (const Quat<T>* q1,
+                  const Quat<T>* q2,
+                  const T* t,
+                  Quat<T>* result,
+                  size_t n,
+                  SlerpAccuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST:
+            SlerpKernel<T, SLERP_FAST>::slerpBatch (q1, q2, t, result, n, true);
+            break;
+        case SLERP_ACCURATE:
+            SlerpKernel<T, SLERP_ACCURATE>::slerpBatch (q1, q2, t, result, n, true);
+            break;
+        default:
+            SlerpKernel<T, SLERP_EXACT>::slerpBatch (q1, q2, t, result, n, true);
+    }
+}
+
+template <class T>
+inline void
+squad (const QuatSoA<const T>& q1,
+       const QuatSoA<const T>& qa,
+       const QuatSoA<const T>& qb,
+       const QuatSoA<const T>& q2,
+       const T* t,
+       const QuatSoA<T>& result,
+       size_t n,
+       SlerpAccuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST:
+            SlerpKernel<T, SLERP_FAST>::squadBatch (q1, qa, qb, q2, t, result, n);
+            break;
+        case SLERP_ACCURATE:
+            SlerpKernel<T, SLERP_ACCURATE>::squadBatch (q1, qa, qb, q2, t, result, n);
+            break;
+        default:
+            SlerpKernel<T, SLERP_EXACT>::squadBatch (q1, qa, qb, q2, t, result, n);
+    }
+}
+
+template <class T>
+inline void
+squad (const Quat<T>* q1,
+       const Quat<T>* qa,
+       const Quat<T>* qb,
+       const Quat<T>* q2,
+       const T* t,
+       Quat<T>* result,
+       size_t n,
+       SlerpAccuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST:
+            SlerpKernel<T, SLERP_FAST>::squadBatch (q1, qa, qb, q2, t, result, n);
+            break;
+        case SLERP_ACCURATE:
+            SlerpKernel<T, SLERP_ACCURATE>::squadBatch (q1, qa, qb, q2, t, result, n);
+            break;
+        default:
+            SlerpKernel<T, SLERP_EXACT>::squadBatch (q1, qa, qb, q2, t, result, n);
+    }
+}
+
+template <class T>
+inline void
+slerp (const SlerpKey<T>* keys,
+       const T* t,
+       const QuatSoA<T>& result,
+       size_t n,
+       SlerpAccuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST:
+            SlerpKernel<T, SLERP_FAST>::keyBatch (keys, t, result, n);
+            break;
+        case SLERP_ACCURATE:
+            SlerpKernel<T, SLERP_ACCURATE>::keyBatch (keys, t, result, n);
+            break;
+        default:
+            SlerpKernel<T, SLERP_EXACT>::keyBatch (keys, t, result, n);
+    }
+}
+
+template <class T>
+inline void
+slerp (const SlerpKey<T>* keys,
+       const T* t,
+       Quat<T>* result,
+       size_t n,
+       SlerpAccuracy accuracy) noexcept
+{
+    switch (accuracy)
+    {
+        case SLERP_FAST:
+            SlerpKernel<T, SLERP_FAST>::keyBatch (keys, t, result, n);
+            break;
+        case SLERP_ACCURATE:
+            SlerpKernel<T, SLERP_ACCURATE>::keyBatch (keys, t, result, n);
+            break;
+        default:
+            SlerpKernel<T, SLERP_EXACT>::keyBatch (keys, t, result, n);
+    }
+}
+
+template <class T>
+inline void
+intermediate (const QuatSoA<const T>& q0,
+              const QuatSoA<const T>& q1,
+              const QuatSoA<const T>& q2,
+              const QuatSoA<T>& result,
+              size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result.set (i, intermediate (q0[i], q1[i], q2[i]));
+}
+
+template <class T>
+inline void
+intermediate (const Quat<T>* q0,
+              const Quat<T>* q1,
+              const Quat<T>* q2,
+              Quat<T>* result,
+              size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = intermediate (q0[i], q1[i], q2[i]);
+}
+
+//----------------------------------------------------------------------
+//
+//	Normalized linear interpolation
+//
+//	nlerp (q1, q2, t) interpolates linearly between q1 and q2, or
+//	-q2, whichever is closer to q1, and normalizes the result.  It
+//	follows the same arc as slerpShortestArc(), but not at constant
+//	speed: for unit quaternions, each component of the result
+//	differs from slerpShortestArc() by up to 0.072.
+//
+//	nlerpCorrected (q1, q2, t) first corrects t with a cubic in t,
+//	whose coefficients depend on |q1 ^ q2| (the correction proposed
+//	by Eberly, and by Kavan et al. for dual quaternions, fitted
+//	here for minimax error).  Each component of the result differs
+//	from slerpShortestArc() by less than 5e-4, at a fraction of
+//	the cost.
+//
+//	Both assume unit quaternions and 0 <= t <= 1.  The results are
+//	normalized with one reciprocal square root; since the length of
+//	the interpolated quaternion is at least sqrt(0.5), no check for
+//	zero length is needed.
+//
+//----------------------------------------------------------------------
+
+template <class T>
+IMATH_CONSTEXPR14 Quat<T> nlerp (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept;
+
+template <class T>
+IMATH_CONSTEXPR14 Quat<T> nlerpCorrected (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept;
+
+//
+// nlerp (q1[i], q2[i], t[i]) and nlerpCorrected (q1[i], q2[i], t[i])
+// for i in [0, n).  The result may be one of the input arrays.
+//
+
+template <class T>
+void nlerp (const QuatSoA<const T>& q1,
+            const QuatSoA<const T>& q2,
+            const T* t,
+            const QuatSoA<T>& result,
+            size_t n) noexcept;
+
+template <class T>
+void nlerp (const Quat<T>* q1, const Quat<T>* q2, const T* t, Quat<T>* result, size_t n) noexcept;
+
+template <class T>
+void nlerpCorrected (const QuatSoA<const T>& q1,
+                     const QuatSoA<const T>& q2,
+                     const T* t,
+                     const QuatSoA<T>& result,
+                     size_t n) noexcept;
+
+template <class T>
+void nlerpCorrected (const Quat<T>* q1,
+                     const Quat<T>* q2,
+                     const T* t,
+                     Quat<T>* result,
+                     size_t n) noexcept;
+
+//
+// q[i].normalize() and q[i].renormalize() for i in [0, n)
+//
+
+template <class T> void normalize (Quat<T>* q, size_t n) noexcept;
+
+template <class T> void renormalize (Quat<T>* q, size_t n) noexcept;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T>
+IMATH_CONSTEXPR14 inline Quat<T>
+nlerp (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept
+{
+    T w2 = std::copysign (t, q1 ^ q2);
+
+    Quat<T> q = q1 * (1 - t) + q2 * w2;
+    return q * (1 / std::sqrt (q ^ q));
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Quat<T>
+nlerpCorrected (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept
+{
+    //
+    // slerp() and nlerp() follow the same arc, so there is a t'
+    // for which nlerp (q1, q2, t') == slerpShortestArc (q1, q2, t).
+    // t' - t is zero at t = 0, 1/2 and 1; approximate it by
+    // t * (t - 1/2) * (t - 1) * (a + b * (t - 1/2)^2), with a and
+    // b polynomials in d = |q1 ^ q2|.
+    //
+
+    T d = std::abs (q1 ^ q2);
+    T u = t - T (0.5);
+    T a = T (0.858295184782992) + d * (T (-1.190919643733628) + d * T (0.3938482440510268));
+    T b = T (0.9742632353354888) + d * T (-1.4907185334663242);
+
+    return nlerp (q1, q2, t + t * u * (t - 1) * (a + b * u * u));
+}
+
+template <class T>
+inline void
+nlerp (const QuatSoA<const T>& q1,
+       const QuatSoA<const T>& q2,
+       const T* t,
+       const QuatSoA<T>& result,
+       size_t n) noexcept
+{
+    QuatBlock<T> b1, b2;
+
+    for (size_t i = 0; i < n; i += QuatBlock<T>::size)
+    {
+        size_t m    = std::min (n - i, size_t (QuatBlock<T>::size));
+        const T* ti = t + i;
+
+        b1.load (q1, i, m);
+        b2.load (q2, i, m);
+
+        for (size_t j = 0; j < m; ++j)
+            b1.set (j, nlerp (b1[j], b2[j], ti[j]));
+
+        b1.store (result, i, m);
+    }
+}
+
+template <class T>
+inline void
+nlerp (const Quat<T>* q1, const Quat<T>* q2, const T* t, Quat<T>* result, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = nlerp (q1[i], q2[i], t[i]);
+}
+
+template <class T>
+inline void
+nlerpCorrected (const QuatSoA<const T>& q1,
+                const QuatSoA<const T>& q2,
+                const T* t,
+                const QuatSoA<T>& result,
+                size_t n) noexcept
+{
+    QuatBlock<T> b1, b2;
+
+    for (size_t i = 0; i < n; i += QuatBlock<T>::size)
+    {
+        size_t m    = std::min (n - i, size_t (QuatBlock<T>::size));
+        const T* ti = t + i;
+
+        b1.load (q1, i, m);
+        b2.load (q2, i, m);
+
+        for (size_t j = 0; j < m; ++j)
+            b1.set (j, nlerpCorrected (b1[j], b2[j], ti[j]));
+
+        b1.store (result, i, m);
+    }
+}
+
+template <class T>
+inline void
+nlerpCorrected (const Quat<T>* q1,
+                const Quat<T>* q2,
+                const T* t,
+                Quat<T>* result,
+                size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = nlerpCorrected (q1[i], q2[i], t[i]);
+}
+
+template <class T>
+inline void
+normalize (Quat<T>* q, size_t n) noexcept
+{
+    //
+    // A branch-free version with one reciprocal square root was
+    // slower than this loop, which the compiler unrolls, and turned
+    // NaN quaternions into (1, NaN, NaN, NaN).
+    //
+
+    for (size_t i = 0; i < n; ++i)
+        q[i].normalize();
+}
+
+template <class T>
+inline void
+renormalize (Quat<T>* q, size_t n) noexcept
+{
+    //
+    // Quat::renormalize(), with the same arithmetic, on blocks in
+    // structure-of-arrays layout, where the dot products vectorize
+    //
+
+    QuatBlock<T> b;
+
+    for (size_t i = 0; i < n; i += QuatBlock<T>::size)
+    {
+        size_t m = std::min (n - i, size_t (QuatBlock<T>::size));
+
+        b.load (q, i, m);
+
+        for (size_t j = 0; j < m; ++j)
+        {
+            T d = b.r[j] * b.r[j] + (b.x[j] * b.x[j] + b.y[j] * b.y[j] + b.z[j] * b.z[j]);
+            T s = (3 - d) / 2;
+
+            b.r[j] *= s;
+            b.x[j] *= s;
+            b.y[j] *= s;
+            b.z[j] *= s;
+        }
+
+        b.store (q, i, m);
+    }
+}
+
+//----------------------------------------------------------------------
+//
+//	template class DualQuat<T>
+//
+//	A dual quaternion r + e*d, where e*e == 0, represents a rigid
+//	transformation (rotation followed by translation) in eight
+//	numbers.  Unlike Matrix44, dual quaternions can be blended
+//	linearly (dlb) without shrinking the result, which makes them
+//	the usual representation for skinning.
+//
+//	Multiplication follows the Quat convention: (a * b) applies
+//	b first, then a.  Consequently
+//
+//	    (a * b).toMatrix44() == b.toMatrix44() * a.toMatrix44()
+//
+//	Use extractDualQuat() in ImathMatrixAlgo.h to convert a
+//	Matrix44 (without scale or shear) to a dual quaternion.
+//
+//----------------------------------------------------------------------
+
+template <class T> class DualQuat
+{
+  public:
+    Quat<T> r; // real part: the rotation
+    Quat<T> d; // dual part: translation * rotation / 2
+
+    //----------------------------------------------------------
+    // Constructors - default constructor is the identity, which
+    // has no rotation and no translation
+    //----------------------------------------------------------
+
+    IMATH_HOSTDEVICE constexpr DualQuat() noexcept;
+
+    template <class S> IMATH_HOSTDEVICE constexpr DualQuat (const DualQuat<S>& dq) noexcept;
+
+    IMATH_HOSTDEVICE constexpr DualQuat (const Quat<T>& real, const Quat<T>& dual) noexcept;
+
+    // Rotation by the unit quaternion q, followed by translation t
+
+    IMATH_HOSTDEVICE constexpr DualQuat (const Quat<T>& q, const Vec3<T>& t) noexcept;
+
+    IMATH_HOSTDEVICE constexpr static DualQuat<T> identity() noexcept;
+
+    //-------------------------------------------------
+    //	Basic Algebra - Operators and Methods
+    //  The operator return values are *NOT* normalized
+    //
+    //  operator~ is the quaternion conjugate of both
+    //            parts, which is the inverse of a unit
+    //            dual quaternion
+    //
+    //  some operators (*,*=,+,-) treat the dual quat as
+    //	an 8D vector when one of the operands is scalar
+    //-------------------------------------------------
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>& operator*= (const DualQuat<T>& dq) noexcept;
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>& operator*= (T t) noexcept;
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>& operator+= (const DualQuat<T>& dq) noexcept;
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>& operator-= (const DualQuat<T>& dq) noexcept;
+
+    template <class S> IMATH_HOSTDEVICE constexpr bool operator== (const DualQuat<S>& dq) const noexcept;
+    template <class S> IMATH_HOSTDEVICE constexpr bool operator!= (const DualQuat<S>& dq) const noexcept;
+
+    //
+    // normalize() scales the dual quaternion so that the real
+    // part has unit length, and removes the component of the dual
+    // part parallel to the real part, so that the result is again
+    // a rigid transformation.
+    //
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>& normalize() noexcept; // returns this
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T> normalized() const noexcept;
+
+    // Inverse of a unit dual quaternion
+
+    IMATH_HOSTDEVICE constexpr DualQuat<T> inverse() const noexcept;
+
+    //-----------------------------------------------------
+    //	Transform conversion; these assume unit dual quats
+    //-----------------------------------------------------
+
+    IMATH_HOSTDEVICE constexpr Quat<T> rotation() const noexcept;
+    IMATH_HOSTDEVICE constexpr Vec3<T> translation() const noexcept;
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T> transform (const Vec3<T>& p) const noexcept;
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Matrix44<T> toMatrix44() const noexcept;
+};
+
+//
+// Screw linear interpolation: interpolates the rotation angle and
+// the translation along the screw axis of dq1^-1 * dq2 at constant
+// speed, along the shortest arc.  Assumes unit dual quaternions.
+//
+
+template <class T>
+IMATH_CONSTEXPR14 DualQuat<T> sclerp (const DualQuat<T>& dq1, const DualQuat<T>& dq2, T t) noexcept;
+
+//
+// Dual quaternion linear blending (Kavan et al.): the normalized,
+// weighted sum of the dual quaternions.  Each dual quaternion is
+// flipped into the hemisphere of the first one, so that blending
+// always takes the shortest path.
+//
+
+template <class T>
+IMATH_CONSTEXPR14 DualQuat<T>
+dlb (const DualQuat<T>& dq1, const DualQuat<T>& dq2, T t) noexcept;
+
+template <class T>
+IMATH_CONSTEXPR14 DualQuat<T> dlb (const DualQuat<T>* dq, const T* weights, size_t n) noexcept;
+
+//
+// Batched dual quaternion linear blending, for skinning: for each
+// of the n results, blend the "influences" joints selected by
+// jointIndices[i * influences + k] with weights[i * influences + k].
+// The joint transforms are read through the index array, so they
+// can be shared by all results. With no influences, the results are
+// the identity, as for an empty blend.
+//
+
+template <class T>
+void dlb (const DualQuat<T>* joints,
+          const int* jointIndices,
+          const T* weights,
+          int influences,
+          size_t n,
+          DualQuat<T>* result) noexcept;
+
+//
+// Transform n points by the corresponding n dual quaternions.
+// src and dst may be the same array.
+//
+
+template <class T>
+void transform (const DualQuat<T>* dq, const Vec3<T>* src, Vec3<T>* dst, size_t n) noexcept;
+
+template <class T> std::ostream& operator<< (std::ostream& o, const DualQuat<T>& dq);
+
+template <class T>
+constexpr DualQuat<T> operator* (const DualQuat<T>& dq1, const DualQuat<T>& dq2) noexcept;
+
+template <class T> constexpr DualQuat<T> operator* (const DualQuat<T>& dq, T t) noexcept;
+
+template <class T> constexpr DualQuat<T> operator* (T t, const DualQuat<T>& dq) noexcept;
+
+template <class T>
+constexpr DualQuat<T> operator+ (const DualQuat<T>& dq1, const DualQuat<T>& dq2) noexcept;
+
+template <class T>
+constexpr DualQuat<T> operator- (const DualQuat<T>& dq1, const DualQuat<T>& dq2) noexcept;
+
+template <class T> constexpr DualQuat<T> operator~ (const DualQuat<T>& dq) noexcept;
+
+template <class T> constexpr DualQuat<T> operator- (const DualQuat<T>& dq) noexcept;
+
+template <class T>
+IMATH_CONSTEXPR14 Vec3<T> operator* (const Vec3<T>& v, const DualQuat<T>& dq) noexcept;
+
+//--------------------
+// Convenient typedefs
+//--------------------
+
+typedef DualQuat<float> DualQuatf;
+typedef DualQuat<double> DualQuatd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T> constexpr inline DualQuat<T>::DualQuat() noexcept : r(), d (0, 0, 0, 0)
+{
+    // empty
+}
+
+template <class T>
+template <class S>
+constexpr inline DualQuat<T>::DualQuat (const DualQuat<S>& dq) noexcept : r (dq.r), d (dq.d)
+{
+    // empty
+}
+
+template <class T>
+constexpr inline DualQuat<T>::DualQuat (const Quat<T>& real, const Quat<T>& dual) noexcept
+    : r (real), d (dual)
+{
+    // empty
+}
+
+template <class T>
+constexpr inline DualQuat<T>::DualQuat (const Quat<T>& q, const Vec3<T>& t) noexcept
+    : r (q), d (Quat<T> (0, t * T (0.5)) * q)
+{
+    // empty
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+DualQuat<T>::identity() noexcept
+{
+    return DualQuat<T>();
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator*= (const DualQuat<T>& dq) noexcept
+{
+    d = r * dq.d + d * dq.r;
+    r *= dq.r;
+    return *this;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator*= (T t) noexcept
+{
+    r *= t;
+    d *= t;
+    return *this;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator+= (const DualQuat<T>& dq) noexcept
+{
+    r += dq.r;
+    d += dq.d;
+    return *this;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator-= (const DualQuat<T>& dq) noexcept
+{
+    r -= dq.r;
+    d -= dq.d;
+    return *this;
+}
+
+template <class T>
+template <class S>
+constexpr inline bool
+DualQuat<T>::operator== (const DualQuat<S>& dq) const noexcept
+{
+    return r == dq.r && d == dq.d;
+}
+
+template <class T>
+template <class S>
+constexpr inline bool
+DualQuat<T>::operator!= (const DualQuat<S>& dq) const noexcept
+{
+    return r != dq.r || d != dq.d;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline DualQuat<T>&
+DualQuat<T>::normalize() noexcept
+{
+    T l2 = r ^ r;
+
+    if (l2 == 0)
+    {
+        r = Quat<T>();
+        d = Quat<T> (0, 0, 0, 0);
+        return *this;
+    }
+
+    //
+    // A unit dual quaternion satisfies r ^ r == 1 and r ^ d == 0.
+    //
+
+    T il = 1 / std::sqrt (l2);
+    r *= il;
+    d *= il;
+    d -= r * (r ^ d);
+    return *this;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline DualQuat<T>
+DualQuat<T>::normalized() const noexcept
+{
+    DualQuat<T> dq (*this);
+    return dq.normalize();
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+DualQuat<T>::inverse() const noexcept
+{
+    return DualQuat<T> (~r, ~d);
+}
+
+template <class T>
+constexpr inline Quat<T>
+DualQuat<T>::rotation() const noexcept
+{
+    return r;
+}
+
+template <class T>
+constexpr inline Vec3<T>
+DualQuat<T>::translation() const noexcept
+{
+    //
+    // t = 2 * d * r*, expanded so that only the vector part
+    // is computed.
+    //
+
+    return T (2) * (r.r * d.v - d.r * r.v + (d.v % -r.v));
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::transform (const Vec3<T>& p) const noexcept
+{
+    return p * r + translation();
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Matrix44<T>
+DualQuat<T>::toMatrix44() const noexcept
+{
+    Matrix44<T> m = r.toMatrix44();
+    Vec3<T> t     = translation();
+    m[3][0]       = t.x;
+    m[3][1]       = t.y;
+    m[3][2]       = t.z;
+    return m;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline DualQuat<T>
+sclerp (const DualQuat<T>& dq1, const DualQuat<T>& dq2, T t) noexcept
+{
+    //
+    // Express the relative transformation dq1^-1 * dq2 as a screw
+    // motion (rotation by theta about, and translation by dist
+    // along, the line with direction l and moment m), scale theta
+    // and dist by t, and apply the result to dq1.
+    //
+
+    DualQuat<T> diff = dq1.inverse() * ((dq1.r ^ dq2.r) < 0 ? -dq2 : dq2);
+
+    T sinHalf = diff.r.v.length();
+
+    if (sinHalf <= limits<T>::epsilon())
+    {
+        //
+        // No rotation: pure translation, which is linear in t.
+        //
+
+        return dq1 * DualQuat<T> (Quat<T>(), diff.translation() * t);
+    }
+
+    T cosHalf   = diff.r.r;
+    T halfTheta = std::atan2 (sinHalf, cosHalf);
+    Vec3<T> l   = diff.r.v / sinHalf;
+    T halfDist  = -diff.d.r / sinHalf;
+    Vec3<T> m   = (diff.d.v - l * (halfDist * cosHalf)) / sinHalf;
+
+    halfTheta *= t;
+    halfDist *= t;
+    sinHalf = std::sin (halfTheta);
+    cosHalf = std::cos (halfTheta);
+
+    DualQuat<T> p (Quat<T> (cosHalf, l * sinHalf),
+                   Quat<T> (-halfDist * sinHalf, m * sinHalf + l * (halfDist * cosHalf)));
+
+    return dq1 * p;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline DualQuat<T>
+dlb (const DualQuat<T>& dq1, const DualQuat<T>& dq2, T t) noexcept
+{
+    T w2 = (dq1.r ^ dq2.r) < 0 ? -t : t;
+    return (dq1 * (1 - t) + dq2 * w2).normalize();
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline DualQuat<T>
+dlb (const DualQuat<T>* dq, const T* weights, size_t n) noexcept
+{
+    if (n == 0)
+        return DualQuat<T>();
+
+    DualQuat<T> sum = dq[0] * weights[0];
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        T w = (dq[0].r ^ dq[i].r) < 0 ? -weights[i] : weights[i];
+        sum += dq[i] * w;
+    }
+
+    return sum.normalize();
+}
+
+template <class T>
+inline void
+dlb (const DualQuat<T>* joints,
+     const int* jointIndices,
+     const T* weights,
+     int influences,
+     size_t n,
+     DualQuat<T>* result) noexcept
+{
+    if (influences <= 0)
+    {
+        for (size_t i = 0; i < n; ++i)
+            result[i] = DualQuat<T>();
+
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int* index = jointIndices + i * influences;
+        const T* weight  = weights + i * influences;
+
+        //
+        // Accumulate into plain scalars rather than through
+        // DualQuat operators, so that the eight sums stay in
+        // registers.
+        //
+
+        const DualQuat<T>& pivot = joints[index[0]];
+        T s[8]                   = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+        for (int k = 0; k < influences; ++k)
+        {
+            const DualQuat<T>& j = joints[index[k]];
+            T w                  = (pivot.r ^ j.r) < 0 ? -weight[k] : weight[k];
+
+            s[0] += w * j.r.r;
+            s[1] += w * j.r.v.x;
+            s[2] += w * j.r.v.y;
+            s[3] += w * j.r.v.z;
+            s[4] += w * j.d.r;
+            s[5] += w * j.d.v.x;
+            s[6] += w * j.d.v.y;
+            s[7] += w * j.d.v.z;
+        }
+
+        result[i] = DualQuat<T> (Quat<T> (s[0], s[1], s[2], s[3]), Quat<T> (s[4], s[5], s[6], s[7]));
+        result[i].normalize();
+    }
+}
+
+template <class T>
+inline void
+transform (const DualQuat<T>* dq, const Vec3<T>* src, Vec3<T>* dst, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        dst[i] = dq[i].transform (src[i]);
+}
+
+template <class T>
+std::ostream&
+operator<< (std::ostream& o, const DualQuat<T>& dq)
+{
+    return o << "(" << dq.r << " " << dq.d << ")";
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+operator* (const DualQuat<T>& dq1, const DualQuat<T>& dq2) noexcept
+{
+    return DualQuat<T> (dq1.r * dq2.r, dq1.r * dq2.d + dq1.d * dq2.r);
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+operator* (const DualQuat<T>& dq, T t) noexcept
+{
+    return DualQuat<T> (dq.r * t, dq.d * t);
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+operator* (T t, const DualQuat<T>& dq) noexcept
+{
+    return DualQuat<T> (dq.r * t, dq.d * t);
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+operator+ (const DualQuat<T>& dq1, const DualQuat<T>& dq2) noexcept
+{
+    return DualQuat<T> (dq1.r + dq2.r, dq1.d + dq2.d);
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+operator- (const DualQuat<T>& dq1, const DualQuat<T>& dq2) noexcept
+{
+    return DualQuat<T> (dq1.r - dq2.r, dq1.d - dq2.d);
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+operator~ (const DualQuat<T>& dq) noexcept
+{
+    return DualQuat<T> (~dq.r, ~dq.d);
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+operator- (const DualQuat<T>& dq) noexcept
+{
+    return DualQuat<T> (-dq.r, -dq.d);
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Vec3<T>
+operator* (const Vec3<T>& v, const DualQuat<T>& dq) noexcept
+{
+    return dq.transform (v);
+}
+
 #if (defined _WIN32 || defined _WIN64) && defined _MSC_VER
 #    pragma warning(default : 4244)
 #endif
@@ -0,0 +1,372 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHRAYPACKET_H
+#define INCLUDED_IMATHRAYPACKET_H
+
+//-------------------------------------------------------------------------
+//
+//  A packet of N rays, for intersecting bundles of coherent rays with
+//  boxes and triangles.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathBox.h"
+#include "ImathLimits.h"
+#include "ImathLine.h"
+#include "ImathNamespace.h"
+#include "ImathVec.h"
+#include <cstdint>
+#include <type_traits>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/////////////////////////////////////////////////////////////////
+// RayPacket
+//
+//	template class RayPacket<T, N>
+//
+// Holds N rays in structure-of-arrays layout, together with the
+// reciprocals of their directions, so that a box is tested against
+// all N rays with the slab test and no divisions. The results are a
+// mask with bit i set if ray i hits the box, and the parameters t at
+// which the rays enter and exit the box; the points are
+// point (i, t). N may be from 1 to 64, typically 4, 8 or 16; the
+// mask is the smallest unsigned type that holds N bits.
+//
+// The tests agree with the scalar functions in ImathBoxAlgo.h:
+//
+//	findEntryAndExitT() with findEntryAndExitPoints(), for lines
+//	that extend in both directions,
+//
+//	intersectT() and intersects() with intersects(Box, Line3),
+//	for rays that start at their origin.
+//
+// A zero direction component makes the ray parallel to a pair of
+// sides; the ray then hits the box only if its origin lies between
+// (or on) those sides, as in the scalar code. A NaN direction
+// component is treated like a zero one, and NaN coordinates of the
+// origin or the box leave the corresponding slab unconstrained, also
+// as in the scalar code. Empty boxes are never hit.
+//
+// Results for rays that just graze an edge or a face of the box may
+// differ from the scalar functions, because those divide by the
+// direction where the packet multiplies by its reciprocal.
+//
+// The triangle test follows the conventions of intersect (line, v0,
+// v1, v2, pt, barycentric, front) in ImathLineAlgo.h, for the lines
+// through the rays, with the Moller-Trumbore algorithm of
+// TrianglePacket in ImathTrianglePacket.h.
+//
+
+template <class T, int N> class RayPacket
+{
+  public:
+    typedef typename std::conditional<
+        N <= 8,
+        uint8_t,
+        typename std::conditional<
+            N <= 16,
+            uint16_t,
+            typename std::conditional<N <= 32, uint32_t, uint64_t>::type>::type>::type RayMask;
+
+    static constexpr int numRays = N;
+
+    T posX[N];
+    T posY[N];
+    T posZ[N];
+    T dirX[N];
+    T dirY[N];
+    T dirZ[N];
+    T invDirX[N];
+    T invDirY[N];
+    T invDirZ[N];
+
+    // Uninitialized by default, like Line3.
+    RayPacket() noexcept {}
+
+    explicit RayPacket (const Line3<T> rays[N]) noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // set()
+    // Set ray i, from 0 to N-1, or all N rays. The direction need not
+    // be normalized; t is measured in multiples of it.
+    void set (int i, const Line3<T>& ray) noexcept;
+    void set (const Line3<T> rays[N]) noexcept;
+
+    Line3<T> ray (int i) const noexcept;
+
+    // The point at parameter t along ray i.
+    Vec3<T> point (int i, T t) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // findEntryAndExitT()
+    // Intersect the lines through the rays, extending in both
+    // directions, with a box. For the lines in the returned mask,
+    // set tEntry[i] and tExit[i] to the parameters of the entry and
+    // exit points, which may be on either side of the origin.
+    RayMask findEntryAndExitT (const Box<Vec3<T>>& box, T tEntry[N], T tExit[N]) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // intersectT()
+    // Intersect the rays, starting at their origin, with a box. For
+    // the rays in the returned mask, tEntry[i] is 0 if the origin is
+    // inside the box and the parameter of the entry point otherwise,
+    // and tExit[i] is the parameter of the exit point.
+    RayMask intersectT (const Box<Vec3<T>>& box, T tEntry[N], T tExit[N]) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // intersects()
+    // Return the mask of the rays that hit a box, or that hit it
+    // at a parameter no greater than tMax[i], for instance the closest
+    // hit found so far.
+    RayMask intersects (const Box<Vec3<T>>& box) const noexcept;
+    RayMask intersects (const Box<Vec3<T>>& box, const T tMax[N]) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // intersect()
+    // Intersect the lines through the rays with the triangle (v0, v1,
+    // v2). For the lines in the returned mask, set t[i] to the
+    // parameter of the intersection point, which may be on either
+    // side of the origin, and barycentric[i] to its barycentric
+    // coordinates, and set bit i of front if the triangle faces ray i.
+    RayMask intersect (const Vec3<T>& v0,
+                       const Vec3<T>& v1,
+                       const Vec3<T>& v2,
+                       T t[N],
+                       Vec3<T> barycentric[N],
+                       RayMask& front) const noexcept;
+
+  private:
+    RayMask slabs (const Box<Vec3<T>>& box,
+                   T tMin,
+                   const T tMax[N],
+                   T tEntry[N],
+                   T tExit[N]) const noexcept;
+};
+
+template <class T, int N> RayPacket<T, N>::RayPacket (const Line3<T> rays[N]) noexcept
+{
+    set (rays);
+}
+
+template <class T, int N>
+inline void
+RayPacket<T, N>::set (int i, const Line3<T>& ray) noexcept
+{
+    //
+    // 1/0 is infinite, with the sign of the zero. A NaN direction
+    // component is replaced by zero, so that the ray is parallel to
+    // that pair of sides, as in the scalar code.
+    //
+
+    Vec3<T> dir = ray.dir;
+
+    for (int j = 0; j < 3; ++j)
+        if (dir[j] != dir[j])
+            dir[j] = T (0);
+
+    posX[i]    = ray.pos.x;
+    posY[i]    = ray.pos.y;
+    posZ[i]    = ray.pos.z;
+    dirX[i]    = dir.x;
+    dirY[i]    = dir.y;
+    dirZ[i]    = dir.z;
+    invDirX[i] = T (1) / dir.x;
+    invDirY[i] = T (1) / dir.y;
+    invDirZ[i] = T (1) / dir.z;
+}
+
+template <class T, int N>
+void
+RayPacket<T, N>::set (const Line3<T> rays[N]) noexcept
+{
+    for (int i = 0; i < N; ++i)
+        set (i, rays[i]);
+}
+
+template <class T, int N>
+inline Line3<T>
+RayPacket<T, N>::ray (int i) const noexcept
+{
+    Line3<T> r;
+    r.pos = Vec3<T> (posX[i], posY[i], posZ[i]);
+    r.dir = Vec3<T> (dirX[i], dirY[i], dirZ[i]);
+    return r;
+}
+
+template <class T, int N>
+inline Vec3<T>
+RayPacket<T, N>::point (int i, T t) const noexcept
+{
+    return Vec3<T> (posX[i] + t * dirX[i], posY[i] + t * dirY[i], posZ[i] + t * dirZ[i]);
+}
+
+//
+// The slab test of all N rays. The loop has no branches, for the
+// compiler to vectorize it.
+//
+// The near and far sides of each slab are selected by the sign of
+// the reciprocal direction, so that the near distance is never
+// greater than the far one for a non-empty box. For a zero direction
+// component the distances are infinite, which excludes the ray if
+// its origin is outside the slab and leaves the slab unconstrained
+// if it is inside. On a side, 0 * inf yields NaN, which the
+// comparisons ignore, so that the origin counts as inside, like in
+// the scalar code.
+//
+
+template <class T, int N>
+inline typename RayPacket<T, N>::RayMask
+RayPacket<T, N>::slabs (const Box<Vec3<T>>& box,
+                        T tMin,
+                        const T tMax[N],
+                        T tEntry[N],
+                        T tExit[N]) const noexcept
+{
+    if (box.isEmpty())
+        return 0;
+
+    for (int i = 0; i < N; ++i)
+    {
+        T nearX = invDirX[i] < 0 ? box.max.x : box.min.x;
+        T nearY = invDirY[i] < 0 ? box.max.y : box.min.y;
+        T nearZ = invDirZ[i] < 0 ? box.max.z : box.min.z;
+        T farX  = invDirX[i] < 0 ? box.min.x : box.max.x;
+        T farY  = invDirY[i] < 0 ? box.min.y : box.max.y;
+        T farZ  = invDirZ[i] < 0 ? box.min.z : box.max.z;
+
+        T tx0 = (nearX - posX[i]) * invDirX[i];
+        T ty0 = (nearY - posY[i]) * invDirY[i];
+        T tz0 = (nearZ - posZ[i]) * invDirZ[i];
+        T tx1 = (farX - posX[i]) * invDirX[i];
+        T ty1 = (farY - posY[i]) * invDirY[i];
+        T tz1 = (farZ - posZ[i]) * invDirZ[i];
+
+        T t0 = tMin;
+        t0   = tx0 > t0 ? tx0 : t0;
+        t0   = ty0 > t0 ? ty0 : t0;
+        t0   = tz0 > t0 ? tz0 : t0;
+
+        T t1 = tMax[i];
+        t1   = tx1 < t1 ? tx1 : t1;
+        t1   = ty1 < t1 ? ty1 : t1;
+        t1   = tz1 < t1 ? tz1 : t1;
+
+        tEntry[i] = t0;
+        tExit[i]  = t1;
+    }
+
+    RayMask mask = 0;
+
+    for (int i = 0; i < N; ++i)
+        mask |= RayMask (tEntry[i] <= tExit[i]) << i;
+
+    return mask;
+}
+
+template <class T, int N>
+typename RayPacket<T, N>::RayMask
+RayPacket<T, N>::findEntryAndExitT (const Box<Vec3<T>>& box, T tEntry[N], T tExit[N])
+    const noexcept
+{
+    T tMax[N];
+
+    for (int i = 0; i < N; ++i)
+        tMax[i] = limits<T>::max();
+
+    return slabs (box, -limits<T>::max(), tMax, tEntry, tExit);
+}
+
+template <class T, int N>
+typename RayPacket<T, N>::RayMask
+RayPacket<T, N>::intersectT (const Box<Vec3<T>>& box, T tEntry[N], T tExit[N]) const noexcept
+{
+    T tMax[N];
+
+    for (int i = 0; i < N; ++i)
+        tMax[i] = limits<T>::max();
+
+    return slabs (box, T (0), tMax, tEntry, tExit);
+}
+
+template <class T, int N>
+typename RayPacket<T, N>::RayMask
+RayPacket<T, N>::intersects (const Box<Vec3<T>>& box) const noexcept
+{
+    T tEntry[N], tExit[N];
+    return intersectT (box, tEntry, tExit);
+}
+
+template <class T, int N>
+typename RayPacket<T, N>::RayMask
+RayPacket<T, N>::intersects (const Box<Vec3<T>>& box, const T tMax[N]) const noexcept
+{
+    T tEntry[N], tExit[N];
+    return slabs (box, T (0), tMax, tEntry, tExit);
+}
+
+//
+// The Moller-Trumbore test of all N rays against one triangle, with
+// the same arithmetic as TrianglePacket::intersect(). The first loop
+// has no branches, for the compiler to vectorize it.
+//
+
+template <class T, int N>
+typename RayPacket<T, N>::RayMask
+RayPacket<T, N>::intersect (const Vec3<T>& v0,
+                            const Vec3<T>& v1,
+                            const Vec3<T>& v2,
+                            T t[N],
+                            Vec3<T> barycentric[N],
+                            RayMask& front) const noexcept
+{
+    const Vec3<T> edge1 = v1 - v0;
+    const Vec3<T> edge2 = v2 - v0;
+
+    T u[N], v[N], det[N];
+
+    for (int i = 0; i < N; ++i)
+    {
+        // p = dir % edge2
+        T px = dirY[i] * edge2.z - dirZ[i] * edge2.y;
+        T py = dirZ[i] * edge2.x - dirX[i] * edge2.z;
+        T pz = dirX[i] * edge2.y - dirY[i] * edge2.x;
+
+        T d      = edge1.x * px + edge1.y * py + edge1.z * pz;
+        T invDet = T (1) / d;
+
+        // s = pos - v0, q = s % edge1
+        T sx = posX[i] - v0.x;
+        T sy = posY[i] - v0.y;
+        T sz = posZ[i] - v0.z;
+
+        T qx = sy * edge1.z - sz * edge1.y;
+        T qy = sz * edge1.x - sx * edge1.z;
+        T qz = sx * edge1.y - sy * edge1.x;
+
+        u[i]   = (sx * px + sy * py + sz * pz) * invDet;
+        v[i]   = (dirX[i] * qx + dirY[i] * qy + dirZ[i] * qz) * invDet;
+        t[i]   = (edge2.x * qx + edge2.y * qy + edge2.z * qz) * invDet;
+        det[i] = d;
+    }
+
+    RayMask mask = 0;
+    front        = 0;
+
+    for (int i = 0; i < N; ++i)
+    {
+        bool hit = (u[i] >= 0) & (v[i] >= 0) & (u[i] + v[i] <= 1) & (det[i] != 0);
+        mask |= RayMask (hit) << i;
+        front |= RayMask (hit & (det[i] < 0)) << i;
+        barycentric[i] = Vec3<T> (T (1) - u[i] - v[i], u[i], v[i]);
+    }
+
+    return mask;
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHRAYPACKET_H
@@ -0,0 +1,686 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHSPACEFILLINGCURVE_H
+#define INCLUDED_IMATHSPACEFILLINGCURVE_H
+
+//-----------------------------------------------------------------------------
+//
+//	Morton (Z-order) and Hilbert curve codes of points, for sorting
+//	points and primitives so that nearby ones are close in memory.
+//
+//	Contains:
+//
+//	uint32_t mortonEncode32(x, y)		16 bits per coordinate
+//	uint32_t mortonEncode32(x, y, z)	10 bits per coordinate
+//	uint64_t mortonEncode64(x, y)		32 bits per coordinate
+//	uint64_t mortonEncode64(x, y, z)	21 bits per coordinate
+//	    (and mortonDecode32(), mortonDecode64())
+//
+//	uint32_t hilbertEncode32(x, y), hilbertEncode32(x, y, z)
+//	uint64_t hilbertEncode64(x, y), hilbertEncode64(x, y, z)
+//	    (and hilbertDecode32(), hilbertDecode64())
+//
+//	uint64_t mortonCode(const Vec3<T>& p, const Box<Vec3<T>>& bounds)
+//	uint64_t mortonCode(const Vec2<T>& p, const Box<Vec2<T>>& bounds)
+//	uint64_t hilbertCode(const Vec3<T>& p, const Box<Vec3<T>>& bounds)
+//	uint64_t hilbertCode(const Vec2<T>& p, const Box<Vec2<T>>& bounds)
+//
+//	void mortonCodes(const Vec3<T>* points,
+//			 const Box<Vec3<T>>& bounds,
+//			 uint64_t* codes,
+//			 size_t n)
+//	void hilbertCodes(const Vec3<T>* points,
+//			  const Box<Vec3<T>>& bounds,
+//			  uint64_t* codes,
+//			  size_t n)
+//	    (and overloads for Vec2 points and for the centers of boxes)
+//
+//	void radixSort(K* keys, uint32_t* values, size_t n)
+//
+//-----------------------------------------------------------------------------
+
+#include "ImathBox.h"
+#include "ImathNamespace.h"
+#include "ImathPlatform.h"
+#include "ImathVec.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+//
+// Spread the bits of an integer apart, so that bit i moves to bit
+// 2i or 3i, and the inverse. spreadBits2() and spreadBits3() keep 16
+// and 10 bits of a uint32_t, or 32 and 21 bits of a uint64_t. These
+// are the bit-interleaving steps of the Morton codes, written with
+// shifts and masks, which compile to a few instructions on all
+// platforms.
+//
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint32_t
+spreadBits2 (uint32_t x) noexcept
+{
+    x &= 0x0000ffff;
+    x = (x | (x << 8)) & 0x00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint64_t
+spreadBits2 (uint64_t x) noexcept
+{
+    x &= 0x00000000ffffffffull;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint32_t
+compactBits2 (uint32_t x) noexcept
+{
+    x &= 0x55555555;
+    x = (x | (x >> 1)) & 0x33333333;
+    x = (x | (x >> 2)) & 0x0f0f0f0f;
+    x = (x | (x >> 4)) & 0x00ff00ff;
+    x = (x | (x >> 8)) & 0x0000ffff;
+    return x;
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint64_t
+compactBits2 (uint64_t x) noexcept
+{
+    x &= 0x5555555555555555ull;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x >> 4)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x >> 8)) & 0x0000ffff0000ffffull;
+    x = (x | (x >> 16)) & 0x00000000ffffffffull;
+    return x;
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint32_t
+spreadBits3 (uint32_t x) noexcept
+{
+    x &= 0x000003ff;
+    x = (x | (x << 16)) & 0x030000ff;
+    x = (x | (x << 8)) & 0x0300f00f;
+    x = (x | (x << 4)) & 0x030c30c3;
+    x = (x | (x << 2)) & 0x09249249;
+    return x;
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint64_t
+spreadBits3 (uint64_t x) noexcept
+{
+    x &= 0x00000000001fffffull;
+    x = (x | (x << 32)) & 0x001f00000000ffffull;
+    x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+    x = (x | (x << 8)) & 0x100f00f00f00f00full;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+    x = (x | (x << 2)) & 0x1249249249249249ull;
+    return x;
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint32_t
+compactBits3 (uint32_t x) noexcept
+{
+    x &= 0x09249249;
+    x = (x | (x >> 2)) & 0x030c30c3;
+    x = (x | (x >> 4)) & 0x0300f00f;
+    x = (x | (x >> 8)) & 0x030000ff;
+    x = (x | (x >> 16)) & 0x000003ff;
+    return x;
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint64_t
+compactBits3 (uint64_t x) noexcept
+{
+    x &= 0x1249249249249249ull;
+    x = (x | (x >> 2)) & 0x10c30c30c30c30c3ull;
+    x = (x | (x >> 4)) & 0x100f00f00f00f00full;
+    x = (x | (x >> 8)) & 0x001f0000ff0000ffull;
+    x = (x | (x >> 16)) & 0x001f00000000ffffull;
+    x = (x | (x >> 32)) & 0x00000000001fffffull;
+    return x;
+}
+
+//
+// Morton codes: the bits of the coordinates interleaved, x in the
+// lowest bit. Higher bits of the coordinates than fit in the code are
+// ignored.
+//
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint32_t
+mortonEncode32 (uint32_t x, uint32_t y) noexcept
+{
+    return spreadBits2 (x) | (spreadBits2 (y) << 1);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint32_t
+mortonEncode32 (uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+    return spreadBits3 (x) | (spreadBits3 (y) << 1) | (spreadBits3 (z) << 2);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint64_t
+mortonEncode64 (uint32_t x, uint32_t y) noexcept
+{
+    return spreadBits2 (uint64_t (x)) | (spreadBits2 (uint64_t (y)) << 1);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint64_t
+mortonEncode64 (uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+    return spreadBits3 (uint64_t (x)) | (spreadBits3 (uint64_t (y)) << 1) |
+           (spreadBits3 (uint64_t (z)) << 2);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+mortonDecode32 (uint32_t code, uint32_t& x, uint32_t& y) noexcept
+{
+    x = compactBits2 (code);
+    y = compactBits2 (code >> 1);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+mortonDecode32 (uint32_t code, uint32_t& x, uint32_t& y, uint32_t& z) noexcept
+{
+    x = compactBits3 (code);
+    y = compactBits3 (code >> 1);
+    z = compactBits3 (code >> 2);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+mortonDecode64 (uint64_t code, uint32_t& x, uint32_t& y) noexcept
+{
+    x = uint32_t (compactBits2 (code));
+    y = uint32_t (compactBits2 (code >> 1));
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+mortonDecode64 (uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z) noexcept
+{
+    x = uint32_t (compactBits3 (code));
+    y = uint32_t (compactBits3 (code >> 1));
+    z = uint32_t (compactBits3 (code >> 2));
+}
+
+//
+// Convert between the coordinates of a point on a grid of 2^Bits
+// cells per axis and the "transposed" Hilbert index, whose bits,
+// interleaved with X[0] in the most significant position, form the
+// index along the curve (J. Skilling, "Programming the Hilbert
+// curve", AIP Conf. Proc. 707, 2004). These are the steps of the
+// Hilbert codes below, and are not part of the public interface.
+//
+
+template <int D, int Bits>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+hilbertAxesToTranspose (uint32_t X[D]) noexcept
+{
+    const uint32_t M = uint32_t (1) << (Bits - 1);
+
+    for (uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+        uint32_t P = Q - 1;
+
+        for (int i = 0; i < D; ++i)
+        {
+            if (X[i] & Q)
+            {
+                X[0] ^= P;
+            }
+            else
+            {
+                uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+
+    for (int i = 1; i < D; ++i)
+        X[i] ^= X[i - 1];
+
+    uint32_t t = 0;
+
+    for (uint32_t Q = M; Q > 1; Q >>= 1)
+        if (X[D - 1] & Q)
+            t ^= Q - 1;
+
+    for (int i = 0; i < D; ++i)
+        X[i] ^= t;
+}
+
+template <int D, int Bits>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+hilbertTransposeToAxes (uint32_t X[D]) noexcept
+{
+    uint32_t t = X[D - 1] >> 1;
+
+    for (int i = D - 1; i > 0; --i)
+        X[i] ^= X[i - 1];
+
+    X[0] ^= t;
+
+    for (int b = 1; b < Bits; ++b)
+    {
+        uint32_t Q = uint32_t (1) << b;
+        uint32_t P = Q - 1;
+
+        for (int i = D - 1; i >= 0; --i)
+        {
+            if (X[i] & Q)
+            {
+                X[0] ^= P;
+            }
+            else
+            {
+                uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+}
+
+//
+// Hilbert codes: the index of a point along the Hilbert curve through
+// a grid of 2^16 or 2^32 cells per axis in 2D, and 2^10 or 2^21 in 3D.
+// Consecutive codes are adjacent cells, which keeps nearby points
+// closer together in a sorted order than Morton codes do, at a higher
+// cost of computing them. Higher bits of the coordinates than fit in
+// the code are ignored.
+//
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint32_t
+hilbertEncode32 (uint32_t x, uint32_t y) noexcept
+{
+    uint32_t X[2] = { x & 0xffff, y & 0xffff };
+    hilbertAxesToTranspose<2, 16> (X);
+    return mortonEncode32 (X[1], X[0]);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint32_t
+hilbertEncode32 (uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+    uint32_t X[3] = { x & 0x3ff, y & 0x3ff, z & 0x3ff };
+    hilbertAxesToTranspose<3, 10> (X);
+    return mortonEncode32 (X[2], X[1], X[0]);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint64_t
+hilbertEncode64 (uint32_t x, uint32_t y) noexcept
+{
+    uint32_t X[2] = { x, y };
+    hilbertAxesToTranspose<2, 32> (X);
+    return mortonEncode64 (X[1], X[0]);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline uint64_t
+hilbertEncode64 (uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+    uint32_t X[3] = { x & 0x1fffff, y & 0x1fffff, z & 0x1fffff };
+    hilbertAxesToTranspose<3, 21> (X);
+    return mortonEncode64 (X[2], X[1], X[0]);
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+hilbertDecode32 (uint32_t code, uint32_t& x, uint32_t& y) noexcept
+{
+    uint32_t X[2] = { 0, 0 };
+    mortonDecode32 (code, X[1], X[0]);
+    hilbertTransposeToAxes<2, 16> (X);
+    x = X[0];
+    y = X[1];
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+hilbertDecode32 (uint32_t code, uint32_t& x, uint32_t& y, uint32_t& z) noexcept
+{
+    uint32_t X[3] = { 0, 0, 0 };
+    mortonDecode32 (code, X[2], X[1], X[0]);
+    hilbertTransposeToAxes<3, 10> (X);
+    x = X[0];
+    y = X[1];
+    z = X[2];
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+hilbertDecode64 (uint64_t code, uint32_t& x, uint32_t& y) noexcept
+{
+    uint32_t X[2] = { 0, 0 };
+    mortonDecode64 (code, X[1], X[0]);
+    hilbertTransposeToAxes<2, 32> (X);
+    x = X[0];
+    y = X[1];
+}
+
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+hilbertDecode64 (uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z) noexcept
+{
+    uint32_t X[3] = { 0, 0, 0 };
+    mortonDecode64 (code, X[2], X[1], X[0]);
+    hilbertTransposeToAxes<3, 21> (X);
+    x = X[0];
+    y = X[1];
+    z = X[2];
+}
+
+//
+// GridQuantizer maps coordinates within an interval to the cells of a
+// grid of 2^Bits cells: the minimum to cell 0, the maximum to the last
+// cell. Coordinates outside the interval are clamped to it, and NaNs
+// and flat intervals map to cell 0. GridQuantizer is not part of the
+// public interface.
+//
+
+template <class T, int Bits> struct GridQuantizer
+{
+    T origin;
+    T scale;
+
+    IMATH_HOSTDEVICE GridQuantizer (T min, T max) noexcept
+        : origin (min), scale (max > min ? T (double (uint64_t (1) << Bits)) / (max - min) : T (0))
+    {}
+
+    IMATH_HOSTDEVICE uint32_t operator() (T v) const noexcept
+    {
+        const uint32_t lastCell = uint32_t ((uint64_t (1) << Bits) - 1);
+
+        T c = (v - origin) * scale;
+        c   = c > T (0) ? c : T (0);
+        return c < T (lastCell) ? uint32_t (c) : lastCell;
+    }
+};
+
+//
+// Morton and Hilbert codes of points within a bounding box, typically
+// the bounds of all points, on a grid of 2^21 cells per axis in 3D
+// and 2^32 in 2D. Points outside the box are clamped to it. For
+// boxes, typically the bounds of primitives, the codes are those of
+// their centers.
+//
+
+template <class T>
+IMATH_HOSTDEVICE inline uint64_t
+mortonCode (const Vec3<T>& p, const Box<Vec3<T>>& bounds) noexcept
+{
+    return mortonEncode64 (GridQuantizer<T, 21> (bounds.min.x, bounds.max.x) (p.x),
+                           GridQuantizer<T, 21> (bounds.min.y, bounds.max.y) (p.y),
+                           GridQuantizer<T, 21> (bounds.min.z, bounds.max.z) (p.z));
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline uint64_t
+mortonCode (const Vec2<T>& p, const Box<Vec2<T>>& bounds) noexcept
+{
+    return mortonEncode64 (GridQuantizer<T, 32> (bounds.min.x, bounds.max.x) (p.x),
+                           GridQuantizer<T, 32> (bounds.min.y, bounds.max.y) (p.y));
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline uint64_t
+hilbertCode (const Vec3<T>& p, const Box<Vec3<T>>& bounds) noexcept
+{
+    return hilbertEncode64 (GridQuantizer<T, 21> (bounds.min.x, bounds.max.x) (p.x),
+                            GridQuantizer<T, 21> (bounds.min.y, bounds.max.y) (p.y),
+                            GridQuantizer<T, 21> (bounds.min.z, bounds.max.z) (p.z));
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline uint64_t
+hilbertCode (const Vec2<T>& p, const Box<Vec2<T>>& bounds) noexcept
+{
+    return hilbertEncode64 (GridQuantizer<T, 32> (bounds.min.x, bounds.max.x) (p.x),
+                            GridQuantizer<T, 32> (bounds.min.y, bounds.max.y) (p.y));
+}
+
+//
+// The codes of n points or boxes: codes[i] = mortonCode (points[i],
+// bounds) for i in [0, n), and likewise for hilbertCode(), with the
+// scale of the grid computed once rather than for every point.
+//
+
+template <class T>
+void
+mortonCodes (const Vec3<T>* points, const Box<Vec3<T>>& bounds, uint64_t* codes, size_t n) noexcept
+{
+    const GridQuantizer<T, 21> qx (bounds.min.x, bounds.max.x);
+    const GridQuantizer<T, 21> qy (bounds.min.y, bounds.max.y);
+    const GridQuantizer<T, 21> qz (bounds.min.z, bounds.max.z);
+
+    for (size_t i = 0; i < n; ++i)
+        codes[i] = mortonEncode64 (qx (points[i].x), qy (points[i].y), qz (points[i].z));
+}
+
+template <class T>
+void
+mortonCodes (const Vec2<T>* points, const Box<Vec2<T>>& bounds, uint64_t* codes, size_t n) noexcept
+{
+    const GridQuantizer<T, 32> qx (bounds.min.x, bounds.max.x);
+    const GridQuantizer<T, 32> qy (bounds.min.y, bounds.max.y);
+
+    for (size_t i = 0; i < n; ++i)
+        codes[i] = mortonEncode64 (qx (points[i].x), qy (points[i].y));
+}
+
+template <class T>
+void
+mortonCodes (const Box<Vec3<T>>* boxes,
+             const Box<Vec3<T>>& bounds,
+             uint64_t* codes,
+             size_t n) noexcept
+{
+    const GridQuantizer<T, 21> qx (bounds.min.x, bounds.max.x);
+    const GridQuantizer<T, 21> qy (bounds.min.y, bounds.max.y);
+    const GridQuantizer<T, 21> qz (bounds.min.z, bounds.max.z);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> c = (boxes[i].min + boxes[i].max) * T (0.5);
+        codes[i]  = mortonEncode64 (qx (c.x), qy (c.y), qz (c.z));
+    }
+}
+
+template <class T>
+void
+hilbertCodes (const Vec3<T>* points, const Box<Vec3<T>>& bounds, uint64_t* codes, size_t n) noexcept
+{
+    const GridQuantizer<T, 21> qx (bounds.min.x, bounds.max.x);
+    const GridQuantizer<T, 21> qy (bounds.min.y, bounds.max.y);
+    const GridQuantizer<T, 21> qz (bounds.min.z, bounds.max.z);
+
+    for (size_t i = 0; i < n; ++i)
+        codes[i] = hilbertEncode64 (qx (points[i].x), qy (points[i].y), qz (points[i].z));
+}
+
+template <class T>
+void
+hilbertCodes (const Vec2<T>* points, const Box<Vec2<T>>& bounds, uint64_t* codes, size_t n) noexcept
+{
+    const GridQuantizer<T, 32> qx (bounds.min.x, bounds.max.x);
+    const GridQuantizer<T, 32> qy (bounds.min.y, bounds.max.y);
+
+    for (size_t i = 0; i < n; ++i)
+        codes[i] = hilbertEncode64 (qx (points[i].x), qy (points[i].y));
+}
+
+template <class T>
+void
+hilbertCodes (const Box<Vec3<T>>* boxes,
+              const Box<Vec3<T>>& bounds,
+              uint64_t* codes,
+              size_t n) noexcept
+{
+    const GridQuantizer<T, 21> qx (bounds.min.x, bounds.max.x);
+    const GridQuantizer<T, 21> qy (bounds.min.y, bounds.max.y);
+    const GridQuantizer<T, 21> qz (bounds.min.z, bounds.max.z);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> c = (boxes[i].min + boxes[i].max) * T (0.5);
+        codes[i]  = hilbertEncode64 (qx (c.x), qy (c.y), qz (c.z));
+    }
+}
+
+//
+// Sort n keys by their lowest numDigits bytes with a least-significant-
+// digit radix sort, using tempKeys and tempValues for the passes. The
+// digits of all passes are counted in one pass over the keys, and the
+// passes in which all keys have the same digit are skipped.
+// radixSortDigits() is not part of the public interface.
+//
+
+template <class K>
+void
+radixSortDigits (K* keys,
+                 uint32_t* values,
+                 K* tempKeys,
+                 uint32_t* tempValues,
+                 size_t n,
+                 int numDigits) noexcept
+{
+    size_t counts[sizeof (K)][256];
+
+    for (int d = 0; d < numDigits; ++d)
+        for (int b = 0; b < 256; ++b)
+            counts[d][b] = 0;
+
+    for (size_t i = 0; i < n; ++i)
+        for (int d = 0; d < numDigits; ++d)
+            ++counts[d][(keys[i] >> (8 * d)) & 0xff];
+
+    K* srcKeys        = keys;
+    K* dstKeys        = tempKeys;
+    uint32_t* srcVals = values;
+    uint32_t* dstVals = tempValues;
+
+    for (int d = 0; d < numDigits; ++d)
+    {
+        size_t* count = counts[d];
+        int shift     = 8 * d;
+
+        if (count[(srcKeys[0] >> shift) & 0xff] == n)
+            continue;
+
+        size_t offset = 0;
+
+        for (int b = 0; b < 256; ++b)
+        {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t j   = count[(srcKeys[i] >> shift) & 0xff]++;
+            dstKeys[j] = srcKeys[i];
+            dstVals[j] = srcVals[i];
+        }
+
+        std::swap (srcKeys, dstKeys);
+        std::swap (srcVals, dstVals);
+    }
+
+    if (srcKeys != keys)
+    {
+        std::memcpy (keys, srcKeys, n * sizeof (K));
+        std::memcpy (values, srcVals, n * sizeof (uint32_t));
+    }
+}
+
+//
+// Sort n unsigned integer keys, uint32_t or uint64_t, in increasing
+// order, and reorder the values with them; typically the keys are
+// codes and the values the indices of the points or primitives. The
+// sort is stable, and allocates temporary arrays of n keys and values.
+//
+// The keys are first distributed by their most significant byte that
+// is not the same in all keys, such as the top byte of 63-bit 3D
+// codes. The buckets, typically small enough to stay in the cache,
+// are then sorted by the lower bytes with a least-significant-digit
+// radix sort, so that only one pass over the whole arrays goes to
+// main memory.
+//
+
+template <class K>
+void
+radixSort (K* keys, uint32_t* values, size_t n)
+{
+    if (n < 2)
+        return;
+
+    K diff = 0;
+
+    for (size_t i = 0; i < n; ++i)
+        diff |= keys[i] ^ keys[0];
+
+    if (diff == 0)
+        return;
+
+    int top = 0;
+
+    while (top + 1 < int (sizeof (K)) && (diff >> (8 * (top + 1))) != 0)
+        ++top;
+
+    std::vector<K> tempKeys (n);
+    std::vector<uint32_t> tempValues (n);
+
+    size_t start[257];
+
+    for (int b = 0; b < 257; ++b)
+        start[b] = 0;
+
+    for (size_t i = 0; i < n; ++i)
+        ++start[((keys[i] >> (8 * top)) & 0xff) + 1];
+
+    for (int b = 0; b < 256; ++b)
+        start[b + 1] += start[b];
+
+    size_t next[256];
+
+    for (int b = 0; b < 256; ++b)
+        next[b] = start[b];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t j      = next[(keys[i] >> (8 * top)) & 0xff]++;
+        tempKeys[j]   = keys[i];
+        tempValues[j] = values[i];
+    }
+
+    for (int b = 0; b < 256; ++b)
+    {
+        size_t m = start[b + 1] - start[b];
+
+        if (top > 0 && m > 1)
+        {
+            radixSortDigits (&tempKeys[start[b]],
+                             &tempValues[start[b]],
+                             keys + start[b],
+                             values + start[b],
+                             m,
+                             top);
+        }
+    }
+
+    std::memcpy (keys, tempKeys.data(), n * sizeof (K));
+    std::memcpy (values, tempValues.data(), n * sizeof (uint32_t));
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHSPACEFILLINGCURVE_H
@@ -16,6 +16,8 @@
 #include "ImathLine.h"
 #include "ImathNamespace.h"
 #include "ImathVec.h"
+#include <cstddef>
+#include <type_traits>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -139,6 +141,49 @@ Sphere3<T>::intersect (const Line3<T>& line, Vec3<T>& intersection) const
     }
 }
 
+//-------------------------------------------------------------------
+//	An array of spheres in structure-of-arrays layout: the i-th
+//	sphere has center (x[i], y[i], z[i]) and radius radius[i].
+//	Functions that read arrays of spheres take Sphere3SoA<const T>,
+//	which a Sphere3SoA<T> converts to.
+//-------------------------------------------------------------------
+
+template <class T> class Sphere3SoA
+{
+  public:
+    typedef typename std::remove_const<T>::type BaseType;
+
+    T* x; // centers
+    T* y;
+    T* z;
+    T* radius;
+
+    IMATH_HOSTDEVICE constexpr Sphere3SoA (T* x, T* y, T* z, T* radius) noexcept
+        : x (x), y (y), z (z), radius (radius)
+    {}
+
+    template <class S>
+    IMATH_HOSTDEVICE constexpr Sphere3SoA (const Sphere3SoA<S>& s) noexcept
+        : x (s.x), y (s.y), z (s.z), radius (s.radius)
+    {}
+
+    // Load and store the i-th sphere
+
+    IMATH_HOSTDEVICE constexpr Sphere3<BaseType> operator[] (size_t i) const noexcept
+    {
+        return Sphere3<BaseType> (Vec3<BaseType> (x[i], y[i], z[i]), radius[i]);
+    }
+
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 void
+    set (size_t i, const Sphere3<BaseType>& s) const noexcept
+    {
+        x[i]      = s.center.x;
+        y[i]      = s.center.y;
+        z[i]      = s.center.z;
+        radius[i] = s.radius;
+    }
+};
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHSPHERE_H
@@ -0,0 +1,48 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHSRGB_H
+#define INCLUDED_IMATHSRGB_H
+
+//-------------------------------------------------------------------------
+//
+//  The sRGB transfer function, shared by the packed color conversions
+//  in ImathColorAlgo.cpp and by ColorPipeline. The functions are not
+//  part of the public interface.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathNamespace.h"
+#include <cmath>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+//
+// Encode a linear value to sRGB, and decode it. Negative values are
+// mirrored, so that the curves are odd functions, as for extended
+// range sRGB.
+//
+
+template <class T>
+inline T
+srgbEncode (T x) noexcept
+{
+    T a = std::abs (x);
+    T y = a <= T (0.0031308) ? T (12.92) * a : T (1.055) * std::pow (a, T (1 / 2.4)) - T (0.055);
+    return std::copysign (y, x);
+}
+
+template <class T>
+inline T
+srgbDecode (T x) noexcept
+{
+    T a = std::abs (x);
+    T y = a <= T (0.04045) ? a / T (12.92) : std::pow ((a + T (0.055)) / T (1.055), T (2.4));
+    return std::copysign (y, x);
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHSRGB_H
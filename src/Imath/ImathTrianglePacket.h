@@ -0,0 +1,216 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_IMATHTRIANGLEPACKET_H
+#define INCLUDED_IMATHTRIANGLEPACKET_H
+
+//-------------------------------------------------------------------------
+//
+//  A packet of N triangles, for intersecting a line with several
+//  triangles at once.
+//
+//-------------------------------------------------------------------------
+
+#include "ImathLine.h"
+#include "ImathNamespace.h"
+#include "ImathVec.h"
+#include <cstdint>
+#include <type_traits>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/////////////////////////////////////////////////////////////////
+// TrianglePacket
+//
+//	template class TrianglePacket<T, N>
+//
+// Holds N triangles in structure-of-arrays layout, as their first
+// vertex and the two edges from it, so that a line is tested against
+// all N triangles with the Moller-Trumbore algorithm in a loop that
+// the compiler vectorizes. N may be from 1 to 64, typically 4, 8 or
+// 16; the mask is the smallest unsigned type that holds N bits.
+//
+// The results follow the conventions of intersect (line, v0, v1, v2,
+// pt, barycentric, front) in ImathLineAlgo.h: the line extends in
+// both directions, so that t may be negative; the barycentric
+// coordinates are those of the intersection point, pt = v0 *
+// barycentric.x + v1 * barycentric.y + v2 * barycentric.z; and a
+// triangle is front-facing if the dot product of its normal,
+// (v2-v1)%(v1-v0), and the direction of the line is negative. The
+// point is line (t), or line.pos + line.dir * t.
+//
+// Lines in the plane of a triangle and degenerate triangles are never
+// hit. Unused triangles of a packet can be set to a degenerate
+// triangle, for instance with all three vertices at the origin.
+// Results for lines that just graze an edge or a vertex of a triangle
+// may differ from intersect(), because of the different arithmetic.
+//
+
+template <class T, int N> class TrianglePacket
+{
+  public:
+    typedef typename std::conditional<
+        N <= 8,
+        uint8_t,
+        typename std::conditional<
+            N <= 16,
+            uint16_t,
+            typename std::conditional<N <= 32, uint32_t, uint64_t>::type>::type>::type
+        TriangleMask;
+
+    static constexpr int numTriangles = N;
+
+    T v0X[N];
+    T v0Y[N];
+    T v0Z[N];
+    T edge1X[N]; // v1 - v0
+    T edge1Y[N];
+    T edge1Z[N];
+    T edge2X[N]; // v2 - v0
+    T edge2Y[N];
+    T edge2Z[N];
+
+    // Uninitialized by default, like Vec3.
+    TrianglePacket() noexcept {}
+
+    ////////////////////////////////////////////////////////////////////
+    // set()
+    // Set triangle i, from 0 to N-1.
+    void set (int i, const Vec3<T>& v0, const Vec3<T>& v1, const Vec3<T>& v2) noexcept;
+
+    void vertices (int i, Vec3<T>& v0, Vec3<T>& v1, Vec3<T>& v2) const noexcept;
+
+    ////////////////////////////////////////////////////////////////////
+    // intersect()
+    // Intersect a line with the N triangles. For the triangles in the
+    // returned mask, set t[i] to the parameter of the intersection
+    // point along the line and barycentric[i] to its barycentric
+    // coordinates, and set bit i of front if the triangle faces the
+    // line.
+    TriangleMask intersect (const Line3<T>& line,
+                            T t[N],
+                            Vec3<T> barycentric[N],
+                            TriangleMask& front) const noexcept;
+
+    // Intersect a line with the N triangles, returning only the
+    // parameters of the intersection points.
+    TriangleMask intersect (const Line3<T>& line, T t[N]) const noexcept;
+
+  private:
+    TriangleMask
+    mollerTrumbore (const Line3<T>& line, T t[N], T u[N], T v[N], T det[N]) const noexcept;
+};
+
+template <class T, int N>
+inline void
+TrianglePacket<T, N>::set (int i, const Vec3<T>& v0, const Vec3<T>& v1, const Vec3<T>& v2) noexcept
+{
+    v0X[i]    = v0.x;
+    v0Y[i]    = v0.y;
+    v0Z[i]    = v0.z;
+    edge1X[i] = v1.x - v0.x;
+    edge1Y[i] = v1.y - v0.y;
+    edge1Z[i] = v1.z - v0.z;
+    edge2X[i] = v2.x - v0.x;
+    edge2Y[i] = v2.y - v0.y;
+    edge2Z[i] = v2.z - v0.z;
+}
+
+template <class T, int N>
+inline void
+TrianglePacket<T, N>::vertices (int i, Vec3<T>& v0, Vec3<T>& v1, Vec3<T>& v2) const noexcept
+{
+    v0 = Vec3<T> (v0X[i], v0Y[i], v0Z[i]);
+    v1 = v0 + Vec3<T> (edge1X[i], edge1Y[i], edge1Z[i]);
+    v2 = v0 + Vec3<T> (edge2X[i], edge2Y[i], edge2Z[i]);
+}
+
+//
+// The Moller-Trumbore test of all N triangles: the intersection point
+// is v0 + u * edge1 + v * edge2, and det is the dot product of the
+// direction of the line and the normal, (v2-v1)%(v1-v0), which is
+// (v2-v0)%(v1-v0). The loop has no branches, for the compiler to
+// vectorize it; a division by a zero det yields infinities or NaNs,
+// which the comparisons in the second loop reject.
+//
+
+template <class T, int N>
+inline typename TrianglePacket<T, N>::TriangleMask
+TrianglePacket<T, N>::mollerTrumbore (const Line3<T>& line, T t[N], T u[N], T v[N], T det[N])
+    const noexcept
+{
+    const T dx = line.dir.x;
+    const T dy = line.dir.y;
+    const T dz = line.dir.z;
+
+    for (int i = 0; i < N; ++i)
+    {
+        // p = dir % edge2
+        T px = dy * edge2Z[i] - dz * edge2Y[i];
+        T py = dz * edge2X[i] - dx * edge2Z[i];
+        T pz = dx * edge2Y[i] - dy * edge2X[i];
+
+        T d      = edge1X[i] * px + edge1Y[i] * py + edge1Z[i] * pz;
+        T invDet = T (1) / d;
+
+        // s = pos - v0, q = s % edge1
+        T sx = line.pos.x - v0X[i];
+        T sy = line.pos.y - v0Y[i];
+        T sz = line.pos.z - v0Z[i];
+
+        T qx = sy * edge1Z[i] - sz * edge1Y[i];
+        T qy = sz * edge1X[i] - sx * edge1Z[i];
+        T qz = sx * edge1Y[i] - sy * edge1X[i];
+
+        u[i]   = (sx * px + sy * py + sz * pz) * invDet;
+        v[i]   = (dx * qx + dy * qy + dz * qz) * invDet;
+        t[i]   = (edge2X[i] * qx + edge2Y[i] * qy + edge2Z[i] * qz) * invDet;
+        det[i] = d;
+    }
+
+    TriangleMask mask = 0;
+
+    for (int i = 0; i < N; ++i)
+    {
+        bool hit = (u[i] >= 0) & (v[i] >= 0) & (u[i] + v[i] <= 1) & (det[i] != 0);
+        mask |= TriangleMask (hit) << i;
+    }
+
+    return mask;
+}
+
+template <class T, int N>
+typename TrianglePacket<T, N>::TriangleMask
+TrianglePacket<T, N>::intersect (const Line3<T>& line,
+                                 T t[N],
+                                 Vec3<T> barycentric[N],
+                                 TriangleMask& front) const noexcept
+{
+    T u[N], v[N], det[N];
+    TriangleMask mask = mollerTrumbore (line, t, u, v, det);
+
+    front = 0;
+
+    for (int i = 0; i < N; ++i)
+    {
+        barycentric[i] = Vec3<T> (T (1) - u[i] - v[i], u[i], v[i]);
+        front |= TriangleMask (det[i] < 0) << i;
+    }
+
+    front &= mask;
+    return mask;
+}
+
+template <class T, int N>
+typename TrianglePacket<T, N>::TriangleMask
+TrianglePacket<T, N>::intersect (const Line3<T>& line, T t[N]) const noexcept
+{
+    T u[N], v[N], det[N];
+    return mollerTrumbore (line, t, u, v, det);
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHTRIANGLEPACKET_H
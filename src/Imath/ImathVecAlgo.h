@@ -70,6 +70,71 @@ reflect (const Vec& s, const Vec& t) noexcept
 template <class Vec>
 IMATH_CONSTEXPR14 Vec closestVertex (const Vec& v0, const Vec& v1, const Vec& v2, const Vec& p) noexcept;
 
+//--------------------------------------------------------------------
+// Find the point of triangle (v0, v1, v2), on its interior, an edge
+// or a vertex, that is closest to point p (Vec2, Vec3, Vec4)
+//--------------------------------------------------------------------
+
+template <class Vec,
+          IMATH_ENABLE_IF(!std::is_integral<typename Vec::BaseType>::value)>
+IMATH_CONSTEXPR14 inline Vec
+closestPointOnTriangle (const Vec& v0, const Vec& v1, const Vec& v2, const Vec& p) noexcept
+{
+    //
+    // Find the Voronoi region of the triangle that contains p, from
+    // the projections of p onto the edges (Ericson, Real-Time
+    // Collision Detection, 5.1.5). The result is v0 + e1 * v + e2 * w.
+    //
+
+    typedef typename Vec::BaseType T;
+
+    Vec e1 = v1 - v0;
+    Vec e2 = v2 - v0;
+    Vec d0 = p - v0;
+
+    T a = e1 ^ d0;
+    T b = e2 ^ d0;
+
+    if (a <= T (0) && b <= T (0))
+        return v0;
+
+    Vec d1 = p - v1;
+    T c    = e1 ^ d1;
+    T d    = e2 ^ d1;
+
+    if (c >= T (0) && d <= c)
+        return v1;
+
+    T vc = a * d - c * b;
+
+    if (vc <= T (0) && a >= T (0) && c <= T (0))
+        return v0 + e1 * (a / (a - c));
+
+    Vec d2 = p - v2;
+    T e    = e1 ^ d2;
+    T f    = e2 ^ d2;
+
+    if (f >= T (0) && e <= f)
+        return v2;
+
+    T vb = e * b - a * f;
+
+    if (vb <= T (0) && b >= T (0) && f <= T (0))
+        return v0 + e2 * (b / (b - f));
+
+    T va = c * f - e * d;
+
+    if (va <= T (0) && d - c >= T (0) && e - f >= T (0))
+        return v1 + (v2 - v1) * ((d - c) / ((d - c) + (e - f)));
+
+    T denom = va + vb + vc;
+
+    if (denom == T (0))
+        return closestVertex (v0, v1, v2, p); // degenerate triangle
+
+    return v0 + e1 * (vb / denom) + e2 * (vc / denom);
+}
+
 //---------------
 // Implementation
 //---------------
@@ -15,28 +15,45 @@
 #include <testLimits.h>
 #include <testSize.h>
 #include <testToFloat.h>
+#include <testBVH.h>
 #include <testBox.h>
 #include <testBoxAlgo.h>
 #include <testColor.h>
+#include <testColorPipeline.h>
+#include <testDepthBuffer.h>
+#include <testDualQuat.h>
+#include <testEulerBatch.h>
 #include <testExtractEuler.h>
 #include <testExtractSHRT.h>
+#include <testFrame.h>
 #include <testFrustum.h>
 #include <testFrustumTest.h>
+#include <testFrustumTestBatch.h>
 #include <testFun.h>
 #include <testInterval.h>
 #include <testInvert.h>
 #include <testJacobiEigenSolver.h>
 #include <testLineAlgo.h>
+#include <testLut3D.h>
 #include <testMatrix.h>
 #include <testMiscMatrixAlgo.h>
+#include <testMultiFrustumTest.h>
+#include <testPolarDecompose.h>
+#include <testPreparedRay.h>
 #include <testProcrustes.h>
+#include <testQuantizedBox.h>
 #include <testQuat.h>
+#include <testQuatBatch.h>
+#include <testQuatNlerp.h>
 #include <testQuatSetRotation.h>
 #include <testQuatSlerp.h>
 #include <testRandom.h>
+#include <testRayPacket.h>
 #include <testRoots.h>
 #include <testShear.h>
+#include <testSpaceFillingCurve.h>
 #include <testTinySVD.h>
+#include <testTrianglePacket.h>
 #include <testVec.h>
 
 #include <iostream>
@@ -84,6 +101,23 @@ main (int argc, char* argv[])
     TEST (testTinySVD);
     TEST (testJacobiEigenSolver);
     TEST (testFrustumTest);
+    TEST (testPolarDecompose);
+    TEST (testDualQuat);
+    TEST (testQuatBatch);
+    TEST (testQuatNlerp);
+    TEST (testEulerBatch);
+    TEST (testFrustumTestBatch);
+    TEST (testMultiFrustumTest);
+    TEST (testBVH);
+    TEST (testRayPacket);
+    TEST (testPreparedRay);
+    TEST (testQuantizedBox);
+    TEST (testSpaceFillingCurve);
+    TEST (testTrianglePacket);
+    TEST (testFrame);
+    TEST (testDepthBuffer);
+    TEST (testColorPipeline);
+    TEST (testLut3D);
     // NB: If you add a test here, make sure to enumerate it in the
     // CMakeLists.txt so it runs as part of the test suite
 
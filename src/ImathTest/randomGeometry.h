@@ -0,0 +1,64 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifndef INCLUDED_RANDOM_GEOMETRY_H
+#define INCLUDED_RANDOM_GEOMETRY_H
+
+//
+// Random vectors, rays and boxes, shared by the tests of the ray and
+// triangle packets and of PreparedRay.
+//
+
+#include "ImathBox.h"
+#include "ImathLine.h"
+#include "ImathRandom.h"
+#include "ImathVec.h"
+
+template <class T>
+IMATH_INTERNAL_NAMESPACE::Vec3<T>
+randomVec (IMATH_INTERNAL_NAMESPACE::Rand48& rand, T size)
+{
+    return IMATH_INTERNAL_NAMESPACE::Vec3<T> (T (rand.nextf (-size, size)),
+                                              T (rand.nextf (-size, size)),
+                                              T (rand.nextf (-size, size)));
+}
+
+//
+// A random ray, with some direction components set to zero, for
+// rays parallel to the sides of the boxes.
+//
+
+template <class T>
+IMATH_INTERNAL_NAMESPACE::Line3<T>
+randomRay (IMATH_INTERNAL_NAMESPACE::Rand48& rand)
+{
+    IMATH_INTERNAL_NAMESPACE::Line3<T> ray;
+    ray.pos = randomVec<T> (rand, 10);
+
+    do
+    {
+        ray.dir = randomVec<T> (rand, 1);
+
+        for (int j = 0; j < 3; ++j)
+            if (rand.nexti() % 4 == 0)
+                ray.dir[j] = T (0);
+    } while (ray.dir == IMATH_INTERNAL_NAMESPACE::Vec3<T> (0));
+
+    ray.dir.normalize();
+    return ray;
+}
+
+template <class T>
+IMATH_INTERNAL_NAMESPACE::Box<IMATH_INTERNAL_NAMESPACE::Vec3<T>>
+randomBox (IMATH_INTERNAL_NAMESPACE::Rand48& rand)
+{
+    IMATH_INTERNAL_NAMESPACE::Vec3<T> c = randomVec<T> (rand, 8);
+    IMATH_INTERNAL_NAMESPACE::Vec3<T> e (T (rand.nextf (0.1, 4)),
+                                         T (rand.nextf (0.1, 4)),
+                                         T (rand.nextf (0.1, 4)));
+    return IMATH_INTERNAL_NAMESPACE::Box<IMATH_INTERNAL_NAMESPACE::Vec3<T>> (c - e, c + e);
+}
+
+#endif // INCLUDED_RANDOM_GEOMETRY_H
@@ -0,0 +1,654 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathBVH.h"
+#include "ImathRandom.h"
+#include "ImathSphere.h"
+#include "ImathVecAlgo.h"
+#include <algorithm>
+#include <cassert>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <testBVH.h>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// The primitives are spheres; their bounds are the boxes around them.
+//
+
+template <class T>
+void
+randomSpheres (Rand48& rand,
+               size_t n,
+               T size,
+               vector<Sphere3<T>>& spheres,
+               vector<Box<Vec3<T>>>& bounds)
+{
+    spheres.resize (n);
+    bounds.resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> c (T (rand.nextf (-100, 100)), T (rand.nextf (-100, 100)), T (rand.nextf (-100, 100)));
+        T r = T (rand.nextf (0.1, size));
+
+        spheres[i] = Sphere3<T> (c, r);
+        bounds[i]  = Box<Vec3<T>> (c - Vec3<T> (r), c + Vec3<T> (r));
+    }
+}
+
+template <class T> struct SphereIntersector
+{
+    const vector<Sphere3<T>>& spheres;
+    size_t calls;
+
+    bool operator() (size_t i, const Line3<T>& ray, T& t)
+    {
+        ++calls;
+        T ti;
+
+        if (spheres[i].intersectT (ray, ti) && ti < t)
+        {
+            t = ti;
+            return true;
+        }
+
+        return false;
+    }
+};
+
+template <class T>
+void
+checkStructure (const BVH<T>& bvh, const vector<Box<Vec3<T>>>& bounds)
+{
+    typedef typename BVH<T>::Node Node;
+
+    size_t numNonEmpty = 0;
+    for (size_t i = 0; i < bounds.size(); ++i)
+        numNonEmpty += !bounds[i].isEmpty();
+
+    assert (bvh.size() == bounds.size());
+    assert (bvh.indices().size() == numNonEmpty);
+    assert (bvh.nodes().empty() == (numNonEmpty == 0));
+
+    // Each primitive appears once, within the bounds of its leaf
+
+    vector<int> seen (bounds.size(), 0);
+    size_t numLeafPrimitives = 0;
+
+    for (const Node& node : bvh.nodes())
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            Box<Vec3<T>> b = node.bounds (i);
+
+            if (node.count[i])
+            {
+                for (uint32_t j = node.child[i]; j < node.child[i] + node.count[i]; ++j)
+                {
+                    uint32_t p = bvh.indices()[j];
+                    ++seen[p];
+                    assert (b.intersects (bounds[p].min) && b.intersects (bounds[p].max));
+                }
+
+                numLeafPrimitives += node.count[i];
+            }
+            else if (node.child[i] != BVH<T>::UNUSED)
+            {
+                // Inner nodes lie within their parent's child bounds
+
+                const Node& c = bvh.nodes()[node.child[i]];
+                for (int k = 0; k < 4; ++k)
+                    if (c.count[k] || c.child[k] != BVH<T>::UNUSED)
+                        assert (b.intersects (c.bounds (k).min) && b.intersects (c.bounds (k).max));
+            }
+            else
+            {
+                assert (b.isEmpty());
+            }
+        }
+    }
+
+    assert (numLeafPrimitives == numNonEmpty);
+    for (size_t i = 0; i < bounds.size(); ++i)
+        assert (seen[i] == (bounds[i].isEmpty() ? 0 : 1));
+}
+
+template <class T>
+void
+checkQueries (const BVH<T>& bvh,
+              const vector<Sphere3<T>>& spheres,
+              const vector<Box<Vec3<T>>>& bounds,
+              Rand48& rand)
+{
+    const size_t n = spheres.size();
+
+    //
+    // Rays: compare with intersecting all spheres
+    //
+
+    for (int k = 0; k < 200; ++k)
+    {
+        Vec3<T> p0 (T (rand.nextf (-150, 150)), T (rand.nextf (-150, 150)), T (rand.nextf (-150, 150)));
+        Vec3<T> p1 (T (rand.nextf (-50, 50)), T (rand.nextf (-50, 50)), T (rand.nextf (-50, 50)));
+
+        // Some rays along the axes, to exercise zero directions
+
+        if (k % 10 == 0)
+            p1 = p0 + Vec3<T> (0, 0, 1);
+
+        Line3<T> ray (p0, p1);
+
+        T tBrute           = numeric_limits<T>::max();
+        size_t primBrute   = n;
+        for (size_t i = 0; i < n; ++i)
+        {
+            T t;
+            if (!bounds[i].isEmpty() && spheres[i].intersectT (ray, t) && t < tBrute)
+            {
+                tBrute    = t;
+                primBrute = i;
+            }
+        }
+
+        SphereIntersector<T> intersect = { spheres, 0 };
+        T t                            = numeric_limits<T>::max();
+        size_t prim                    = n;
+        bool hit                       = bvh.closestHit (ray, t, prim, intersect);
+
+        assert (hit == (primBrute < n));
+        if (hit)
+        {
+            assert (t == tBrute);
+            assert (spheres[prim].intersectT (ray, t) && t == tBrute);
+        }
+
+        // Any hit before tMax
+
+        if (!hit)
+            assert (!bvh.anyHit (ray, numeric_limits<T>::max(), intersect));
+        else
+        {
+            assert (bvh.anyHit (ray, tBrute * T (1.001), intersect));
+            assert (!bvh.anyHit (ray, tBrute * T (0.999), intersect));
+        }
+    }
+
+    //
+    // Frustums: compare with FrustumTest::isVisible()
+    //
+
+    for (int k = 0; k < 20; ++k)
+    {
+        Frustum<T> frustum (T (1), T (50 + 10 * k), T (-1), T (1), T (0.75), T (-0.75), k % 4 == 3);
+        Matrix44<T> cameraMat;
+        cameraMat.rotate (Vec3<T> (T (rand.nextf (-3, 3)), T (rand.nextf (-3, 3)), T (0)));
+        cameraMat.translate (
+            Vec3<T> (T (rand.nextf (-100, 100)), T (rand.nextf (-100, 100)), T (rand.nextf (-100, 100))));
+
+        FrustumTest<T> ft (frustum, cameraMat);
+
+        vector<size_t> found;
+        bvh.findVisible (ft, [&] (size_t i) { found.push_back (i); });
+        sort (found.begin(), found.end());
+
+        vector<size_t> expected;
+        for (size_t i = 0; i < n; ++i)
+            if (ft.isVisible (bounds[i]))
+                expected.push_back (i);
+
+        assert (found == expected);
+    }
+
+    //
+    // Boxes: compare with Box::intersects()
+    //
+
+    for (int k = 0; k < 50; ++k)
+    {
+        Vec3<T> c (T (rand.nextf (-100, 100)), T (rand.nextf (-100, 100)), T (rand.nextf (-100, 100)));
+        Vec3<T> s (T (rand.nextf (0, 30)), T (rand.nextf (0, 30)), T (rand.nextf (0, 30)));
+        Box<Vec3<T>> box (c - s, c + s);
+
+        vector<size_t> found;
+        bvh.findOverlapping (box, [&] (size_t i) { found.push_back (i); });
+        sort (found.begin(), found.end());
+
+        vector<size_t> expected;
+        for (size_t i = 0; i < n; ++i)
+            if (bounds[i].intersects (box))
+                expected.push_back (i);
+
+        assert (found == expected);
+    }
+}
+
+template <class T>
+void
+testBVHT()
+{
+    Rand48 rand (11);
+
+    // An empty hierarchy
+
+    {
+        BVH<T> bvh;
+        size_t prim;
+        T t = 1;
+        auto never = [] (size_t, const Line3<T>&, T&) { return true; };
+        assert (!bvh.closestHit (Line3<T> (Vec3<T> (0), Vec3<T> (1)), t, prim, never));
+        assert (!bvh.anyHit (Line3<T> (Vec3<T> (0), Vec3<T> (1)), t, never));
+        assert (bvh.bounds().isEmpty() && bvh.size() == 0);
+    }
+
+    for (size_t n : { size_t (1), size_t (3), size_t (5), size_t (100), size_t (3000) })
+    {
+        for (int maxLeafSize : { 1, 4, 8 })
+        {
+            vector<Sphere3<T>> spheres;
+            vector<Box<Vec3<T>>> bounds;
+            randomSpheres (rand, n, T (5), spheres, bounds);
+
+            // Some primitives have empty bounds
+
+            for (size_t i = 7; i < n; i += 13)
+                bounds[i].makeEmpty();
+
+            BVH<T> bvh (bounds.data(), n, maxLeafSize);
+            checkStructure (bvh, bounds);
+            checkQueries (bvh, spheres, bounds, rand);
+        }
+    }
+
+    // Many primitives with the same bounds
+
+    {
+        vector<Sphere3<T>> spheres (500, Sphere3<T> (Vec3<T> (1, 2, 3), T (1)));
+        vector<Box<Vec3<T>>> bounds (500, Box<Vec3<T>> (Vec3<T> (0, 1, 2), Vec3<T> (2, 3, 4)));
+
+        BVH<T> bvh (bounds.data(), bounds.size());
+        checkStructure (bvh, bounds);
+        checkQueries (bvh, spheres, bounds, rand);
+    }
+}
+
+template <class T>
+Vec3<T>
+randomPoint (Rand48& rand, T size)
+{
+    return Vec3<T> (T (rand.nextf (-size, size)),
+                    T (rand.nextf (-size, size)),
+                    T (rand.nextf (-size, size)));
+}
+
+//
+// closestPointOnTriangle() returns a point of the triangle that is
+// no farther from p than any other point of the triangle that we try.
+//
+
+template <class T>
+void
+testClosestPointOnTriangle (Rand48& rand)
+{
+    const T e = std::numeric_limits<T>::epsilon() * 1000;
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        Vec3<T> v0 = randomPoint<T> (rand, 1);
+        Vec3<T> v1 = randomPoint<T> (rand, 1);
+        Vec3<T> v2 = k % 50 == 1 ? v0 + (v1 - v0) * T (2) : randomPoint<T> (rand, 1);
+        Vec3<T> p  = randomPoint<T> (rand, 2);
+        Vec3<T> q  = closestPointOnTriangle (v0, v1, v2, p);
+        T d        = (q - p).length();
+
+        // q is in the triangle: its area splits exactly into three
+
+        T area = ((v1 - v0) % (v2 - v0)).length();
+        T sum  = ((v0 - q) % (v1 - q)).length() + ((v1 - q) % (v2 - q)).length() +
+                ((v2 - q) % (v0 - q)).length();
+
+        assert (abs (sum - area) <= e * (1 + area));
+
+        for (int i = 0; i <= 20; ++i)
+        {
+            for (int j = 0; i + j <= 20; ++j)
+            {
+                Vec3<T> r = v0 + (v1 - v0) * T (i / 20.0) + (v2 - v0) * T (j / 20.0);
+                assert (d <= (r - p).length() + e);
+            }
+        }
+    }
+
+    // The vertices, edges and interior of a right triangle
+
+    Vec3<T> v0 (0, 0, 0), v1 (1, 0, 0), v2 (0, 1, 0);
+
+    assert (closestPointOnTriangle (v0, v1, v2, Vec3<T> (-1, -1, 5)) == v0);
+    assert (closestPointOnTriangle (v0, v1, v2, Vec3<T> (2, -1, 0)) == v1);
+    assert (closestPointOnTriangle (v0, v1, v2, Vec3<T> (0, 3, -1)) == v2);
+    assert (closestPointOnTriangle (v0, v1, v2, Vec3<T> (0.5, -1, 1)) == Vec3<T> (0.5, 0, 0));
+    assert (closestPointOnTriangle (v0, v1, v2, Vec3<T> (1, 1, 0)) == Vec3<T> (0.5, 0.5, 0));
+    assert (closestPointOnTriangle (v0, v1, v2, Vec3<T> (0.25, 0.25, 3)) ==
+            Vec3<T> (0.25, 0.25, 0));
+}
+
+//
+// Distance queries over points and over triangles, compared with
+// measuring the distance to every primitive
+//
+
+template <class T> struct PointDistance
+{
+    const vector<Vec3<T>>& points;
+
+    bool operator() (size_t i, const Vec3<T>& p, T& d2) const
+    {
+        T d = (points[i] - p).length2();
+
+        if (d < d2)
+        {
+            d2 = d;
+            return true;
+        }
+
+        return false;
+    }
+};
+
+template <class T> struct TriangleDistance
+{
+    const vector<Vec3<T>>& vertices;
+
+    bool operator() (size_t i, const Vec3<T>& p, T& d2) const
+    {
+        const Vec3<T>* v = &vertices[3 * i];
+        T d = (closestPointOnTriangle (v[0], v[1], v[2], p) - p).length2();
+
+        if (d < d2)
+        {
+            d2 = d;
+            return true;
+        }
+
+        return false;
+    }
+};
+
+template <class T, class Distance>
+void
+checkDistanceQueries (const BVH<T>& bvh,
+                      const vector<Box<Vec3<T>>>& bounds,
+                      Distance distance,
+                      Rand48& rand)
+{
+    const size_t n = bounds.size();
+    const int m    = 100;
+
+    vector<Vec3<T>> queries (m);
+
+    for (int q = 0; q < m; ++q)
+    {
+        Vec3<T> p = queries[q] = randomPoint<T> (rand, 120);
+
+        vector<pair<T, size_t>> brute;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T d2 = numeric_limits<T>::max();
+
+            if (!bounds[i].isEmpty() && distance (i, p, d2))
+                brute.push_back (make_pair (d2, i));
+        }
+
+        sort (brute.begin(), brute.end());
+
+        // The closest primitive; with ties, any of them will do
+
+        T d2        = numeric_limits<T>::max();
+        size_t prim = n;
+        bool found  = bvh.findClosest (p, d2, prim, distance);
+
+        assert (found == !brute.empty());
+
+        if (found)
+        {
+            T d2p = numeric_limits<T>::max();
+            assert (d2 == brute[0].first && distance (prim, p, d2p) && d2p == d2);
+
+            // Nothing is closer than the closest
+
+            T limit = d2;
+            assert (!bvh.findClosest (p, limit, prim, distance));
+        }
+
+        // The k closest, and those within a distance
+
+        const size_t k = 1 + q % 7;
+        const T maxD2  = q % 3 ? numeric_limits<T>::max() : T (400);
+
+        size_t kPrims[8];
+        T kD2[8];
+        size_t count = bvh.findKClosest (p, k, maxD2, kPrims, kD2, distance);
+
+        size_t expected = 0;
+        while (expected < k && expected < brute.size() && brute[expected].first < maxD2)
+            ++expected;
+
+        assert (count == expected);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            assert (kD2[i] == brute[i].first);
+
+            T d2i = numeric_limits<T>::max();
+            assert (distance (kPrims[i], p, d2i) && d2i == kD2[i]);
+        }
+
+        const T radius2 = T (rand.nextf (0, 1000));
+
+        vector<size_t> within;
+        bvh.findWithinDistance (p, radius2, distance, [&] (size_t i, T d2i) {
+            T d = numeric_limits<T>::max();
+            assert (distance (i, p, d) && d == d2i && d2i < radius2);
+            within.push_back (i);
+        });
+
+        sort (within.begin(), within.end());
+
+        vector<size_t> withinBrute;
+        for (size_t i = 0; i < brute.size() && brute[i].first < radius2; ++i)
+            withinBrute.push_back (brute[i].second);
+
+        sort (withinBrute.begin(), withinBrute.end());
+        assert (within == withinBrute);
+    }
+
+    // A batch of queries gives the same distances as one at a time
+
+    vector<size_t> prims (m);
+    vector<T> d2s (m);
+    bvh.findClosest (queries.data(), m, prims.data(), d2s.data(), distance);
+
+    for (int q = 0; q < m; ++q)
+    {
+        T d2        = numeric_limits<T>::max();
+        size_t prim = bvh.size();
+        bvh.findClosest (queries[q], d2, prim, distance);
+
+        assert (d2s[q] == d2);
+        assert (prims[q] < bvh.size() || bvh.indices().empty());
+    }
+}
+
+template <class T>
+void
+testDistanceQueries()
+{
+    Rand48 rand (13);
+
+    testClosestPointOnTriangle<T> (rand);
+
+    for (size_t n : { size_t (0), size_t (1), size_t (7), size_t (200), size_t (3000) })
+    {
+        // Points, some of them left out with empty bounds
+
+        vector<Vec3<T>> points (n);
+        vector<Box<Vec3<T>>> bounds (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            points[i] = randomPoint<T> (rand, 100);
+            bounds[i] = Box<Vec3<T>> (points[i]);
+        }
+
+        for (size_t i = 5; i < n; i += 17)
+            bounds[i].makeEmpty();
+
+        BVH<T> pointBVH (bounds.data(), n);
+        checkDistanceQueries (pointBVH, bounds, PointDistance<T> { points }, rand);
+
+        // Triangles
+
+        vector<Vec3<T>> vertices (3 * n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> c = randomPoint<T> (rand, 100);
+
+            bounds[i].makeEmpty();
+
+            for (int j = 0; j < 3; ++j)
+            {
+                vertices[3 * i + j] = c + randomPoint<T> (rand, 5);
+                bounds[i].extendBy (vertices[3 * i + j]);
+            }
+        }
+
+        BVH<T> triangleBVH (bounds.data(), n);
+        checkDistanceQueries (triangleBVH, bounds, TriangleDistance<T> { vertices }, rand);
+    }
+
+    // An empty hierarchy finds nothing
+
+    BVH<T> bvh;
+    vector<Vec3<T>> none;
+    T d2 = numeric_limits<T>::max();
+    size_t prim;
+    assert (!bvh.findClosest (Vec3<T> (0), d2, prim, PointDistance<T> { none }));
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+testTiming()
+{
+    const size_t n    = 200000;
+    const int numRays = 20000;
+
+    Rand48 rand (12);
+    vector<Sphere3<float>> spheres;
+    vector<Box3f> bounds;
+    randomSpheres (rand, n, 1.0f, spheres, bounds);
+
+    clock_t t0 = clock();
+    BVHf bvh (bounds.data(), n);
+    clock_t t1 = clock();
+
+    SphereIntersector<float> intersect = { spheres, 0 };
+    size_t hits                        = 0;
+
+    for (int k = 0; k < numRays; ++k)
+    {
+        V3f p0 (rand.nextf (-150, 150), rand.nextf (-150, 150), rand.nextf (-150, 150));
+        V3f p1 (rand.nextf (-50, 50), rand.nextf (-50, 50), rand.nextf (-50, 50));
+
+        float t = numeric_limits<float>::max();
+        size_t prim;
+        hits += bvh.closestHit (Line3f (p0, p1), t, prim, intersect);
+    }
+
+    clock_t t2 = clock();
+
+    cout << "  build " << n << " primitives: " << double (t1 - t0) / CLOCKS_PER_SEC << " s, "
+         << bvh.nodes().size() << " nodes; " << numRays
+         << " closest-hit rays: " << double (t2 - t1) / CLOCKS_PER_SEC << " s, "
+         << double (intersect.calls) / numRays << " primitive tests per ray (" << hits << ")"
+         << endl;
+
+    //
+    // Closest points in a point cloud, for queries in random order,
+    // one at a time and as a batch
+    //
+
+    const size_t numQueries = 200000;
+
+    vector<V3f> points (n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        points[i] = randomPoint<float> (rand, 100);
+        bounds[i] = Box3f (points[i]);
+    }
+
+    BVHf pointBVH (bounds.data(), n);
+    PointDistance<float> distance = { points };
+
+    vector<V3f> queries (numQueries);
+    for (size_t i = 0; i < numQueries; ++i)
+        queries[i] = randomPoint<float> (rand, 100);
+
+    vector<size_t> prims (numQueries);
+    vector<float> d2s (numQueries);
+
+    clock_t t3 = clock();
+
+    for (size_t i = 0; i < numQueries; ++i)
+    {
+        d2s[i] = numeric_limits<float>::max();
+        pointBVH.findClosest (queries[i], d2s[i], prims[i], distance);
+    }
+
+    clock_t t4 = clock();
+
+    pointBVH.findClosest (queries.data(), numQueries, prims.data(), d2s.data(), distance);
+
+    clock_t t5 = clock();
+
+    cout << "  " << numQueries << " closest-point queries among " << n
+         << " points: one at a time " << double (t4 - t3) / CLOCKS_PER_SEC << " s, as a batch "
+         << double (t5 - t4) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testBVH()
+{
+    cout << "Testing bounding volume hierarchies" << endl;
+
+    testBVHT<float>();
+    testBVHT<double>();
+    testDistanceQueries<float>();
+    testDistanceQueries<double>();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    testTiming();
+#endif
+
+    cout << "ok\n" << endl;
+}
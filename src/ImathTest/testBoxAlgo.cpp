@@ -11,8 +11,11 @@
 #include "ImathRandom.h"
 #include <algorithm>
 #include <assert.h>
+#include <ctime>
 #include <iostream>
+#include <limits>
 #include <testBoxAlgo.h>
+#include <vector>
 
 using namespace std;
 using namespace IMATH_INTERNAL_NAMESPACE;
@@ -832,6 +835,239 @@ boxMatrixTransform()
     assert (b51 == b5);
 }
 
+template <class S, class T>
+void
+checkBoxArrayTransform (const Matrix44<T>& M)
+{
+    //
+    // n boxes, more than one block, including empty, infinite and
+    // flat boxes
+    //
+
+    const size_t n = 1000;
+    Rand48 rand (n);
+
+    vector<Box<Vec3<S>>> boxes (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<S> p (S (rand.nextf (-10, 10)), S (rand.nextf (-10, 10)), S (rand.nextf (-10, 10)));
+        Vec3<S> q (S (rand.nextf (-10, 10)), S (rand.nextf (-10, 10)), S (rand.nextf (-10, 10)));
+
+        switch (i % 10)
+        {
+            case 0: boxes[i].makeEmpty(); break;
+            case 1: boxes[i].makeInfinite(); break;
+            case 2: boxes[i] = Box<Vec3<S>> (p, p); break;
+            case 3: boxes[i] = Box<Vec3<S>> (q, p); break; // usually empty
+            default: boxes[i] = Box<Vec3<S>> (p); boxes[i].extendBy (q);
+        }
+    }
+
+    vector<Box<Vec3<S>>> result (n);
+    vector<S> soa[6];
+    for (int k = 0; k < 6; ++k)
+        soa[k].resize (n);
+
+    Box3SoA<S> boxesSoA (&soa[0][0], &soa[1][0], &soa[2][0], &soa[3][0], &soa[4][0], &soa[5][0]);
+
+    for (size_t i = 0; i < n; ++i)
+        boxesSoA.set (i, boxes[i]);
+
+    // transform()
+
+    transform (&boxes[0], M, &result[0], n);
+    transform<S> (boxesSoA, M, boxesSoA, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (result[i] == transform (boxes[i], M));
+        assert (boxesSoA[i] == result[i]);
+    }
+
+    // affineTransform(), in place
+
+    if (M[0][3] == 0 && M[1][3] == 0 && M[2][3] == 0 && M[3][3] == 1)
+    {
+        result = boxes;
+        affineTransform (&result[0], M, &result[0], n);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (result[i] == affineTransform (boxes[i], M));
+    }
+}
+
+void
+boxArrayTransform()
+{
+    cout << "  transform arrays of boxes by matrix" << endl;
+
+    M44f M;
+    M.setEulerAngles (V3f (1, 2, 3));
+    M.translate (V3f (20, -15, 2));
+    M.scale (V3f (1, -2, 3));
+
+    checkBoxArrayTransform<float> (M);
+    checkBoxArrayTransform<double> (M);
+    checkBoxArrayTransform<double> (M44d (M));
+
+    M[0][3] = 1;
+    M[1][3] = 2;
+    M[2][3] = 3;
+    M[3][3] = 4;
+
+    checkBoxArrayTransform<float> (M);
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+    //
+    // Timing
+    //
+
+    const size_t n = 1000000;
+    vector<Box3f> boxes (n, Box3f (V3f (-1, -2, -3), V3f (1, 2, 3)));
+    vector<Box3f> result (n);
+
+    vector<float> soa[6];
+    for (int k = 0; k < 6; ++k)
+        soa[k].assign (n, k < 3 ? -float (k + 1) : float (k - 2));
+
+    Box3SoA<float> boxesSoA (&soa[0][0], &soa[1][0], &soa[2][0], &soa[3][0], &soa[4][0], &soa[5][0]);
+
+    M44f A;
+    A.setEulerAngles (V3f (1, 2, 3));
+
+    clock_t t0 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        result[i] = transform (boxes[i], A);
+
+    clock_t t1 = clock();
+
+    transform (&boxes[0], A, &result[0], n);
+
+    clock_t t2 = clock();
+
+    transform<float> (boxesSoA, A, boxesSoA, n);
+
+    clock_t t3 = clock();
+
+    cout << "    " << n << " boxes: one at a time " << double (t1 - t0) / CLOCKS_PER_SEC
+         << " s, as an array " << double (t2 - t1) / CLOCKS_PER_SEC
+         << " s, as structure of arrays " << double (t3 - t2) / CLOCKS_PER_SEC << " s" << endl;
+
+#endif
+}
+
+template <class T>
+void
+checkPointBounds()
+{
+    //
+    // Sizes around the number of lanes, with NaNs at some of them
+    //
+
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    Rand48 rand (7);
+
+    for (size_t n = 0; n < 120; n += (n < 50 ? 1 : 7))
+    {
+        vector<Vec3<T>> p3 (n);
+        vector<Vec2<T>> p2 (n);
+        vector<T> x (n), y (n), z (n), xyzw (4 * n + 1);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            p3[i] = Vec3<T> (T (rand.nextf (-10, 10)),
+                             T (rand.nextf (-10, 10)),
+                             T (rand.nextf (-10, 10)));
+
+            if (n % 3 == 1 && i % 5 == 2)
+                p3[i][i % 3] = nan;
+
+            p2[i] = Vec2<T> (p3[i].x, p3[i].y);
+            x[i]  = p3[i].x;
+            y[i]  = p3[i].y;
+            z[i]  = p3[i].z;
+
+            for (int d = 0; d < 3; ++d)
+                xyzw[4 * i + d] = p3[i][d];
+
+            xyzw[4 * i + 3] = T (100);
+        }
+
+        Box<Vec3<T>> b3;
+        Box<Vec2<T>> b2;
+        Interval<T> bx;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            b3.extendBy (p3[i]);
+            b2.extendBy (p2[i]);
+            bx.extendBy (x[i]);
+        }
+
+        assert (computeBounds (p3.data(), n) == b3);
+        assert (computeBounds (p2.data(), n) == b2);
+        assert (computeBounds (x.data(), n) == bx);
+        assert (computeBounds (x.data(), y.data(), z.data(), n) == b3);
+        assert (computeBounds (xyzw.data(), n, 4) == b3);
+        assert (computeBounds (reinterpret_cast<const T*> (p3.data()), n, 3) == b3);
+    }
+
+    // Empty and all-NaN inputs
+
+    assert (computeBounds ((const Vec3<T>*) 0, 0) == Box<Vec3<T>>());
+    assert (computeBounds ((const T*) 0, 0) == Interval<T>());
+
+    vector<Vec3<T>> nans (40, Vec3<T> (nan));
+    assert (computeBounds (nans.data(), nans.size()).isEmpty());
+}
+
+void
+pointArrayBounds()
+{
+    cout << "  bounds of arrays of points" << endl;
+
+    checkPointBounds<float>();
+    checkPointBounds<double>();
+
+    assert (computeBounds (vector<V3i> (1, V3i (1, -2, 3)).data(), 1) ==
+            Box3i (V3i (1, -2, 3), V3i (1, -2, 3)));
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+    //
+    // Timing
+    //
+
+    const size_t n = 1000000;
+    Rand48 rand (0);
+    vector<V3f> points (n);
+
+    for (size_t i = 0; i < n; ++i)
+        points[i] = V3f (rand.nextf (-1, 1), rand.nextf (-1, 1), rand.nextf (-1, 1));
+
+    clock_t t0 = clock();
+
+    Box3f b1;
+    for (size_t i = 0; i < n; ++i)
+        b1.extendBy (points[i]);
+
+    clock_t t1 = clock();
+
+    Box3f b2 = computeBounds (points.data(), n);
+
+    clock_t t2 = clock();
+
+    assert (b1 == b2);
+
+    cout << "    " << n << " points: extendBy() " << double (t1 - t0) / CLOCKS_PER_SEC
+         << " s, computeBounds() " << double (t2 - t1) / CLOCKS_PER_SEC << " s" << endl;
+
+#endif
+}
+
 void
 pointInAndOnBox()
 {
@@ -903,6 +1139,8 @@ testBoxAlgo()
     rayBoxIntersection1();
     rayBoxIntersection2();
     boxMatrixTransform();
+    boxArrayTransform();
+    pointArrayBounds();
     pointInAndOnBox();
 
     cout << "ok\n" << endl;
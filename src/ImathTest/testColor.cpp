@@ -11,12 +11,427 @@
 #include "ImathColorAlgo.h"
 #include "ImathLimits.h"
 #include "ImathMath.h"
+#include "ImathRandom.h"
+#include <algorithm>
 #include <assert.h>
+#include <ctime>
 #include <iostream>
 #include <testColor.h>
+#include <vector>
 
 using namespace std;
 
+namespace
+{
+
+using IMATH_INTERNAL_NAMESPACE::C3f;
+using IMATH_INTERNAL_NAMESPACE::C3h;
+using IMATH_INTERNAL_NAMESPACE::C4f;
+using IMATH_INTERNAL_NAMESPACE::C4h;
+using IMATH_INTERNAL_NAMESPACE::Rand48;
+using IMATH_INTERNAL_NAMESPACE::V3d;
+
+//
+// Random colors, including grays, black, primaries and colors with
+// equal components, which exercise the special cases of the
+// conversions.
+//
+
+vector<C3f>
+testColors (size_t n)
+{
+    Rand48 rand (0);
+    vector<C3f> colors (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        float x = float (rand.nextf());
+        float y = float (rand.nextf());
+        float z = float (rand.nextf());
+
+        if (i % 8 == 0)
+            colors[i] = C3f (x, x, x);
+        else if (i % 8 == 1)
+            colors[i] = C3f (0, 0, 0);
+        else if (i % 8 == 2)
+            colors[i] = C3f (x, 0, 0);
+        else if (i % 8 == 3)
+            colors[i] = C3f (x, x, y);
+        else if (i % 8 == 4)
+            colors[i] = C3f (y, x, x);
+        else if (i % 8 == 5)
+            colors[i] = C3f (x * 100, y * 100, z * 100);
+        else
+            colors[i] = C3f (x, y, z);
+    }
+
+    return colors;
+}
+
+float
+maxError (const V3d& a, const V3d& b)
+{
+    return float (max (abs (a.x - b.x), max (abs (a.y - b.y), abs (a.z - b.z))));
+}
+
+//
+// The array conversions agree with rgb2hsv_d() and hsv2rgb_d() to
+// within 1e-6, relative to the value for all components but the hue
+//
+
+void
+testHsvArrays()
+{
+    cout << "rgb2hsv, hsv2rgb for arrays" << endl;
+
+    const size_t n   = 10000;
+    vector<C3f> rgb  = testColors (n);
+    vector<C3f> hsv  = rgb;
+    vector<C3f> back = rgb;
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (rgb.data(), hsv.data(), n);
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (hsv.data(), back.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        V3d ref  = IMATH_INTERNAL_NAMESPACE::rgb2hsv_d (V3d (rgb[i]));
+        double v = ref.z;
+        assert (abs (hsv[i].x - ref.x) <= 1e-6);
+        assert (abs (hsv[i].y - ref.y) <= 1e-6);
+        assert (hsv[i].z == ref.z);
+
+        V3d refRgb = IMATH_INTERNAL_NAMESPACE::hsv2rgb_d (V3d (hsv[i]));
+        assert (maxError (V3d (back[i]), refRgb) <= 1e-6 * v);
+        assert (maxError (V3d (back[i]), V3d (rgb[i])) <= 1e-5 * v);
+    }
+
+    // Hues of 1 and outside [0,1]
+
+    C3f special[] = {C3f (1, 0.5f, 0.5f), C3f (0, 0.5f, 0.5f), C3f (-0.1f, 1, 1), C3f (1.5f, 1, 1)};
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (special, special, 4);
+    assert (special[0] == special[1] && special[0] == C3f (0.5f, 0.25f, 0.25f));
+    assert (special[2] == C3f (0) && special[3] == C3f (0));
+
+    // Color4, in place, with alpha copied
+
+    vector<C4f> rgba (n);
+    for (size_t i = 0; i < n; ++i)
+        rgba[i] = C4f (rgb[i].x, rgb[i].y, rgb[i].z, float (i));
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (rgba.data(), rgba.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (rgba[i] == C4f (hsv[i].x, hsv[i].y, hsv[i].z, float (i)));
+
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (rgba.data(), rgba.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (rgba[i] == C4f (back[i].x, back[i].y, back[i].z, float (i)));
+
+    // Half colors are converted in float, and rounded to half
+
+    vector<C3h> rgbh (n), hsvh (n);
+    vector<C4h> rgbah (n), hsvah (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        rgbh[i]  = C3h (rgb[i] / 100.0f);
+        rgbah[i] = C4h (rgbh[i].x, rgbh[i].y, rgbh[i].z, half (0.5f));
+    }
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (rgbh.data(), hsvh.data(), n);
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (rgbah.data(), hsvah.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        C3f in (rgbh[i]);
+        C3f expected;
+        IMATH_INTERNAL_NAMESPACE::rgb2hsv (&in, &expected, 1);
+
+        assert (hsvh[i] == C3h (expected));
+        assert (hsvah[i] == C4h (hsvh[i].x, hsvh[i].y, hsvh[i].z, half (0.5f)));
+    }
+
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (hsvh.data(), rgbh.data(), n);
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (hsvah.data(), rgbah.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        C3f in (hsvh[i]);
+        C3f expected;
+        IMATH_INTERNAL_NAMESPACE::hsv2rgb (&in, &expected, 1);
+
+        assert (rgbh[i] == C3h (expected));
+        assert (rgbah[i] == C4h (rgbh[i].x, rgbh[i].y, rgbh[i].z, half (0.5f)));
+    }
+}
+
+//
+// The array conversions to and from PackedColor
+//
+
+double
+srgbEncode (double x)
+{
+    return (x <= 0.0031308) ? 12.92 * x : 1.055 * pow (x, 1 / 2.4) - 0.055;
+}
+
+unsigned
+byte (IMATH_INTERNAL_NAMESPACE::PackedColor packed, int i)
+{
+    return (packed >> (8 * i)) & 0xFF;
+}
+
+//
+// Black and white pack to 0x00 and 0xFF components with every
+// rounding and encoding. The alpha of Color3 is 0xFF.
+//
+
+template <class C>
+void
+testPackedBlackAndWhite (typename C::BaseType one, IMATH_INTERNAL_NAMESPACE::PackedColor alpha0)
+{
+    using IMATH_INTERNAL_NAMESPACE::PackedColor;
+
+    C colors[2];
+    for (int j = 0; j < int (C::dimensions()); ++j)
+    {
+        colors[0][j] = typename C::BaseType (0);
+        colors[1][j] = one;
+    }
+
+    for (int rounding = 0; rounding < 2; ++rounding)
+    {
+        for (int encoding = 0; encoding < 2; ++encoding)
+        {
+            PackedColor packed[2];
+            IMATH_INTERNAL_NAMESPACE::rgb2packed (
+                colors,
+                packed,
+                2,
+                IMATH_INTERNAL_NAMESPACE::PackedColorRounding (rounding),
+                IMATH_INTERNAL_NAMESPACE::PackedColorEncoding (encoding));
+
+            assert (packed[0] == alpha0);
+            assert (packed[1] == 0xFFFFFFFF);
+        }
+    }
+}
+
+void
+testPackedArrays()
+{
+    using IMATH_INTERNAL_NAMESPACE::C4c;
+    using IMATH_INTERNAL_NAMESPACE::PackedColor;
+
+    cout << "rgb2packed, packed2rgb for arrays" << endl;
+
+    const size_t n = 10000;
+    Rand48 rand (1);
+
+    vector<C4f> colors (n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        colors[i] = C4f (float (rand.nextf()),
+                         float (rand.nextf()),
+                         float (rand.nextf()),
+                         float (rand.nextf()));
+    }
+
+    vector<C3f> colors3 (n);
+    for (size_t i = 0; i < n; ++i)
+        colors3[i] = C3f (colors[i].r, colors[i].g, colors[i].b);
+
+    vector<PackedColor> packed (n), packed3 (n);
+
+    // Truncation matches rgb2packed(), and unpacking packed2rgb()
+
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (
+        colors.data(), packed.data(), n, IMATH_INTERNAL_NAMESPACE::PACKED_COLOR_TRUNCATE);
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (
+        colors3.data(), packed3.data(), n, IMATH_INTERNAL_NAMESPACE::PACKED_COLOR_TRUNCATE);
+
+    vector<C4f> unpacked (n);
+    vector<C3f> unpacked3 (n);
+    IMATH_INTERNAL_NAMESPACE::packed2rgb (packed.data(), unpacked.data(), n);
+    IMATH_INTERNAL_NAMESPACE::packed2rgb (packed3.data(), unpacked3.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (packed[i] == IMATH_INTERNAL_NAMESPACE::rgb2packed (colors[i]));
+        assert (packed3[i] == IMATH_INTERNAL_NAMESPACE::rgb2packed (colors3[i]));
+
+        C4f c;
+        C3f c3;
+        IMATH_INTERNAL_NAMESPACE::packed2rgb (packed[i], c);
+        IMATH_INTERNAL_NAMESPACE::packed2rgb (packed3[i], c3);
+        assert (unpacked[i] == c && unpacked3[i] == c3);
+    }
+
+    // Rounding, with clamping, and NaN
+
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (colors.data(), packed.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            assert (byte (packed[i], j) == unsigned (colors[i][j] * 255 + 0.5f));
+    }
+
+    C4f special[] = {C4f (-1, 2, 1e30f, -1e30f), C4f (nanf (""), 0.5f, 0.998f, 0.002f)};
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (special, packed.data(), 2);
+    assert (packed[0] == 0x00FFFF00 && packed[1] == 0x01FE8000);
+
+    // Half colors
+
+    vector<C4h> colorsh (n);
+    for (size_t i = 0; i < n; ++i)
+        colorsh[i] = C4h (colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (colorsh.data(), packed.data(), n);
+    IMATH_INTERNAL_NAMESPACE::packed2rgb (packed.data(), colorsh.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            assert (abs (colorsh[i][j] - colors[i][j]) <= 0.5f / 255 + 1e-3f);
+    }
+
+    // Unsigned char colors are copied
+
+    vector<C4c> colorsc (n), unpackedc (n);
+    for (size_t i = 0; i < n; ++i)
+        colorsc[i] = C4c (i & 0xFF, (i >> 8) & 0xFF, (i * 7) & 0xFF, 255 - (i & 0xFF));
+
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (colorsc.data(), packed.data(), n);
+    IMATH_INTERNAL_NAMESPACE::packed2rgb (packed.data(), unpackedc.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (packed[i] == IMATH_INTERNAL_NAMESPACE::rgb2packed (colorsc[i]));
+        assert (unpackedc[i] == colorsc[i]);
+    }
+
+    testPackedBlackAndWhite<C3f> (1.0f, 0xFF000000);
+    testPackedBlackAndWhite<C4f> (1.0f, 0);
+    testPackedBlackAndWhite<C4h> (half (1.0f), 0);
+    testPackedBlackAndWhite<C4c> (255, 0);
+
+    // sRGB encoding is exact, decoding inverts it, and alpha is linear
+
+    const IMATH_INTERNAL_NAMESPACE::PackedColorEncoding srgb =
+        IMATH_INTERNAL_NAMESPACE::PACKED_COLOR_SRGB;
+
+    for (int rounding = 0; rounding < 2; ++rounding)
+    {
+        IMATH_INTERNAL_NAMESPACE::PackedColorRounding r =
+            IMATH_INTERNAL_NAMESPACE::PackedColorRounding (rounding);
+
+        IMATH_INTERNAL_NAMESPACE::rgb2packed (colors.data(), packed.data(), n, r, srgb);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                double e = srgbEncode (colors[i][j]) * 255 + (rounding ? 0.5 : 0);
+                assert (byte (packed[i], j) == unsigned (e));
+            }
+
+            assert (byte (packed[i], 3) == unsigned (colors[i].a * 255 + (rounding ? 0.5f : 0)));
+        }
+    }
+
+    for (size_t i = 0; i < 256; ++i)
+        packed[i] = PackedColor (i * 0x01010101);
+
+    IMATH_INTERNAL_NAMESPACE::packed2rgb (packed.data(), unpacked.data(), 256, srgb);
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (
+        unpacked.data(), packed3.data(), 256, IMATH_INTERNAL_NAMESPACE::PACKED_COLOR_ROUND, srgb);
+    IMATH_INTERNAL_NAMESPACE::packed2rgb (packed.data(), colorsc.data(), 256, srgb);
+
+    for (size_t i = 0; i < 256; ++i)
+    {
+        assert (packed3[i] == packed[i]);
+        assert (unpacked[i].a == float (i) * (1.0f / 255));
+        assert (colorsc[i].r == (unsigned char) (unpacked[i].r * 255 + 0.5f));
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmarkHsvArrays()
+{
+    const size_t n  = 1920 * 1080;
+    vector<C3f> rgb = testColors (n);
+    vector<C3f> hsv (n), back (n);
+
+    clock_t t0 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        hsv[i] = IMATH_INTERNAL_NAMESPACE::rgb2hsv (rgb[i]);
+
+    for (size_t i = 0; i < n; ++i)
+        back[i] = IMATH_INTERNAL_NAMESPACE::hsv2rgb (hsv[i]);
+
+    clock_t t1 = clock();
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (rgb.data(), hsv.data(), n);
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (hsv.data(), back.data(), n);
+
+    clock_t t2 = clock();
+
+    cout << "  " << n << " colors to HSV and back: one at a time "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, as arrays "
+         << double (t2 - t1) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmarkPackedArrays()
+{
+    using IMATH_INTERNAL_NAMESPACE::PackedColor;
+
+    const size_t n = 1920 * 1080;
+    Rand48 rand (2);
+
+    vector<C4f> colors (n);
+    for (size_t i = 0; i < n; ++i)
+        colors[i] = C4f (float (rand.nextf()));
+
+    vector<PackedColor> packed (n);
+
+    clock_t t0 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        packed[i] = IMATH_INTERNAL_NAMESPACE::rgb2packed (colors[i]);
+
+    clock_t t1 = clock();
+
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (colors.data(), packed.data(), n);
+
+    clock_t t2 = clock();
+
+    IMATH_INTERNAL_NAMESPACE::rgb2packed (colors.data(),
+                                          packed.data(),
+                                          n,
+                                          IMATH_INTERNAL_NAMESPACE::PACKED_COLOR_ROUND,
+                                          IMATH_INTERNAL_NAMESPACE::PACKED_COLOR_SRGB);
+
+    clock_t t3 = clock();
+
+    cout << "  " << n << " colors packed: one at a time " << double (t1 - t0) / CLOCKS_PER_SEC
+         << " s, as an array " << double (t2 - t1) / CLOCKS_PER_SEC << " s, as sRGB "
+         << double (t3 - t2) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
 void
 testColor()
 {
@@ -160,5 +575,13 @@ testColor()
             std::fabs ((X.b / Y.b) - tmp.b) <= 1e-5f &&
             std::fabs ((X.a / Y.a) - tmp.a) <= 1e-5f);
 
+    testHsvArrays();
+    testPackedArrays();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmarkHsvArrays();
+    benchmarkPackedArrays();
+#endif
+
     cout << "ok\n" << endl;
 }
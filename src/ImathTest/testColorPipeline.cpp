@@ -0,0 +1,364 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathColorPipeline.h"
+#include "ImathFun.h"
+#include "ImathRandom.h"
+#include "half.h"
+#include "halfFunction.h"
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <testColorPipeline.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// ACEScg (AP1 primaries) to linear Rec.709, for row vectors
+//
+
+template <class T>
+Matrix33<T>
+ap1ToRec709()
+{
+    return Matrix33<T> (T (1.70505),
+                        T (-0.62179),
+                        T (-0.08326),
+                        T (-0.13026),
+                        T (1.14080),
+                        T (-0.01055),
+                        T (-0.02400),
+                        T (-0.12897),
+                        T (1.15297))
+        .transposed();
+}
+
+double
+srgbEncode (double x)
+{
+    double a = std::abs (x);
+    double y = a <= 0.0031308 ? 12.92 * a : 1.055 * std::pow (a, 1 / 2.4) - 0.055;
+    return std::copysign (y, x);
+}
+
+double
+srgbDecode (double x)
+{
+    double a = std::abs (x);
+    double y = a <= 0.04045 ? a / 12.92 : std::pow ((a + 0.055) / 1.055, 2.4);
+    return std::copysign (y, x);
+}
+
+template <class T>
+Color3<double>
+reference (const Color3<double>& c, const Matrix33<T>& m1, const Matrix33<T>& m2)
+{
+    Color3<double> d = c * m1;
+
+    for (int j = 0; j < 3; ++j)
+        d[j] = srgbEncode (std::copysign (std::pow (std::abs (d[j]), 2.2), d[j]));
+
+    return d * m2;
+}
+
+template <class T>
+vector<Color4<T>>
+randomColors (size_t n)
+{
+    Rand48 rand (n);
+    vector<Color4<T>> colors (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        colors[i] = Color4<T> (T (rand.nextf (-0.5, 2)),
+                               T (rand.nextf (-0.5, 2)),
+                               T (rand.nextf (-0.5, 2)),
+                               T (rand.nextf()));
+    }
+
+    return colors;
+}
+
+//
+// Adjacent matrices are multiplied together
+//
+
+void
+testStages()
+{
+    M33f m1 = ap1ToRec709<float>();
+    M33f m2 (2, 0, 0, 0, 3, 0, 0, 0, 4);
+
+    ColorPipelinef p;
+    assert (p.numStages() == 0);
+
+    p.appendMatrix (m1).appendMatrix (m2);
+    assert (p.numStages() == 1);
+
+    p.appendCurve (ColorPipelinef::CURVE_SRGB_ENCODE).appendMatrix (m2);
+    assert (p.numStages() == 3);
+
+    // The last matrix of p and the first of the copy are multiplied
+
+    p.append (p);
+    assert (p.numStages() == 5);
+
+    Color3f c (0.25f, 0.5f, 0.75f);
+    Color3f d = Color3f (c * m1 * m2);
+
+    for (int j = 0; j < 3; ++j)
+        d[j] = float (srgbEncode (d[j]));
+
+    d = Color3f (d * m2 * m1 * m2);
+
+    for (int j = 0; j < 3; ++j)
+        d[j] = float (srgbEncode (d[j]));
+
+    d = Color3f (d * m2);
+
+    assert (p.apply (c).equalWithRelError (d, 1e-5f));
+
+    // The identity
+
+    ColorPipelinef identity;
+    Color4f c4 (0.25f, -0.5f, 1.5f, 0.5f);
+    assert (identity.apply (c4) == c4);
+}
+
+//
+// Arrays of colors agree with the curves and matrices applied one at
+// a time, in double precision
+//
+
+template <class T, class S>
+void
+testArrays (T e)
+{
+    const size_t n = 1000;
+
+    Matrix33<T> m1 = ap1ToRec709<T>();
+    Matrix33<T> m2 = m1.inverse();
+
+    ColorPipeline<T> p;
+    p.appendMatrix (m1);
+    p.appendPower (T (2.2));
+    p.appendCurve (ColorPipeline<T>::CURVE_SRGB_ENCODE);
+    p.appendMatrix (m2);
+
+    vector<Color4<S>> in = randomColors<S> (n);
+    vector<Color4<S>> out4 (n);
+    vector<Color3<S>> in3 (n), out3 (n);
+
+    for (size_t i = 0; i < n; ++i)
+        in3[i] = Color3<S> (in[i].r, in[i].g, in[i].b);
+
+    p.apply (in.data(), out4.data(), n);
+    p.apply (in3.data(), out3.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Color3<double> c (in[i].r, in[i].g, in[i].b);
+        Color3<double> ref = reference (c, m1, m2);
+
+        for (int j = 0; j < 3; ++j)
+        {
+            assert (equalWithAbsError (double (out4[i][j]), ref[j], e * (1 + std::abs (ref[j]))));
+            assert (out3[i][j] == out4[i][j]);
+        }
+
+        assert (out4[i].a == in[i].a);
+        assert (p.apply (in[i]) == out4[i]);
+    }
+
+    // In place
+
+    p.apply (in.data(), in.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (in[i] == out4[i]);
+}
+
+//
+// Converting ACEScg to sRGB and back
+//
+
+void
+testRoundTrip()
+{
+    const size_t n = 1000;
+
+    M33f m = ap1ToRec709<float>();
+
+    ColorPipelinef toSrgb;
+    toSrgb.appendMatrix (m).appendCurve (ColorPipelinef::CURVE_SRGB_ENCODE);
+
+    ColorPipelinef fromSrgb;
+    fromSrgb.appendCurve (ColorPipelinef::CURVE_SRGB_DECODE).appendMatrix (m.inverse());
+
+    ColorPipelinef roundTrip = toSrgb;
+    roundTrip.append (fromSrgb);
+    assert (roundTrip.numStages() == 4);
+
+    vector<Color4f> in = randomColors<float> (n);
+    vector<Color4f> srgb (n), out (n);
+
+    toSrgb.apply (in.data(), srgb.data(), n);
+    fromSrgb.apply (srgb.data(), out.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+            assert (equalWithAbsError (out[i][j], in[i][j], 1e-5f));
+
+        assert (out[i] == roundTrip.apply (in[i]));
+
+        Color3<double> c (in[i].r, in[i].g, in[i].b);
+        c *= Matrix33<double> (m);
+
+        for (int j = 0; j < 3; ++j)
+            assert (equalWithAbsError (double (srgb[i][j]), srgbEncode (c[j]), 1e-5));
+    }
+
+    // The decoding inverts the encoding exactly in double
+
+    for (int k = -100; k <= 100; ++k)
+    {
+        double x = k / 50.0;
+        assert (equalWithAbsError (srgbDecode (srgbEncode (x)), x, 1e-12));
+    }
+}
+
+//
+// Lookup tables evaluate the halfFunction for the components rounded
+// to half
+//
+
+half
+halfSqrt (half x)
+{
+    return half (std::sqrt (float (x)));
+}
+
+void
+testLookupTables()
+{
+    const size_t n = 1000;
+
+    halfFunction<half> sqrtLut (halfSqrt, 0, HALF_MAX, 0, half::posInf(), 0, half::qNan());
+
+    ColorPipelinef p;
+    p.appendCurve (sqrtLut);
+    p.appendMatrix (M33f (2, 0, 0, 0, 2, 0, 0, 0, 2));
+
+    vector<Color4f> in = randomColors<float> (n);
+    vector<Color4f> out (n);
+
+    p.apply (in.data(), out.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            float ref = 2 * float (sqrtLut (half (in[i][j])));
+            assert (out[i][j] == ref);
+            assert (in[i][j] >= 0 || out[i][j] == 0);
+        }
+    }
+
+    // Without a matrix, which would spread the NaN to every component
+
+    ColorPipelinef q;
+    q.appendCurve (sqrtLut);
+
+    Color3h specials[] = {Color3h (half::posInf(), half::qNan(), half (-1))};
+    q.apply (specials, specials, 1);
+    assert (specials[0][0].isInfinity() && specials[0][1].isNan() && specials[0][2] == 0);
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmark()
+{
+    const size_t n = 1920 * 1080;
+
+    M33f m = ap1ToRec709<float>();
+
+    halfFunction<half> encodeLut (
+        [] (half x) { return half (float (srgbEncode (float (x)))); },
+        -HALF_MAX,
+        HALF_MAX,
+        0,
+        1,
+        -1);
+
+    ColorPipelinef analytic, lut;
+    analytic.appendMatrix (m).appendCurve (ColorPipelinef::CURVE_SRGB_ENCODE);
+    lut.appendMatrix (m).appendCurve (encodeLut);
+
+    vector<Color4f> in = randomColors<float> (n);
+    vector<Color4f> out (n);
+
+    clock_t t0 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Color3f c = Color3f (Color3f (in[i].r, in[i].g, in[i].b) * m);
+
+        out[i] = Color4f (float (srgbEncode (c.x)),
+                          float (srgbEncode (c.y)),
+                          float (srgbEncode (c.z)),
+                          in[i].a);
+    }
+
+    clock_t t1 = clock();
+
+    analytic.apply (in.data(), out.data(), n);
+
+    clock_t t2 = clock();
+
+    lut.apply (in.data(), out.data(), n);
+
+    clock_t t3 = clock();
+
+    cout << "  " << n << " colors from ACEScg to sRGB: one at a time "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, pipeline "
+         << double (t2 - t1) / CLOCKS_PER_SEC << " s, pipeline with lookup table "
+         << double (t3 - t2) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testColorPipeline()
+{
+    cout << "Testing color pipelines" << endl;
+
+    testStages();
+    testArrays<float, float> (1e-5f);
+    testArrays<float, half> (1e-2f);
+    testArrays<double, double> (1e-12);
+    testArrays<double, float> (1e-6);
+    testRoundTrip();
+    testLookupTables();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark();
+#endif
+
+    cout << "ok\n" << endl;
+}
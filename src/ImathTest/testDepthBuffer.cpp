@@ -0,0 +1,223 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathDepthBuffer.h"
+#include "ImathFun.h"
+#include "ImathRandom.h"
+#include "half.h"
+#include <cassert>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <testDepthBuffer.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// The conversions agree with Frustum's for normalized floating-point
+// Z values, and for integer Z values
+//
+
+template <class T>
+void
+testFrustum (const Frustum<T>& frustum, T e)
+{
+    const size_t n = 1000;
+    Rand48 rand (0);
+
+    // Normalized Z values
+
+    DepthLinearizer<T> linearizer (frustum);
+
+    vector<T> z (n), depth (n), back (n);
+    vector<half> zh (n);
+    vector<T> depthh (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        z[i]  = T (rand.nextf (0.01, 0.99));
+        zh[i] = half (float (z[i]));
+    }
+
+    linearizer.depthBufferToLinear (z.data(), n, depth.data());
+    linearizer.depthBufferToLinear (zh.data(), n, depthh.data());
+    linearizer.linearToDepthBuffer (depth.data(), n, back.data());
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T ref = frustum.normalizedZToDepth (z[i]);
+        assert (equalWithRelError (depth[i], ref, e));
+        assert (depth[i] == linearizer.toLinear (z[i]));
+        assert (equalWithAbsError (back[i], z[i], e));
+        assert (back[i] == linearizer.fromLinear (depth[i]));
+
+        T refh = frustum.normalizedZToDepth (T (float (zh[i])));
+        assert (equalWithRelError (depthh[i], refh, e));
+    }
+
+    // 24-bit integer Z values
+
+    const long zmin = 0, zmax = 0xffffff;
+    DepthLinearizer<T> linearizer24 (frustum, zmin, zmax);
+
+    vector<uint32_t> zi (n), backi (n);
+    for (size_t i = 0; i < n; ++i)
+        zi[i] = uint32_t (rand.nexti() % (zmax + 1));
+
+    linearizer24.depthBufferToLinear (zi.data(), n, depth.data());
+    linearizer24.linearToDepthBuffer (depth.data(), n, backi.data());
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T ref = frustum.ZToDepth (long (zi[i]), zmin, zmax);
+        assert (equalWithRelError (depth[i], ref, e * 10));
+
+        // The round trip and DepthToZ() agree to within the rounding
+        // of T, which for float is coarser than the integer steps
+
+        long tolerance = 1 + long (zmax * e);
+        long z         = frustum.DepthToZ (depth[i], zmin, zmax);
+        assert (backi[i] <= zmax);
+        assert (abs (long (backi[i]) - long (zi[i])) <= tolerance);
+        assert (abs (long (backi[i]) - z) <= tolerance);
+    }
+}
+
+template <class T>
+void
+testFrustums (T e)
+{
+    typedef Frustum<T> F;
+
+    const typename F::DepthRange ranges[] = {
+        F::DEPTH_NEGATIVE_ONE_TO_ONE, F::DEPTH_ZERO_TO_ONE, F::DEPTH_ONE_TO_ZERO};
+
+    F perspective (T (0.1), T (100), T (-1), T (2), T (0.75), T (-0.5));
+    F orthographic (T (0.1), T (100), T (-1), T (2), T (0.75), T (-0.5), true);
+    F infinite (
+        T (0.1), std::numeric_limits<T>::infinity(), T (-1), T (2), T (0.75), T (-0.5));
+
+    for (auto range : ranges)
+    {
+        perspective.setDepthRange (range);
+        orthographic.setDepthRange (range);
+        infinite.setDepthRange (range);
+
+        testFrustum (perspective, e);
+        testFrustum (orthographic, e);
+        testFrustum (infinite, e);
+    }
+}
+
+//
+// Integer Z values are clamped to [zmin, zmax]
+//
+
+void
+testClamping()
+{
+    Frustumf frustum (0.1f, 100.0f, -1.0f, 1.0f, 1.0f, -1.0f);
+    DepthLinearizerf linearizer (frustum, 0, 0xffffffff);
+
+    float depth[] = {-0.01f,
+                     -0.1f,
+                     -100.0f,
+                     -1000.0f,
+                     std::numeric_limits<float>::quiet_NaN(),
+                     -1e30f};
+    uint32_t z[6];
+
+    linearizer.linearToDepthBuffer (depth, 6, z);
+
+    assert (z[0] == 0);
+    assert (z[1] < 0x100);
+    assert (z[2] > 0xffffff00u);
+    assert (z[3] == 0xffffffffu);
+    assert (z[4] == 0);
+    assert (z[5] == 0xffffffffu);
+
+    uint16_t z16[6];
+    DepthLinearizerf linearizer16 (frustum, 0, 0xffff);
+    linearizer16.linearToDepthBuffer (depth, 6, z16);
+    assert (z16[0] == 0 && z16[3] == 0xffff);
+
+    // An empty range of Z-buffer values is rejected, like
+    // Frustum::ZToDepthExc() does
+
+    bool caught = false;
+    try
+    {
+        DepthLinearizerf empty (frustum, 7, 7);
+    }
+    catch (std::domain_error&)
+    {
+        caught = true;
+    }
+    assert (caught);
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmark()
+{
+    const size_t n = 3840 * 2160;
+
+    Frustumf frustum (0.1f, 1000.0f, -1.0f, 1.0f, 0.5625f, -0.5625f);
+    frustum.setDepthRange (Frustumf::DEPTH_ONE_TO_ZERO);
+
+    DepthLinearizerf linearizer (frustum);
+    Rand48 rand (1);
+
+    vector<float> z (n), depth (n);
+    for (size_t i = 0; i < n; ++i)
+        z[i] = float (rand.nextf());
+
+    clock_t t0 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        depth[i] = frustum.normalizedZToDepth (z[i]);
+
+    clock_t t1 = clock();
+
+    linearizer.depthBufferToLinear (z.data(), n, depth.data());
+
+    clock_t t2 = clock();
+
+    cout << "  " << n << " depth samples: normalizedZToDepth() "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, depthBufferToLinear() "
+         << double (t2 - t1) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testDepthBuffer()
+{
+    cout << "Testing depth buffer conversion" << endl;
+
+    testFrustums (1e-4f);
+    testFrustums (1e-9);
+    testClamping();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark();
+#endif
+
+    cout << "ok\n" << endl;
+}
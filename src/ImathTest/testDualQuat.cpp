@@ -0,0 +1,235 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathMatrixAlgo.h"
+#include "ImathQuat.h"
+#include "ImathRandom.h"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <testDualQuat.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+Matrix44<T>
+randomRigid (Rand48& rand)
+{
+    Quat<T> q (T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)));
+
+    Matrix44<T> m = q.normalized().toMatrix44();
+    m.translate (Vec3<T> (T (rand.nextf (-10, 10)),
+                          T (rand.nextf (-10, 10)),
+                          T (rand.nextf (-10, 10))));
+    return m;
+}
+
+template <class T>
+void
+testDualQuatT()
+{
+    const T e = sizeof (T) == 8 ? T (1e-10) : T (1e-4);
+    Rand48 rand (2024);
+
+    //
+    // constructors, rotation(), translation()
+    //
+
+    {
+        DualQuat<T> dq;
+        assert (dq.r == Quat<T>() && dq.d == Quat<T> (0, 0, 0, 0));
+        assert (dq == DualQuat<T>::identity());
+
+        Quat<T> q;
+        q.setAxisAngle (Vec3<T> (0, 0, 1), T (M_PI_2));
+        dq = DualQuat<T> (q, Vec3<T> (1, 2, 3));
+        assert (dq.rotation() == q);
+        assert (dq.translation().equalWithAbsError (Vec3<T> (1, 2, 3), e));
+
+        // rotate (1, 0, 0) to (0, 1, 0), then translate
+
+        Vec3<T> p = Vec3<T> (1, 0, 0) * dq;
+        assert (p.equalWithAbsError (Vec3<T> (1, 3, 3), e));
+
+        DualQuat<T> dq1 = DualQuat<T> (DualQuat<float> (dq));
+        assert (dq1.translation().equalWithAbsError (Vec3<T> (1, 2, 3), T (1e-5)));
+    }
+
+    //
+    // Conversion to and from Matrix44, composition, inverse
+    //
+
+    for (int i = 0; i < 100; ++i)
+    {
+        Matrix44<T> m1 = randomRigid<T> (rand);
+        Matrix44<T> m2 = randomRigid<T> (rand);
+
+        DualQuat<T> dq1 = extractDualQuat (m1);
+        DualQuat<T> dq2 = extractDualQuat (m2);
+
+        assert (dq1.toMatrix44().equalWithAbsError (m1, e * 10));
+
+        Vec3<T> p (T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1)));
+        assert ((p * dq1).equalWithAbsError (p * m1, e * 10));
+
+        // (dq2 * dq1) applies dq1 first
+
+        assert ((dq2 * dq1).toMatrix44().equalWithAbsError (m1 * m2, e * 100));
+
+        DualQuat<T> dq3 = dq1;
+        dq3 *= dq2;
+        assert (dq3 == dq1 * dq2);
+
+        assert ((dq1 * dq1.inverse()).toMatrix44().equalWithAbsError (Matrix44<T>(), e * 10));
+        assert ((p * dq1 * ~dq1).equalWithAbsError (p, e * 100));
+    }
+
+    //
+    // normalize()
+    //
+
+    {
+        DualQuat<T> dq = extractDualQuat (randomRigid<T> (rand));
+        DualQuat<T> dq1 = (dq * T (3)).normalized();
+        assert (dq1.toMatrix44().equalWithAbsError (dq.toMatrix44(), e * 10));
+
+        dq1 = DualQuat<T> (dq.r, dq.d + dq.r * T (0.1));
+        dq1.normalize();
+        assert (std::abs (dq1.r ^ dq1.d) < e);
+
+        dq1 = DualQuat<T> (Quat<T> (0, 0, 0, 0), Quat<T> (1, 2, 3, 4));
+        assert (dq1.normalize() == DualQuat<T>());
+    }
+
+    //
+    // sclerp() and dlb()
+    //
+
+    {
+        Quat<T> q;
+        q.setAxisAngle (Vec3<T> (0, 0, 1), T (M_PI_2));
+        DualQuat<T> dq1;
+        DualQuat<T> dq2 (q, Vec3<T> (0, 0, 2));
+
+        // Screw motion: a quarter of the rotation, a quarter of the
+        // translation along the z axis
+
+        DualQuat<T> dq = sclerp (dq1, dq2, T (0.25));
+        Quat<T> q1;
+        q1.setAxisAngle (Vec3<T> (0, 0, 1), T (M_PI_2 / 4));
+        assert (std::abs (dq.r ^ q1) > 1 - e);
+        assert (dq.translation().equalWithAbsError (Vec3<T> (0, 0, T (0.5)), e));
+
+        assert (sclerp (dq1, dq2, T (0)).toMatrix44().equalWithAbsError (dq1.toMatrix44(), e));
+        assert (sclerp (dq1, dq2, T (1)).toMatrix44().equalWithAbsError (dq2.toMatrix44(), e));
+
+        // Sign of the second quaternion does not matter
+
+        assert (sclerp (dq1, -dq2, T (0.25)).toMatrix44().equalWithAbsError (dq.toMatrix44(), e));
+
+        // Pure translation
+
+        DualQuat<T> dq3 (Quat<T>(), Vec3<T> (4, 0, 0));
+        assert (sclerp (dq1, dq3, T (0.5)).translation().equalWithAbsError (Vec3<T> (2, 0, 0),
+                                                                            e));
+
+        // Blending preserves rigidity, and blending equal transforms
+        // is the identity operation
+
+        DualQuat<T> b = dlb (dq2, -dq2, T (0.3));
+        assert (b.toMatrix44().equalWithAbsError (dq2.toMatrix44(), e));
+
+        b = dlb (dq1, dq2, T (0.5));
+        assert (std::abs ((b.r ^ b.r) - 1) < e);
+        assert (std::abs (b.r ^ b.d) < e);
+
+        DualQuat<T> dqs[3] = { dq1, dq2, -dq3 };
+        T weights[3]       = { T (0.5), T (0.25), T (0.25) };
+        b                  = dlb (dqs, weights, 3);
+        assert (std::abs ((b.r ^ b.r) - 1) < e);
+        assert (std::abs (b.r ^ b.d) < e);
+    }
+
+    //
+    // Batched blending and transformation
+    //
+
+    {
+        const int numJoints  = 10;
+        const int influences = 4;
+        const size_t n       = 100;
+
+        vector<DualQuat<T>> joints (numJoints);
+        for (int j = 0; j < numJoints; ++j)
+            joints[j] = extractDualQuat (randomRigid<T> (rand));
+
+        vector<int> indices (n * influences);
+        vector<T> weights (n * influences);
+        for (size_t i = 0; i < n * influences; ++i)
+        {
+            indices[i] = rand.nexti() % numJoints;
+            weights[i] = T (rand.nextf (0, 1));
+        }
+
+        vector<DualQuat<T>> blended (n);
+        dlb (&joints[0], &indices[0], &weights[0], influences, n, &blended[0]);
+
+        vector<Vec3<T>> points (n), moved (n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            DualQuat<T> dqs[influences];
+            for (int k = 0; k < influences; ++k)
+                dqs[k] = joints[indices[i * influences + k]];
+
+            DualQuat<T> b = dlb (dqs, &weights[i * influences], influences);
+            assert (b.toMatrix44().equalWithAbsError (blended[i].toMatrix44(), e * 10));
+
+            points[i] = Vec3<T> (T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1)));
+        }
+
+        transform (&blended[0], &points[0], &moved[0], n);
+        for (size_t i = 0; i < n; ++i)
+            assert (moved[i].equalWithAbsError (points[i] * blended[i].toMatrix44(), e * 100));
+    }
+
+    //
+    // No influences: no joint is read, and the results are the identity
+    //
+
+    {
+        DualQuat<T> blended[3];
+        blended[1] = DualQuat<T> (Quat<T> (0, 1, 0, 0), Quat<T> (1, 2, 3, 4));
+
+        dlb<T> (nullptr, nullptr, nullptr, 0, 3, blended);
+
+        for (int i = 0; i < 3; ++i)
+            assert (blended[i] == DualQuat<T>());
+    }
+}
+
+} // namespace
+
+void
+testDualQuat()
+{
+    cout << "Testing dual quaternions" << endl;
+
+    testDualQuatT<float>();
+    testDualQuatT<double>();
+
+    cout << "ok\n" << endl;
+}
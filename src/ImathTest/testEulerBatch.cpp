@@ -0,0 +1,245 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathEuler.h"
+#include "ImathRandom.h"
+#include <cassert>
+#include <ctime>
+#include <iostream>
+#include <testEulerBatch.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+bool
+equalMatrix (const Matrix44<T>& a, const Matrix44<T>& b)
+{
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            if (a[i][j] != b[i][j])
+                return false;
+    return true;
+}
+
+template <class T>
+bool
+equalMatrix (const Matrix33<T>& a, const Matrix33<T>& b)
+{
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            if (a[i][j] != b[i][j])
+                return false;
+    return true;
+}
+
+//
+// The compile-time conversions must match the member functions of an
+// Euler object with the same order bit for bit.
+//
+
+template <class T, typename Euler<T>::Order O>
+void
+testStaticOrder (Rand48& rand)
+{
+    for (int i = 0; i < 20; ++i)
+    {
+        Vec3<T> ijk (T (rand.nextf (-M_PI, M_PI)),
+                     T (rand.nextf (-M_PI, M_PI)),
+                     T (rand.nextf (-M_PI, M_PI)));
+
+        Euler<T> e (ijk, O);
+
+        assert (equalMatrix (Euler<T>::template toMatrix33<O> (ijk), e.toMatrix33()));
+        assert (equalMatrix (Euler<T>::template toMatrix44<O> (ijk), e.toMatrix44()));
+        assert (Euler<T>::template toQuat<O> (ijk) == e.toQuat());
+
+        Matrix33<T> M33 = e.toMatrix33();
+        Matrix44<T> M44 = e.toMatrix44();
+        Quat<T> q       = e.toQuat();
+
+        Euler<T> e1 (O);
+        e1.extract (M33);
+        assert (Euler<T>::template extractAngles<O> (M33) == e1);
+        e1.extract (M44);
+        assert (Euler<T>::template extractAngles<O> (M44) == e1);
+        e1.extract (q);
+        assert (Euler<T>::template extractAngles<O> (q) == e1);
+    }
+}
+
+template <class T>
+void
+testStatic()
+{
+    Rand48 rand (0);
+
+    testStaticOrder<T, Euler<T>::XYZ> (rand);
+    testStaticOrder<T, Euler<T>::XZY> (rand);
+    testStaticOrder<T, Euler<T>::YZX> (rand);
+    testStaticOrder<T, Euler<T>::YXZ> (rand);
+    testStaticOrder<T, Euler<T>::ZXY> (rand);
+    testStaticOrder<T, Euler<T>::ZYX> (rand);
+    testStaticOrder<T, Euler<T>::XZX> (rand);
+    testStaticOrder<T, Euler<T>::XYX> (rand);
+    testStaticOrder<T, Euler<T>::YXY> (rand);
+    testStaticOrder<T, Euler<T>::YZY> (rand);
+    testStaticOrder<T, Euler<T>::ZYZ> (rand);
+    testStaticOrder<T, Euler<T>::ZXZ> (rand);
+    testStaticOrder<T, Euler<T>::XYZr> (rand);
+    testStaticOrder<T, Euler<T>::XZYr> (rand);
+    testStaticOrder<T, Euler<T>::YZXr> (rand);
+    testStaticOrder<T, Euler<T>::YXZr> (rand);
+    testStaticOrder<T, Euler<T>::ZXYr> (rand);
+    testStaticOrder<T, Euler<T>::ZYXr> (rand);
+    testStaticOrder<T, Euler<T>::XZXr> (rand);
+    testStaticOrder<T, Euler<T>::XYXr> (rand);
+    testStaticOrder<T, Euler<T>::YXYr> (rand);
+    testStaticOrder<T, Euler<T>::YZYr> (rand);
+    testStaticOrder<T, Euler<T>::ZYZr> (rand);
+    testStaticOrder<T, Euler<T>::ZXZr> (rand);
+}
+
+//
+// The batched conversions must match the member functions for every
+// legal order.
+//
+
+template <class T>
+void
+testBatched()
+{
+    const size_t n = 100;
+    Rand48 rand (1);
+
+    vector<Vec3<T>> ijk (n), angles (n);
+    vector<Matrix33<T>> M33 (n);
+    vector<Matrix44<T>> M44 (n);
+    vector<Quat<T>> q (n);
+
+    for (size_t i = 0; i < n; ++i)
+        ijk[i] = Vec3<T> (T (rand.nextf (-M_PI, M_PI)),
+                          T (rand.nextf (-M_PI, M_PI)),
+                          T (rand.nextf (-M_PI, M_PI)));
+
+    for (int o = 0; o < Euler<T>::Max; ++o)
+    {
+        typename Euler<T>::Order order = typename Euler<T>::Order (o);
+
+        if (!Euler<T>::legal (order))
+            continue;
+
+        Euler<T>::toMatrix33 (&ijk[0], &M33[0], n, order);
+        Euler<T>::toMatrix44 (&ijk[0], &M44[0], n, order);
+        Euler<T>::toQuat (&ijk[0], &q[0], n, order);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Euler<T> e (ijk[i], order);
+            assert (equalMatrix (M33[i], e.toMatrix33()));
+            assert (equalMatrix (M44[i], e.toMatrix44()));
+            assert (q[i] == e.toQuat());
+        }
+
+        Euler<T>::extractAngles (&M33[0], &angles[0], n, order);
+        for (size_t i = 0; i < n; ++i)
+        {
+            Euler<T> e (order);
+            e.extract (M33[i]);
+            assert (angles[i] == e);
+        }
+
+        Euler<T>::extractAngles (&M44[0], &angles[0], n, order);
+        for (size_t i = 0; i < n; ++i)
+        {
+            Euler<T> e (order);
+            e.extract (M44[i]);
+            assert (angles[i] == e);
+
+            // Round trip
+
+            Euler<T> e1 (angles[i], order);
+            assert (e1.toMatrix44().equalWithAbsError (M44[i], T (1e-5)));
+        }
+
+        Euler<T>::extractAngles (&q[0], &angles[0], n, order);
+        for (size_t i = 0; i < n; ++i)
+        {
+            Euler<T> e (order);
+            e.extract (q[i]);
+            assert (angles[i] == e);
+        }
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+testTiming()
+{
+    const size_t n    = 1 << 16;
+    const int repeats = 20;
+    Rand48 rand (2);
+
+    vector<Vec3<float>> ijk (n);
+    vector<Matrix44<float>> M (n);
+
+    for (size_t i = 0; i < n; ++i)
+        ijk[i] = Vec3<float> (float (rand.nextf (-M_PI, M_PI)),
+                              float (rand.nextf (-M_PI, M_PI)),
+                              float (rand.nextf (-M_PI, M_PI)));
+
+    float sum = 0;
+
+    clock_t t0 = clock();
+    for (int r = 0; r < repeats; ++r)
+    {
+        for (size_t i = 0; i < n; ++i)
+            M[i] = Eulerf (ijk[i], Eulerf::ZYX).toMatrix44();
+        sum += M[r][0][0];
+    }
+
+    clock_t t1 = clock();
+    for (int r = 0; r < repeats; ++r)
+    {
+        Eulerf::toMatrix44 (&ijk[0], &M[0], n, Eulerf::ZYX);
+        sum += M[r][0][0];
+    }
+
+    clock_t t2 = clock();
+
+    cout << "  Euler objects: " << double (t1 - t0) / CLOCKS_PER_SEC << " s, "
+         << "batched: " << double (t2 - t1) / CLOCKS_PER_SEC << " s"
+         << " (" << sum << ")" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testEulerBatch()
+{
+    cout << "Testing batched and compile-time Euler conversions" << endl;
+
+    testStatic<float>();
+    testStatic<double>();
+    testBatched<float>();
+    testBatched<double>();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    testTiming();
+#endif
+
+    cout << "ok\n" << endl;
+}
@@ -0,0 +1,253 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathFrame.h"
+#include "ImathMatrix.h"
+#include "ImathQuat.h"
+#include "ImathRandom.h"
+#include "ImathVec.h"
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <testFrame.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+vector<Vec3<T>>
+helix (size_t n, T turns)
+{
+    vector<Vec3<T>> points (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T a       = T (2 * M_PI) * turns * T (i) / T (n - 1);
+        points[i] = Vec3<T> (std::cos (a), std::sin (a), a / T (4));
+    }
+
+    return points;
+}
+
+//
+// The frames are orthonormal, the tangents point along the curve,
+// and the three forms of the frames agree.
+//
+
+template <class T>
+void
+checkFrames (const vector<Vec3<T>>& points, T e)
+{
+    const size_t n = points.size();
+
+    vector<Vec3<T>> tangents (n), normals (n);
+    vector<Matrix44<T>> frames (n);
+    vector<Quat<T>> rotations (n);
+
+    computeFrames (points.data(), n, tangents.data(), normals.data());
+    computeFrames (points.data(), n, frames.data());
+    computeFrames (points.data(), n, rotations.data());
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Vec3<T>& t = tangents[i];
+        const Vec3<T>& r = normals[i];
+
+        assert (abs (t.length() - 1) < e && abs (r.length() - 1) < e);
+        assert (abs (t.dot (r)) < e);
+
+        Vec3<T> d = points[i + 1 < n ? i + 1 : i] - points[i > 0 ? i - 1 : i];
+        if (d.length() > 0)
+            assert (t.equalWithAbsError (d.normalized(), e));
+
+        const Matrix44<T>& m = frames[i];
+        Vec3<T> b            = t.cross (r);
+
+        for (int j = 0; j < 3; ++j)
+        {
+            assert (m[0][j] == t[j] && m[1][j] == r[j] && m[2][j] == b[j]);
+            assert (m[3][j] == points[i][j] && m[j][3] == 0);
+        }
+
+        assert (m[3][3] == 1);
+
+        Matrix33<T> q = rotations[i].toMatrix33();
+        assert (abs (rotations[i].length() - 1) < e);
+
+        for (int j = 0; j < 3; ++j)
+        {
+            assert (abs (q[0][j] - t[j]) < e);
+            assert (abs (q[1][j] - r[j]) < e);
+            assert (abs (q[2][j] - b[j]) < e);
+        }
+    }
+}
+
+template <class T>
+void
+testFramesT (T e)
+{
+    Rand48 rand (0);
+
+    // A helix, and random curves, some with repeated points
+
+    checkFrames (helix<T> (100, T (3)), e);
+
+    for (int k = 0; k < 100; ++k)
+    {
+        vector<Vec3<T>> points (1 + k % 20);
+
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            if (i > 0 && rand.nextf() < 0.2)
+                points[i] = points[i - 1];
+            else
+                points[i] = Vec3<T> (T (rand.nextf (-1, 1)),
+                                     T (rand.nextf (-1, 1)),
+                                     T (rand.nextf (-1, 1)));
+        }
+
+        checkFrames (points, e);
+    }
+
+    // Straight lines and single points
+
+    vector<Vec3<T>> line (10);
+    for (size_t i = 0; i < line.size(); ++i)
+        line[i] = Vec3<T> (1, 2, 3) + Vec3<T> (0, 0, T (i));
+
+    checkFrames (line, e);
+    checkFrames (vector<Vec3<T>> (1, Vec3<T> (1, 2, 3)), e);
+    checkFrames (vector<Vec3<T>> (5, Vec3<T> (1, 2, 3)), e);
+    checkFrames (vector<Vec3<T>>(), e);
+
+    // The first frame is that of firstFrame()
+
+    vector<Vec3<T>> points = helix<T> (50, T (1));
+    vector<Matrix44<T>> frames (points.size());
+    computeFrames (points.data(), points.size(), frames.data());
+
+    assert (frames[0].equalWithAbsError (firstFrame (points[0], points[1], points[2]), e));
+
+    // The frames of a planar curve keep the normal of the plane
+
+    vector<Vec3<T>> circle (64);
+    for (size_t i = 0; i < circle.size(); ++i)
+    {
+        T a       = T (0.1) * T (i);
+        circle[i] = Vec3<T> (std::cos (a), std::sin (a), 0);
+    }
+
+    vector<Vec3<T>> tangents (circle.size()), normals (circle.size());
+    computeFrames (circle.data(), circle.size(), tangents.data(), normals.data());
+
+    for (size_t i = 0; i < circle.size(); ++i)
+        assert (normals[i].equalWithAbsError (Vec3<T> (0, 0, 1), e));
+
+    // The frames do not rotate about the tangent: the twist between
+    // consecutive frames, measured about the tangent, is close to
+    // zero, unlike the twist of the Frenet frame of a helix
+
+    points = helix<T> (1000, T (2));
+
+    vector<Vec3<T>> t (points.size()), r (points.size());
+    computeFrames (points.data(), points.size(), t.data(), r.data());
+
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+        Vec3<T> b = t[i - 1].cross (r[i - 1]);
+        assert (abs (r[i].dot (b)) < T (0.001));
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmark()
+{
+    const size_t numCurves = 10000;
+    const size_t n         = 100;
+
+    Rand48 rand (1);
+    vector<V3f> points (numCurves * n);
+
+    for (size_t c = 0; c < numCurves; ++c)
+    {
+        V3f p (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            p += V3f (rand.nextf (-0.1, 0.1), rand.nextf (-0.1, 0.1), rand.nextf (0.5, 1));
+            points[c * n + i] = p;
+        }
+    }
+
+    vector<M44f> frames (points.size());
+    vector<Quatf> rotations (points.size());
+
+    clock_t t0 = clock();
+
+    for (size_t c = 0; c < numCurves; ++c)
+    {
+        const V3f* p = &points[c * n];
+        M44f* m      = &frames[c * n];
+
+        m[0] = firstFrame (p[0], p[1], p[2]);
+        V3f t0 = p[1] - p[0];
+
+        for (size_t i = 1; i < n - 1; ++i)
+        {
+            V3f t1 = p[i + 1] - p[i - 1];
+            m[i]   = nextFrame (m[i - 1], p[i - 1], p[i], t0, t1);
+            t0     = t1;
+        }
+
+        m[n - 1] = lastFrame (m[n - 2], p[n - 2], p[n - 1]);
+    }
+
+    clock_t t1 = clock();
+
+    for (size_t c = 0; c < numCurves; ++c)
+        computeFrames (&points[c * n], n, &frames[c * n]);
+
+    clock_t t2 = clock();
+
+    for (size_t c = 0; c < numCurves; ++c)
+        computeFrames (&points[c * n], n, &rotations[c * n]);
+
+    clock_t t3 = clock();
+
+    cout << "  " << points.size() << " frames: nextFrame() " << double (t1 - t0) / CLOCKS_PER_SEC
+         << " s, computeFrames() " << double (t2 - t1) / CLOCKS_PER_SEC << " s as matrices, "
+         << double (t3 - t2) / CLOCKS_PER_SEC << " s as quaternions" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testFrame()
+{
+    cout << "Testing frames along curves" << endl;
+
+    testFramesT<float> (1e-4f);
+    testFramesT<double> (1e-10);
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark();
+#endif
+
+    cout << "ok\n" << endl;
+}
@@ -10,10 +10,15 @@
 #include "ImathEuler.h"
 #include "ImathFrustum.h"
 #include "ImathFun.h"
+#include "ImathRandom.h"
 #include "ImathVec.h"
 #include <assert.h>
+#include <ctime>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <testFrustum.h>
+#include <vector>
 
 using namespace std;
 
@@ -147,6 +152,272 @@ testFrustumPlanes (IMATH_INTERNAL_NAMESPACE::Frustumf& frustum)
     }
 }
 
+//
+// The batched projections agree with the single ones
+//
+
+template <class T>
+void
+testBatchProjection (const IMATH_INTERNAL_NAMESPACE::Frustum<T>& frustum, T e)
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    const size_t n = 1000;
+    Rand48 rand (0);
+
+    std::vector<Vec3<T>> points (n);
+    std::vector<Vec2<T>> screen (n);
+    std::vector<T> radii (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        points[i] = Vec3<T> (T (rand.nextf (-10, 10)),
+                             T (rand.nextf (-10, 10)),
+                             T (rand.nextf (-20, -0.1)));
+        screen[i] = Vec2<T> (T (rand.nextf (-1.5, 1.5)), T (rand.nextf (-1.5, 1.5)));
+        radii[i]  = T (rand.nextf (0, 2));
+    }
+
+    points[0].z = 0;
+
+    std::vector<Vec2<T>> projected (n);
+    frustum.projectPointToScreenN (points.data(), n, projected.data());
+
+    std::vector<Line3<T>> rays (n);
+    frustum.projectScreenToRayN (screen.data(), n, rays.data());
+
+    std::vector<T> soa[6];
+    for (int k = 0; k < 6; ++k)
+        soa[k].resize (n);
+
+    Line3SoA<T> raysSoA (
+        soa[0].data(), soa[1].data(), soa[2].data(), soa[3].data(), soa[4].data(), soa[5].data());
+    frustum.projectScreenToRayN (screen.data(), n, raysSoA);
+
+    std::vector<T> worldRadii (n), screenRadii (n);
+    frustum.worldRadiusN (points.data(), radii.data(), n, worldRadii.data());
+    frustum.screenRadiusN (points.data() + 1, radii.data() + 1, n - 1, screenRadii.data() + 1);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec2<T> p = frustum.projectPointToScreen (points[i]);
+        assert (projected[i].equalWithRelError (p, e));
+
+        Line3<T> ray = frustum.projectScreenToRay (screen[i]);
+        assert (rays[i].pos.equalWithAbsError (ray.pos, e) &&
+                rays[i].dir.equalWithAbsError (ray.dir, e));
+
+        Line3<T> raySoA = Line3SoA<const T> (raysSoA)[i];
+        assert (raySoA.pos == rays[i].pos && raySoA.dir == rays[i].dir);
+
+        T w = frustum.worldRadius (points[i], radii[i]);
+        assert (equalWithRelError (worldRadii[i], w, e));
+
+        if (i > 0)
+        {
+            T s = frustum.screenRadius (points[i], radii[i]);
+            assert (equalWithRelError (screenRadii[i], s, e));
+        }
+    }
+
+    // Round trip: the rays through the projected points pass
+    // through the points
+
+    frustum.projectScreenToRayN (projected.data() + 1, n - 1, rays.data() + 1);
+
+    for (size_t i = 1; i < n; ++i)
+        assert (rays[i].distanceTo (points[i]) < e * 100);
+}
+
+//
+// The depth conversions invert the projection matrix for each depth
+// range, with finite and infinite far planes
+//
+
+template <class T>
+void
+testDepthRange (IMATH_INTERNAL_NAMESPACE::Frustum<T> frustum,
+                typename IMATH_INTERNAL_NAMESPACE::Frustum<T>::DepthRange range,
+                T e)
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+    typedef Frustum<T> F;
+
+    frustum.setDepthRange (range);
+    assert (frustum.depthRange() == range);
+
+    T dn = range == F::DEPTH_NEGATIVE_ONE_TO_ONE ? T (-1)
+           : range == F::DEPTH_ZERO_TO_ONE       ? T (0)
+                                                 : T (1);
+    T df = range == F::DEPTH_ONE_TO_ZERO ? T (0) : T (1);
+
+    bool infinite = frustum.farPlane() > limits<T>::max();
+    T n           = frustum.nearPlane();
+    T f           = infinite ? T (1e4) * n : frustum.farPlane();
+
+    Matrix44<T> M = frustum.projectionMatrix();
+    assert (M == frustum.projectionMatrixExc());
+
+    assert (equalWithAbsError ((Vec3<T> (0, 0, -n) * M).z, dn, e));
+    if (!infinite)
+        assert (equalWithAbsError ((Vec3<T> (0, 0, -f) * M).z, df, e));
+    else
+        assert (abs ((Vec3<T> (0, 0, -f) * M).z - df) < T (1e-3));
+
+    const long zmin = 0, zmax = 1 << 20;
+    Rand48 rand (1);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        T depth = -T (rand.nextf (n, f));
+        T ndc   = (Vec3<T> (0, 0, depth) * M).z;
+        T zval  = range == F::DEPTH_NEGATIVE_ONE_TO_ONE ? (ndc + 1) / 2 : ndc;
+
+        assert (equalWithRelError (frustum.normalizedZToDepth (zval), depth, e * 100));
+        assert (frustum.normalizedZToDepth (zval) == frustum.normalizedZToDepthExc (zval));
+
+        long z = frustum.DepthToZ (depth, zmin, zmax);
+        assert (z == frustum.DepthToZExc (depth, zmin, zmax));
+        assert (abs (T (z) - zval * zmax) <= 1 + zmax * e);
+    }
+
+    // Depth ranges take part in comparisons, and survive window()
+
+    F other (frustum);
+    assert (other == frustum);
+    other.setDepthRange (range == F::DEPTH_ZERO_TO_ONE ? F::DEPTH_ONE_TO_ZERO
+                                                       : F::DEPTH_ZERO_TO_ONE);
+    assert (other != frustum);
+    assert (frustum.window (-1, 1, 1, -1).depthRange() == range);
+}
+
+template <class T>
+void
+testDepthRanges (T e)
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+    typedef Frustum<T> F;
+
+    const typename F::DepthRange ranges[] = {
+        F::DEPTH_NEGATIVE_ONE_TO_ONE, F::DEPTH_ZERO_TO_ONE, F::DEPTH_ONE_TO_ZERO};
+
+    F perspective (T (0.1), T (100), T (-1), T (2), T (0.75), T (-0.5));
+    F orthographic (T (0.1), T (100), T (-1), T (2), T (0.75), T (-0.5), true);
+    F infinite (
+        T (0.1), std::numeric_limits<T>::infinity(), T (-1), T (2), T (0.75), T (-0.5));
+
+    for (auto range : ranges)
+    {
+        testDepthRange (perspective, range, e);
+        testDepthRange (orthographic, range, e);
+        testDepthRange (infinite, range, e);
+    }
+
+    // The default is OpenGL's, with its familiar depth row
+
+    assert (perspective.depthRange() == F::DEPTH_NEGATIVE_ONE_TO_ONE);
+
+    T n = perspective.nearPlane(), f = perspective.farPlane();
+    Matrix44<T> M = perspective.projectionMatrix();
+    assert (M[2][2] == -(f + n) / (f - n));
+    assert (M[3][2] == T (-2) * f * n / (f - n));
+
+    T Zp = T (0.25) * T (2) - T (1);
+    assert (perspective.normalizedZToDepth (T (0.25)) ==
+            2 * f * n / (Zp * (f - n) - f - n));
+
+    // Integer depths keep their precision for a large range of z
+    // values, in every depth range
+
+    const long zmax = (1L << 30) + 1;
+
+    for (auto range : ranges)
+    {
+        orthographic.setDepthRange (range);
+        long zNear = range == F::DEPTH_ONE_TO_ZERO ? zmax : 0;
+        long zFar  = range == F::DEPTH_ONE_TO_ZERO ? 0 : zmax;
+        assert (orthographic.DepthToZ (-orthographic.nearPlane(), 0, zmax) == zNear);
+        assert (orthographic.DepthToZ (-orthographic.farPlane(), 0, zmax) == zFar);
+        assert (orthographic.DepthToZExc (-orthographic.farPlane(), 0, zmax) == zFar);
+    }
+
+    orthographic.setDepthRange (F::DEPTH_NEGATIVE_ONE_TO_ONE);
+
+    // An infinite far plane contains every point, and cannot be
+    // orthographic
+
+    Plane3<T> planes[6];
+    infinite.planes (planes, Matrix44<T>());
+    assert (planes[5].distanceTo (Vec3<T> (0, 0, T (-1e30))) < 0);
+    assert (planes[5].normal.equalWithAbsError (Vec3<T> (0, 0, -1), e));
+
+    infinite.planes (planes);
+    assert (planes[5].distanceTo (Vec3<T> (0, 0, T (-1e30))) < 0);
+
+    infinite.setOrthographic (true);
+    bool caught = false;
+    try
+    {
+        infinite.projectionMatrixExc();
+    }
+    catch (std::domain_error&)
+    {
+        caught = true;
+    }
+    assert (caught);
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmarkBatchProjection()
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    const size_t n = 1000000;
+    Frustumf frustum (0.1f, 1000.0f, -1.0f, 1.0f, 0.75f, -0.75f);
+    Rand48 rand (1);
+
+    std::vector<V3f> points (n);
+    std::vector<V2f> screen (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        points[i] = V3f (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-20, -0.1));
+        screen[i] = V2f (rand.nextf (-1, 1), rand.nextf (-1, 1));
+    }
+
+    std::vector<V2f> projected (n);
+    std::vector<Line3f> rays (n);
+
+    clock_t t0 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        projected[i] = frustum.projectPointToScreen (points[i]);
+
+    clock_t t1 = clock();
+
+    frustum.projectPointToScreenN (points.data(), n, projected.data());
+
+    clock_t t2 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        rays[i] = frustum.projectScreenToRay (screen[i]);
+
+    clock_t t3 = clock();
+
+    frustum.projectScreenToRayN (screen.data(), n, rays.data());
+
+    clock_t t4 = clock();
+
+    cout << "\n" << n << " points projected to screen: one at a time "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, batched " << double (t2 - t1) / CLOCKS_PER_SEC
+         << " s; rays from screen: one at a time " << double (t3 - t2) / CLOCKS_PER_SEC
+         << " s, batched " << double (t4 - t3) / CLOCKS_PER_SEC << " s";
+}
+
+#endif
+
 } // namespace
 
 void
@@ -332,5 +603,25 @@ testFrustum()
 
     cout << "\npassed noexcept equality verification";
 
+    IMATH_INTERNAL_NAMESPACE::Frustumf pf (0.1f, 100.0f, -1.0f, 2.0f, 0.75f, -0.5f);
+    IMATH_INTERNAL_NAMESPACE::Frustumd od (0.1, 100.0, -1.0, 2.0, 0.75, -0.5, true);
+    testBatchProjection (pf, 1e-5f);
+    testBatchProjection (od, 1e-12);
+    pf.setOrthographic (true);
+    od.setOrthographic (false);
+    testBatchProjection (pf, 1e-5f);
+    testBatchProjection (od, 1e-12);
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmarkBatchProjection();
+#endif
+
+    cout << "\npassed batched projection";
+
+    testDepthRanges (1e-5f);
+    testDepthRanges (1e-12);
+
+    cout << "\npassed depth ranges";
+
     cout << "\nok\n\n";
 }
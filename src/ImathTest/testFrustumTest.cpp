@@ -10,6 +10,7 @@
 #include "ImathBox.h"
 #include "ImathFrustum.h"
 #include "ImathFrustumTest.h"
+#include "ImathRandom.h"
 #include "ImathSphere.h"
 #include <assert.h>
 #include <iostream>
@@ -17,6 +18,103 @@
 
 using namespace std;
 
+namespace
+{
+
+void
+testClassify (const IMATH_INTERNAL_NAMESPACE::FrustumTest<float>& frustumTest)
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    typedef FrustumTest<float> FT;
+
+    Rand48 rand (3);
+
+    // Empty boxes are outside
+
+    assert (frustumTest.classify (Box3f()) == FT::OUTSIDE);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        V3f c (rand.nextf (50, 150), rand.nextf (150, 250), rand.nextf (-300, 300));
+        V3f s (rand.nextf (0, 10), rand.nextf (0, 10), rand.nextf (0, 10));
+        Box3f box (c - s, c + s);
+        Sphere3f sphere (c, s.x);
+
+        // classify() agrees with isVisible() and completelyContains()
+
+        FT::Classification cb = frustumTest.classify (box);
+        assert ((cb == FT::OUTSIDE) == !frustumTest.isVisible (box));
+        assert ((cb == FT::INSIDE) == frustumTest.completelyContains (box));
+
+        FT::Classification cs = frustumTest.classify (sphere);
+        assert ((cs == FT::OUTSIDE) == !frustumTest.isVisible (sphere));
+        assert ((cs == FT::INSIDE) == frustumTest.completelyContains (sphere));
+
+        // The result does not depend on the cached plane
+
+        unsigned int mask = FT::ALL_PLANES;
+        int lastPlane     = i % 6;
+        assert (frustumTest.classify (box, mask, lastPlane) == cb);
+        assert (mask != 0 || cb != FT::INTERSECTS);
+
+        // A box inside the first one, tested against the planes that
+        // the first one straddles, is classified like it is against
+        // all planes, and straddles a subset of those planes.
+
+        if (cb == FT::INTERSECTS)
+        {
+            unsigned int parentMask = FT::ALL_PLANES;
+            frustumTest.classify (box, parentMask);
+
+            V3f c1 (rand.nextf (box.min.x, box.max.x),
+                    rand.nextf (box.min.y, box.max.y),
+                    rand.nextf (box.min.z, box.max.z));
+            Box3f child (c1);
+            child.extendBy (V3f (rand.nextf (box.min.x, box.max.x),
+                                 rand.nextf (box.min.y, box.max.y),
+                                 rand.nextf (box.min.z, box.max.z)));
+
+            unsigned int childMask = parentMask;
+            int childLastPlane     = 0;
+            FT::Classification cc  = frustumTest.classify (child, childMask, childLastPlane);
+            assert (cc == frustumTest.classify (child));
+
+            if (cc != FT::OUTSIDE)
+                assert ((childMask & ~parentMask) == 0);
+            else
+                assert (parentMask & (1u << childLastPlane));
+        }
+    }
+
+    // A rejecting plane is remembered
+
+    V3f farPoint (100, 200, -1000);
+    unsigned int mask = FT::ALL_PLANES;
+    int lastPlane     = 0;
+    assert (frustumTest.classify (Box3f (farPoint), mask, lastPlane) == FT::OUTSIDE);
+    assert (lastPlane == 5 && mask == FT::ALL_PLANES);
+
+    // A lastPlane outside 0 to 5 is taken as 0
+
+    const int badPlanes[] = { -1, 6, 1000 };
+
+    for (int badPlane: badPlanes)
+    {
+        lastPlane = badPlane;
+        mask      = FT::ALL_PLANES;
+        assert (frustumTest.classify (Box3f (farPoint), mask, lastPlane) == FT::OUTSIDE);
+        assert (lastPlane == 5);
+
+        lastPlane = badPlane;
+        mask      = FT::ALL_PLANES;
+        assert (frustumTest.classify (Box3f (V3f (100, 200, 290)), mask, lastPlane) == FT::INSIDE);
+        assert (lastPlane == 0);
+    }
+}
+
+} // namespace
+
 void
 testFrustumTest()
 {
@@ -143,5 +241,10 @@ testFrustumTest()
         IMATH_INTERNAL_NAMESPACE::Sphere3<float> (outsideVec_up, tinyRadius)));
     cout << "passed Sphere\n";
 
+    /////////////////////////////////////////////////////
+    // Test classify()
+    testClassify (frustumTest);
+    cout << "passed classify\n";
+
     cout << "\nok\n\n";
 }
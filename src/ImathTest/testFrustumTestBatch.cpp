@@ -0,0 +1,233 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathBox.h"
+#include "ImathFrustum.h"
+#include "ImathFrustumTest.h"
+#include "ImathRandom.h"
+#include "ImathSphere.h"
+#include <cassert>
+#include <ctime>
+#include <iostream>
+#include <testFrustumTestBatch.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+bool
+maskBit (const vector<uint64_t>& mask, size_t i)
+{
+    return (mask[i / 64] >> (i % 64)) & 1;
+}
+
+template <class T>
+FrustumTest<T>
+makeFrustumTest()
+{
+    Frustum<T> frustum (T (1.7), T (567), T (-3.5), T (2), T (0.9), T (-1.3), false);
+
+    Matrix44<T> cameraMat;
+    cameraMat.rotate (Vec3<T> (T (0.1), T (0.2), T (0.3)));
+    cameraMat.translate (Vec3<T> (100, 200, 300));
+
+    return FrustumTest<T> (frustum, cameraMat);
+}
+
+//
+// Random bounds around the frustum, with some empty boxes, so that
+// all results occur.
+//
+
+template <class T>
+void
+randomBounds (Rand48& rand, size_t n, vector<Box<Vec3<T>>>& boxes, vector<Sphere3<T>>& spheres)
+{
+    boxes.resize (n);
+    spheres.resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> c (T (rand.nextf (0, 200)), T (rand.nextf (100, 300)), T (rand.nextf (-300, 300)));
+        Vec3<T> s (T (rand.nextf (0, 20)), T (rand.nextf (0, 20)), T (rand.nextf (0, 20)));
+
+        if (i % 17 == 0)
+            boxes[i] = Box<Vec3<T>>();
+        else
+            boxes[i] = Box<Vec3<T>> (c - s, c + s);
+
+        spheres[i] = Sphere3<T> (c, s.x);
+    }
+}
+
+template <class T>
+void
+testBatchT()
+{
+    FrustumTest<T> ft = makeFrustumTest<T>();
+    Rand48 rand (7);
+
+    for (size_t n : { size_t (0), size_t (1), size_t (63), size_t (64), size_t (1000) })
+    {
+        vector<Box<Vec3<T>>> boxes;
+        vector<Sphere3<T>> spheres;
+        randomBounds (rand, n, boxes, spheres);
+
+        vector<T> minX (n), minY (n), minZ (n), maxX (n), maxY (n), maxZ (n);
+        vector<T> x (n), y (n), z (n), radius (n);
+
+        Box3SoA<T> boxSoA (minX.data(),
+                           minY.data(),
+                           minZ.data(),
+                           maxX.data(),
+                           maxY.data(),
+                           maxZ.data());
+        Sphere3SoA<T> sphereSoA (x.data(), y.data(), z.data(), radius.data());
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            boxSoA.set (i, boxes[i]);
+            sphereSoA.set (i, spheres[i]);
+            assert (boxSoA[i] == boxes[i]);
+            assert (sphereSoA[i].center == spheres[i].center);
+        }
+
+        // Unused bits of the last word must be cleared
+
+        const size_t words = (n + 63) / 64;
+        vector<uint64_t> v1 (words, ~uint64_t (0)), v2 (words, ~uint64_t (0));
+        vector<uint64_t> v3 (words), v4 (words);
+        vector<uint64_t> c1 (words), c2 (words), c3 (words), c4 (words);
+
+        size_t numVisible = 0, numContained = 0;
+
+        ft.isVisibleN (boxSoA, n, v1.data());
+        ft.isVisibleN (boxes.data(), n, v2.data());
+        ft.completelyContainsN (boxSoA, n, c1.data());
+        ft.completelyContainsN (boxes.data(), n, c2.data());
+        ft.classifyN (boxSoA, n, v3.data(), c3.data());
+        ft.classifyN (boxes.data(), n, v4.data(), c4.data());
+
+        assert (v1 == v2 && v1 == v3 && v1 == v4);
+        assert (c1 == c2 && c1 == c3 && c1 == c4);
+
+        for (size_t i = 0; i < words * 64; ++i)
+        {
+            bool visible   = i < n && ft.isVisible (boxes[i]);
+            bool contained = i < n && ft.completelyContains (boxes[i]);
+            assert (maskBit (v1, i) == visible);
+            assert (maskBit (c1, i) == contained);
+            numVisible += visible;
+            numContained += contained;
+        }
+
+        ft.isVisibleN (sphereSoA, n, v1.data());
+        ft.isVisibleN (spheres.data(), n, v2.data());
+        ft.completelyContainsN (sphereSoA, n, c1.data());
+        ft.completelyContainsN (spheres.data(), n, c2.data());
+        ft.classifyN (sphereSoA, n, v3.data(), c3.data());
+        ft.classifyN (spheres.data(), n, v4.data(), c4.data());
+
+        assert (v1 == v2 && v1 == v3 && v1 == v4);
+        assert (c1 == c2 && c1 == c3 && c1 == c4);
+
+        for (size_t i = 0; i < words * 64; ++i)
+        {
+            bool visible   = i < n && ft.isVisible (spheres[i]);
+            bool contained = i < n && ft.completelyContains (spheres[i]);
+            assert (maskBit (v1, i) == visible);
+            assert (maskBit (c1, i) == contained);
+        }
+
+        if (n == 1000)
+            assert (numVisible > 0 && numVisible < n && numContained > 0);
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+testTiming()
+{
+    const size_t n    = 1 << 16;
+    const int repeats = 50;
+
+    FrustumTest<float> ft = makeFrustumTest<float>();
+    Rand48 rand (8);
+
+    vector<Box3f> boxes;
+    vector<Sphere3<float>> spheres;
+    randomBounds (rand, n, boxes, spheres);
+
+    vector<float> minX (n), minY (n), minZ (n), maxX (n), maxY (n), maxZ (n);
+    Box3SoA<float> boxSoA (minX.data(),
+                           minY.data(),
+                           minZ.data(),
+                           maxX.data(),
+                           maxY.data(),
+                           maxZ.data());
+
+    for (size_t i = 0; i < n; ++i)
+        boxSoA.set (i, boxes[i]);
+
+    vector<bool> visible (n);
+    vector<uint64_t> mask (n / 64);
+    size_t count = 0;
+
+    clock_t t0 = clock();
+    for (int r = 0; r < repeats; ++r)
+    {
+        for (size_t i = 0; i < n; ++i)
+            visible[i] = ft.isVisible (boxes[i]);
+        count += visible[r];
+    }
+
+    clock_t t1 = clock();
+    for (int r = 0; r < repeats; ++r)
+    {
+        ft.isVisibleN (boxes.data(), n, mask.data());
+        count += mask[r] & 1;
+    }
+
+    clock_t t2 = clock();
+    for (int r = 0; r < repeats; ++r)
+    {
+        ft.isVisibleN (boxSoA, n, mask.data());
+        count += mask[r] & 1;
+    }
+
+    clock_t t3 = clock();
+
+    cout << "  isVisible(Box): " << double (t1 - t0) / CLOCKS_PER_SEC << " s, "
+         << "isVisibleN(Box*): " << double (t2 - t1) / CLOCKS_PER_SEC << " s, "
+         << "isVisibleN(Box3SoA): " << double (t3 - t2) / CLOCKS_PER_SEC << " s"
+         << " (" << count << ")" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testFrustumTestBatch()
+{
+    cout << "Testing batched FrustumTest functions" << endl;
+
+    testBatchT<float>();
+    testBatchT<double>();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    testTiming();
+#endif
+
+    cout << "ok\n" << endl;
+}
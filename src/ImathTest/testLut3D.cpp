@@ -0,0 +1,435 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathFun.h"
+#include "ImathLut3D.h"
+#include "ImathRandom.h"
+#include "half.h"
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <testLut3D.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+Vec3<T>
+randomColor (Rand48& rand, T lo, T hi)
+{
+    return Vec3<T> (T (rand.nextf (lo, hi)), T (rand.nextf (lo, hi)), T (rand.nextf (lo, hi)));
+}
+
+//
+// A transform that mixes the components non-linearly
+//
+
+template <class T>
+Color3<T>
+curve (const Vec3<T>& c)
+{
+    return Color3<T> (c.x * c.x + T (0.25) * c.y,
+                      std::sin (c.y) - T (0.5) * c.z * c.x,
+                      std::sqrt (std::abs (c.z)) + T (0.1) * c.y);
+}
+
+template <class C>
+void
+fill (Lut3D<C>& lut)
+{
+    for (int b = 0; b < lut.size(); ++b)
+        for (int g = 0; g < lut.size(); ++g)
+            for (int r = 0; r < lut.size(); ++r)
+                lut (r, g, b) = curve (lut.latticePoint (r, g, b));
+}
+
+//
+// Reference interpolations, with the lattice as a function of the
+// indices and tetrahedra selected by comparisons
+//
+
+template <class C>
+void
+referenceCell (const Lut3D<C>& lut,
+               const Vec3<typename C::BaseType>& c,
+               int i[3],
+               typename C::BaseType f[3])
+{
+    typedef typename C::BaseType T;
+
+    for (int k = 0; k < 3; ++k)
+    {
+        T x  = (c[k] - lut.domainMin()[k]) / (lut.domainMax()[k] - lut.domainMin()[k]);
+        x    = clamp (x, T (0), T (1)) * T (lut.size() - 1);
+        i[k] = std::min (int (x), lut.size() - 2);
+        f[k] = x - T (i[k]);
+    }
+}
+
+template <class C>
+C
+referenceTrilinear (const Lut3D<C>& lut, const Vec3<typename C::BaseType>& c)
+{
+    typedef typename C::BaseType T;
+
+    int i[3];
+    T f[3];
+    referenceCell (lut, c, i, f);
+
+    C result (0);
+
+    for (int b = 0; b < 2; ++b)
+        for (int g = 0; g < 2; ++g)
+            for (int r = 0; r < 2; ++r)
+            {
+                T w = (r ? f[0] : 1 - f[0]) * (g ? f[1] : 1 - f[1]) * (b ? f[2] : 1 - f[2]);
+                result += lut (i[0] + r, i[1] + g, i[2] + b) * w;
+            }
+
+    return result;
+}
+
+template <class C>
+C
+referenceTetrahedral (const Lut3D<C>& lut, const Vec3<typename C::BaseType>& c)
+{
+    typedef typename C::BaseType T;
+
+    int i[3];
+    T f[3];
+    referenceCell (lut, c, i, f);
+
+    // The axes in the order of decreasing fractions
+
+    int a[3] = {0, 1, 2};
+
+    if (f[a[0]] < f[a[1]])
+        std::swap (a[0], a[1]);
+    if (f[a[1]] < f[a[2]])
+        std::swap (a[1], a[2]);
+    if (f[a[0]] < f[a[1]])
+        std::swap (a[0], a[1]);
+
+    int corner[3] = {i[0], i[1], i[2]};
+    C result      = lut (corner[0], corner[1], corner[2]) * (1 - f[a[0]]);
+
+    for (int k = 0; k < 3; ++k)
+    {
+        ++corner[a[k]];
+        T w = f[a[k]] - (k < 2 ? f[a[k + 1]] : 0);
+        result += lut (corner[0], corner[1], corner[2]) * w;
+    }
+
+    return result;
+}
+
+//
+// Construction, storage and the identity
+//
+
+template <class C>
+void
+testIdentity (typename C::BaseType e)
+{
+    typedef typename C::BaseType T;
+    typedef Lut3D<C> L;
+
+    for (int size : {2, 4, 5, 17, 33})
+    {
+        L lut (size);
+        Rand48 rand (size);
+
+        for (int k = 0; k < 100; ++k)
+        {
+            Vec3<T> c = randomColor<T> (rand, 0, 1);
+            assert (lut.lookup (c, L::INTERPOLATE_TRILINEAR).equalWithAbsError (c, e));
+            assert (lut.lookup (c, L::INTERPOLATE_TETRAHEDRAL).equalWithAbsError (c, e));
+        }
+
+        // Clamping, and NaNs
+
+        T nan = std::numeric_limits<T>::quiet_NaN();
+        assert (lut.lookup (Vec3<T> (-1, 2, nan)).equalWithAbsError (Vec3<T> (0, 1, 0), e));
+
+        // The entries do not overlap in the tiled storage
+
+        for (int b = 0; b < size; ++b)
+            for (int g = 0; g < size; ++g)
+                for (int r = 0; r < size; ++r)
+                    lut (r, g, b) = C (T (r), T (g), T (b));
+
+        for (int b = 0; b < size; ++b)
+            for (int g = 0; g < size; ++g)
+                for (int r = 0; r < size; ++r)
+                    assert (lut (r, g, b) == C (T (r), T (g), T (b)));
+    }
+
+    // A domain other than the unit cube
+
+    L lut (9, Vec3<T> (-0.5, 0, 1), Vec3<T> (2, 1, 5));
+    assert (lut.latticePoint (0, 0, 0) == Vec3<T> (-0.5, 0, 1));
+    assert (lut.latticePoint (8, 8, 8).equalWithAbsError (Vec3<T> (2, 1, 5), e));
+    assert (lut.lookup (Vec3<T> (1, 0.5, 3)).equalWithAbsError (Vec3<T> (1, 0.5, 3), e * 10));
+
+    bool caught = false;
+
+    try
+    {
+        L bad (1);
+    }
+    catch (const std::domain_error&)
+    {
+        caught = true;
+    }
+
+    assert (caught);
+    caught = false;
+
+    try
+    {
+        L bad (2, Vec3<T> (0), Vec3<T> (1, 0, 1));
+    }
+    catch (const std::domain_error&)
+    {
+        caught = true;
+    }
+
+    assert (caught);
+}
+
+//
+// The interpolations agree with the references, and are exact at
+// lattice points; tetrahedral interpolation is exact along the gray
+// axis of each cell
+//
+
+template <class C>
+void
+testInterpolation (typename C::BaseType e)
+{
+    typedef typename C::BaseType T;
+    typedef Lut3D<C> L;
+
+    L lut (17, Vec3<T> (-0.5), Vec3<T> (1.5));
+    fill (lut);
+
+    Rand48 rand (0);
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        Vec3<T> c = randomColor<T> (rand, -1, 2);
+
+        assert (lut.lookup (c, L::INTERPOLATE_TRILINEAR)
+                    .equalWithAbsError (referenceTrilinear (lut, c), e));
+        assert (lut.lookup (c, L::INTERPOLATE_TETRAHEDRAL)
+                    .equalWithAbsError (referenceTetrahedral (lut, c), e));
+    }
+
+    for (int b = 0; b < 17; b += 3)
+        for (int g = 0; g < 17; g += 5)
+            for (int r = 0; r < 17; r += 2)
+            {
+                Vec3<T> c = lut.latticePoint (r, g, b);
+                C ref     = lut (r, g, b);
+                assert (lut.lookup (c, L::INTERPOLATE_TRILINEAR).equalWithAbsError (ref, e));
+                assert (lut.lookup (c).equalWithAbsError (ref, e));
+            }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        T t        = T (rand.nextf());
+        Vec3<T> c0 = lut.latticePoint (i, i, i);
+        Vec3<T> c1 = lut.latticePoint (i + 1, i + 1, i + 1);
+        Vec3<T> c  = c0 * (1 - t) + c1 * t;
+        C ref      = lut (i, i, i) * (1 - t) + lut (i + 1, i + 1, i + 1) * t;
+        assert (lut.lookup (c).equalWithAbsError (ref, e));
+    }
+}
+
+//
+// Arrays of colors agree with lookup()
+//
+
+template <class S>
+void
+testArrays (float e)
+{
+    typedef Lut3Df::Interpolation Interpolation;
+
+    const size_t n = 1000;
+
+    Lut3Df lut (33);
+    fill (lut);
+
+    Rand48 rand (1);
+    vector<Color4<S>> in (n), out (n);
+    vector<Color3<S>> in3 (n), out3 (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<float> c = randomColor<float> (rand, -0.1f, 1.1f);
+        in[i]         = Color4<S> (S (c.x), S (c.y), S (c.z), S (rand.nextf()));
+        in3[i]        = Color3<S> (in[i].r, in[i].g, in[i].b);
+    }
+
+    const Interpolation interpolations[] = {Lut3Df::INTERPOLATE_TRILINEAR,
+                                            Lut3Df::INTERPOLATE_TETRAHEDRAL};
+
+    for (Interpolation interpolation : interpolations)
+    {
+        lut.apply (in.data(), out.data(), n, interpolation);
+        lut.apply (in3.data(), out3.data(), n, interpolation);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Color3f ref = lut.lookup (Vec3<float> (in[i].r, in[i].g, in[i].b), interpolation);
+
+            for (int j = 0; j < 3; ++j)
+            {
+                assert (equalWithAbsError (float (out[i][j]), ref[j], e));
+                assert (out3[i][j] == out[i][j]);
+            }
+
+            assert (out[i].a == in[i].a);
+        }
+    }
+
+    // In place
+
+    vector<Color4<S>> inPlace = in;
+    lut.apply (inPlace.data(), inPlace.data(), n);
+    lut.apply (in.data(), out.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (inPlace[i] == out[i]);
+}
+
+//
+// Folding matrices into the table
+//
+
+void
+testMatrices()
+{
+    M33f m (0.8f, 0.1f, 0.05f, 0.15f, 0.7f, 0.1f, 0.05f, 0.2f, 0.85f);
+
+    Lut3Df lut (17);
+    fill (lut);
+
+    Lut3Df after = lut;
+    after.appendMatrix (m);
+
+    Rand48 rand (2);
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        V3f c = randomColor<float> (rand, 0, 1);
+        V3f d = lut.lookup (c) * m;
+        assert (after.lookup (c).equalWithAbsError (d, 1e-5f));
+    }
+
+    // The columns of m are positive and sum to 1, so that the unit
+    // cube maps into itself and an identity table resamples exactly
+
+    Lut3Df identity (9);
+    identity.prependMatrix (m);
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        V3f c = randomColor<float> (rand, 0, 1);
+        assert (identity.lookup (c).equalWithAbsError (c * m, 1e-5f));
+    }
+
+    // Before a non-linear table, resampling is exact at lattice points
+
+    Lut3Df before = lut;
+    before.prependMatrix (m);
+
+    for (int b = 0; b < 17; b += 4)
+        for (int g = 0; g < 17; g += 4)
+            for (int r = 0; r < 17; r += 4)
+            {
+                V3f c = lut.latticePoint (r, g, b);
+                assert (before (r, g, b).equalWithAbsError (lut.lookup (c * m), 1e-5f));
+            }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmark()
+{
+    const size_t n = 1920 * 1080;
+
+    Lut3Df lut (65);
+    fill (lut);
+
+    Rand48 rand (3);
+    vector<Color4h> in (n), out (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        V3f c = randomColor<float> (rand, 0, 1);
+        in[i]   = Color4h (half (c.x), half (c.y), half (c.z), half (1));
+    }
+
+    clock_t t0 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Color3f c = lut.lookup (V3f (in[i].r, in[i].g, in[i].b), Lut3Df::INTERPOLATE_TRILINEAR);
+        out[i]    = Color4h (half (c.x), half (c.y), half (c.z), in[i].a);
+    }
+
+    clock_t t1 = clock();
+
+    lut.apply (in.data(), out.data(), n, Lut3Df::INTERPOLATE_TRILINEAR);
+
+    clock_t t2 = clock();
+
+    lut.apply (in.data(), out.data(), n, Lut3Df::INTERPOLATE_TETRAHEDRAL);
+
+    clock_t t3 = clock();
+
+    cout << "  " << n << " half colors through a 65^3 table: lookup() "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, trilinear apply() "
+         << double (t2 - t1) / CLOCKS_PER_SEC << " s, tetrahedral apply() "
+         << double (t3 - t2) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testLut3D()
+{
+    cout << "Testing 3D lookup tables" << endl;
+
+    testIdentity<Color3f> (1e-5f);
+    testIdentity<V3d> (1e-12);
+    testInterpolation<Color3f> (1e-5f);
+    testInterpolation<Color3<double>> (1e-12);
+    testArrays<float> (1e-6f);
+    testArrays<half> (1e-2f);
+    testMatrices();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark();
+#endif
+
+    cout << "ok\n" << endl;
+}
@@ -0,0 +1,223 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathBox.h"
+#include "ImathFrustum.h"
+#include "ImathFrustumTest.h"
+#include "ImathRandom.h"
+#include "ImathSphere.h"
+#include <cassert>
+#include <ctime>
+#include <iostream>
+#include <testMultiFrustumTest.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// N views from the same position, rotated about the y axis, with a
+// mix of perspective and orthographic frustums.
+//
+
+template <class T, int N>
+void
+makeViews (Frustum<T> frustums[N], Matrix44<T> cameraMats[N])
+{
+    for (int v = 0; v < N; ++v)
+    {
+        frustums[v] =
+            Frustum<T> (T (1), T (100 + 50 * v), T (-2), T (2), T (1.5), T (-1.5), v % 3 == 2);
+
+        cameraMats[v].makeIdentity();
+        cameraMats[v].rotate (Vec3<T> (0, T (v * 2 * M_PI / N), 0));
+        cameraMats[v].translate (Vec3<T> (10, 20, 30));
+    }
+}
+
+template <class T, int N>
+void
+testViews()
+{
+    typedef typename MultiFrustumTest<T, N>::ViewMask ViewMask;
+
+    Frustum<T> frustums[N];
+    Matrix44<T> cameraMats[N];
+    makeViews<T, N> (frustums, cameraMats);
+
+    MultiFrustumTest<T, N> mft (frustums, cameraMats);
+    FrustumTest<T> ft[N];
+    for (int v = 0; v < N; ++v)
+        ft[v].setFrustum (frustums[v], cameraMats[v]);
+
+    assert ((MultiFrustumTest<T, N>::numViews == N));
+    assert (sizeof (ViewMask) * 8 >= N && sizeof (ViewMask) * 8 < 2 * N + 8);
+    assert (mft.cameraMat (N - 1) == cameraMats[N - 1]);
+
+    Rand48 rand (N);
+    const size_t n = 2000;
+
+    vector<Box<Vec3<T>>> boxes (n);
+    vector<Sphere3<T>> spheres (n);
+    vector<Vec3<T>> points (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> c (T (rand.nextf (-150, 150)),
+                   T (rand.nextf (-20, 60)),
+                   T (rand.nextf (-150, 150)));
+        Vec3<T> s (T (rand.nextf (0, 10)), T (rand.nextf (0, 10)), T (rand.nextf (0, 10)));
+
+        boxes[i]   = i % 13 ? Box<Vec3<T>> (c - s, c + s) : Box<Vec3<T>>();
+        spheres[i] = Sphere3<T> (c, s.x);
+        points[i]  = c;
+    }
+
+    vector<T> minX (n), minY (n), minZ (n), maxX (n), maxY (n), maxZ (n);
+    vector<T> x (n), y (n), z (n), radius (n);
+    Box3SoA<T> boxSoA (minX.data(),
+                       minY.data(),
+                       minZ.data(),
+                       maxX.data(),
+                       maxY.data(),
+                       maxZ.data());
+    Sphere3SoA<T> sphereSoA (x.data(), y.data(), z.data(), radius.data());
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        boxSoA.set (i, boxes[i]);
+        sphereSoA.set (i, spheres[i]);
+    }
+
+    vector<ViewMask> m1 (n), m2 (n), m3 (n), m4 (n);
+    mft.isVisibleN (boxSoA, n, m1.data());
+    mft.isVisibleN (boxes.data(), n, m2.data());
+    mft.isVisibleN (sphereSoA, n, m3.data());
+    mft.isVisibleN (spheres.data(), n, m4.data());
+
+    assert (m1 == m2 && m3 == m4);
+
+    size_t seen = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        ViewMask b = 0, s = 0, p = 0;
+
+        for (int v = 0; v < N; ++v)
+        {
+            b |= ViewMask (ft[v].isVisible (boxes[i])) << v;
+            s |= ViewMask (ft[v].isVisible (spheres[i])) << v;
+            p |= ViewMask (ft[v].isVisible (points[i])) << v;
+        }
+
+        assert (m1[i] == b && mft.isVisible (boxes[i]) == b);
+        assert (m3[i] == s && mft.isVisible (spheres[i]) == s);
+        assert (mft.isVisible (points[i]) == p);
+
+        seen |= b;
+    }
+
+    // Each view sees some of the boxes
+
+    assert (seen == (size_t (1) << N) - 1);
+
+    // Updating one view
+
+    if (N > 1)
+    {
+        mft.setFrustum (0, frustums[1], cameraMats[1]);
+        for (size_t i = 0; i < n; ++i)
+        {
+            ViewMask m = mft.isVisible (boxes[i]);
+            assert (((m >> 1) & 1) == (m & 1));
+        }
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+testTiming()
+{
+    const int N       = 4;
+    const size_t n    = 1 << 16;
+    const int repeats = 50;
+
+    Frustum<float> frustums[N];
+    Matrix44<float> cameraMats[N];
+    makeViews<float, N> (frustums, cameraMats);
+
+    MultiFrustumTest<float, N> mft (frustums, cameraMats);
+    FrustumTest<float> ft[N];
+    for (int v = 0; v < N; ++v)
+        ft[v].setFrustum (frustums[v], cameraMats[v]);
+
+    Rand48 rand (1);
+    vector<Box3f> boxes (n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        V3f c (rand.nextf (-150, 150), rand.nextf (-20, 60), rand.nextf (-150, 150));
+        boxes[i] = Box3f (c - V3f (5), c + V3f (5));
+    }
+
+    vector<uint8_t> masks (n);
+    size_t count = 0;
+
+    clock_t t0 = clock();
+    for (int r = 0; r < repeats; ++r)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint8_t m = 0;
+            for (int v = 0; v < N; ++v)
+                m |= uint8_t (ft[v].isVisible (boxes[i])) << v;
+            masks[i] = m;
+        }
+        count += masks[r];
+    }
+
+    clock_t t1 = clock();
+    for (int r = 0; r < repeats; ++r)
+    {
+        mft.isVisibleN (boxes.data(), n, masks.data());
+        count += masks[r];
+    }
+
+    clock_t t2 = clock();
+
+    cout << "  " << N << " FrustumTests: " << double (t1 - t0) / CLOCKS_PER_SEC << " s, "
+         << "MultiFrustumTest: " << double (t2 - t1) / CLOCKS_PER_SEC << " s"
+         << " (" << count << ")" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testMultiFrustumTest()
+{
+    cout << "Testing MultiFrustumTest" << endl;
+
+    testViews<float, 1>();
+    testViews<float, 4>();
+    testViews<float, 6>();
+    testViews<float, 8>();
+    testViews<double, 4>();
+    testViews<float, 12>();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    testTiming();
+#endif
+
+    cout << "ok\n" << endl;
+}
@@ -0,0 +1,354 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathMatrixAlgo.h"
+#include "ImathRandom.h"
+#include "testPolarDecompose.h"
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <typename TM>
+bool
+equal (const TM& A, const TM& B, typename TM::BaseType e)
+{
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+        for (unsigned int j = 0; j < TM::dimensions(); ++j)
+            if (std::abs (A[i][j] - B[i][j]) > e * (1 + std::abs (B[i][j])))
+                return false;
+    return true;
+}
+
+template <typename T>
+T
+tolerance()
+{
+    return sizeof (T) == 8 ? T (1e-9) : T (1e-4);
+}
+
+template <typename TM>
+void
+verifyPolar (const TM& A)
+{
+    typedef typename TM::BaseType T;
+    const T e = tolerance<T>();
+
+    TM Q, S;
+    polarDecompose (A, Q, S);
+
+    // A = S * Q, Q orthonormal, S symmetric
+
+    assert (equal (S * Q, A, e));
+    assert (equal (Q * Q.transposed(), TM(), e));
+    assert (equal (S, S.transposed(), e));
+
+    // S is positive semi-definite
+
+    TM M (S);
+    TM V;
+    typename conditional<TM::dimensions() == 3, Vec3<T>, Vec4<T>>::type ev;
+    jacobiEigenSolver (M, ev, V);
+
+    for (unsigned int i = 0; i < TM::dimensions(); ++i)
+        assert (ev[i] > -e);
+
+    // The orthonormal factor has the sign of det(A)
+
+    assert ((Q.determinant() > 0) == (A.determinant() > 0) || A.determinant() == 0);
+}
+
+template <typename T>
+Matrix33<T>
+randomTransform33 (Rand48& rand)
+{
+    Matrix33<T> A;
+    A.rotate (T (rand.nextf (-M_PI, M_PI)));
+    A.shear (Vec2<T> (T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1))));
+    A.scale (Vec2<T> (T (rand.nextf (0.1, 10)), T (rand.nextf (0.1, 10))));
+
+    Matrix33<T> M;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            M[i][j] = i < 2 && j < 2 ? A[i][j] : T (i == j);
+
+    M[2][2] = T (rand.nextf (0.5, 2));
+    return M;
+}
+
+template <typename T>
+Matrix44<T>
+randomTransform44 (Rand48& rand)
+{
+    Matrix44<T> A;
+    A.rotate (Vec3<T> (T (rand.nextf (-M_PI, M_PI)),
+                       T (rand.nextf (-M_PI, M_PI)),
+                       T (rand.nextf (-M_PI, M_PI))));
+    A.shear (Vec3<T> (T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1))));
+    A.scale (
+        Vec3<T> (T (rand.nextf (0.1, 10)), T (rand.nextf (0.1, 10)), T (rand.nextf (0.1, 10))));
+    return A;
+}
+
+template <typename T>
+void
+testPolarDecomposeImp()
+{
+    Rand48 rand (1701);
+
+    verifyPolar (Matrix33<T>());
+    verifyPolar (Matrix44<T>());
+
+    // Reflections and singular matrices
+
+    verifyPolar (Matrix33<T> (1, 0, 0, 0, -1, 0, 0, 0, 1));
+    verifyPolar (Matrix33<T> (1, 2, 0, 2, 4, 0, 0, 0, 1));
+    verifyPolar (Matrix33<T> (0, 0, 0, 0, 0, 0, 0, 0, 0));
+    verifyPolar (Matrix44<T> (1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1));
+
+    // An orthonormal matrix is its own rotation factor
+
+    Matrix44<T> R;
+    R.rotate (Vec3<T> (T (0.3), T (-1.2), T (2.5)));
+
+    Matrix44<T> Q, S;
+    polarDecompose (R, Q, S);
+    assert (equal (Q, R, tolerance<T>()));
+    assert (equal (S, Matrix44<T>(), tolerance<T>()));
+
+    // Random scale/shear/rotate matrices, through the array interface
+
+    const size_t n = 100;
+    vector<Matrix33<T>> A33 (n), Q33 (n), S33 (n);
+    vector<Matrix44<T>> A44 (n), Q44 (n), S44 (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        A33[i] = randomTransform33<T> (rand);
+        A44[i] = randomTransform44<T> (rand);
+        verifyPolar (A33[i]);
+        verifyPolar (A44[i]);
+    }
+
+    polarDecompose (&A33[0], &Q33[0], &S33[0], n);
+    polarDecompose (&A44[0], &Q44[0], &S44[0], n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (equal (S33[i] * Q33[i], A33[i], tolerance<T>()));
+        assert (equal (S44[i] * Q44[i], A44[i], tolerance<T>()));
+    }
+
+    // S is optional
+
+    polarDecompose (&A44[0], &Q44[0], (Matrix44<T>*) 0, n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (equal (Q44[i] * Q44[i].transposed(), Matrix44<T>(), tolerance<T>()));
+}
+
+template <typename TM>
+void
+verifyMatrixFunctions (const TM& A)
+{
+    typedef typename TM::BaseType T;
+    const T e = tolerance<T>();
+
+    const TM R = sqrtm (A);
+    assert (equal (R * R, A, e));
+
+    const TM L = logm (A);
+    assert (equal (expm (L), A, e));
+
+    // exp(log(A) / 2) is the principal square root as well
+
+    assert (equal (expm (L * T (0.5)), R, e * 10));
+}
+
+template <typename T>
+void
+testMatrixFunctionsImp()
+{
+    Rand48 rand (4711);
+
+    // Functions of the identity and of diagonal matrices
+
+    assert (equal (expm (Matrix44<T> (T (0))), Matrix44<T>(), tolerance<T>()));
+    assert (equal (logm (Matrix44<T>()), Matrix44<T> (T (0)), tolerance<T>()));
+    assert (equal (sqrtm (Matrix33<T>()), Matrix33<T>(), tolerance<T>()));
+
+    const Matrix33<T> D (2, 0, 0, 0, 3, 0, 0, 0, T (0.5));
+    assert (equal (expm (D), Matrix33<T> (exp (T (2)), 0, 0, 0, exp (T (3)), 0, 0, 0, exp (T (0.5))),
+                   tolerance<T>()));
+
+    // The logarithm of a rotation is the skew-symmetric matrix of
+    // its axis-angle
+
+    Matrix44<T> R;
+    R.setAxisAngle (Vec3<T> (0, 0, 1), T (1));
+    const Matrix44<T> L = logm (R);
+    assert (equal (L, Matrix44<T> (0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), tolerance<T>()));
+
+    // Symmetric (eigensolver) and general (iterative) paths
+
+    const size_t n = 50;
+    vector<Matrix33<T>> A33 (n), B33 (n);
+    vector<Matrix44<T>> A44 (n), B44 (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        A33[i] = randomTransform33<T> (rand);
+        A44[i] = randomTransform44<T> (rand);
+
+        if (A33[i].determinant() < 0)
+            A33[i][2][2] *= -1;
+
+        Matrix44<T> Q, S;
+        polarDecompose (A44[i], Q, S);
+
+        verifyMatrixFunctions (S);
+        verifyMatrixFunctions (Q.determinant() > 0 ? Q : S * S);
+    }
+
+    // Array versions agree with the scalar versions.  Scale the
+    // matrices down so that the imaginary parts of their eigenvalues
+    // stay within (-pi, pi), where logm() inverts expm(), and their
+    // exponentials have no eigenvalues on the negative real axis.
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        A33[i] *= T (0.1);
+        A44[i] = expm (A44[i] * T (0.1));
+    }
+
+    sqrtm (&A44[0], &B44[0], n);
+    for (size_t i = 0; i < n; ++i)
+        assert (equal (B44[i] * B44[i], A44[i], tolerance<T>()));
+
+    expm (&A33[0], &B33[0], n);
+    for (size_t i = 0; i < n; ++i)
+        assert (B33[i] == expm (A33[i]));
+
+    logm (&B33[0], &B33[0], n);
+    for (size_t i = 0; i < n; ++i)
+        assert (equal (B33[i], A33[i], tolerance<T>() * 10));
+
+    // Errors
+
+    try
+    {
+        logm (Matrix33<T> (-1, 0, 0, 0, 1, 0, 0, 0, 1));
+        assert (false);
+    }
+    catch (const std::domain_error&)
+    {
+    }
+
+    try
+    {
+        sqrtm (Matrix33<T> (-1, 0, 0, 0, -1, 0, 0, 0, 1));
+        assert (false);
+    }
+    catch (const std::domain_error&)
+    {
+    }
+
+    const T special[] = { std::numeric_limits<T>::infinity(),
+                          std::numeric_limits<T>::quiet_NaN() };
+
+    for (T x : special)
+    {
+        Matrix44<T> A;
+        A[3][0] = x;
+
+        try
+        {
+            expm (A);
+            assert (false);
+        }
+        catch (const std::domain_error&)
+        {
+        }
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+template <typename T>
+void
+testPolarDecomposeTiming()
+{
+    Rand48 rand (1209);
+    const size_t n = 100000;
+    vector<Matrix33<T>> A (n), Q (n), S (n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        // The linear part of a 3D scale/shear/rotate transform
+
+        const Matrix44<T> M = randomTransform44<T> (rand);
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < 3; ++k)
+                A[i][j][k] = M[j][k];
+    }
+
+    clock_t t = clock();
+    polarDecompose (&A[0], &Q[0], &S[0], n);
+    const clock_t tPolar = clock() - t;
+
+    t = clock();
+    Vec3<T> s;
+    for (size_t i = 0; i < n; ++i)
+        jacobiSVD (A[i], Q[i], s, S[i]);
+    const clock_t tSVD = clock() - t;
+
+    cout << "polarDecompose of 3x3 matrices took " << tPolar << " clocks." << endl;
+    cout << "jacobiSVD      of 3x3 matrices took " << tSVD << " clocks." << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testPolarDecompose()
+{
+    cout << "Testing polar decomposition and matrix functions" << endl;
+
+    cout << "polarDecompose in single precision...";
+    testPolarDecomposeImp<float>();
+    cout << "PASS" << endl;
+
+    cout << "polarDecompose in double precision...";
+    testPolarDecomposeImp<double>();
+    cout << "PASS" << endl;
+
+    cout << "expm/logm/sqrtm in single precision...";
+    testMatrixFunctionsImp<float>();
+    cout << "PASS" << endl;
+
+    cout << "expm/logm/sqrtm in double precision...";
+    testMatrixFunctionsImp<double>();
+    cout << "PASS" << endl;
+
+#ifdef IMATH_TEST_BENCHMARKS
+    cout << "Timing polarDecompose in double precision..." << endl;
+    testPolarDecomposeTiming<double>();
+#endif
+
+    cout << "ok\n" << endl;
+}
@@ -0,0 +1,224 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathBoxAlgo.h"
+#include "ImathPreparedRay.h"
+#include "ImathRandom.h"
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <randomGeometry.h>
+#include <testPreparedRay.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+void
+compare (const Line3<T>& ray, const Box<Vec3<T>>& box, T e)
+{
+    PreparedRay<T> r (ray);
+
+    T tEntry, tExit;
+    Vec3<T> entry, exit;
+    bool hit = findEntryAndExitPoints (ray, box, entry, exit);
+    assert (r.findEntryAndExitT (box, tEntry, tExit) == hit);
+
+    if (hit)
+    {
+        assert (tEntry <= tExit);
+        assert (r (tEntry).equalWithAbsError (entry, e));
+        assert (r (tExit).equalWithAbsError (exit, e));
+    }
+
+    Vec3<T> ip;
+    hit = intersects (box, ray, ip);
+    assert (r.intersectT (box, tEntry, tExit) == hit);
+    assert (r.intersects (box) == hit);
+
+    if (hit)
+    {
+        assert (tEntry >= 0 && tEntry <= tExit);
+        assert (r (tEntry).equalWithAbsError (ip, e));
+        assert (r.intersects (box, tEntry));
+        assert (r.intersects (box, tEntry * T (0.5)) == (tEntry == 0));
+    }
+}
+
+template <class T>
+void
+testBoxes (T e)
+{
+    Rand48 rand (0);
+
+    for (int k = 0; k < 10000; ++k)
+    {
+        Line3<T> ray = randomRay<T> (rand);
+        PreparedRay<T> r (ray);
+
+        assert (r.ray().pos == ray.pos && r.ray().dir == ray.dir);
+        assert (r.parallel == (ray.dir.x == 0 || ray.dir.y == 0 || ray.dir.z == 0));
+
+        for (int b = 0; b < 10; ++b)
+            compare (ray, randomBox<T> (rand), e);
+    }
+
+    //
+    // Rays parallel to the sides, on the sides, with NaN directions,
+    // and empty boxes
+    //
+
+    const T nan = numeric_limits<T>::quiet_NaN();
+    Box<Vec3<T>> box (Vec3<T> (-1), Vec3<T> (1));
+
+    Line3<T> rays[8];
+    rays[0].pos = Vec3<T> (-2, 1, -1);
+    rays[0].dir = Vec3<T> (1, 0, 0);
+    rays[1].pos = Vec3<T> (-2, 2, 0);
+    rays[1].dir = Vec3<T> (1, 0, 0);
+    rays[2].pos = Vec3<T> (-2, 0, 0);
+    rays[2].dir = Vec3<T> (-1, -T (0), T (0));
+    rays[3].pos = Vec3<T> (0, 0, 0);
+    rays[3].dir = Vec3<T> (0, 0, 0);
+    rays[4].pos = Vec3<T> (0, 5, 0);
+    rays[4].dir = Vec3<T> (0, 0, 0);
+    rays[5].pos = Vec3<T> (0, -2, 0);
+    rays[5].dir = Vec3<T> (nan, 1, 0);
+    rays[6].pos = Vec3<T> (3, -2, 0);
+    rays[6].dir = Vec3<T> (nan, 1, 0);
+    rays[7].pos = Vec3<T> (0, -2, 0);
+    rays[7].dir = Vec3<T> (0, 1, 0);
+
+    bool lineHits[8] = { true, false, true, true, false, true, false, true };
+    bool rayHits[8]  = { true, false, false, true, false, true, false, true };
+
+    for (int i = 0; i < 8; ++i)
+    {
+        PreparedRay<T> r (rays[i]);
+        assert (r.parallel);
+
+        T tEntry, tExit;
+        Vec3<T> entry, exit;
+        assert (r.findEntryAndExitT (box, tEntry, tExit) == lineHits[i]);
+        assert (findEntryAndExitPoints (rays[i], box, entry, exit) == lineHits[i]);
+        assert (r.intersects (box) == rayHits[i]);
+        assert (intersects (box, rays[i]) == rayHits[i]);
+
+        assert (!r.findEntryAndExitT (Box<Vec3<T>>(), tEntry, tExit));
+        assert (!r.intersects (Box<Vec3<T>>()));
+    }
+
+    PreparedRay<T> r (rays[0]);
+    T tEntry, tExit;
+    assert (r.intersectT (box, tEntry, tExit) && tEntry == 1 && tExit == 3);
+
+    r.set (rays[2]);
+    assert (r.findEntryAndExitT (box, tEntry, tExit) && tEntry == -3 && tExit == -1);
+}
+
+template <class T>
+void
+testSpheresAndPlanes()
+{
+    Rand48 rand (1);
+
+    for (int k = 0; k < 10000; ++k)
+    {
+        Line3<T> ray = randomRay<T> (rand);
+        PreparedRay<T> r (ray);
+
+        Sphere3<T> sphere (randomVec<T> (rand, 8), T (rand.nextf (0.1, 4)));
+
+        T t1 = -1, t2 = -1;
+        bool hit = sphere.intersectT (ray, t1);
+        assert (r.intersectT (sphere, t2) == hit);
+        assert (!hit || t1 == t2);
+
+        Plane3<T> plane (randomVec<T> (rand, 8), randomVec<T> (rand, 1));
+
+        hit = plane.intersectT (ray, t1);
+        assert (r.intersectT (plane, t2) == hit);
+        assert (!hit || t1 == t2);
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+template <class T>
+void
+benchmark()
+{
+    const int numBoxes = 1024;
+    const int numRays  = 200;
+
+    Rand48 rand (0);
+    vector<Box<Vec3<T>>> boxes (numBoxes);
+    for (int b = 0; b < numBoxes; ++b)
+        boxes[b] = randomBox<T> (rand);
+
+    vector<Line3<T>> rays (numRays);
+    for (int i = 0; i < numRays; ++i)
+    {
+        rays[i].pos = randomVec<T> (rand, 10);
+        rays[i].dir = randomVec<T> (rand, 1).normalized();
+    }
+
+    size_t scalarHits = 0, preparedHits = 0;
+
+    clock_t t0 = clock();
+
+    for (int i = 0; i < numRays; ++i)
+        for (int b = 0; b < numBoxes; ++b)
+            scalarHits += intersects (boxes[b], rays[i]);
+
+    clock_t t1 = clock();
+
+    for (int i = 0; i < numRays; ++i)
+    {
+        PreparedRay<T> r (rays[i]);
+
+        for (int b = 0; b < numBoxes; ++b)
+            preparedHits += r.intersects (boxes[b]);
+    }
+
+    clock_t t2 = clock();
+
+    cout << "  " << numRays * numBoxes << " ray-box tests: scalar "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, prepared "
+         << double (t2 - t1) / CLOCKS_PER_SEC << " s (" << scalarHits << ", " << preparedHits
+         << " hits)" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testPreparedRay()
+{
+    cout << "Testing prepared rays" << endl;
+
+    testBoxes<float> (1e-3f);
+    testBoxes<double> (1e-9);
+
+    testSpheresAndPlanes<float>();
+    testSpheresAndPlanes<double>();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark<float>();
+#endif
+
+    cout << "ok\n" << endl;
+}
@@ -0,0 +1,299 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathFrustum.h"
+#include "ImathFrustumTest.h"
+#include "ImathQuantizedBox.h"
+#include "ImathRandom.h"
+#include <algorithm>
+#include <cassert>
+#include <ctime>
+#include <iostream>
+#include <testQuantizedBox.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+Vec3<T>
+randomPoint (Rand48& rand, const Box<Vec3<T>>& box)
+{
+    return Vec3<T> (T (rand.nextf (box.min.x, box.max.x)),
+                    T (rand.nextf (box.min.y, box.max.y)),
+                    T (rand.nextf (box.min.z, box.max.z)));
+}
+
+//
+// Quantize a box, and check that the decoded box contains the part of
+// the box within the parent, and is at most one grid step larger on
+// each side.
+//
+
+template <class Q, class T>
+void
+check (const Box<Vec3<T>>& box, const Box<Vec3<T>>& parent)
+{
+    QuantizedBox<Q> q (box, parent);
+    Box<Vec3<T>> decoded = q.decode (parent);
+
+    Box<Vec3<T>> clipped (box);
+    for (int i = 0; i < 3; ++i)
+    {
+        clipped.min[i] = std::max (box.min[i], parent.min[i]);
+        clipped.max[i] = std::min (box.max[i], parent.max[i]);
+    }
+
+    if (clipped.isEmpty())
+    {
+        assert (q.isEmpty());
+        assert (decoded.isEmpty());
+        return;
+    }
+
+    assert (!q.isEmpty());
+
+    Vec3<T> s = QuantizedBox<Q>::step (parent);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        assert (decoded.min[i] <= clipped.min[i]);
+        assert (decoded.max[i] >= clipped.max[i]);
+        assert (decoded.min[i] >= parent.min[i] && decoded.max[i] <= parent.max[i]);
+        assert (clipped.min[i] - decoded.min[i] <= s[i] * T (1.01));
+        assert (decoded.max[i] - clipped.max[i] <= s[i] * T (1.01));
+    }
+}
+
+template <class Q, class T>
+void
+testRandom (const Box<Vec3<T>>& parent)
+{
+    Rand48 rand (0);
+
+    for (int k = 0; k < 10000; ++k)
+    {
+        Box<Vec3<T>> box (randomPoint (rand, parent));
+        box.extendBy (randomPoint (rand, parent));
+        check<Q> (box, parent);
+
+        // A point, and a box that extends beyond the parent
+
+        Vec3<T> p = randomPoint (rand, parent);
+        check<Q> (Box<Vec3<T>> (p, p), parent);
+        check<Q> (Box<Vec3<T>> (p, p + parent.size()), parent);
+    }
+}
+
+template <class Q, class T>
+void
+testSpecialCases()
+{
+    const unsigned top = QuantizedBox<Q>::maxValue();
+
+    Box<Vec3<T>> parent (Vec3<T> (-1, 2, 10), Vec3<T> (3, 2.5, 1000));
+
+    // The parent itself decodes exactly
+
+    QuantizedBox<Q> q (parent, parent);
+    assert (q.min[0] == 0 && q.min[1] == 0 && q.min[2] == 0);
+    assert (q.max[0] == top && q.max[1] == top && q.max[2] == top);
+    assert (q.decode (parent) == parent);
+
+    // Empty boxes, and boxes outside the parent
+
+    q.set (Box<Vec3<T>>(), parent);
+    assert (q.isEmpty() && q.decode (parent).isEmpty());
+
+    q.set (Box<Vec3<T>> (Vec3<T> (4, 2, 10), Vec3<T> (5, 2.5, 20)), parent);
+    assert (q.isEmpty());
+
+    QuantizedBox<Q> e;
+    e.makeEmpty();
+    assert (e == q);
+
+    // Touching the parent is not outside
+
+    Box<Vec3<T>> touching (Vec3<T> (3, 2, 10), Vec3<T> (5, 2.5, 20));
+    q.set (touching, parent);
+    assert (!q.isEmpty() && q != e && q.max[0] == top);
+    check<Q> (touching, parent);
+
+    // A flat parent
+
+    Box<Vec3<T>> flat (Vec3<T> (0, 1, 0), Vec3<T> (1, 1, 1));
+    check<Q> (Box<Vec3<T>> (Vec3<T> (0.25, 1, 0.5), Vec3<T> (0.5, 1, 0.75)), flat);
+
+    // A parent far from the origin, where the grid steps are close to
+    // the spacing of the floating-point numbers
+
+    Box<Vec3<T>> far (Vec3<T> (T (1e6)), Vec3<T> (T (1e6) + T (1)));
+    testRandom<Q> (far);
+}
+
+template <class Q, class T>
+void
+testArrays()
+{
+    Rand48 rand (1);
+
+    Box<Vec3<T>> parent (Vec3<T> (-10, -20, -30), Vec3<T> (10, 20, 30));
+
+    for (size_t n = 0; n < 30; ++n)
+    {
+        vector<QuantizedBox<Q>> boxes (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (i % 7 == 3)
+            {
+                boxes[i].makeEmpty();
+            }
+            else
+            {
+                Box<Vec3<T>> box (randomPoint (rand, parent));
+                box.extendBy (randomPoint (rand, parent));
+                boxes[i].set (box, parent);
+            }
+        }
+
+        vector<Box<Vec3<T>>> result (n);
+        vector<T> soa[6];
+        for (int k = 0; k < 6; ++k)
+            soa[k].resize (n + 1);
+
+        Box3SoA<T> resultSoA (
+            &soa[0][0], &soa[1][0], &soa[2][0], &soa[3][0], &soa[4][0], &soa[5][0]);
+
+        decode (boxes.data(), parent, result.data(), n);
+        decode (boxes.data(), parent, resultSoA, n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert (result[i] == boxes[i].decode (parent));
+            assert (resultSoA[i] == result[i]);
+        }
+    }
+}
+
+//
+// Culling with the decoded boxes is conservative
+//
+
+void
+testCulling()
+{
+    Frustumf frustum (0.1f, 100.0f, 1.0f, 0.0f, 1.0f);
+    M44f camera;
+    camera.setTranslation (V3f (0, 0, 50));
+
+    FrustumTestf test (frustum, camera);
+
+    Box3f parent (V3f (-50), V3f (50));
+    Rand48 rand (2);
+
+    size_t visible = 0;
+
+    for (int k = 0; k < 10000; ++k)
+    {
+        V3f c = randomPoint (rand, parent);
+        V3f e (rand.nextf (0, 2), rand.nextf (0, 2), rand.nextf (0, 2));
+        Box3f box (c - e, c + e);
+
+        QuantizedBox8 q8 (box, parent);
+        QuantizedBox16 q16 (box, parent);
+
+        if (test.isVisible (box))
+        {
+            ++visible;
+            assert (test.isVisible (q8.decode (parent)));
+            assert (test.isVisible (q16.decode (parent)));
+        }
+    }
+
+    assert (visible > 0);
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmark()
+{
+    const size_t n = 1000000;
+
+    Box3f parent (V3f (-50), V3f (50));
+    Rand48 rand (3);
+
+    vector<Box3f> boxes (n);
+    vector<QuantizedBox16> quantized (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        boxes[i] = Box3f (randomPoint (rand, parent));
+        boxes[i].extendBy (randomPoint (rand, parent));
+        quantized[i].set (boxes[i], parent);
+    }
+
+    vector<Box3f> result (n);
+
+    clock_t t0 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        result[i] = quantized[i].decode (parent);
+
+    clock_t t1 = clock();
+
+    decode (quantized.data(), parent, result.data(), n);
+
+    clock_t t2 = clock();
+
+    cout << "  " << n << " boxes of " << sizeof (QuantizedBox16) << " bytes: decode() "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, as an array "
+         << double (t2 - t1) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testQuantizedBox()
+{
+    cout << "Testing quantized boxes" << endl;
+
+    assert (sizeof (QuantizedBox8) == 6);
+    assert (sizeof (QuantizedBox16) == 12);
+
+    Box3f parentf (V3f (-3, 0, 7), V3f (5, 0.125f, 1000));
+    Box3d parentd (V3d (-3, 0, 7), V3d (5, 0.125, 1000));
+
+    testRandom<uint8_t> (parentf);
+    testRandom<uint16_t> (parentf);
+    testRandom<uint8_t> (parentd);
+    testRandom<uint16_t> (parentd);
+
+    testSpecialCases<uint8_t, float>();
+    testSpecialCases<uint16_t, float>();
+    testSpecialCases<uint16_t, double>();
+
+    testArrays<uint8_t, float>();
+    testArrays<uint16_t, float>();
+    testArrays<uint16_t, double>();
+
+    testCulling();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark();
+#endif
+
+    cout << "ok\n" << endl;
+}
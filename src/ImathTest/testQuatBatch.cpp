@@ -0,0 +1,349 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathQuat.h"
+#include "ImathRandom.h"
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <testQuatBatch.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+Quat<T>
+randomQuat (Rand48& rand)
+{
+    Quat<T> q (T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)));
+    return q.normalized();
+}
+
+template <class T, class S>
+T
+maxError (const Quat<T>& q1, const Quat<S>& q2)
+{
+    T e = std::abs (q1.r - T (q2.r));
+    e   = std::max (e, std::abs (q1.v.x - T (q2.v.x)));
+    e   = std::max (e, std::abs (q1.v.y - T (q2.v.y)));
+    e   = std::max (e, std::abs (q1.v.z - T (q2.v.z)));
+    return e;
+}
+
+//
+// A stream of n quaternions, stored both as Quat and as QuatSoA
+//
+
+template <class T> struct Stream
+{
+    vector<Quat<T>> aos;
+    vector<T> r, x, y, z;
+
+    Stream (size_t n) : aos (n), r (n), x (n), y (n), z (n) {}
+
+    QuatSoA<T> soa() { return QuatSoA<T> (&r[0], &x[0], &y[0], &z[0]); }
+
+    void copyToSoA()
+    {
+        for (size_t i = 0; i < aos.size(); ++i)
+            soa().set (i, aos[i]);
+    }
+};
+
+//
+// Compare the batched functions, in precision T, against the
+// scalar functions in double precision
+//
+
+template <class T>
+void
+testAccuracy (SlerpAccuracy accuracy, double bound)
+{
+    const size_t n = 10000;
+    Rand48 rand (17);
+
+    Stream<T> q1 (n), q2 (n), qa (n), qb (n), q3 (n), result (n);
+    vector<Quatd> q1d (n), q2d (n), qad (n), qbd (n);
+    vector<T> t (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        q1d[i] = randomQuat<double> (rand);
+        q2d[i] = randomQuat<double> (rand);
+        qad[i] = randomQuat<double> (rand);
+        qbd[i] = randomQuat<double> (rand);
+
+        // slerp() and squad() require q1^q2 >= 0 for the error bound
+
+        if ((q1d[i] ^ q2d[i]) < 0)
+            q2d[i] = -q2d[i];
+
+        if ((qad[i] ^ qbd[i]) < 0)
+            qbd[i] = -qbd[i];
+
+        q1.aos[i] = Quat<T> (q1d[i]);
+        q2.aos[i] = Quat<T> (q2d[i]);
+        qa.aos[i] = Quat<T> (qad[i]);
+        qb.aos[i] = Quat<T> (qbd[i]);
+        q3.aos[i] = -q2.aos[i];
+
+        // Round t so that the double precision reference uses
+        // the same value
+
+        t[i] = T (rand.nextf (0, 1));
+    }
+
+    q1.copyToSoA();
+    q2.copyToSoA();
+    qa.copyToSoA();
+    qb.copyToSoA();
+    q3.copyToSoA();
+
+    const double e = bound + (sizeof (T) == 4 ? 1e-6 : 0);
+
+    //
+    // slerp()
+    //
+
+    slerp (&q1.aos[0], &q2.aos[0], &t[0], &result.aos[0], n, accuracy);
+    slerp<T> (q1.soa(), q2.soa(), &t[0], result.soa(), n, accuracy);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Quatd ref = slerp (Quatd (q1.aos[i]), Quatd (q2.aos[i]), double (t[i]));
+        assert (maxError (ref, result.aos[i]) < e);
+        assert (result.soa()[i] == result.aos[i]);
+    }
+
+    //
+    // slerpShortestArc(), with q1^q3 < 0
+    //
+
+    slerpShortestArc (&q1.aos[0], &q3.aos[0], &t[0], &result.aos[0], n, accuracy);
+    slerpShortestArc<T> (q1.soa(), q3.soa(), &t[0], result.soa(), n, accuracy);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Quatd ref = slerpShortestArc (Quatd (q1.aos[i]), Quatd (q3.aos[i]), double (t[i]));
+        assert (maxError (ref, result.aos[i]) < e);
+        assert (result.soa()[i] == result.aos[i]);
+    }
+
+    //
+    // squad()
+    //
+
+    squad (&q1.aos[0], &qa.aos[0], &qb.aos[0], &q2.aos[0], &t[0], &result.aos[0], n, accuracy);
+    squad<T> (q1.soa(), qa.soa(), qb.soa(), q2.soa(), &t[0], result.soa(), n, accuracy);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Quatd ref = squad (Quatd (q1.aos[i]),
+                           Quatd (qa.aos[i]),
+                           Quatd (qb.aos[i]),
+                           Quatd (q2.aos[i]),
+                           double (t[i]));
+
+        // squad() chains three slerps, and the last one can span
+        // nearly pi, where slerp() is ill-conditioned, so the
+        // errors grow, even for SLERP_EXACT in float
+
+        assert (maxError (ref, result.aos[i]) < 50 * bound + (sizeof (T) == 4 ? 1e-5 : 0));
+        assert (result.soa()[i] == result.aos[i]);
+    }
+
+    //
+    // SlerpKey
+    //
+
+    vector<SlerpKey<T>> keys (n);
+    for (size_t i = 0; i < n; ++i)
+        keys[i] = SlerpKey<T> (q1.aos[i], q3.aos[i], true);
+
+    slerp (&keys[0], &t[0], &result.aos[0], n, accuracy);
+    slerp (&keys[0], &t[0], result.soa(), n, accuracy);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Quatd ref = slerp (Quatd (q1.aos[i]), Quatd (q2.aos[i]), double (t[i]));
+        assert (maxError (ref, result.aos[i]) < e);
+        assert (result.soa()[i] == result.aos[i]);
+        assert (keys[i] (t[i], accuracy) == result.aos[i]);
+    }
+}
+
+template <class T>
+void
+testSpecialCases()
+{
+    const T e = sizeof (T) == 8 ? T (1e-12) : T (1e-6);
+    Rand48 rand (3);
+
+    Quat<T> q1 = randomQuat<T> (rand);
+    Quat<T> q2 = randomQuat<T> (rand);
+    if ((q1 ^ q2) < 0)
+        q2 = -q2;
+
+    T t[4] = { 0, 1, T (0.5), T (0.25) };
+
+    Quat<T> q1s[4] = { q1, q1, q1, q1 };
+    Quat<T> q2s[4] = { q2, q2, q1, -q1 };
+    Quat<T> result[4];
+
+    for (int a = SLERP_FAST; a <= SLERP_EXACT; ++a)
+    {
+        SlerpAccuracy accuracy = SlerpAccuracy (a);
+        slerpShortestArc (q1s, q2s, t, result, 4, accuracy);
+
+        // End points
+
+        assert (maxError (result[0], q1) < 5e-5);
+        assert (maxError (result[1], q2) < 5e-5);
+
+        // Identical quaternions, and opposite quaternions along
+        // the shortest arc
+
+        assert (maxError (result[2], q1) < e);
+        assert (maxError (result[3], q1) < e);
+
+        // The default key is the identity
+
+        assert (SlerpKey<T>() (T (0.3), accuracy) == Quat<T>());
+    }
+
+    // SLERP_EXACT is the scalar slerp()
+
+    slerp (q1s, q2s, t, result, 3, SLERP_EXACT);
+    for (int i = 0; i < 3; ++i)
+        assert (result[i] == slerp (q1s[i], q2s[i], t[i]));
+}
+
+template <class T>
+void
+testIntermediate()
+{
+    const size_t n = 100;
+    Rand48 rand (5);
+
+    Stream<T> q0 (n), q1 (n), q2 (n), result (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        q0.aos[i] = randomQuat<T> (rand);
+        q1.aos[i] = randomQuat<T> (rand);
+        q2.aos[i] = randomQuat<T> (rand);
+    }
+
+    q0.copyToSoA();
+    q1.copyToSoA();
+    q2.copyToSoA();
+
+    intermediate (&q0.aos[0], &q1.aos[0], &q2.aos[0], &result.aos[0], n);
+    intermediate<T> (q0.soa(), q1.soa(), q2.soa(), result.soa(), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (result.aos[i] == intermediate (q0.aos[i], q1.aos[i], q2.aos[i]));
+        assert (result.soa()[i] == result.aos[i]);
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+testTiming()
+{
+    const size_t n    = 100000;
+    const int repeats = 20;
+    Rand48 rand (11);
+
+    Stream<float> q1 (n), q2 (n), result (n);
+    vector<float> t (n);
+    vector<SlerpKey<float>> keys (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        q1.aos[i] = randomQuat<float> (rand);
+        q2.aos[i] = randomQuat<float> (rand);
+        t[i]      = float (rand.nextf (0, 1));
+        keys[i]   = SlerpKey<float> (q1.aos[i], q2.aos[i], true);
+    }
+
+    q1.copyToSoA();
+    q2.copyToSoA();
+
+    clock_t start = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        for (size_t i = 0; i < n; ++i)
+            result.aos[i] = slerpShortestArc (q1.aos[i], q2.aos[i], t[i]);
+
+    clock_t scalarTime = clock() - start;
+    start              = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        slerpShortestArc<float> (q1.soa(), q2.soa(), &t[0], result.soa(), n, SLERP_ACCURATE);
+
+    clock_t accurateTime = clock() - start;
+    start                = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        slerpShortestArc<float> (q1.soa(), q2.soa(), &t[0], result.soa(), n, SLERP_FAST);
+
+    clock_t fastTime = clock() - start;
+    start            = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        slerp (&keys[0], &t[0], result.soa(), n, SLERP_ACCURATE);
+
+    clock_t keyTime = clock() - start;
+
+    cout << "  slerpShortestArc of " << n * repeats << " float quaternions:\n"
+         << "    scalar:                 " << float (scalarTime) / CLOCKS_PER_SEC << " s\n"
+         << "    batched SLERP_ACCURATE: " << float (accurateTime) / CLOCKS_PER_SEC << " s\n"
+         << "    batched SLERP_FAST:     " << float (fastTime) / CLOCKS_PER_SEC << " s\n"
+         << "    SlerpKey, accurate:     " << float (keyTime) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testQuatBatch()
+{
+    cout << "Testing batched quaternion interpolation" << endl;
+
+    testAccuracy<float> (SLERP_FAST, 5e-5);
+    testAccuracy<float> (SLERP_ACCURATE, 2e-9);
+    testAccuracy<float> (SLERP_EXACT, 0);
+    testAccuracy<double> (SLERP_FAST, 5e-5);
+    testAccuracy<double> (SLERP_ACCURATE, 2e-9);
+    testAccuracy<double> (SLERP_EXACT, 1e-14);
+
+    testSpecialCases<float>();
+    testSpecialCases<double>();
+
+    testIntermediate<float>();
+    testIntermediate<double>();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    testTiming();
+#endif
+
+    cout << "ok\n" << endl;
+}
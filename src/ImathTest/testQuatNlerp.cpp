@@ -0,0 +1,303 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathQuat.h"
+#include "ImathRandom.h"
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <testQuatNlerp.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+Quat<T>
+randomQuat (Rand48& rand)
+{
+    Quat<T> q (T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)),
+               T (rand.nextf (-1, 1)));
+    return q.normalized();
+}
+
+template <class T, class S>
+T
+maxError (const Quat<T>& q1, const Quat<S>& q2)
+{
+    T e = std::abs (q1.r - T (q2.r));
+    e   = std::max (e, std::abs (q1.v.x - T (q2.v.x)));
+    e   = std::max (e, std::abs (q1.v.y - T (q2.v.y)));
+    e   = std::max (e, std::abs (q1.v.z - T (q2.v.z)));
+    return e;
+}
+
+template <class T>
+void
+testNormalize()
+{
+    const T eps = limits<T>::epsilon();
+    Rand48 rand (7);
+
+    //
+    // renormalize(): if |q^q - 1| <= e, then |length - 1| < e*e/2
+    //
+
+    const T es[] = { T (0.5), T (0.1), T (1e-2), T (1e-3) };
+
+    for (T e: es)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            Quat<T> q = randomQuat<T> (rand) * std::sqrt (1 + T (rand.nextf (-e, e)));
+            assert (std::abs ((q ^ q) - 1) <= e + 4 * eps);
+
+            Quat<T> q1 = q.renormalized();
+            assert (std::abs (q1.length() - 1) < e * e / 2 + 4 * eps);
+
+            q.renormalize();
+            assert (q == q1);
+        }
+    }
+
+    //
+    // Batched normalize() and renormalize()
+    //
+
+    const size_t n = 100;
+    vector<Quat<T>> q (n), q1 (n);
+
+    for (size_t i = 0; i < n; ++i)
+        q[i] = randomQuat<T> (rand) * T (rand.nextf (0.01, 100));
+
+    q[7]  = Quat<T> (0, 0, 0, 0);
+    q[11] = Quat<T> (numeric_limits<T>::quiet_NaN(), 0, 0, 0);
+    q1    = q;
+
+    normalize (&q1[0], n);
+    for (size_t i = 0; i < n; ++i)
+        assert (i == 11 || q1[i] == q[i].normalized());
+
+    assert (q1[7] == Quat<T>());
+
+    // As with Quat::normalize(), NaNs spread to every component
+
+    assert (std::isnan (q1[11].r) && std::isnan (q1[11].v.x));
+    assert (std::isnan (q1[11].v.y) && std::isnan (q1[11].v.z));
+
+    q1[11] = Quat<T>();
+
+    vector<Quat<T>> q2 (q1);
+
+    renormalize (&q1[0], n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (q1[i] == q2[i].renormalized());
+        assert (i == 11 || maxError (q1[i], q[i].normalized()) <= 4 * eps);
+    }
+}
+
+template <class T>
+void
+testNlerp()
+{
+    const size_t n = 10000;
+    Rand48 rand (19);
+
+    vector<Quat<T>> q1 (n), q2 (n), result (n);
+    vector<T> t (n);
+    vector<T> r1 (n), x1 (n), y1 (n), z1 (n);
+    vector<T> r2 (n), x2 (n), y2 (n), z2 (n);
+    vector<T> r (n), x (n), y (n), z (n);
+
+    QuatSoA<T> s1 (&r1[0], &x1[0], &y1[0], &z1[0]);
+    QuatSoA<T> s2 (&r2[0], &x2[0], &y2[0], &z2[0]);
+    QuatSoA<T> s (&r[0], &x[0], &y[0], &z[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        q1[i] = randomQuat<T> (rand);
+        q2[i] = randomQuat<T> (rand);
+        t[i]  = T (rand.nextf (0, 1));
+        s1.set (i, q1[i]);
+        s2.set (i, q2[i]);
+    }
+
+    //
+    // Error contracts, against slerpShortestArc() in double
+    //
+
+    const double e = sizeof (T) == 4 ? 1e-6 : 1e-14;
+
+    T maxNlerp = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Quatd ref = slerpShortestArc (Quatd (q1[i]), Quatd (q2[i]), double (t[i]));
+
+        Quat<T> q = nlerp (q1[i], q2[i], t[i]);
+        assert (std::abs (q.length() - 1) < 4 * e);
+        maxNlerp = std::max (maxNlerp, maxError (q, ref));
+        assert (maxError (q, ref) < 0.072 + e);
+
+        q = nlerpCorrected (q1[i], q2[i], t[i]);
+        assert (std::abs (q.length() - 1) < 4 * e);
+        assert (maxError (q, ref) < 5e-4 + e);
+    }
+
+    // The uncorrected error is large enough to matter
+
+    assert (maxNlerp > 0.05);
+
+    //
+    // End points, and both signs of q2
+    //
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        assert (maxError (nlerp (q1[i], q2[i], T (0)), q1[i]) < 4 * e);
+        assert (maxError (nlerpCorrected (q1[i], q2[i], T (0)), q1[i]) < 4 * e);
+
+        Quat<T> q = nlerpCorrected (q1[i], q2[i], T (1));
+        assert (maxError (q, q2[i]) < 4 * e || maxError (q, -q2[i]) < 4 * e);
+
+        assert (maxError (nlerp (q1[i], q2[i], t[i]), nlerp (q1[i], -q2[i], t[i])) < 4 * e);
+    }
+
+    //
+    // Batched versions
+    //
+
+    nlerp (&q1[0], &q2[0], &t[0], &result[0], n);
+    nlerp<T> (s1, s2, &t[0], s, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (result[i] == nlerp (q1[i], q2[i], t[i]));
+        assert (s[i] == result[i]);
+    }
+
+    nlerpCorrected (&q1[0], &q2[0], &t[0], &result[0], n);
+    nlerpCorrected<T> (s1, s2, &t[0], s, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (result[i] == nlerpCorrected (q1[i], q2[i], t[i]));
+        assert (s[i] == result[i]);
+    }
+
+    // In place
+
+    nlerp<T> (s1, s2, &t[0], s1, n);
+    for (size_t i = 0; i < n; ++i)
+        assert (s1[i] == nlerp (q1[i], q2[i], t[i]));
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+testTiming()
+{
+    const size_t n    = 100000;
+    const int repeats = 20;
+    Rand48 rand (23);
+
+    vector<Quatf> q1 (n), q2 (n), q (n), result (n);
+    vector<float> t (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        q1[i] = randomQuat<float> (rand);
+        q2[i] = randomQuat<float> (rand);
+        q[i]  = q1[i] * float (rand.nextf (0.999, 1.001));
+        t[i]  = float (rand.nextf (0, 1));
+    }
+
+    clock_t start = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        for (size_t i = 0; i < n; ++i)
+            result[i] = q[i].normalized();
+
+    clock_t normalizeTime = clock() - start;
+
+    //
+    // The arrays are normalized in place repeatedly, which costs the
+    // same each time, rather than copied before each call
+    //
+
+    vector<Quatf> qn (q), qr (q);
+    start = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        normalize (&qn[0], n);
+
+    clock_t normalizeArrayTime = clock() - start;
+    start                      = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        renormalize (&qr[0], n);
+
+    clock_t renormalizeTime = clock() - start;
+    start                   = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        for (size_t i = 0; i < n; ++i)
+            result[i] = slerpShortestArc (q1[i], q2[i], t[i]);
+
+    clock_t slerpTime = clock() - start;
+    start             = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        nlerp (&q1[0], &q2[0], &t[0], &result[0], n);
+
+    clock_t nlerpTime = clock() - start;
+    start             = clock();
+
+    for (int j = 0; j < repeats; ++j)
+        nlerpCorrected (&q1[0], &q2[0], &t[0], &result[0], n);
+
+    clock_t correctedTime = clock() - start;
+
+    cout << "  " << n * repeats << " float quaternions:\n"
+         << "    normalized():       " << float (normalizeTime) / CLOCKS_PER_SEC << " s\n"
+         << "    normalize() array:  " << float (normalizeArrayTime) / CLOCKS_PER_SEC << " s\n"
+         << "    renormalize():      " << float (renormalizeTime) / CLOCKS_PER_SEC << " s\n"
+         << "    slerpShortestArc(): " << float (slerpTime) / CLOCKS_PER_SEC << " s\n"
+         << "    nlerp():            " << float (nlerpTime) / CLOCKS_PER_SEC << " s\n"
+         << "    nlerpCorrected():   " << float (correctedTime) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testQuatNlerp()
+{
+    cout << "Testing fast quaternion normalization and nlerp" << endl;
+
+    testNormalize<float>();
+    testNormalize<double>();
+    testNlerp<float>();
+    testNlerp<double>();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    testTiming();
+#endif
+
+    cout << "ok\n" << endl;
+}
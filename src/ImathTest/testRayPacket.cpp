@@ -0,0 +1,311 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathBoxAlgo.h"
+#include "ImathRandom.h"
+#include "ImathRayPacket.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <randomGeometry.h>
+#include <testRayPacket.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// Compare all tests of a packet against one box with the scalar
+// functions in ImathBoxAlgo.h.
+//
+
+template <class T, int N>
+void
+compare (const RayPacket<T, N>& packet, const Line3<T> rays[N], const Box<Vec3<T>>& box, T e)
+{
+    typedef typename RayPacket<T, N>::RayMask RayMask;
+
+    T tEntry[N], tExit[N];
+    RayMask lineMask = packet.findEntryAndExitT (box, tEntry, tExit);
+
+    for (int i = 0; i < N; ++i)
+    {
+        Vec3<T> entry, exit;
+        bool hit = findEntryAndExitPoints (rays[i], box, entry, exit);
+        assert (hit == bool ((lineMask >> i) & 1));
+
+        if (hit)
+        {
+            assert (tEntry[i] <= tExit[i]);
+            assert (packet.point (i, tEntry[i]).equalWithAbsError (entry, e));
+            assert (packet.point (i, tExit[i]).equalWithAbsError (exit, e));
+        }
+    }
+
+    T tMax[N];
+    RayMask rayMask = packet.intersectT (box, tEntry, tExit);
+
+    for (int i = 0; i < N; ++i)
+    {
+        Vec3<T> ip;
+        bool hit = intersects (box, rays[i], ip);
+        assert (hit == bool ((rayMask >> i) & 1));
+
+        if (hit)
+        {
+            assert (tEntry[i] >= 0 && tEntry[i] <= tExit[i]);
+            assert (packet.point (i, tEntry[i]).equalWithAbsError (ip, e));
+            assert (tEntry[i] > 0 || box.intersects (rays[i].pos));
+
+            tMax[i] = tEntry[i] * T (0.5);
+        }
+        else
+        {
+            tMax[i] = limits<T>::max();
+        }
+    }
+
+    assert (packet.intersects (box) == rayMask);
+
+    // Hits before tMax[i] only: rays that start inside the box
+    // have tEntry[i] == 0 and are still hit.
+
+    RayMask closerMask = packet.intersects (box, tMax);
+
+    for (int i = 0; i < N; ++i)
+    {
+        bool hit = ((rayMask >> i) & 1) && tEntry[i] == 0;
+        assert (hit == bool ((closerMask >> i) & 1));
+    }
+}
+
+template <class T, int N>
+void
+testRandom (T e)
+{
+    Rand48 rand (N);
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        Line3<T> rays[N];
+
+        for (int i = 0; i < N; ++i)
+            rays[i] = randomRay<T> (rand);
+
+        RayPacket<T, N> packet (rays);
+
+        for (int i = 0; i < N; ++i)
+        {
+            assert (packet.ray (i).pos == rays[i].pos);
+            assert (packet.ray (i).dir == rays[i].dir);
+        }
+
+        for (int b = 0; b < 10; ++b)
+            compare (packet, rays, randomBox<T> (rand), e);
+    }
+}
+
+template <class T>
+void
+testSpecialCases()
+{
+    typedef RayPacket<T, 8> Packet;
+
+    const T nan = numeric_limits<T>::quiet_NaN();
+    Box<Vec3<T>> box (Vec3<T> (-1), Vec3<T> (1));
+
+    Line3<T> rays[8];
+    rays[0].pos = Vec3<T> (-2, 0, 0); // along x, hits
+    rays[0].dir = Vec3<T> (1, 0, 0);
+    rays[1].pos = Vec3<T> (-2, 1, -1); // along x, on an edge of the box
+    rays[1].dir = Vec3<T> (1, 0, 0);
+    rays[2].pos = Vec3<T> (-2, 2, 0); // along x, beside the box
+    rays[2].dir = Vec3<T> (1, 0, 0);
+    rays[3].pos = Vec3<T> (-2, 0, 0); // along -x, hits behind the origin
+    rays[3].dir = Vec3<T> (-1, -T (0), T (0));
+    rays[4].pos = Vec3<T> (0, 0, 0); // zero direction inside
+    rays[4].dir = Vec3<T> (0, 0, 0);
+    rays[5].pos = Vec3<T> (0, 5, 0); // zero direction outside
+    rays[5].dir = Vec3<T> (0, 0, 0);
+    rays[6].pos = Vec3<T> (0, -2, 0); // NaN x direction, inside in x
+    rays[6].dir = Vec3<T> (nan, 1, 0);
+    rays[7].pos = Vec3<T> (3, -2, 0); // NaN x direction, outside in x
+    rays[7].dir = Vec3<T> (nan, 1, 0);
+
+    Packet packet (rays);
+
+    T tEntry[8], tExit[8];
+
+    assert (packet.findEntryAndExitT (box, tEntry, tExit) == 0x5b);
+    assert (tEntry[0] == 1 && tExit[0] == 3);
+    assert (tEntry[1] == 1 && tExit[1] == 3);
+    assert (tEntry[3] == -3 && tExit[3] == -1);
+    assert (tEntry[6] == 1 && tExit[6] == 3);
+
+    assert (packet.intersectT (box, tEntry, tExit) == 0x53);
+    assert (tEntry[4] == 0);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        Vec3<T> entry, exit;
+        bool hit = (packet.findEntryAndExitT (box, tEntry, tExit) >> i) & 1;
+        assert (hit == findEntryAndExitPoints (rays[i], box, entry, exit));
+        assert (bool ((packet.intersects (box) >> i) & 1) == intersects (box, rays[i]));
+    }
+
+    // Empty boxes are never hit
+
+    assert (packet.findEntryAndExitT (Box<Vec3<T>>(), tEntry, tExit) == 0);
+    assert (packet.intersects (Box<Vec3<T>>()) == 0);
+}
+
+//
+// Compare the triangle test of a packet with intersect() in
+// ImathLineAlgo.h. The results may differ only for rays close to an
+// edge of the triangle.
+//
+
+template <class T, int N>
+void
+testTriangles (T e)
+{
+    typedef typename RayPacket<T, N>::RayMask RayMask;
+
+    Rand48 rand (N + 1);
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        Line3<T> rays[N];
+
+        for (int i = 0; i < N; ++i)
+            rays[i] = randomRay<T> (rand);
+
+        RayPacket<T, N> packet (rays);
+
+        Vec3<T> c  = randomVec<T> (rand, 2);
+        Vec3<T> v0 = c + randomVec<T> (rand, 4);
+        Vec3<T> v1 = c + randomVec<T> (rand, 4);
+        Vec3<T> v2 = c + randomVec<T> (rand, 4);
+
+        T t[N];
+        Vec3<T> barycentric[N];
+        RayMask front;
+        RayMask mask = packet.intersect (v0, v1, v2, t, barycentric, front);
+
+        assert ((front & ~mask) == 0);
+
+        for (int i = 0; i < N; ++i)
+        {
+            Vec3<T> pt, b;
+            bool f   = false;
+            bool ref = intersect (rays[i], v0, v1, v2, pt, b, f);
+            bool hit = (mask >> i) & 1;
+
+            if (hit && ref)
+            {
+                assert (packet.point (i, t[i]).equalWithAbsError (pt, e * 10));
+                assert (barycentric[i].equalWithAbsError (b, e));
+                assert (bool ((front >> i) & 1) == f);
+            }
+            else if (hit)
+            {
+                assert (min (barycentric[i].x, min (barycentric[i].y, barycentric[i].z)) < e);
+            }
+            else if (ref)
+            {
+                assert (min (b.x, min (b.y, b.z)) < e);
+            }
+        }
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+template <class T>
+void
+benchmark()
+{
+    const int N        = 8;
+    const int numBoxes = 1024;
+
+    Rand48 rand (0);
+    vector<Box<Vec3<T>>> boxes (numBoxes);
+    for (int b = 0; b < numBoxes; ++b)
+        boxes[b] = randomBox<T> (rand);
+
+    Line3<T> rays[N];
+    for (int i = 0; i < N; ++i)
+        rays[i] = randomRay<T> (rand);
+
+    RayPacket<T, N> packet (rays);
+
+    const int repeat = 100;
+    size_t scalarHits = 0, packetHits = 0;
+
+    clock_t t0 = clock();
+
+    for (int r = 0; r < repeat; ++r)
+        for (int b = 0; b < numBoxes; ++b)
+            for (int i = 0; i < N; ++i)
+                scalarHits += intersects (boxes[b], rays[i]);
+
+    clock_t t1 = clock();
+
+    for (int r = 0; r < repeat; ++r)
+    {
+        for (int b = 0; b < numBoxes; ++b)
+        {
+            unsigned mask = packet.intersects (boxes[b]);
+            for (; mask; mask &= mask - 1)
+                ++packetHits;
+        }
+    }
+
+    clock_t t2 = clock();
+
+    cout << "  " << repeat * numBoxes * N << " ray-box tests: scalar "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, packets of " << N << " "
+         << double (t2 - t1) / CLOCKS_PER_SEC << " s (" << scalarHits << ", " << packetHits
+         << " hits)" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testRayPacket()
+{
+    cout << "Testing ray packets" << endl;
+
+    testRandom<float, 4> (1e-3f);
+    testRandom<float, 8> (1e-3f);
+    testRandom<float, 16> (1e-3f);
+    testRandom<double, 4> (1e-9);
+    testRandom<double, 64> (1e-9);
+    testRandom<double, 3> (1e-9);
+
+    testSpecialCases<float>();
+    testSpecialCases<double>();
+
+    testTriangles<float, 8> (1e-3f);
+    testTriangles<double, 16> (1e-9);
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark<float>();
+#endif
+
+    cout << "ok\n" << endl;
+}
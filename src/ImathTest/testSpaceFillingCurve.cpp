@@ -0,0 +1,373 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathRandom.h"
+#include "ImathSpaceFillingCurve.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <testSpaceFillingCurve.h>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// Interleave the low bits of D coordinates one bit at a time
+//
+
+uint64_t
+interleave (const uint32_t c[], int D, int bits)
+{
+    uint64_t code = 0;
+
+    for (int b = 0; b < bits; ++b)
+        for (int d = 0; d < D; ++d)
+            code |= uint64_t ((c[d] >> b) & 1) << (b * D + d);
+
+    return code;
+}
+
+uint32_t
+randomBits (Rand48& rand, int bits)
+{
+    uint32_t r = uint32_t (rand.nexti()) ^ (uint32_t (rand.nexti()) << 16);
+    return bits == 32 ? r : r & ((uint32_t (1) << bits) - 1);
+}
+
+void
+testMorton()
+{
+    cout << "  Morton codes" << endl;
+
+    assert (mortonEncode32 (1, 0, 0) == 1);
+    assert (mortonEncode32 (0, 1, 0) == 2);
+    assert (mortonEncode32 (0, 0, 1) == 4);
+    assert (mortonEncode32 (0x3ff, 0x3ff, 0x3ff) == 0x3fffffff);
+    assert (mortonEncode32 (0xffff, 0xffff) == 0xffffffff);
+    assert (mortonEncode64 (0x1fffff, 0x1fffff, 0x1fffff) == 0x7fffffffffffffffull);
+    assert (mortonEncode64 (0xffffffff, 0xffffffff) == 0xffffffffffffffffull);
+
+    // Higher bits are ignored
+
+    assert (mortonEncode32 (0x400, 0, 0) == 0);
+    assert (mortonEncode64 (0, 0x200000, 0) == 0);
+
+    Rand48 rand (0);
+
+    for (int k = 0; k < 100000; ++k)
+    {
+        uint32_t c2[2] = { randomBits (rand, 16), randomBits (rand, 16) };
+        uint32_t c3[3] = { randomBits (rand, 10), randomBits (rand, 10), randomBits (rand, 10) };
+        uint32_t d2[2] = { randomBits (rand, 32), randomBits (rand, 32) };
+        uint32_t d3[3] = { randomBits (rand, 21), randomBits (rand, 21), randomBits (rand, 21) };
+
+        uint32_t x, y, z;
+
+        uint32_t code32 = mortonEncode32 (c2[0], c2[1]);
+        assert (code32 == interleave (c2, 2, 16));
+        mortonDecode32 (code32, x, y);
+        assert (x == c2[0] && y == c2[1]);
+
+        code32 = mortonEncode32 (c3[0], c3[1], c3[2]);
+        assert (code32 == interleave (c3, 3, 10));
+        mortonDecode32 (code32, x, y, z);
+        assert (x == c3[0] && y == c3[1] && z == c3[2]);
+
+        uint64_t code64 = mortonEncode64 (d2[0], d2[1]);
+        assert (code64 == interleave (d2, 2, 32));
+        mortonDecode64 (code64, x, y);
+        assert (x == d2[0] && y == d2[1]);
+
+        code64 = mortonEncode64 (d3[0], d3[1], d3[2]);
+        assert (code64 == interleave (d3, 3, 21));
+        mortonDecode64 (code64, x, y, z);
+        assert (x == d3[0] && y == d3[1] && z == d3[2]);
+    }
+}
+
+//
+// Consecutive Hilbert codes are neighboring cells
+//
+
+bool
+adjacent (const uint32_t a[], const uint32_t b[], int D)
+{
+    uint32_t distance = 0;
+
+    for (int d = 0; d < D; ++d)
+        distance += a[d] > b[d] ? a[d] - b[d] : b[d] - a[d];
+
+    return distance == 1;
+}
+
+void
+testHilbert()
+{
+    cout << "  Hilbert codes" << endl;
+
+    uint32_t p[3], q[3];
+
+    // The whole 3D 32-bit curve
+
+    hilbertDecode32 (0, p[0], p[1], p[2]);
+    assert (p[0] == 0 && p[1] == 0 && p[2] == 0);
+
+    for (uint32_t code = 1; code < (uint32_t (1) << 30); code += (code < (1 << 20) ? 1 : 997))
+    {
+        hilbertDecode32 (code, q[0], q[1], q[2]);
+        assert (hilbertEncode32 (q[0], q[1], q[2]) == code);
+
+        if (code < (1 << 20))
+            assert (adjacent (p, q, 3));
+
+        p[0] = q[0];
+        p[1] = q[1];
+        p[2] = q[2];
+    }
+
+    // The start of the 2D 32-bit curve
+
+    hilbertDecode32 (0, p[0], p[1]);
+    assert (p[0] == 0 && p[1] == 0);
+
+    for (uint32_t code = 1; code < (1 << 20); ++code)
+    {
+        hilbertDecode32 (code, q[0], q[1]);
+        assert (hilbertEncode32 (q[0], q[1]) == code);
+        assert (adjacent (p, q, 2));
+
+        p[0] = q[0];
+        p[1] = q[1];
+    }
+
+    // Random parts of the 64-bit curves
+
+    Rand48 rand (1);
+
+    for (int k = 0; k < 100000; ++k)
+    {
+        uint64_t code = (uint64_t (randomBits (rand, 32)) << 32) | randomBits (rand, 32);
+
+        hilbertDecode64 (code, p[0], p[1]);
+        hilbertDecode64 (code + 1, q[0], q[1]);
+        assert (hilbertEncode64 (p[0], p[1]) == code);
+        assert (code == ~uint64_t (0) || adjacent (p, q, 2));
+
+        code &= 0x7fffffffffffffffull;
+
+        hilbertDecode64 (code, p[0], p[1], p[2]);
+        hilbertDecode64 (code + 1, q[0], q[1], q[2]);
+        assert (hilbertEncode64 (p[0], p[1], p[2]) == code);
+        assert (code == 0x7fffffffffffffffull || adjacent (p, q, 3));
+    }
+}
+
+template <class T>
+void
+testCodesOfPoints()
+{
+    Box<Vec3<T>> bounds (Vec3<T> (-1, 2, 10), Vec3<T> (3, 2.5, 1000));
+    const uint32_t last = (1 << 21) - 1;
+
+    assert (mortonCode (bounds.min, bounds) == 0);
+    assert (mortonCode (bounds.max, bounds) == mortonEncode64 (last, last, last));
+    assert (mortonCode (bounds.max + Vec3<T> (1), bounds) == mortonCode (bounds.max, bounds));
+    assert (mortonCode (bounds.min - Vec3<T> (1), bounds) == 0);
+    assert (mortonCode (Vec3<T> (numeric_limits<T>::quiet_NaN()), bounds) == 0);
+    assert (hilbertCode (bounds.min, bounds) == 0);
+
+    Box<Vec2<T>> bounds2 (Vec2<T> (-1, -1), Vec2<T> (1, 1));
+    assert (mortonCode (bounds2.max, bounds2) == ~uint64_t (0));
+    assert (mortonCode (Vec2<T> (0, 0), bounds2) == mortonEncode64 (1u << 31, 1u << 31));
+
+    // A flat box
+
+    Box<Vec3<T>> flat (Vec3<T> (0, 0, 1), Vec3<T> (1, 1, 1));
+    assert (mortonCode (Vec3<T> (1, 1, 1), flat) == mortonEncode64 (last, last, 0));
+
+    // Arrays
+
+    const size_t n = 1000;
+    Rand48 rand (2);
+
+    vector<Vec3<T>> points (n);
+    vector<Vec2<T>> points2 (n);
+    vector<Box<Vec3<T>>> boxes (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        points[i] = Vec3<T> (T (rand.nextf (-2, 4)), T (rand.nextf (2, 2.5)), T (rand.nextf (0, 999)));
+        points2[i] = Vec2<T> (points[i].x, points[i].y);
+        boxes[i]   = Box<Vec3<T>> (points[i] - Vec3<T> (T (0.25)), points[i] + Vec3<T> (T (0.25)));
+    }
+
+    vector<uint64_t> codes (n);
+
+    mortonCodes (points.data(), bounds, codes.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        assert (codes[i] == mortonCode (points[i], bounds));
+
+    mortonCodes (points2.data(), bounds2, codes.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        assert (codes[i] == mortonCode (points2[i], bounds2));
+
+    mortonCodes (boxes.data(), bounds, codes.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        assert (codes[i] == mortonCode (boxes[i].center(), bounds));
+
+    hilbertCodes (points.data(), bounds, codes.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        assert (codes[i] == hilbertCode (points[i], bounds));
+
+    hilbertCodes (points2.data(), bounds2, codes.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        assert (codes[i] == hilbertCode (points2[i], bounds2));
+
+    hilbertCodes (boxes.data(), bounds, codes.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        assert (codes[i] == hilbertCode (boxes[i].center(), bounds));
+}
+
+template <class K>
+void
+checkRadixSort (vector<K> keys)
+{
+    size_t n = keys.size();
+
+    vector<pair<K, uint32_t>> expected (n);
+    vector<uint32_t> values (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        values[i]   = uint32_t (i);
+        expected[i] = make_pair (keys[i], uint32_t (i));
+    }
+
+    stable_sort (expected.begin(),
+                 expected.end(),
+                 [] (const pair<K, uint32_t>& a, const pair<K, uint32_t>& b) {
+                     return a.first < b.first;
+                 });
+
+    radixSort (keys.data(), values.data(), n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (keys[i] == expected[i].first && values[i] == expected[i].second);
+}
+
+void
+testRadixSort()
+{
+    cout << "  radix sort" << endl;
+
+    Rand48 rand (3);
+
+    for (size_t n = 0; n < 2000; n = n * 2 + 1)
+    {
+        vector<uint64_t> keys64 (n);
+        vector<uint32_t> keys32 (n);
+
+        for (size_t i = 0; i < n; ++i)
+            keys64[i] = (uint64_t (randomBits (rand, 32)) << 32) | randomBits (rand, 32);
+        checkRadixSort (keys64);
+
+        // 63-bit codes, and many equal keys
+
+        for (size_t i = 0; i < n; ++i)
+            keys64[i] = mortonEncode64 (randomBits (rand, 4), randomBits (rand, 21), 7);
+        checkRadixSort (keys64);
+
+        for (size_t i = 0; i < n; ++i)
+            keys32[i] = randomBits (rand, 32) & 0x00ff0f0f;
+        checkRadixSort (keys32);
+
+        checkRadixSort (vector<uint32_t> (n, 42));
+    }
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+void
+benchmark()
+{
+    const size_t n = 1000000;
+
+    Rand48 rand (4);
+    vector<V3f> points (n);
+
+    for (size_t i = 0; i < n; ++i)
+        points[i] = V3f (rand.nextf (-1, 1), rand.nextf (-1, 1), rand.nextf (-1, 1));
+
+    Box3f bounds (V3f (-1), V3f (1));
+
+    vector<uint64_t> codes (n);
+    vector<uint32_t> order (n);
+
+    clock_t t0 = clock();
+
+    mortonCodes (points.data(), bounds, codes.data(), n);
+
+    clock_t t1 = clock();
+
+    vector<pair<uint64_t, uint32_t>> pairs (n);
+    for (size_t i = 0; i < n; ++i)
+        pairs[i] = make_pair (codes[i], uint32_t (i));
+
+    sort (pairs.begin(), pairs.end());
+
+    clock_t t2 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        order[i] = uint32_t (i);
+
+    radixSort (codes.data(), order.data(), n);
+
+    clock_t t3 = clock();
+
+    for (size_t i = 0; i < n; ++i)
+        assert (codes[i] == pairs[i].first);
+
+    cout << "    " << n << " points: Morton codes " << double (t1 - t0) / CLOCKS_PER_SEC
+         << " s, std::sort " << double (t2 - t1) / CLOCKS_PER_SEC << " s, radixSort "
+         << double (t3 - t2) / CLOCKS_PER_SEC << " s" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testSpaceFillingCurve()
+{
+    cout << "Testing space-filling curves" << endl;
+
+    testMorton();
+    testHilbert();
+
+    cout << "  codes of points" << endl;
+
+    testCodesOfPoints<float>();
+    testCodesOfPoints<double>();
+
+    testRadixSort();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark();
+#endif
+
+    cout << "ok\n" << endl;
+}
@@ -0,0 +1,268 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "ImathLineAlgo.h"
+#include "ImathRandom.h"
+#include "ImathTrianglePacket.h"
+#include <algorithm>
+#include <cassert>
+#include <ctime>
+#include <iostream>
+#include <randomGeometry.h>
+#include <testTrianglePacket.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+T
+minComponent (const Vec3<T>& v)
+{
+    return std::min (v.x, std::min (v.y, v.z));
+}
+
+//
+// Compare the results for triangle i of a packet with intersect().
+// They may differ only for lines close to an edge of the triangle.
+//
+
+template <class T>
+void
+compare (const Line3<T>& line,
+         const Vec3<T>& v0,
+         const Vec3<T>& v1,
+         const Vec3<T>& v2,
+         bool hit,
+         T t,
+         const Vec3<T>& barycentric,
+         bool front,
+         T e)
+{
+    Vec3<T> pt, b;
+    bool f   = false;
+    bool ref = intersect (line, v0, v1, v2, pt, b, f);
+
+    if (hit && ref)
+    {
+        assert (line (t).equalWithAbsError (pt, e * 10));
+        assert (barycentric.equalWithAbsError (b, e));
+        assert (front == f);
+    }
+    else if (hit)
+    {
+        assert (minComponent (barycentric) < e);
+    }
+    else if (ref)
+    {
+        assert (minComponent (b) < e);
+    }
+}
+
+template <class T, int N>
+void
+testRandom (T e)
+{
+    typedef typename TrianglePacket<T, N>::TriangleMask TriangleMask;
+
+    Rand48 rand (N);
+
+    for (int k = 0; k < 2000; ++k)
+    {
+        Vec3<T> v0[N], v1[N], v2[N];
+        TrianglePacket<T, N> packet;
+
+        for (int i = 0; i < N; ++i)
+        {
+            Vec3<T> c = randomVec<T> (rand, 1);
+            v0[i]     = c + randomVec<T> (rand, 1);
+            v1[i]     = c + randomVec<T> (rand, 1);
+            v2[i]     = c + randomVec<T> (rand, 1);
+            packet.set (i, v0[i], v1[i], v2[i]);
+
+            Vec3<T> w0, w1, w2;
+            packet.vertices (i, w0, w1, w2);
+            assert (w0 == v0[i]);
+            assert (w1.equalWithAbsError (v1[i], e) && w2.equalWithAbsError (v2[i], e));
+        }
+
+        Line3<T> line (randomVec<T> (rand, 5), randomVec<T> (rand, 1));
+
+        T t[N], t2[N];
+        Vec3<T> barycentric[N];
+        TriangleMask front;
+        TriangleMask mask = packet.intersect (line, t, barycentric, front);
+
+        assert (packet.intersect (line, t2) == mask);
+        assert ((front & ~mask) == 0);
+
+        for (int i = 0; i < N; ++i)
+        {
+            bool hit = (mask >> i) & 1;
+            bool isFront = (front >> i) & 1;
+            compare (line, v0[i], v1[i], v2[i], hit, t[i], barycentric[i], isFront, e);
+
+            if (hit)
+                assert (t2[i] == t[i]);
+        }
+    }
+}
+
+template <class T>
+void
+testSpecialCases()
+{
+    TrianglePacket<T, 4> packet;
+
+    Vec3<T> v0 (0, 0, 0), v1 (1, 0, 0), v2 (0, 1, 0);
+
+    packet.set (0, v0, v1, v2);         // normal (0, 0, -1)
+    packet.set (1, v0, v2, v1);         // normal (0, 0, 1)
+    packet.set (2, v0, v0, v0);         // degenerate
+    packet.set (3, v0, v1, v1 * T (2)); // degenerate
+
+    T t[4];
+    Vec3<T> barycentric[4];
+    uint8_t front;
+
+    // From above, hitting (0.25, 0.5, 0)
+
+    Line3<T> line (Vec3<T> (0.25, 0.5, 2), Vec3<T> (0.25, 0.5, 1));
+    assert (packet.intersect (line, t, barycentric, front) == 0x3);
+    assert (front == 0x2);
+    assert (t[0] == 2 && t[1] == 2);
+    assert (barycentric[0] == Vec3<T> (0.25, 0.25, 0.5));
+    assert (barycentric[1] == Vec3<T> (0.25, 0.5, 0.25));
+
+    // From below, in the opposite direction
+
+    line = Line3<T> (Vec3<T> (0.25, 0.5, -1), Vec3<T> (0.25, 0.5, 0));
+    assert (packet.intersect (line, t, barycentric, front) == 0x3);
+    assert (front == 0x1);
+    assert (t[0] == 1 && t[1] == 1);
+
+    // On a vertex and an edge
+
+    line = Line3<T> (Vec3<T> (0, 0, 1), Vec3<T> (0, 0, 0));
+    assert (packet.intersect (line, t) == 0x3 && t[0] == 1);
+
+    line = Line3<T> (Vec3<T> (0.5, 0, 1), Vec3<T> (0.5, 0, 0));
+    assert (packet.intersect (line, t) == 0x3);
+
+    // Outside, and parallel to the triangle
+
+    line = Line3<T> (Vec3<T> (1, 1, 1), Vec3<T> (1, 1, 0));
+    assert (packet.intersect (line, t) == 0);
+
+    line = Line3<T> (Vec3<T> (0.1, 0.1, 1), Vec3<T> (0.2, 0.1, 1));
+    assert (packet.intersect (line, t) == 0);
+
+    line = Line3<T> (Vec3<T> (-1, 0.1, 0), Vec3<T> (0, 0.1, 0));
+    assert (packet.intersect (line, t) == 0);
+}
+
+#ifdef IMATH_TEST_BENCHMARKS
+
+template <class T>
+void
+benchmark()
+{
+    const int N          = 8;
+    const int numPackets = 1000;
+    const int numLines   = 100;
+
+    Rand48 rand (0);
+
+    vector<Vec3<T>> vertices (3 * N * numPackets);
+    vector<TrianglePacket<T, N>> packets (numPackets);
+
+    for (int p = 0; p < numPackets; ++p)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            Vec3<T>* v = &vertices[3 * (p * N + i)];
+            Vec3<T> c  = randomVec<T> (rand, 2);
+
+            for (int j = 0; j < 3; ++j)
+                v[j] = c + randomVec<T> (rand, T (0.5));
+
+            packets[p].set (i, v[0], v[1], v[2]);
+        }
+    }
+
+    vector<Line3<T>> lines (numLines);
+    for (int l = 0; l < numLines; ++l)
+        lines[l] = Line3<T> (randomVec<T> (rand, 5), randomVec<T> (rand, 1));
+
+    size_t scalarHits = 0, packetHits = 0;
+
+    clock_t t0 = clock();
+
+    for (int l = 0; l < numLines; ++l)
+    {
+        for (size_t k = 0; k < vertices.size(); k += 3)
+        {
+            Vec3<T> pt, barycentric;
+            bool front;
+            scalarHits += intersect (
+                lines[l], vertices[k], vertices[k + 1], vertices[k + 2], pt, barycentric, front);
+        }
+    }
+
+    clock_t t1 = clock();
+
+    for (int l = 0; l < numLines; ++l)
+    {
+        for (int p = 0; p < numPackets; ++p)
+        {
+            T t[N];
+            Vec3<T> barycentric[N];
+            uint8_t front;
+
+            unsigned mask = packets[p].intersect (lines[l], t, barycentric, front);
+            for (; mask; mask &= mask - 1)
+                ++packetHits;
+        }
+    }
+
+    clock_t t2 = clock();
+
+    cout << "  " << numLines * N * numPackets << " line-triangle tests: scalar "
+         << double (t1 - t0) / CLOCKS_PER_SEC << " s, packets of " << N << " "
+         << double (t2 - t1) / CLOCKS_PER_SEC << " s (" << scalarHits << ", " << packetHits
+         << " hits)" << endl;
+}
+
+#endif
+
+} // namespace
+
+void
+testTrianglePacket()
+{
+    cout << "Testing triangle packets" << endl;
+
+    testRandom<float, 4> (1e-3f);
+    testRandom<float, 8> (1e-3f);
+    testRandom<float, 16> (1e-3f);
+    testRandom<double, 5> (1e-9);
+    testRandom<double, 64> (1e-9);
+
+    testSpecialCases<float>();
+    testSpecialCases<double>();
+
+#ifdef IMATH_TEST_BENCHMARKS
+    benchmark<float>();
+#endif
+
+    cout << "ok\n" << endl;
+}